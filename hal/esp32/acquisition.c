@@ -0,0 +1,337 @@
+/**
+ * @file acquisition.c
+ * @brief Data-ready driven sensor acquisition engine for the ESP32 HAL.
+ *
+ * The DRDY interrupt only timestamps the edge and wakes the acquisition
+ * task, by task notification when the OSAL supports it so the wake-up
+ * skips the timer daemon hop of event groups. The task does the SPI burst
+ * read, so the ISR stays
+ * short and the bus is never touched from interrupt context. The task is
+ * the single producer of the sample ring and the caller of
+ * SPP_HAL_ACQ_Read() its single consumer; a full ring drops the newest
+ * sample instead of blocking the reader of the sensor.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <string.h>
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "spp/hal/gpio/gpio.h"
+#include "spp/osal/eventgroups.h"
+#include "spp/osal/task.h"
+#include "task_ext.h"
+
+#include "esp_timer.h"
+
+#include "acquisition.h"
+#include "gpio_esp32.h"
+#include "spi_esp32.h"
+#include "spsc.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Notification / event bit set by the DRDY ISR. */
+#define K_DRDY_BIT (1u << 0)
+
+/** @brief Longest the task blocks before re-checking the running flag. */
+#define K_WAIT_MS 100u
+
+/** @brief Longest SPP_HAL_ACQ_Stop() waits for the task to exit. */
+#define K_STOP_TIMEOUT_MS (4u * K_WAIT_MS)
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Block until the DRDY ISR signals an edge or K_WAIT_MS passes.
+ *
+ * @param[in] p_engine Engine being serviced.
+ * @return Non-zero if an edge was signalled.
+ */
+static int acq_wait_drdy(spp_acq_engine_t *p_engine)
+{
+#if SPP_OSAL_TASK_NOTIFY
+    spp_uint32_t bits = 0;
+    (void)p_engine;
+    SPP_OSAL_TaskNotifyWait(K_WAIT_MS, &bits);
+#else
+    osal_eventbits_t bits = 0;
+    OSAL_EventGroupWaitBits(p_engine->p_eventGroup, K_DRDY_BIT, 1, 0, K_WAIT_MS, &bits);
+#endif
+    return (bits & K_DRDY_BIT) != 0u;
+}
+
+/**
+ * @brief Acquisition task: wait for DRDY, read the burst, publish it.
+ *
+ * @param[in] p_arg The spp_acq_engine_t being serviced.
+ */
+static void acq_task(void *p_arg)
+{
+    spp_acq_engine_t *p_engine = (spp_acq_engine_t *)p_arg;
+    spp_acq_stats_t *p_stats = &p_engine->stats;
+    spp_acq_sample_t sample;
+
+    while (p_engine->running != 0u)
+    {
+        if (acq_wait_drdy(p_engine) == 0)
+            continue;
+
+        spp_uint32_t edgeCount = 0;
+        SPP_HAL_GPIO_GetLastEdge(p_engine->cfg.drdy_pin, &sample.capture_us, &edgeCount);
+
+        /* Edges that landed while the previous read was still running */
+        spp_uint32_t edges = edgeCount - p_engine->lastEdgeCount;
+        p_engine->lastEdgeCount = edgeCount;
+        if (edges == 0u)
+        {
+            /* Late or coalesced wake-up for an edge already read */
+            continue;
+        }
+        if (edges > 1u)
+        {
+            p_stats->missed_edges += edges - 1u;
+        }
+
+        sample.seq = edgeCount;
+        sample.length = p_engine->cfg.length;
+        if (SPP_HAL_SPI_BurstRead(p_engine->cfg.spi_handler, p_engine->cfg.start_reg, sample.data,
+                                  sample.length) != SPP_OK)
+        {
+            p_stats->read_errors += 1;
+            continue;
+        }
+        sample.read_us = esp_timer_get_time();
+
+        int64_t readLatency = sample.read_us - sample.capture_us;
+        if (readLatency > p_stats->read_latency_max)
+        {
+            p_stats->read_latency_max = readLatency;
+        }
+
+        if (SPP_OSAL_SpscPush(&p_engine->ring, &sample, 0) != SPP_OK)
+        {
+            p_stats->dropped += 1;
+            continue;
+        }
+        p_stats->samples += 1;
+    }
+
+    p_engine->taskExited = 1;
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Start acquiring samples on every DRDY edge.
+ *
+ * Configures the DRDY pin, spawns the acquisition task and registers the
+ * ISR that wakes it. The engine can be restarted after SPP_HAL_ACQ_Stop();
+ * without task notifications the event group is created once and reused.
+ *
+ * @param[in] p_engine Engine instance, zero-initialised before first use.
+ * @param[in] p_cfg    What to read and when; copied into the engine.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the engine (or a task from a timed-out stop) is
+ *         still running, the config is invalid or an
+ *         OSAL object could not be created.
+ */
+retval_t SPP_HAL_ACQ_Start(spp_acq_engine_t *p_engine, const spp_acq_config_t *p_cfg)
+{
+    retval_t ret;
+
+    if (p_engine == NULL || p_cfg == NULL || p_cfg->spi_handler == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_engine->running != 0u || (p_engine->p_task != NULL && p_engine->taskExited == 0u) ||
+        p_cfg->length == 0u || p_cfg->length > SPP_ACQ_SAMPLE_MAX_BYTES)
+    {
+        return SPP_ERROR;
+    }
+
+    p_engine->cfg = *p_cfg;
+    memset(&p_engine->stats, 0, sizeof(p_engine->stats));
+    p_engine->stats.latency_min = INT64_MAX;
+
+    ret = SPP_OSAL_SpscInit(&p_engine->ring, (uint8_t *)p_engine->ringStorage,
+                            SPP_ACQ_RING_DEPTH, sizeof(spp_acq_sample_t));
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+
+    /* Edges from before this start are not ours to count as missed */
+    int64_t lastEdgeUs = 0;
+    p_engine->lastEdgeCount = 0;
+    SPP_HAL_GPIO_GetLastEdge(p_cfg->drdy_pin, &lastEdgeUs, &p_engine->lastEdgeCount);
+
+    ret = SPP_HAL_GPIO_ConfigInterrupt(p_cfg->drdy_pin, p_cfg->drdy_intr_type, p_cfg->drdy_pull);
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+
+#if !SPP_OSAL_TASK_NOTIFY
+    if (p_engine->p_eventGroup == NULL)
+    {
+        p_engine->p_eventGroup = SPP_OSAL_EventGroupCreate(SPP_OSAL_GetEventGroupsBuffer());
+        if (p_engine->p_eventGroup == NULL)
+        {
+            return SPP_ERROR;
+        }
+    }
+
+    p_engine->isrCtx.p_event_group = p_engine->p_eventGroup;
+    p_engine->isrCtx.bits = K_DRDY_BIT;
+    ret = SPP_HAL_GPIO_RegisterISR(p_cfg->drdy_pin, &p_engine->isrCtx);
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+#endif
+
+    p_engine->taskExited = 0;
+    p_engine->running = 1;
+
+    spp_uint32_t stack = (p_cfg->task_stack != 0u) ? p_cfg->task_stack : SPP_ACQ_DEFAULT_STACK_DEPTH;
+    spp_uint32_t priority =
+        (p_cfg->task_priority != 0u) ? p_cfg->task_priority : SPP_ACQ_DEFAULT_PRIORITY;
+
+    p_engine->p_task = SPP_OSAL_TaskCreate(acq_task, "acq", stack, p_engine, priority,
+                                           SPP_OSAL_GetTaskStorage());
+    if (p_engine->p_task == NULL)
+    {
+        p_engine->running = 0;
+        return SPP_ERROR;
+    }
+
+#if SPP_OSAL_TASK_NOTIFY
+    /* The ISR needs the task handle, so it is attached once the task exists */
+    p_engine->notifyCtx.p_task = p_engine->p_task;
+    p_engine->notifyCtx.bits = K_DRDY_BIT;
+    ret = SPP_HAL_GPIO_RegisterISRNotify(p_cfg->drdy_pin, &p_engine->notifyCtx);
+    if (ret != SPP_OK)
+    {
+        /* The task notices within K_WAIT_MS and exits */
+        p_engine->running = 0;
+        return ret;
+    }
+#endif
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Take the oldest sample.
+ *
+ * Must be called from a single consumer task.
+ *
+ * @param[in]  p_engine   Engine instance.
+ * @param[out] p_sample   Receives the sample.
+ * @param[in]  timeout_ms Longest to wait for one, 0 to poll.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if no sample arrived within the timeout.
+ */
+retval_t SPP_HAL_ACQ_Read(spp_acq_engine_t *p_engine, spp_acq_sample_t *p_sample,
+                          spp_uint32_t timeout_ms)
+{
+    if (p_engine == NULL || p_sample == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    retval_t ret = SPP_OSAL_SpscPop(&p_engine->ring, p_sample, timeout_ms);
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+
+    spp_acq_stats_t *p_stats = &p_engine->stats;
+    int64_t latency = esp_timer_get_time() - p_sample->capture_us;
+
+    p_stats->consumed += 1;
+    p_stats->latency_sum += latency;
+    if (latency < p_stats->latency_min)
+    {
+        p_stats->latency_min = latency;
+    }
+    if (latency > p_stats->latency_max)
+    {
+        p_stats->latency_max = latency;
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Copy the engine counters.
+ *
+ * The producer and consumer keep updating them meanwhile, so the copy is a
+ * snapshot rather than a consistent cut.
+ *
+ * @param[in]  p_engine Engine instance.
+ * @param[out] p_stats  Receives the counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL.
+ */
+retval_t SPP_HAL_ACQ_GetStats(const spp_acq_engine_t *p_engine, spp_acq_stats_t *p_stats)
+{
+    if (p_engine == NULL || p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    *p_stats = p_engine->stats;
+    return SPP_OK;
+}
+
+/**
+ * @brief Stop acquiring and wait for the acquisition task to exit.
+ *
+ * The DRDY interrupt is unregistered before the task is told to exit, so
+ * no edge signals a task that is going away or its reused handle. Samples
+ * still in the ring can be read afterwards.
+ *
+ * @param[in] p_engine Engine instance.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_engine is NULL,
+ *         SPP_ERROR if the engine is not running or the task did not exit
+ *         in time.
+ */
+retval_t SPP_HAL_ACQ_Stop(spp_acq_engine_t *p_engine)
+{
+    if (p_engine == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_engine->running == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    SPP_HAL_GPIO_UnregisterISR(p_engine->cfg.drdy_pin);
+    p_engine->running = 0;
+
+    /* A delay pass is a whole tick, not 1 ms, so compare real time */
+    int64_t deadline = esp_timer_get_time() + (int64_t)K_STOP_TIMEOUT_MS * 1000;
+    while (p_engine->taskExited == 0u)
+    {
+        if (esp_timer_get_time() >= deadline)
+        {
+            return SPP_ERROR;
+        }
+        SPP_OSAL_TaskDelay(1);
+    }
+
+    p_engine->p_task = NULL;
+    return SPP_OK;
+}
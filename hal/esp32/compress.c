@@ -0,0 +1,428 @@
+/**
+ * @file compress.c
+ * @brief Streaming compression of multi-channel sensor samples.
+ *
+ * Pushing a sample costs one pass over its channels: difference, zigzag,
+ * varint, written straight into the open block. The LZ stage runs once
+ * per block over the packed bytes with a single-probe hash table (greedy
+ * matching, 64 KiB window covering the whole block), so its cost is one
+ * hash lookup per input byte that does not start a match. A block whose
+ * LZ form is not smaller is stored packed.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <string.h>
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+
+#include "compress.h"
+#include "logformat.h"
+#include "logwriter.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Longest zigzag LEB128 varint of a 64-bit value. */
+#define K_VARINT_MAX 10u
+
+/** @brief Shortest LZ match. */
+#define K_LZ_MIN_MATCH 4u
+
+/** @brief Token nibble value that continues in extension bytes. */
+#define K_LZ_NIBBLE_MAX 15u
+
+/** @brief Multiplicative hash constant (Knuth). */
+#define K_LZ_HASH_MUL 2654435761u
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Append a signed value as a zigzag LEB128 varint.
+ *
+ * @param[out] p_dst Destination, room for K_VARINT_MAX bytes.
+ * @param[in]  value Value to encode.
+ * @return Bytes written.
+ */
+static spp_uint32_t compress_put_varint(spp_uint8_t *p_dst, int64_t value)
+{
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    spp_uint32_t n = 0;
+
+    while (zigzag >= 0x80u)
+    {
+        p_dst[n++] = (spp_uint8_t)(zigzag | 0x80u);
+        zigzag >>= 7;
+    }
+    p_dst[n++] = (spp_uint8_t)zigzag;
+    return n;
+}
+
+/**
+ * @brief Append an LZ length extension: 255 per full step, then the rest.
+ *
+ * @return Bytes written, or 0 if they do not fit before p_end.
+ */
+static spp_uint32_t compress_put_length(spp_uint8_t *p_dst, const spp_uint8_t *p_end,
+                                        spp_uint32_t length)
+{
+    spp_uint32_t n = 0;
+
+    for (;;)
+    {
+        if (p_dst + n >= p_end)
+            return 0;
+        if (length < 255u)
+            break;
+        p_dst[n++] = 255u;
+        length -= 255u;
+    }
+    p_dst[n++] = (spp_uint8_t)length;
+    return n;
+}
+
+/**
+ * @brief Emit one LZ sequence.
+ *
+ * @param[in,out] pp_dst     Write position, advanced on success.
+ * @param[in]     p_end      End of the destination.
+ * @param[in]     p_literals Literal bytes.
+ * @param[in]     literals   Literal count.
+ * @param[in]     offset     Match distance, 0 for the final sequence.
+ * @param[in]     match      Match length (>= K_LZ_MIN_MATCH unless final).
+ * @return 1 on success, 0 if the destination is full.
+ */
+static int compress_put_sequence(spp_uint8_t **pp_dst, const spp_uint8_t *p_end,
+                                 const spp_uint8_t *p_literals, spp_uint32_t literals,
+                                 spp_uint32_t offset, spp_uint32_t match)
+{
+    spp_uint8_t *p_dst = *pp_dst;
+    spp_uint32_t matchCode = (offset != 0u) ? match - K_LZ_MIN_MATCH : 0u;
+    spp_uint8_t litNibble = (spp_uint8_t)((literals < K_LZ_NIBBLE_MAX) ? literals : K_LZ_NIBBLE_MAX);
+    spp_uint8_t matchNibble = (spp_uint8_t)((matchCode < K_LZ_NIBBLE_MAX) ? matchCode : K_LZ_NIBBLE_MAX);
+
+    if (p_dst >= p_end)
+        return 0;
+    *p_dst++ = (spp_uint8_t)((litNibble << 4) | matchNibble);
+
+    if (litNibble == K_LZ_NIBBLE_MAX)
+    {
+        spp_uint32_t n = compress_put_length(p_dst, p_end, literals - K_LZ_NIBBLE_MAX);
+        if (n == 0u)
+            return 0;
+        p_dst += n;
+    }
+
+    if ((spp_uint32_t)(p_end - p_dst) < literals)
+        return 0;
+    memcpy(p_dst, p_literals, literals);
+    p_dst += literals;
+
+    if (offset != 0u)
+    {
+        if (p_end - p_dst < 2)
+            return 0;
+        *p_dst++ = (spp_uint8_t)(offset & 0xFFu);
+        *p_dst++ = (spp_uint8_t)(offset >> 8);
+
+        if (matchNibble == K_LZ_NIBBLE_MAX)
+        {
+            spp_uint32_t n = compress_put_length(p_dst, p_end, matchCode - K_LZ_NIBBLE_MAX);
+            if (n == 0u)
+                return 0;
+            p_dst += n;
+        }
+    }
+
+    *pp_dst = p_dst;
+    return 1;
+}
+
+/**
+ * @brief Start a new block at the given time.
+ *
+ * @param[in] p_stream Stream instance.
+ * @param[in] time_us  Time of the block's first sample.
+ */
+static void compress_open_block(spp_compress_t *p_stream, int64_t time_us)
+{
+    p_stream->samples = 0;
+    p_stream->packedBytes = 0;
+    p_stream->baseTime = time_us;
+    p_stream->prevTime = time_us;
+    p_stream->prevTimeDelta = 0;
+    memset(p_stream->prev, 0, sizeof(p_stream->prev));
+    memset(p_stream->prevDelta, 0, sizeof(p_stream->prevDelta));
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Set up a stream.
+ *
+ * @param[in] p_stream Stream instance.
+ * @param[in] p_cfg    Stream setup; copied into the stream.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer or the
+ *         sink is NULL, SPP_ERROR if the channel count is out of range.
+ */
+retval_t SPP_HAL_Compress_Init(spp_compress_t *p_stream, const spp_compress_config_t *p_cfg)
+{
+    if (p_stream == NULL || p_cfg == NULL || p_cfg->p_sink == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_cfg->channels == 0u || p_cfg->channels > SPP_LOGFMT_BLOCK_MAX_CHANNELS)
+    {
+        return SPP_ERROR;
+    }
+
+    p_stream->cfg = *p_cfg;
+    if (p_stream->cfg.raw_sample_bytes == 0u)
+    {
+        p_stream->cfg.raw_sample_bytes = 8u + 4u * p_cfg->channels;
+    }
+    memset(&p_stream->stats, 0, sizeof(p_stream->stats));
+    compress_open_block(p_stream, 0);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Add one sample to the open block.
+ *
+ * Closes the block first if the sample might not fit, and afterwards if it
+ * reached max_samples.
+ *
+ * @param[in] p_stream Stream instance.
+ * @param[in] time_us  Sample time.
+ * @param[in] p_values One value per channel.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if closing a block failed (its samples are counted as
+ *         dropped; this sample is kept).
+ */
+retval_t SPP_HAL_Compress_Push(spp_compress_t *p_stream, int64_t time_us, const int32_t *p_values)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_stream == NULL || p_values == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spp_uint32_t channels = p_stream->cfg.channels;
+    if (p_stream->packedBytes + K_VARINT_MAX * (channels + 1u) > SPP_LOGFMT_BLOCK_MAX_PACKED)
+    {
+        ret = SPP_HAL_Compress_Flush(p_stream);
+    }
+    if (p_stream->samples == 0u)
+    {
+        compress_open_block(p_stream, time_us);
+    }
+
+    spp_uint8_t *p_dst = &p_stream->packed[p_stream->packedBytes];
+    spp_uint32_t n = 0;
+
+    int64_t timeDelta = time_us - p_stream->prevTime;
+    n += compress_put_varint(&p_dst[n], timeDelta - p_stream->prevTimeDelta);
+    p_stream->prevTime = time_us;
+    p_stream->prevTimeDelta = timeDelta;
+
+    for (spp_uint32_t ch = 0; ch < channels; ch++)
+    {
+        int64_t delta = (int64_t)p_values[ch] - p_stream->prev[ch];
+        int64_t coded = delta;
+        if ((p_stream->cfg.order2_mask & (1u << ch)) != 0u)
+        {
+            coded = delta - p_stream->prevDelta[ch];
+            p_stream->prevDelta[ch] = delta;
+        }
+        p_stream->prev[ch] = p_values[ch];
+        n += compress_put_varint(&p_dst[n], coded);
+    }
+
+    p_stream->packedBytes += n;
+    p_stream->samples += 1;
+    p_stream->stats.samples += 1;
+    p_stream->stats.raw_bytes += p_stream->cfg.raw_sample_bytes;
+
+    if (p_stream->cfg.max_samples != 0u && p_stream->samples >= p_stream->cfg.max_samples)
+    {
+        retval_t flushed = SPP_HAL_Compress_Flush(p_stream);
+        if (ret == SPP_OK)
+        {
+            ret = flushed;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Close the open block and hand it to the sink.
+ *
+ * @param[in] p_stream Stream instance.
+ * @return SPP_OK on success or if the block is empty,
+ *         SPP_ERROR_NULL_POINTER if p_stream is NULL, SPP_ERROR if the sink
+ *         refused the block (its samples are counted as dropped).
+ */
+retval_t SPP_HAL_Compress_Flush(spp_compress_t *p_stream)
+{
+    if (p_stream == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_stream->samples == 0u)
+    {
+        return SPP_OK;
+    }
+
+    spp_logfmt_block_t header = {
+        .flags = 0,
+        .channels = p_stream->cfg.channels,
+        .samples = (uint16_t)p_stream->samples,
+        .packed_bytes = (uint16_t)p_stream->packedBytes,
+        .order2_mask = p_stream->cfg.order2_mask,
+        .base_time_us = p_stream->baseTime,
+    };
+    spp_uint8_t *p_body = &p_stream->block[sizeof(header)];
+    spp_uint32_t bodyBytes = 0;
+
+    if (p_stream->cfg.use_lz != 0u)
+    {
+        /* Only worth keeping if strictly smaller than the packed body */
+        bodyBytes = SPP_HAL_Compress_Lz(p_stream->packed, p_stream->packedBytes, p_body,
+                                        p_stream->packedBytes - 1u, p_stream->lzTable);
+    }
+    if (bodyBytes != 0u)
+    {
+        header.flags |= SPP_LOGFMT_BLOCK_LZ;
+        p_stream->stats.blocks_lz += 1;
+    }
+    else
+    {
+        memcpy(p_body, p_stream->packed, p_stream->packedBytes);
+        bodyBytes = p_stream->packedBytes;
+    }
+    memcpy(p_stream->block, &header, sizeof(header));
+
+    spp_uint32_t total = (spp_uint32_t)sizeof(header) + bodyBytes;
+    retval_t ret = p_stream->cfg.p_sink(p_stream->cfg.p_sink_ctx, p_stream->cfg.frame_type,
+                                        p_stream->baseTime, p_stream->block, total);
+
+    p_stream->stats.packed_bytes += p_stream->packedBytes;
+    if (ret == SPP_OK)
+    {
+        p_stream->stats.blocks += 1;
+        p_stream->stats.out_bytes += total;
+    }
+    else
+    {
+        p_stream->stats.dropped_samples += p_stream->samples;
+        ret = SPP_ERROR;
+    }
+
+    p_stream->samples = 0;
+    p_stream->packedBytes = 0;
+    return ret;
+}
+
+/**
+ * @brief Copy the stream counters.
+ *
+ * @param[in]  p_stream Stream instance.
+ * @param[out] p_stats  Receives the counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL.
+ */
+retval_t SPP_HAL_Compress_GetStats(const spp_compress_t *p_stream, spp_compress_stats_t *p_stats)
+{
+    if (p_stream == NULL || p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    *p_stats = p_stream->stats;
+    return SPP_OK;
+}
+
+/**
+ * @brief LZ-compress a buffer of up to 64 KiB in the block body format.
+ *
+ * @param[in]  p_src    Input.
+ * @param[in]  length   Input length, at most 65535.
+ * @param[out] p_dst    Output.
+ * @param[in]  capacity Output capacity.
+ * @param[in]  p_table  SPP_COMPRESS_LZ_TABLE entries of scratch.
+ * @return Compressed length, or 0 if it does not fit in capacity.
+ */
+spp_uint32_t SPP_HAL_Compress_Lz(const spp_uint8_t *p_src, spp_uint32_t length, spp_uint8_t *p_dst,
+                                 spp_uint32_t capacity, spp_uint16_t *p_table)
+{
+    const spp_uint8_t *p_end = p_dst + capacity;
+    spp_uint8_t *p_out = p_dst;
+    spp_uint32_t anchor = 0;
+    spp_uint32_t pos = 0;
+
+    if (length > UINT16_MAX)
+        return 0;
+
+    /* Entries hold position + 1 so that 0 means empty */
+    memset(p_table, 0, SPP_COMPRESS_LZ_TABLE * sizeof(p_table[0]));
+
+    while (pos + K_LZ_MIN_MATCH <= length)
+    {
+        uint32_t word;
+        memcpy(&word, &p_src[pos], sizeof(word));
+        uint32_t hash = (word * K_LZ_HASH_MUL) >> (32u - __builtin_ctz(SPP_COMPRESS_LZ_TABLE));
+        spp_uint32_t candidate = p_table[hash];
+        p_table[hash] = (spp_uint16_t)(pos + 1u);
+
+        uint32_t candidateWord = 0;
+        if (candidate != 0u)
+        {
+            memcpy(&candidateWord, &p_src[candidate - 1u], sizeof(candidateWord));
+        }
+        if (candidate == 0u || candidateWord != word)
+        {
+            pos += 1;
+            continue;
+        }
+
+        spp_uint32_t from = candidate - 1u;
+        spp_uint32_t match = K_LZ_MIN_MATCH;
+        while (pos + match < length && p_src[from + match] == p_src[pos + match])
+        {
+            match += 1;
+        }
+
+        if (compress_put_sequence(&p_out, p_end, &p_src[anchor], pos - anchor, pos - from, match) == 0)
+            return 0;
+        pos += match;
+        anchor = pos;
+    }
+
+    if (compress_put_sequence(&p_out, p_end, &p_src[anchor], length - anchor, 0, 0) == 0)
+        return 0;
+
+    return (spp_uint32_t)(p_out - p_dst);
+}
+
+/**
+ * @brief Sink that writes blocks as frames of a spp_logwriter_t.
+ *
+ * Set p_sink_ctx to the writer.
+ *
+ * @return Result of SPP_HAL_LogWriter_Write().
+ */
+retval_t SPP_HAL_Compress_LogWriterSink(void *p_ctx, spp_uint8_t type, int64_t time_us,
+                                        const void *p_data, spp_uint32_t length)
+{
+    return SPP_HAL_LogWriter_Write((spp_logwriter_t *)p_ctx, type, time_us, p_data, length);
+}
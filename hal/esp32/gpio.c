@@ -3,7 +3,19 @@
  * @brief ESP32 GPIO HAL implementation for the SPP framework.
  *
  * Provides GPIO interrupt configuration and ISR registration, bridging
- * ESP-IDF gpio driver calls to the SPP OSAL event group mechanism.
+ * ESP-IDF gpio driver calls to the SPP OSAL event group mechanism, or to a
+ * direct task notification when a single task services the pin. The ISR
+ * also timestamps every edge so consumers can tell when the event happened
+ * rather than when their task got to run, and can log each edge of
+ * selected pins into a ring drained by SPP_HAL_GPIO_DrainEdges().
+ *
+ * The ESP-IDF GPIO ISR service dispatches every pin from one interrupt on
+ * one core, indexing its handler table by pin; each entry hands this HAL's
+ * ISR the pin's slot in s_pinSlots, so the ISR is the single producer of
+ * the edge ring and of the per-pin statistics. The service is installed
+ * with SPP_GPIO_INTR_ALLOC_FLAGS (IRAM by default) and everything the ISR
+ * runs is IRAM_ATTR, so interrupts are not held off while the flash cache
+ * is disabled.
  */
 
 /* ============================================================================
@@ -15,10 +27,67 @@
 #include "spp/core/types.h"
 
 #include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/portmacro.h"
 
 #include "spp/osal/eventgroups.h"
+#include "spsc.h"
+#include "task_ext.h"
+#include "trace.h"
+#include "gpio_esp32.h"
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/** @brief How the ISR signals a pin's edge. */
+typedef enum
+{
+    K_ISR_EVENT_GROUP = 0, /**< p_ctx is a spp_gpio_isr_ctx_t. */
+    K_ISR_NOTIFY = 1       /**< p_ctx is a spp_gpio_notify_ctx_t. */
+} GpioIsrMode_t;
+
+/**
+ * @brief Per-pin ISR state, passed to the driver as the handler argument.
+ *
+ * lastEdgeUs and edgeCount are published under a seqlock: the ISR makes
+ * edgeSeq odd, stores both, then makes it even again. A reader that sees
+ * the same even value before and after copying them has a consistent pair.
+ */
+typedef struct
+{
+    void *p_ctx;
+    spp_uint8_t mode;
+    volatile spp_uint8_t capture;
+    volatile int64_t lastEdgeUs;
+    volatile spp_uint32_t edgeCount;
+    volatile spp_uint32_t edgeSeq; /**< Odd while the ISR updates the pair above. */
+    volatile spp_uint32_t maxHandlerCycles;
+} GpioPinSlot_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static GpioPinSlot_t s_pinSlots[GPIO_NUM_MAX];
+
+/** @brief Flags for gpio_install_isr_service(). */
+static int s_intrAllocFlags = SPP_GPIO_INTR_ALLOC_FLAGS;
+
+/** @brief Set once the ISR service is installed; flags are fixed from then on. */
+static spp_uint8_t s_isrServiceInstalled = 0;
+
+/** @brief Edges of capturing pins, pushed by the ISR. */
+static spp_spsc_t s_edgeRing;
+static spp_gpio_edge_t s_edgeStorage[SPP_GPIO_EDGE_RING_DEPTH];
+static spp_uint8_t s_edgeRingReady = 0;
+
+/** @brief Edges lost because the ring was full. */
+static volatile spp_uint32_t s_edgeOverflows = 0;
 
 /* ============================================================================
  * Private Functions
@@ -27,17 +96,65 @@
 /**
  * @brief Internal GPIO ISR handler.
  *
- * Sets the configured event group bits from ISR context and yields to a
- * higher-priority task if one was unblocked.
+ * Timestamps the edge, logs it to the edge ring if the pin captures,
+ * sets the configured event group bits or notifies the registered task
+ * from ISR context, and yields to a higher-priority task if one was
+ * unblocked.
  *
- * @param[in] p_arg Pointer to the spp_gpio_isr_ctx_t context structure.
+ * @param[in] p_arg Pointer to the pin's GpioPinSlot_t.
  */
-static void gpio_internal_isr(void *p_arg)
+static void IRAM_ATTR gpio_internal_isr(void *p_arg)
 {
-    spp_gpio_isr_ctx_t *p_ctx = (spp_gpio_isr_ctx_t *)p_arg;
+    GpioPinSlot_t *p_slot = (GpioPinSlot_t *)p_arg;
+    esp_cpu_cycle_count_t startCycles = esp_cpu_get_cycle_count();
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_GPIO_ISR, p_slot - s_pinSlots, p_slot->edgeCount + 1u);
+
+    int64_t nowUs = esp_timer_get_time();
+    spp_uint32_t count = p_slot->edgeCount + 1u;
+    spp_uint32_t seq = p_slot->edgeSeq;
+
+    /* Seqlock write: odd sequence, fence, data, then even with release */
+    __atomic_store_n(&p_slot->edgeSeq, seq + 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    p_slot->lastEdgeUs = nowUs;
+    __atomic_store_n(&p_slot->edgeCount, count, __ATOMIC_RELAXED);
+    __atomic_store_n(&p_slot->edgeSeq, seq + 2u, __ATOMIC_RELEASE);
 
     spp_uint8_t hpw = 0;
-    OSAL_EventGroupSetBitsFromISR(p_ctx->p_event_group, p_ctx->bits, NULL, &hpw);
+    if (p_slot->capture != 0u)
+    {
+        spp_gpio_edge_t edge;
+        spp_uint8_t ringHpw = 0;
+
+        edge.time_us = nowUs;
+        edge.pin = (spp_uint32_t)(p_slot - s_pinSlots);
+        edge.seq = count;
+        if (SPP_OSAL_SpscPushFromISR(&s_edgeRing, &edge, &ringHpw) != SPP_OK)
+        {
+            s_edgeOverflows += 1;
+        }
+        hpw |= ringHpw;
+    }
+
+    spp_uint8_t signalHpw = 0;
+    if (p_slot->mode == K_ISR_NOTIFY)
+    {
+        spp_gpio_notify_ctx_t *p_ctx = (spp_gpio_notify_ctx_t *)p_slot->p_ctx;
+        SPP_OSAL_TaskNotifyFromISR(p_ctx->p_task, p_ctx->bits, &signalHpw);
+    }
+    else
+    {
+        spp_gpio_isr_ctx_t *p_ctx = (spp_gpio_isr_ctx_t *)p_slot->p_ctx;
+        OSAL_EventGroupSetBitsFromISR(p_ctx->p_event_group, p_ctx->bits, NULL, &signalHpw);
+    }
+    hpw |= signalHpw;
+
+    spp_uint32_t cycles = (spp_uint32_t)(esp_cpu_get_cycle_count() - startCycles);
+    if (cycles > p_slot->maxHandlerCycles)
+    {
+        p_slot->maxHandlerCycles = cycles;
+    }
+    SPP_TRACE_END(SPP_TRACE_EV_GPIO_ISR, p_slot - s_pinSlots, hpw);
 
     if (hpw != 0)
     {
@@ -45,6 +162,55 @@ static void gpio_internal_isr(void *p_arg)
     }
 }
 
+/**
+ * @brief Attach the internal ISR to a pin in the given mode.
+ *
+ * Installs the ESP-IDF GPIO ISR service on the first call. A service
+ * already installed by another component is used as is.
+ *
+ * @param[in] pin   GPIO pin number.
+ * @param[in] mode  GpioIsrMode_t value.
+ * @param[in] p_ctx Context matching the mode; must outlive the registration.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_ctx is NULL,
+ *         SPP_ERROR if the pin does not exist, no interrupt matching the
+ *         allocation flags is free or the handler could not be added (the
+ *         pin is then left without a handler).
+ */
+static retval_t gpio_register_slot(spp_uint32_t pin, GpioIsrMode_t mode, void *p_ctx)
+{
+    if (p_ctx == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (pin >= (spp_uint32_t)GPIO_NUM_MAX)
+    {
+        return SPP_ERROR;
+    }
+
+    if (s_isrServiceInstalled == 0)
+    {
+        esp_err_t err = gpio_install_isr_service(s_intrAllocFlags);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+        {
+            return SPP_ERROR;
+        }
+        s_isrServiceInstalled = 1;
+    }
+
+    /* Detach first so the ISR never sees a context of the wrong mode */
+    gpio_isr_handler_remove((gpio_num_t)pin);
+    s_pinSlots[pin].p_ctx = p_ctx;
+    s_pinSlots[pin].mode = (spp_uint8_t)mode;
+    s_pinSlots[pin].maxHandlerCycles = 0;
+    if (gpio_isr_handler_add((gpio_num_t)pin, gpio_internal_isr, &s_pinSlots[pin]) != ESP_OK)
+    {
+        s_pinSlots[pin].p_ctx = NULL;
+        s_pinSlots[pin].mode = (spp_uint8_t)K_ISR_EVENT_GROUP;
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+
 /* ============================================================================
  * Public Functions
  * ========================================================================= */
@@ -84,27 +250,285 @@ retval_t SPP_HAL_GPIO_ConfigInterrupt(spp_uint32_t pin, spp_uint32_t intr_type,
     return SPP_OK;
 }
 
+/**
+ * @brief Choose the interrupt allocation flags of the GPIO ISR service.
+ *
+ * Must be called before the first ISR registration. Flags without
+ * ESP_INTR_FLAG_IRAM let the interrupt be deferred while the flash cache
+ * is disabled; a priority level (ESP_INTR_FLAG_LEVELn) up to 3 may be
+ * added, since the handler path is written in C.
+ *
+ * @param[in] intr_alloc_flags ESP_INTR_FLAG_* mask.
+ * @return SPP_OK on success, SPP_ERROR if the ISR service is already
+ *         installed.
+ */
+retval_t SPP_HAL_GPIO_SetIntrAllocFlags(int intr_alloc_flags)
+{
+    if (s_isrServiceInstalled != 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    s_intrAllocFlags = intr_alloc_flags;
+    return SPP_OK;
+}
+
 /**
  * @brief Register an ISR handler for a GPIO pin.
  *
  * Installs the ESP-IDF GPIO ISR service on the first call, then adds the
- * internal ISR handler for the specified pin. The ISR context is passed
- * through to the handler and should point to a spp_gpio_isr_ctx_t.
+ * internal ISR handler for the specified pin. The ISR context should
+ * point to a spp_gpio_isr_ctx_t in internal RAM and must outlive the
+ * registration.
  *
  * @param[in] pin         GPIO pin number.
  * @param[in] p_isrContext Pointer to the spp_gpio_isr_ctx_t for this pin.
- * @return SPP_OK on success.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_isrContext is NULL,
+ *         SPP_ERROR if the pin does not exist, the ISR service could not
+ *         be installed or the handler could not be added.
  */
 retval_t SPP_HAL_GPIO_RegisterISR(spp_uint32_t pin, void *p_isrContext)
 {
-    static spp_uint8_t s_isrServiceInstalled = 0;
+    return gpio_register_slot(pin, K_ISR_EVENT_GROUP, p_isrContext);
+}
 
-    if (s_isrServiceInstalled == 0)
+/**
+ * @brief Register an ISR that wakes one task directly.
+ *
+ * Each edge OR-s the context's bits into the task's notification value,
+ * to be collected with SPP_OSAL_TaskNotifyWait(). Unlike the event group
+ * path, this makes the task ready straight from the ISR rather than
+ * through the FreeRTOS timer daemon, saving a context switch per edge.
+ * Replaces any earlier registration on the pin.
+ *
+ * @param[in] pin   GPIO pin number.
+ * @param[in] p_ctx Task and bits to signal; must outlive the registration.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_ctx or its task
+ *         is NULL, SPP_ERROR if the pin does not exist, task
+ *         notifications are unavailable in this build or the handler could
+ *         not be added.
+ */
+retval_t SPP_HAL_GPIO_RegisterISRNotify(spp_uint32_t pin, spp_gpio_notify_ctx_t *p_ctx)
+{
+    if (p_ctx == NULL || p_ctx->p_task == NULL)
     {
-        gpio_install_isr_service(0);
-        s_isrServiceInstalled = 1;
+        return SPP_ERROR_NULL_POINTER;
+    }
+#if SPP_OSAL_TASK_NOTIFY == 0
+    (void)pin;
+    return SPP_ERROR;
+#else
+    return gpio_register_slot(pin, K_ISR_NOTIFY, p_ctx);
+#endif
+}
+
+/**
+ * @brief Detach the ISR from a pin and clear its slot.
+ *
+ * Undoes SPP_HAL_GPIO_RegisterISR() or SPP_HAL_GPIO_RegisterISRNotify()
+ * and turns edge capture off, so the context passed there is no longer
+ * used once this returns, except by an invocation already running on the
+ * other core. The edge count keeps its value, so SPP_HAL_GPIO_GetLastEdge()
+ * still reports the last edge. Harmless on a pin with no ISR.
+ *
+ * @param[in] pin GPIO pin number.
+ * @return SPP_OK on success, SPP_ERROR if the pin does not exist.
+ */
+retval_t SPP_HAL_GPIO_UnregisterISR(spp_uint32_t pin)
+{
+    if (pin >= (spp_uint32_t)GPIO_NUM_MAX)
+    {
+        return SPP_ERROR;
+    }
+
+    if (s_isrServiceInstalled != 0u)
+    {
+        gpio_isr_handler_remove((gpio_num_t)pin);
+    }
+    s_pinSlots[pin].capture = 0;
+    s_pinSlots[pin].p_ctx = NULL;
+    s_pinSlots[pin].mode = (spp_uint8_t)K_ISR_EVENT_GROUP;
+    return SPP_OK;
+}
+
+/**
+ * @brief Get the time and running count of the most recent edge on a pin.
+ *
+ * Safe to call from a task while the ISR keeps firing. The count wraps and
+ * is meant to be compared by difference: a jump of more than one between
+ * two calls means edges arrived that the caller never serviced.
+ *
+ * @param[in]  pin       GPIO pin number.
+ * @param[out] p_time_us Receives the esp_timer time of the last edge, in us.
+ * @param[out] p_count   Receives the number of edges since registration
+ *                       (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_time_us is NULL,
+ *         SPP_ERROR if the pin does not exist.
+ */
+retval_t SPP_HAL_GPIO_GetLastEdge(spp_uint32_t pin, int64_t *p_time_us, spp_uint32_t *p_count)
+{
+    if (p_time_us == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (pin >= (spp_uint32_t)GPIO_NUM_MAX)
+    {
+        return SPP_ERROR;
+    }
+
+    GpioPinSlot_t *p_slot = &s_pinSlots[pin];
+    spp_uint32_t before;
+    spp_uint32_t after;
+    spp_uint32_t count;
+    int64_t timeUs;
+
+    /* Seqlock read; retries only while the ISR runs on the other core */
+    do
+    {
+        before = __atomic_load_n(&p_slot->edgeSeq, __ATOMIC_ACQUIRE);
+        timeUs = p_slot->lastEdgeUs;
+        count = __atomic_load_n(&p_slot->edgeCount, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&p_slot->edgeSeq, __ATOMIC_RELAXED);
+    } while ((before & 1u) != 0u || before != after);
+
+    *p_time_us = timeUs;
+    if (p_count != NULL)
+    {
+        *p_count = count;
+    }
+    return SPP_OK;
+}
+
+/**
+ * @brief Turn logging of a pin's edges into the edge ring on or off.
+ *
+ * The pin still needs an ISR registered with SPP_HAL_GPIO_RegisterISR()
+ * or SPP_HAL_GPIO_RegisterISRNotify(). Configure from task context, not
+ * concurrently with SPP_HAL_GPIO_DrainEdges().
+ *
+ * @param[in] pin    GPIO pin number.
+ * @param[in] enable Non-zero to log every edge of the pin.
+ * @return SPP_OK on success, SPP_ERROR if the pin does not exist or the
+ *         ring could not be set up.
+ */
+retval_t SPP_HAL_GPIO_SetEdgeCapture(spp_uint32_t pin, spp_uint8_t enable)
+{
+    if (pin >= (spp_uint32_t)GPIO_NUM_MAX)
+    {
+        return SPP_ERROR;
+    }
+
+    if (s_edgeRingReady == 0u)
+    {
+        if (SPP_OSAL_SpscInit(&s_edgeRing, (uint8_t *)s_edgeStorage, SPP_GPIO_EDGE_RING_DEPTH,
+                              sizeof(spp_gpio_edge_t)) != SPP_OK)
+        {
+            return SPP_ERROR;
+        }
+        s_edgeRingReady = 1;
+    }
+
+    s_pinSlots[pin].capture = (enable != 0u) ? 1u : 0u;
+    return SPP_OK;
+}
+
+/**
+ * @brief Take captured edges, oldest first.
+ *
+ * Waits up to timeout_ms for the first edge, then takes whatever else is
+ * already queued, up to max_edges. Must be called from a single task.
+ *
+ * @param[out] p_edges    Receives the edges.
+ * @param[in]  max_edges  Capacity of p_edges.
+ * @param[in]  timeout_ms Longest to wait for the first edge, 0 to poll.
+ * @param[out] p_count    Receives the number of edges written.
+ * @return SPP_OK if at least one edge was taken, SPP_ERROR_NULL_POINTER if
+ *         a pointer is NULL, SPP_NOT_ENOUGH_PACKETS if none arrived, SPP_ERROR
+ *         if capture was never enabled.
+ */
+retval_t SPP_HAL_GPIO_DrainEdges(spp_gpio_edge_t *p_edges, spp_uint32_t max_edges,
+                                 spp_uint32_t timeout_ms, spp_uint32_t *p_count)
+{
+    if (p_edges == NULL || p_count == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    *p_count = 0;
+    if (s_edgeRingReady == 0u)
+    {
+        return SPP_ERROR;
+    }
+    if (max_edges == 0u)
+    {
+        return SPP_NOT_ENOUGH_PACKETS;
+    }
+
+    retval_t ret = SPP_OSAL_SpscPop(&s_edgeRing, &p_edges[0], timeout_ms);
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+
+    spp_uint32_t count = 1;
+    while (count < max_edges && SPP_OSAL_SpscPop(&s_edgeRing, &p_edges[count], 0) == SPP_OK)
+    {
+        count++;
+    }
+
+    *p_count = count;
+    return SPP_OK;
+}
+
+/**
+ * @brief Number of captured edges lost because the ring was full.
+ *
+ * @return Overflow count since boot.
+ */
+spp_uint32_t SPP_HAL_GPIO_GetEdgeOverflows(void)
+{
+    return s_edgeOverflows;
+}
+
+/**
+ * @brief Get the interrupt statistics of a pin.
+ *
+ * @param[in]  pin     GPIO pin number.
+ * @param[out] p_stats Receives the statistics.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_stats is NULL,
+ *         SPP_ERROR if the pin does not exist.
+ */
+retval_t SPP_HAL_GPIO_GetPinStats(spp_uint32_t pin, spp_gpio_pin_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (pin >= (spp_uint32_t)GPIO_NUM_MAX)
+    {
+        return SPP_ERROR;
+    }
+
+    p_stats->interrupts = __atomic_load_n(&s_pinSlots[pin].edgeCount, __ATOMIC_ACQUIRE);
+    p_stats->max_handler_cycles = s_pinSlots[pin].maxHandlerCycles;
+    return SPP_OK;
+}
+
+/**
+ * @brief Restart the worst handler duration measurement of a pin.
+ *
+ * The interrupt count keeps running, since it also sequences edges.
+ *
+ * @param[in] pin GPIO pin number.
+ * @return SPP_OK on success, SPP_ERROR if the pin does not exist.
+ */
+retval_t SPP_HAL_GPIO_ResetPinStats(spp_uint32_t pin)
+{
+    if (pin >= (spp_uint32_t)GPIO_NUM_MAX)
+    {
+        return SPP_ERROR;
     }
 
-    gpio_isr_handler_add((gpio_num_t)pin, gpio_internal_isr, p_isrContext);
+    s_pinSlots[pin].maxHandlerCycles = 0;
     return SPP_OK;
 }
@@ -0,0 +1,482 @@
+/**
+ * @file bmp390_sim.c
+ * @brief Register-level BMP390 simulator for the host SPI stand-in.
+ *
+ * A read transaction is the address byte with bit 7 set, one dummy byte
+ * and then consecutive registers; a write transaction is address/data
+ * pairs. Measurements due since the previous transaction complete at its
+ * start. Raw ADC values are found by bisection on the datasheet's
+ * floating-point compensation, which is monotonic in both raw values.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <string.h>
+#include "bmp390_sim.h"
+#include "esp_timer.h"
+#include "spi_host.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_READ_FLAG 0x80u
+#define K_ADDR_MASK 0x7Fu
+
+/** @brief Registers. */
+#define K_CHIP_ID 0x00u
+#define K_REV_ID 0x01u
+#define K_ERR_REG 0x02u
+#define K_STATUS 0x03u
+#define K_DATA_0 0x04u
+#define K_DATA_3 0x07u
+#define K_DATA_5 0x09u
+#define K_SENSORTIME_0 0x0Cu
+#define K_EVENT 0x10u
+#define K_INT_STATUS 0x11u
+#define K_FIFO_WTM_0 0x15u
+#define K_FIFO_CONFIG_1 0x17u
+#define K_FIFO_CONFIG_2 0x18u
+#define K_INT_CTRL 0x19u
+#define K_PWR_CTRL 0x1Bu
+#define K_OSR 0x1Cu
+#define K_ODR 0x1Du
+#define K_CONFIG 0x1Fu
+#define K_CMD 0x7Eu
+
+/** @brief Register bits and values. */
+#define K_ERR_CMD 0x02u
+#define K_ERR_CONF 0x04u
+#define K_STATUS_CMD_RDY 0x10u
+#define K_STATUS_DRDY_PRESS 0x20u
+#define K_STATUS_DRDY_TEMP 0x40u
+#define K_EVENT_POR 0x01u
+#define K_INT_DRDY 0x08u
+#define K_PWR_PRESS_EN 0x01u
+#define K_PWR_TEMP_EN 0x02u
+#define K_PWR_MODE_MASK 0x30u
+#define K_PWR_MODE_NORMAL 0x30u
+#define K_CMD_SOFTRESET 0xB6u
+#define K_CMD_FIFO_FLUSH 0xB0u
+#define K_CMD_EXTMODE_EN 0x34u
+
+/** @brief Largest ODR selection and the period of selection 0, in us. */
+#define K_ODR_SEL_MAX 17u
+#define K_ODR_BASE_US 5000.0
+
+/** @brief SENSORTIME tick, in us. */
+#define K_SENSORTIME_US 39.0625
+
+/** @brief Raw ADC value of a skipped measurement, and the largest raw value. */
+#define K_RAW_SKIPPED 0x800000u
+#define K_RAW_MAX 0xFFFFFFu
+
+/** @brief Measurements completed at most per transaction. */
+#define K_MAX_CATCHUP 64u
+
+/**
+ * @brief Calibration coefficients NVM_PAR_T1 .. NVM_PAR_P11, little-endian.
+ *
+ * T1 27480, T2 19200, T3 -7, P1 29700, P2 4500, P3 35, P4 -4, P5 2063,
+ * P6 100, P7 -7, P8 -5, P9 15110, P10 14, P11 -60: a plausible part whose
+ * raw values stay well inside 24 bits from 30 to 125 kPa and -40 to 85 °C.
+ */
+static const uint8_t K_NVM[BMP390_SIM_NVM_PAR_BYTES] = {
+    0x58, 0x6B, 0x00, 0x4B, 0xF9, 0x04, 0x74, 0x94, 0x11, 0x23, 0xFC,
+    0x0F, 0x08, 0x64, 0x00, 0xF9, 0xFB, 0x06, 0x3B, 0x0E, 0xC4,
+};
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Calibration coefficients scaled as in the datasheet.
+ */
+typedef struct
+{
+    double t1, t2, t3;
+    double p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11;
+} Bmp390Calib_t;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static void bmp_calib(const uint8_t *p_nvm, Bmp390Calib_t *p_cal)
+{
+    uint16_t t1 = (uint16_t)(p_nvm[0] | (p_nvm[1] << 8));
+    uint16_t t2 = (uint16_t)(p_nvm[2] | (p_nvm[3] << 8));
+    int8_t t3 = (int8_t)p_nvm[4];
+    int16_t p1 = (int16_t)(p_nvm[5] | (p_nvm[6] << 8));
+    int16_t p2 = (int16_t)(p_nvm[7] | (p_nvm[8] << 8));
+    int8_t p3 = (int8_t)p_nvm[9];
+    int8_t p4 = (int8_t)p_nvm[10];
+    uint16_t p5 = (uint16_t)(p_nvm[11] | (p_nvm[12] << 8));
+    uint16_t p6 = (uint16_t)(p_nvm[13] | (p_nvm[14] << 8));
+    int8_t p7 = (int8_t)p_nvm[15];
+    int8_t p8 = (int8_t)p_nvm[16];
+    int16_t p9 = (int16_t)(p_nvm[17] | (p_nvm[18] << 8));
+    int8_t p10 = (int8_t)p_nvm[19];
+    int8_t p11 = (int8_t)p_nvm[20];
+
+    p_cal->t1 = (double)t1 * 256.0;
+    p_cal->t2 = (double)t2 / 1073741824.0;
+    p_cal->t3 = (double)t3 / 281474976710656.0;
+    p_cal->p1 = ((double)p1 - 16384.0) / 1048576.0;
+    p_cal->p2 = ((double)p2 - 16384.0) / 536870912.0;
+    p_cal->p3 = (double)p3 / 4294967296.0;
+    p_cal->p4 = (double)p4 / 137438953472.0;
+    p_cal->p5 = (double)p5 * 8.0;
+    p_cal->p6 = (double)p6 / 64.0;
+    p_cal->p7 = (double)p7 / 256.0;
+    p_cal->p8 = (double)p8 / 32768.0;
+    p_cal->p9 = (double)p9 / 281474976710656.0;
+    p_cal->p10 = (double)p10 / 281474976710656.0;
+    p_cal->p11 = (double)p11 / 36893488147419103232.0;
+}
+
+static double bmp_comp_temp(const Bmp390Calib_t *p_cal, double raw_temp)
+{
+    double d1 = raw_temp - p_cal->t1;
+    return d1 * p_cal->t2 + d1 * d1 * p_cal->t3;
+}
+
+static double bmp_comp_press(const Bmp390Calib_t *p_cal, double raw_press, double t_lin)
+{
+    double t2 = t_lin * t_lin;
+    double t3 = t2 * t_lin;
+    double out1 = p_cal->p5 + p_cal->p6 * t_lin + p_cal->p7 * t2 + p_cal->p8 * t3;
+    double out2 = raw_press * (p_cal->p1 + p_cal->p2 * t_lin + p_cal->p3 * t2 + p_cal->p4 * t3);
+    double r2 = raw_press * raw_press;
+    double out3 = r2 * (p_cal->p9 + p_cal->p10 * t_lin) + r2 * raw_press * p_cal->p11;
+    return out1 + out2 + out3;
+}
+
+/**
+ * @brief Smallest raw value whose compensated output reaches target.
+ */
+static uint32_t bmp_invert(const Bmp390Calib_t *p_cal, double target, double t_lin, int pressure)
+{
+    uint32_t lo = 0;
+    uint32_t hi = K_RAW_MAX;
+
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2u;
+        double value = pressure ? bmp_comp_press(p_cal, (double)mid, t_lin)
+                                : bmp_comp_temp(p_cal, (double)mid);
+        if (value < target)
+            lo = mid + 1u;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static void bmp_put24(uint8_t *p_out, uint32_t value)
+{
+    p_out[0] = (uint8_t)value;
+    p_out[1] = (uint8_t)(value >> 8);
+    p_out[2] = (uint8_t)(value >> 16);
+}
+
+/**
+ * @brief Power-on / soft reset state: sleep mode, defaults, POR event.
+ */
+static void bmp_reset(bmp390_sim_t *p_sim)
+{
+    memset(p_sim->regs, 0, sizeof(p_sim->regs));
+    p_sim->regs[K_CHIP_ID] = BMP390_SIM_CHIP_ID;
+    p_sim->regs[K_REV_ID] = 0x01u;
+    p_sim->regs[K_STATUS] = K_STATUS_CMD_RDY;
+    p_sim->regs[K_EVENT] = K_EVENT_POR;
+    p_sim->regs[K_FIFO_WTM_0] = 0x01u;
+    p_sim->regs[K_FIFO_CONFIG_1] = 0x02u;
+    p_sim->regs[K_FIFO_CONFIG_2] = 0x02u;
+    p_sim->regs[K_INT_CTRL] = 0x02u;
+    p_sim->regs[K_OSR] = 0x02u;
+    bmp_put24(&p_sim->regs[K_DATA_0], K_RAW_SKIPPED);
+    bmp_put24(&p_sim->regs[K_DATA_3], K_RAW_SKIPPED);
+    memcpy(&p_sim->regs[BMP390_SIM_NVM_PAR_ADDR], K_NVM, sizeof(K_NVM));
+
+    p_sim->forcedDoneUs = 0;
+    p_sim->measureIndex = 0;
+}
+
+/**
+ * @brief Conversion time of one measurement with the current settings, in us.
+ */
+static double bmp_conversion_us(const bmp390_sim_t *p_sim)
+{
+    uint8_t pwr = p_sim->regs[K_PWR_CTRL];
+    uint8_t osrP = (uint8_t)(p_sim->regs[K_OSR] & 0x7u);
+    uint8_t osrT = (uint8_t)((p_sim->regs[K_OSR] >> 3) & 0x7u);
+    double us = 234.0;
+
+    if (pwr & K_PWR_PRESS_EN)
+        us += 392.0 + 2020.0 * (double)(1u << osrP);
+    if (pwr & K_PWR_TEMP_EN)
+        us += 163.0 + 2020.0 * (double)(1u << osrT);
+    return us;
+}
+
+static double bmp_period_us(const bmp390_sim_t *p_sim)
+{
+    uint8_t odrSel = (uint8_t)(p_sim->regs[K_ODR] & 0x1Fu);
+    if (odrSel > K_ODR_SEL_MAX)
+        odrSel = K_ODR_SEL_MAX;
+    return K_ODR_BASE_US * (double)(1u << odrSel);
+}
+
+/**
+ * @brief Complete one measurement into the data registers.
+ */
+static void bmp_measure(bmp390_sim_t *p_sim, int64_t time_us)
+{
+    bmp390_sim_sample_t sample = {101325.0, 25.0};
+    Bmp390Calib_t cal;
+    uint8_t pwr = p_sim->regs[K_PWR_CTRL];
+
+    if (p_sim->p_source != NULL)
+    {
+        p_sim->p_source(p_sim->p_sourceCtx, time_us, &sample);
+    }
+
+    bmp_calib(&p_sim->regs[BMP390_SIM_NVM_PAR_ADDR], &cal);
+    uint32_t rawTemp = bmp_invert(&cal, sample.temp_c, 0.0, 0);
+    double tLin = bmp_comp_temp(&cal, (double)rawTemp);
+
+    if (pwr & K_PWR_PRESS_EN)
+    {
+        bmp_put24(&p_sim->regs[K_DATA_0], bmp_invert(&cal, sample.pressure_pa, tLin, 1));
+        p_sim->regs[K_STATUS] |= K_STATUS_DRDY_PRESS;
+    }
+    if (pwr & K_PWR_TEMP_EN)
+    {
+        bmp_put24(&p_sim->regs[K_DATA_3], rawTemp);
+        p_sim->regs[K_STATUS] |= K_STATUS_DRDY_TEMP;
+    }
+
+    bmp_put24(&p_sim->regs[K_SENSORTIME_0],
+              (uint32_t)((double)time_us / K_SENSORTIME_US) & K_RAW_MAX);
+    p_sim->regs[K_INT_STATUS] |= K_INT_DRDY;
+    p_sim->stats.measurements += 1;
+}
+
+/**
+ * @brief Complete every measurement due by now_us.
+ */
+static void bmp_update(bmp390_sim_t *p_sim, int64_t now_us)
+{
+    uint8_t mode = (uint8_t)(p_sim->regs[K_PWR_CTRL] & K_PWR_MODE_MASK);
+
+    if (p_sim->forcedDoneUs != 0 && now_us >= p_sim->forcedDoneUs)
+    {
+        bmp_measure(p_sim, p_sim->forcedDoneUs);
+        p_sim->forcedDoneUs = 0;
+        p_sim->regs[K_PWR_CTRL] &= (uint8_t)~K_PWR_MODE_MASK; /* Back to sleep */
+        return;
+    }
+    if (mode != K_PWR_MODE_NORMAL)
+        return;
+
+    double periodUs = bmp_period_us(p_sim);
+    double firstUs = bmp_conversion_us(p_sim);
+    double sinceUs = (double)(now_us - p_sim->epochUs);
+    if (sinceUs < firstUs)
+        return;
+
+    uint64_t due = (uint64_t)((sinceUs - firstUs) / periodUs) + 1u;
+    if (due > p_sim->measureIndex + K_MAX_CATCHUP)
+    {
+        p_sim->measureIndex = due - K_MAX_CATCHUP;
+    }
+    while (p_sim->measureIndex < due)
+    {
+        int64_t atUs = p_sim->epochUs + (int64_t)(firstUs + (double)p_sim->measureIndex * periodUs);
+        p_sim->measureIndex += 1;
+        bmp_measure(p_sim, atUs);
+    }
+}
+
+static uint8_t bmp_read(bmp390_sim_t *p_sim, uint8_t addr)
+{
+    uint8_t value = p_sim->regs[addr];
+
+    p_sim->stats.reads += 1;
+    switch (addr)
+    {
+    case K_ERR_REG:
+    case K_EVENT:
+    case K_INT_STATUS:
+        p_sim->regs[addr] = 0; /* Cleared on read */
+        break;
+    default:
+        if (addr >= K_DATA_0 && addr < K_DATA_3)
+            p_sim->regs[K_STATUS] &= (uint8_t)~K_STATUS_DRDY_PRESS;
+        else if (addr >= K_DATA_3 && addr <= K_DATA_5)
+            p_sim->regs[K_STATUS] &= (uint8_t)~K_STATUS_DRDY_TEMP;
+        break;
+    }
+    return value;
+}
+
+static void bmp_write(bmp390_sim_t *p_sim, uint8_t addr, uint8_t value, int64_t now_us)
+{
+    p_sim->stats.writes += 1;
+
+    switch (addr)
+    {
+    case K_CMD:
+        if (value == K_CMD_SOFTRESET)
+            bmp_reset(p_sim);
+        else if (value != K_CMD_FIFO_FLUSH && value != K_CMD_EXTMODE_EN)
+            p_sim->regs[K_ERR_REG] |= K_ERR_CMD;
+        return;
+    case K_PWR_CTRL:
+    {
+        uint8_t mode = (uint8_t)(value & K_PWR_MODE_MASK);
+        p_sim->regs[K_PWR_CTRL] = (uint8_t)(value & (K_PWR_MODE_MASK | K_PWR_PRESS_EN | K_PWR_TEMP_EN));
+        p_sim->forcedDoneUs = 0;
+        if (mode == K_PWR_MODE_NORMAL)
+        {
+            if (bmp_conversion_us(p_sim) > bmp_period_us(p_sim))
+            {
+                /* The measurement does not fit the ODR period: refuse normal mode */
+                p_sim->regs[K_ERR_REG] |= K_ERR_CONF;
+                p_sim->regs[K_PWR_CTRL] &= (uint8_t)~K_PWR_MODE_MASK;
+                return;
+            }
+            p_sim->epochUs = now_us;
+            p_sim->measureIndex = 0;
+        }
+        else if (mode != 0u)
+        {
+            p_sim->forcedDoneUs = now_us + (int64_t)bmp_conversion_us(p_sim);
+        }
+        return;
+    }
+    case K_OSR:
+    case K_ODR:
+        p_sim->regs[addr] = value;
+        p_sim->epochUs = now_us;
+        p_sim->measureIndex = 0;
+        return;
+    default:
+        if ((addr >= K_FIFO_WTM_0 && addr <= K_ODR) || addr == K_CONFIG)
+        {
+            p_sim->regs[addr] = value;
+        }
+        return;
+    }
+}
+
+/**
+ * @brief spi_host_device_fn_t of the simulator.
+ */
+static void bmp_transfer(void *p_ctx, const uint8_t *p_tx, uint8_t *p_rx, size_t length)
+{
+    bmp390_sim_t *p_sim = (bmp390_sim_t *)p_ctx;
+    int64_t nowUs = esp_timer_get_time();
+
+    p_sim->stats.transactions += 1;
+    if (length == 0u)
+        return;
+
+    bmp_update(p_sim, nowUs);
+
+    if (p_tx[0] & K_READ_FLAG)
+    {
+        uint8_t addr = (uint8_t)(p_tx[0] & K_ADDR_MASK);
+        /* p_rx[1] is the dummy byte */
+        for (size_t i = 2; i < length; i++)
+        {
+            p_rx[i] = bmp_read(p_sim, addr);
+            addr = (uint8_t)((addr + 1u) & K_ADDR_MASK);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i + 1u < length; i += 2u)
+    {
+        bmp_write(p_sim, (uint8_t)(p_tx[i] & K_ADDR_MASK), p_tx[i + 1u], nowUs);
+    }
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Put the simulator in its power-on state.
+ *
+ * The signal source defaults to 101325 Pa at 25 °C.
+ *
+ * @param[out] p_sim Simulator instance.
+ */
+void bmp390_sim_init(bmp390_sim_t *p_sim)
+{
+    memset(p_sim, 0, sizeof(*p_sim));
+    bmp_reset(p_sim);
+}
+
+/**
+ * @brief Set the signal the device measures.
+ *
+ * @param[in] p_sim    Simulator instance.
+ * @param[in] p_source Source, or NULL for constant standard conditions.
+ * @param[in] p_ctx    Passed to p_source.
+ */
+void bmp390_sim_set_source(bmp390_sim_t *p_sim, bmp390_sim_source_t p_source, void *p_ctx)
+{
+    p_sim->p_source = p_source;
+    p_sim->p_sourceCtx = p_ctx;
+}
+
+/**
+ * @brief Put the simulator behind a CS pin of the SPI stand-in.
+ *
+ * @param[in] p_sim  Simulator instance.
+ * @param[in] cs_pin Chip select GPIO, normally CS_PIN_BMP.
+ * @return The result of spi_host_attach_device().
+ */
+esp_err_t bmp390_sim_attach(bmp390_sim_t *p_sim, int cs_pin)
+{
+    return spi_host_attach_device(cs_pin, bmp_transfer, p_sim);
+}
+
+/**
+ * @brief Copy the simulator counters.
+ *
+ * @param[in]  p_sim   Simulator instance.
+ * @param[out] p_stats Receives the counters.
+ */
+void bmp390_sim_get_stats(const bmp390_sim_t *p_sim, bmp390_sim_stats_t *p_stats)
+{
+    *p_stats = p_sim->stats;
+}
+
+/**
+ * @brief Datasheet floating-point compensation, for checking driver output.
+ *
+ * @param[in]  p_nvm         BMP390_SIM_NVM_PAR_BYTES calibration bytes read
+ *                           from BMP390_SIM_NVM_PAR_ADDR.
+ * @param[in]  raw_pressure  24-bit raw pressure (DATA_0..2).
+ * @param[in]  raw_temp      24-bit raw temperature (DATA_3..5).
+ * @param[out] p_pressure_pa Receives the pressure in pascal.
+ * @param[out] p_temp_c      Receives the temperature in degrees Celsius.
+ */
+void bmp390_sim_compensate(const uint8_t *p_nvm, uint32_t raw_pressure, uint32_t raw_temp,
+                           double *p_pressure_pa, double *p_temp_c)
+{
+    Bmp390Calib_t cal;
+
+    bmp_calib(p_nvm, &cal);
+    double tLin = bmp_comp_temp(&cal, (double)raw_temp);
+    *p_temp_c = tLin;
+    *p_pressure_pa = bmp_comp_press(&cal, (double)raw_pressure, tLin);
+}
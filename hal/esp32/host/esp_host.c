@@ -0,0 +1,123 @@
+/**
+ * @file esp_host.c
+ * @brief Host stand-ins for ESP-IDF system helpers, esp_timer and FreeRTOS ticks.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_err.h"
+#include "esp_random.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Reflected CRC-32 (IEEE 802.3) polynomial. */
+#define K_CRC32_POLY 0xEDB88320u
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static uint32_t s_crcTable[256];
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    static int64_t s_originMs = -1;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t nowMs = (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+    if (s_originMs < 0)
+    {
+        s_originMs = nowMs;
+    }
+    return (TickType_t)((nowMs - s_originMs) * configTICK_RATE_HZ / 1000);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    static int64_t s_originUs = -1;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t nowUs = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    if (s_originUs < 0)
+    {
+        s_originUs = nowUs;
+    }
+    return nowUs - s_originUs;
+}
+
+uint32_t esp_random(void)
+{
+    uint32_t value = 0;
+
+    if (getentropy(&value, sizeof(value)) != 0)
+    {
+        value = (uint32_t)esp_timer_get_time() ^ (uint32_t)getpid();
+    }
+    return value;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len)
+{
+    if (s_crcTable[1] == 0u)
+    {
+        for (uint32_t i = 0; i < 256u; i++)
+        {
+            uint32_t entry = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                entry = (entry & 1u) ? (entry >> 1) ^ K_CRC32_POLY : entry >> 1;
+            }
+            s_crcTable[i] = entry;
+        }
+    }
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc = s_crcTable[(crc ^ buf[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file gpio_host.c
+ * @brief Host stand-in for the ESP-IDF GPIO driver.
+ *
+ * Keeps per-pin configuration and ISR handlers. gpio_host_trigger_edge()
+ * runs the pin's handler in the calling thread, serialised with every
+ * other injected interrupt the way a single interrupt level would be.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdint.h>
+#include "driver/gpio.h"
+#include "gpio_host.h"
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Simulated pin.
+ */
+typedef struct
+{
+    gpio_int_type_t intrType;
+    gpio_isr_t p_handler;
+    void *p_arg;
+    uint32_t interrupts;
+} HostPin_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static HostPin_t s_pins[GPIO_NUM_MAX];
+static uint8_t s_isrServiceInstalled = 0;
+static int s_isrServiceFlags = 0;
+
+/** @brief Protects s_pins and serialises injected interrupts. */
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ============================================================================
+ * Public Functions — Driver Stand-In
+ * ========================================================================= */
+
+esp_err_t gpio_config(const gpio_config_t *pGPIOConfig)
+{
+    if (pGPIOConfig == NULL || pGPIOConfig->pin_bit_mask == 0u ||
+        (pGPIOConfig->pin_bit_mask >> GPIO_NUM_MAX) != 0u)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++)
+    {
+        if (pGPIOConfig->pin_bit_mask & (1ULL << pin))
+        {
+            s_pins[pin].intrType = pGPIOConfig->intr_type;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_isrServiceInstalled == 0u)
+    {
+        s_isrServiceInstalled = 1;
+        s_isrServiceFlags = intr_alloc_flags;
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+void gpio_uninstall_isr_service(void)
+{
+    pthread_mutex_lock(&s_lock);
+    s_isrServiceInstalled = 0;
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++)
+    {
+        s_pins[pin].p_handler = NULL;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_isrServiceInstalled != 0u)
+    {
+        s_pins[gpio_num].p_handler = isr_handler;
+        s_pins[gpio_num].p_arg = args;
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    s_pins[gpio_num].p_handler = NULL;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+/* ============================================================================
+ * Public Functions — Interrupt Injection
+ * ========================================================================= */
+
+/**
+ * @brief Simulate an interrupt-triggering edge on a pin.
+ *
+ * @param[in] gpio_num Pin.
+ * @return ESP_OK if the handler ran, ESP_ERR_INVALID_STATE if the pin has
+ *         no handler or its interrupt is disabled.
+ */
+esp_err_t gpio_host_trigger_edge(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    HostPin_t *p_pin = &s_pins[gpio_num];
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (p_pin->p_handler != NULL && p_pin->intrType != GPIO_INTR_DISABLE)
+    {
+        p_pin->interrupts += 1;
+        p_pin->p_handler(p_pin->p_arg);
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+/**
+ * @brief Number of interrupts delivered on a pin.
+ *
+ * @param[in] gpio_num Pin.
+ * @return Handler invocations since start.
+ */
+uint32_t gpio_host_get_interrupt_count(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX)
+        return 0;
+
+    pthread_mutex_lock(&s_lock);
+    uint32_t count = s_pins[gpio_num].interrupts;
+    pthread_mutex_unlock(&s_lock);
+    return count;
+}
+
+/**
+ * @brief Allocation flags the ISR service was installed with.
+ *
+ * @return Flags passed to gpio_install_isr_service(), 0 if not installed.
+ */
+int gpio_host_get_isr_service_flags(void)
+{
+    pthread_mutex_lock(&s_lock);
+    int flags = (s_isrServiceInstalled != 0u) ? s_isrServiceFlags : 0;
+    pthread_mutex_unlock(&s_lock);
+    return flags;
+}
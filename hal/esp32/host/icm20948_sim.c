@@ -0,0 +1,416 @@
+/**
+ * @file icm20948_sim.c
+ * @brief Register-level ICM-20948 simulator for the host SPI stand-in.
+ *
+ * A transaction is the SPI frame of the datasheet: an address byte with
+ * the read flag in bit 7, then data bytes for consecutive registers of the
+ * selected bank (FIFO_R_W repeats instead of incrementing). Samples due
+ * since the previous transaction are taken at its start, so data and
+ * status registers read as they would at that instant.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "icm20948_sim.h"
+#include "spi_host.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_READ_FLAG 0x80u
+#define K_ADDR_MASK 0x7Fu
+
+/** @brief Bank 0 registers. */
+#define K_B0_WHO_AM_I 0x00u
+#define K_B0_USER_CTRL 0x03u
+#define K_B0_LP_CONFIG 0x05u
+#define K_B0_PWR_MGMT_1 0x06u
+#define K_B0_PWR_MGMT_2 0x07u
+#define K_B0_I2C_MST_STATUS 0x17u
+#define K_B0_INT_STATUS 0x19u
+#define K_B0_INT_STATUS_1 0x1Au
+#define K_B0_INT_STATUS_2 0x1Bu
+#define K_B0_INT_STATUS_3 0x1Cu
+#define K_B0_DELAY_TIMEH 0x28u
+#define K_B0_ACCEL_XOUT_H 0x2Du
+#define K_B0_GYRO_XOUT_H 0x33u
+#define K_B0_TEMP_OUT_H 0x39u
+#define K_B0_EXT_SLV_SENS_DATA_23 0x52u
+#define K_B0_FIFO_EN_2 0x67u
+#define K_B0_FIFO_RST 0x68u
+#define K_B0_FIFO_MODE 0x69u
+#define K_B0_FIFO_COUNTH 0x70u
+#define K_B0_FIFO_COUNTL 0x71u
+#define K_B0_FIFO_R_W 0x72u
+#define K_B0_DATA_RDY_STATUS 0x74u
+
+/** @brief Bank 2 registers. */
+#define K_B2_GYRO_SMPLRT_DIV 0x00u
+#define K_B2_GYRO_CONFIG_1 0x01u
+#define K_B2_ACCEL_CONFIG 0x14u
+
+/** @brief REG_BANK_SEL, present in every bank. */
+#define K_REG_BANK_SEL 0x7Fu
+
+/** @brief Register bits. */
+#define K_PWR_DEVICE_RESET 0x80u
+#define K_PWR_SLEEP 0x40u
+#define K_PWR2_DISABLE_ACCEL 0x38u
+#define K_PWR2_DISABLE_GYRO 0x07u
+#define K_USER_FIFO_EN 0x40u
+#define K_USER_SELF_CLEARING 0x0Eu
+#define K_FIFO_EN2_ACCEL 0x10u
+#define K_FIFO_EN2_GYRO_Z 0x08u
+#define K_FIFO_EN2_GYRO_Y 0x04u
+#define K_FIFO_EN2_GYRO_X 0x02u
+#define K_FIFO_EN2_TEMP 0x01u
+#define K_FIFO_MODE_SNAPSHOT 0x01u
+#define K_RAW_DATA_0_RDY 0x01u
+#define K_FIFO_OVERFLOW_0 0x01u
+
+/** @brief Internal sample clock before the divider. */
+#define K_BASE_RATE_HZ 1125.0
+
+/** @brief Samples taken at most per transaction; older ones could not reach the FIFO anyway. */
+#define K_MAX_CATCHUP 64u
+
+/** @brief Temperature output: LSB per degree and the 0 LSB point. */
+#define K_TEMP_SENSITIVITY 333.87
+#define K_TEMP_OFFSET_C 21.0
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static uint8_t icm_bank(const icm20948_sim_t *p_sim)
+{
+    return (uint8_t)((p_sim->regs[0][K_REG_BANK_SEL] >> 4) & 0x3u);
+}
+
+/**
+ * @brief Power-on / DEVICE_RESET state: asleep, FIFO empty, bank 0.
+ */
+static void icm_reset(icm20948_sim_t *p_sim)
+{
+    memset(p_sim->regs, 0, sizeof(p_sim->regs));
+    p_sim->regs[0][K_B0_WHO_AM_I] = ICM20948_SIM_WHO_AM_I;
+    p_sim->regs[0][K_B0_LP_CONFIG] = 0x40u;
+    p_sim->regs[0][K_B0_PWR_MGMT_1] = K_PWR_SLEEP | 0x01u;
+    p_sim->regs[2][K_B2_GYRO_CONFIG_1] = 0x01u;
+    p_sim->regs[2][K_B2_ACCEL_CONFIG] = 0x01u;
+
+    p_sim->fifoHead = 0;
+    p_sim->fifoCount = 0;
+    p_sim->awake = 0;
+    p_sim->sampleIndex = 0;
+}
+
+static int icm_read_only(uint8_t bank, uint8_t addr)
+{
+    if (bank != 0u)
+        return 0;
+    return addr == K_B0_WHO_AM_I || addr == K_B0_I2C_MST_STATUS ||
+           (addr >= K_B0_INT_STATUS && addr <= K_B0_INT_STATUS_3) ||
+           (addr >= K_B0_DELAY_TIMEH && addr <= K_B0_EXT_SLV_SENS_DATA_23) ||
+           addr == K_B0_FIFO_COUNTH || addr == K_B0_FIFO_COUNTL || addr == K_B0_DATA_RDY_STATUS;
+}
+
+static void icm_fifo_push(icm20948_sim_t *p_sim, const uint8_t *p_data, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (p_sim->fifoCount == ICM20948_SIM_FIFO_BYTES)
+        {
+            p_sim->stats.fifo_overflows += 1;
+            p_sim->regs[0][K_B0_INT_STATUS_2] |= K_FIFO_OVERFLOW_0;
+            if (p_sim->regs[0][K_B0_FIFO_MODE] & K_FIFO_MODE_SNAPSHOT)
+                continue;
+            /* Stream mode: the oldest byte makes room */
+            p_sim->fifoHead = (p_sim->fifoHead + 1u) % ICM20948_SIM_FIFO_BYTES;
+            p_sim->fifoCount -= 1;
+        }
+        p_sim->fifo[(p_sim->fifoHead + p_sim->fifoCount) % ICM20948_SIM_FIFO_BYTES] = p_data[i];
+        p_sim->fifoCount += 1;
+    }
+}
+
+static void icm_put16(uint8_t *p_out, double value)
+{
+    double clamped = (value > 32767.0) ? 32767.0 : (value < -32768.0) ? -32768.0 : value;
+    int16_t raw = (int16_t)lrint(clamped);
+    p_out[0] = (uint8_t)((uint16_t)raw >> 8);
+    p_out[1] = (uint8_t)raw;
+}
+
+/**
+ * @brief Take one sample into the output registers and the FIFO.
+ */
+static void icm_sample(icm20948_sim_t *p_sim, int64_t time_us)
+{
+    icm20948_sim_sample_t sample = {{0.0, 0.0, 1.0}, {0.0, 0.0, 0.0}, 25.0};
+    if (p_sim->p_source != NULL)
+    {
+        p_sim->p_source(p_sim->p_sourceCtx, time_us, &sample);
+    }
+
+    uint8_t *p_b0 = p_sim->regs[0];
+    uint8_t accelFs = (uint8_t)((p_sim->regs[2][K_B2_ACCEL_CONFIG] >> 1) & 0x3u);
+    uint8_t gyroFs = (uint8_t)((p_sim->regs[2][K_B2_GYRO_CONFIG_1] >> 1) & 0x3u);
+    double accelLsb = 16384.0 / (double)(1u << accelFs);
+    double gyroLsb = 131.0 / (double)(1u << gyroFs);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if ((p_b0[K_B0_PWR_MGMT_2] & K_PWR2_DISABLE_ACCEL) == 0u)
+        {
+            icm_put16(&p_b0[K_B0_ACCEL_XOUT_H + 2 * axis], sample.accel_g[axis] * accelLsb);
+        }
+        if ((p_b0[K_B0_PWR_MGMT_2] & K_PWR2_DISABLE_GYRO) == 0u)
+        {
+            icm_put16(&p_b0[K_B0_GYRO_XOUT_H + 2 * axis], sample.gyro_dps[axis] * gyroLsb);
+        }
+    }
+    icm_put16(&p_b0[K_B0_TEMP_OUT_H], (sample.temp_c - K_TEMP_OFFSET_C) * K_TEMP_SENSITIVITY);
+
+    if (p_b0[K_B0_USER_CTRL] & K_USER_FIFO_EN)
+    {
+        uint8_t enabled = p_b0[K_B0_FIFO_EN_2];
+        if (enabled & K_FIFO_EN2_ACCEL)
+            icm_fifo_push(p_sim, &p_b0[K_B0_ACCEL_XOUT_H], 6);
+        if (enabled & K_FIFO_EN2_GYRO_X)
+            icm_fifo_push(p_sim, &p_b0[K_B0_GYRO_XOUT_H], 2);
+        if (enabled & K_FIFO_EN2_GYRO_Y)
+            icm_fifo_push(p_sim, &p_b0[K_B0_GYRO_XOUT_H + 2], 2);
+        if (enabled & K_FIFO_EN2_GYRO_Z)
+            icm_fifo_push(p_sim, &p_b0[K_B0_GYRO_XOUT_H + 4], 2);
+        if (enabled & K_FIFO_EN2_TEMP)
+            icm_fifo_push(p_sim, &p_b0[K_B0_TEMP_OUT_H], 2);
+    }
+
+    p_b0[K_B0_INT_STATUS_1] |= K_RAW_DATA_0_RDY;
+    p_b0[K_B0_DATA_RDY_STATUS] |= K_RAW_DATA_0_RDY;
+    p_sim->stats.samples += 1;
+}
+
+/**
+ * @brief Take every sample due by now_us.
+ */
+static void icm_update(icm20948_sim_t *p_sim, int64_t now_us)
+{
+    if (p_sim->awake == 0u)
+        return;
+
+    double periodUs = 1e6 * (1.0 + (double)p_sim->regs[2][K_B2_GYRO_SMPLRT_DIV]) / K_BASE_RATE_HZ;
+    uint64_t due = (uint64_t)((double)(now_us - p_sim->epochUs) / periodUs);
+    if (due > p_sim->sampleIndex + K_MAX_CATCHUP)
+    {
+        p_sim->sampleIndex = due - K_MAX_CATCHUP;
+    }
+
+    while (p_sim->sampleIndex < due)
+    {
+        p_sim->sampleIndex += 1;
+        icm_sample(p_sim, p_sim->epochUs + (int64_t)((double)p_sim->sampleIndex * periodUs));
+    }
+}
+
+/**
+ * @brief Restart the sample clock, e.g. on wake-up or a rate change.
+ */
+static void icm_restart_clock(icm20948_sim_t *p_sim, int64_t now_us)
+{
+    p_sim->epochUs = now_us;
+    p_sim->sampleIndex = 0;
+}
+
+static uint8_t icm_read(icm20948_sim_t *p_sim, uint8_t addr)
+{
+    uint8_t bank = icm_bank(p_sim);
+    uint8_t *p_b0 = p_sim->regs[0];
+
+    p_sim->stats.reads += 1;
+    if (addr == K_REG_BANK_SEL)
+        return p_b0[K_REG_BANK_SEL];
+    if (bank != 0u)
+        return p_sim->regs[bank][addr];
+
+    uint8_t value = p_b0[addr];
+    switch (addr)
+    {
+    case K_B0_INT_STATUS_1:
+    case K_B0_INT_STATUS_2:
+    case K_B0_INT_STATUS_3:
+    case K_B0_DATA_RDY_STATUS:
+        p_b0[addr] = 0; /* Cleared on read */
+        break;
+    case K_B0_FIFO_COUNTH:
+        value = (uint8_t)((p_sim->fifoCount >> 8) & 0x1Fu);
+        break;
+    case K_B0_FIFO_COUNTL:
+        value = (uint8_t)p_sim->fifoCount;
+        break;
+    case K_B0_FIFO_R_W:
+        value = 0xFFu;
+        if (p_sim->fifoCount != 0u)
+        {
+            value = p_sim->fifo[p_sim->fifoHead];
+            p_sim->fifoHead = (p_sim->fifoHead + 1u) % ICM20948_SIM_FIFO_BYTES;
+            p_sim->fifoCount -= 1;
+        }
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+static void icm_write(icm20948_sim_t *p_sim, uint8_t addr, uint8_t value, int64_t now_us)
+{
+    uint8_t bank = icm_bank(p_sim);
+
+    p_sim->stats.writes += 1;
+    if (addr == K_REG_BANK_SEL)
+    {
+        p_sim->regs[0][K_REG_BANK_SEL] = (uint8_t)(value & 0x30u);
+        return;
+    }
+    if (icm_read_only(bank, addr))
+        return;
+
+    if (bank == 2u && addr == K_B2_GYRO_SMPLRT_DIV)
+    {
+        icm_restart_clock(p_sim, now_us);
+    }
+    if (bank != 0u)
+    {
+        p_sim->regs[bank][addr] = value;
+        return;
+    }
+
+    switch (addr)
+    {
+    case K_B0_PWR_MGMT_1:
+        if (value & K_PWR_DEVICE_RESET)
+        {
+            icm_reset(p_sim);
+            return;
+        }
+        p_sim->regs[0][addr] = value;
+        if ((value & K_PWR_SLEEP) == 0u && p_sim->awake == 0u)
+        {
+            icm_restart_clock(p_sim, now_us);
+        }
+        p_sim->awake = ((value & K_PWR_SLEEP) == 0u);
+        break;
+    case K_B0_USER_CTRL:
+        p_sim->regs[0][addr] = (uint8_t)(value & ~K_USER_SELF_CLEARING);
+        break;
+    case K_B0_FIFO_RST:
+        if (value & 0x1Fu)
+        {
+            p_sim->fifoHead = 0;
+            p_sim->fifoCount = 0;
+        }
+        p_sim->regs[0][addr] = value;
+        break;
+    case K_B0_FIFO_R_W:
+        icm_fifo_push(p_sim, &value, 1);
+        break;
+    default:
+        p_sim->regs[0][addr] = value;
+        break;
+    }
+}
+
+/**
+ * @brief spi_host_device_fn_t of the simulator.
+ */
+static void icm_transfer(void *p_ctx, const uint8_t *p_tx, uint8_t *p_rx, size_t length)
+{
+    icm20948_sim_t *p_sim = (icm20948_sim_t *)p_ctx;
+    int64_t nowUs = esp_timer_get_time();
+
+    p_sim->stats.transactions += 1;
+    if (length == 0u)
+        return;
+
+    icm_update(p_sim, nowUs);
+
+    uint8_t addr = (uint8_t)(p_tx[0] & K_ADDR_MASK);
+    int reading = (p_tx[0] & K_READ_FLAG) != 0u;
+    for (size_t i = 1; i < length; i++)
+    {
+        if (reading)
+        {
+            p_rx[i] = icm_read(p_sim, addr);
+        }
+        else
+        {
+            icm_write(p_sim, addr, p_tx[i], nowUs);
+        }
+        if (!(icm_bank(p_sim) == 0u && addr == K_B0_FIFO_R_W))
+        {
+            addr = (uint8_t)((addr + 1u) & K_ADDR_MASK);
+        }
+    }
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Put the simulator in its power-on state.
+ *
+ * The signal source defaults to the device lying flat at rest at 25 °C.
+ *
+ * @param[out] p_sim Simulator instance.
+ */
+void icm20948_sim_init(icm20948_sim_t *p_sim)
+{
+    memset(p_sim, 0, sizeof(*p_sim));
+    icm_reset(p_sim);
+}
+
+/**
+ * @brief Set the signal the device measures.
+ *
+ * @param[in] p_sim    Simulator instance.
+ * @param[in] p_source Source, or NULL for the device at rest.
+ * @param[in] p_ctx    Passed to p_source.
+ */
+void icm20948_sim_set_source(icm20948_sim_t *p_sim, icm20948_sim_source_t p_source, void *p_ctx)
+{
+    p_sim->p_source = p_source;
+    p_sim->p_sourceCtx = p_ctx;
+}
+
+/**
+ * @brief Put the simulator behind a CS pin of the SPI stand-in.
+ *
+ * @param[in] p_sim  Simulator instance.
+ * @param[in] cs_pin Chip select GPIO, normally CS_PIN_ICM.
+ * @return The result of spi_host_attach_device().
+ */
+esp_err_t icm20948_sim_attach(icm20948_sim_t *p_sim, int cs_pin)
+{
+    return spi_host_attach_device(cs_pin, icm_transfer, p_sim);
+}
+
+/**
+ * @brief Copy the simulator counters.
+ *
+ * @param[in]  p_sim   Simulator instance.
+ * @param[out] p_stats Receives the counters.
+ */
+void icm20948_sim_get_stats(const icm20948_sim_t *p_sim, icm20948_sim_stats_t *p_stats)
+{
+    *p_stats = p_sim->stats;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file bmp390_sim.h
+ * @brief Register-level BMP390 simulator for the host SPI stand-in.
+ *
+ * Models the SPI register interface of the barometer as seen through the
+ * CS pin it is attached to: reset values, the dummy byte before read data,
+ * address/data pairs for writes, address auto-increment on reads, sleep,
+ * forced and normal modes with the ODR and oversampling settings and their
+ * conversion times, STATUS data-ready bits cleared by reading the data,
+ * INT_STATUS and EVENT cleared on read, SENSORTIME, configuration and
+ * command errors in ERR_REG, the soft reset command, and a set of NVM
+ * calibration coefficients. Raw pressure and temperature are the ADC
+ * values that compensate, with those coefficients, to the source's
+ * physical values. The FIFO is not modelled; FIFO_LENGTH reads 0.
+ */
+
+#ifndef BMP390_SIM_H
+#define BMP390_SIM_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief CHIP_ID value. */
+#define BMP390_SIM_CHIP_ID 0x60u
+
+/** @brief First calibration register and number of calibration bytes. */
+#define BMP390_SIM_NVM_PAR_ADDR 0x31u
+#define BMP390_SIM_NVM_PAR_BYTES 21u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief One measurement in physical units.
+ */
+typedef struct
+{
+    double pressure_pa; /**< Pressure in pascal. */
+    double temp_c;      /**< Temperature in degrees Celsius. */
+} bmp390_sim_sample_t;
+
+/**
+ * @brief Signal source, called for every measurement the device makes.
+ *
+ * @param[in]  p_ctx    Context given to bmp390_sim_set_source().
+ * @param[in]  time_us  esp_timer time of the measurement.
+ * @param[out] p_sample Receives the measurement.
+ */
+typedef void (*bmp390_sim_source_t)(void *p_ctx, int64_t time_us, bmp390_sim_sample_t *p_sample);
+
+/**
+ * @brief Simulator counters.
+ */
+typedef struct
+{
+    uint32_t transactions; /**< CS assertions. */
+    uint32_t reads;        /**< Register bytes read. */
+    uint32_t writes;       /**< Register bytes written. */
+    uint32_t measurements; /**< Measurements completed. */
+} bmp390_sim_stats_t;
+
+/**
+ * @brief Simulator instance; fields are private to bmp390_sim.c.
+ */
+typedef struct
+{
+    uint8_t regs[128];
+    int64_t epochUs;
+    uint64_t measureIndex;
+    int64_t forcedDoneUs;
+    bmp390_sim_source_t p_source;
+    void *p_sourceCtx;
+    bmp390_sim_stats_t stats;
+} bmp390_sim_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void bmp390_sim_init(bmp390_sim_t *p_sim);
+void bmp390_sim_set_source(bmp390_sim_t *p_sim, bmp390_sim_source_t p_source, void *p_ctx);
+esp_err_t bmp390_sim_attach(bmp390_sim_t *p_sim, int cs_pin);
+void bmp390_sim_get_stats(const bmp390_sim_t *p_sim, bmp390_sim_stats_t *p_stats);
+void bmp390_sim_compensate(const uint8_t *p_nvm, uint32_t raw_pressure, uint32_t raw_temp,
+                           double *p_pressure_pa, double *p_temp_c);
+
+#endif /* BMP390_SIM_H */
@@ -0,0 +1,14 @@
+/**
+ * @file diskio_sdmmc.h
+ * @brief Host stand-in for the FatFs disk I/O glue of SD cards.
+ */
+
+#ifndef DISKIO_SDMMC_H
+#define DISKIO_SDMMC_H
+
+#include "ff.h"
+#include "sdmmc_cmd.h"
+
+BYTE ff_diskio_get_pdrv_card(const sdmmc_card_t *card);
+
+#endif /* DISKIO_SDMMC_H */
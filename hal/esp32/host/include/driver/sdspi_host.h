@@ -0,0 +1,33 @@
+/**
+ * @file sdspi_host.h
+ * @brief Host stand-in for the ESP-IDF SD-over-SPI host driver.
+ */
+
+#ifndef SDSPI_HOST_H
+#define SDSPI_HOST_H
+
+#include "driver/gpio.h"
+#include "driver/spi_common.h"
+#include "sdmmc_cmd.h"
+
+typedef struct
+{
+    spi_host_device_t host_id;
+    gpio_num_t gpio_cs;
+    gpio_num_t gpio_cd;
+    gpio_num_t gpio_wp;
+    gpio_num_t gpio_int;
+} sdspi_device_config_t;
+
+#define SDSPI_HOST_DEFAULT()                                                                       \
+    {                                                                                              \
+        .slot = SPI2_HOST, .max_freq_khz = SDMMC_FREQ_DEFAULT                                      \
+    }
+
+#define SDSPI_DEVICE_CONFIG_DEFAULT()                                                              \
+    {                                                                                              \
+        .host_id = SPI2_HOST, .gpio_cs = GPIO_NUM_NC, .gpio_cd = GPIO_NUM_NC,                      \
+        .gpio_wp = GPIO_NUM_NC, .gpio_int = GPIO_NUM_NC                                            \
+    }
+
+#endif /* SDSPI_HOST_H */
@@ -0,0 +1,39 @@
+/**
+ * @file spi_common.h
+ * @brief Host stand-in for the ESP-IDF SPI bus API.
+ */
+
+#ifndef SPI_COMMON_H
+#define SPI_COMMON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef enum
+{
+    SPI1_HOST = 0,
+    SPI2_HOST = 1,
+    SPI3_HOST = 2
+} spi_host_device_t;
+
+#define SPI_DMA_DISABLED 0
+#define SPI_DMA_CH_AUTO 3
+
+typedef struct
+{
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+    int intr_flags;
+} spi_bus_config_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config,
+                             int dma_chan);
+esp_err_t spi_bus_free(spi_host_device_t host_id);
+
+#endif /* SPI_COMMON_H */
@@ -0,0 +1,14 @@
+/**
+ * @file esp_attr.h
+ * @brief Host stand-in for ESP-IDF placement attributes (no-ops on the host).
+ */
+
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
+#define DMA_ATTR WORD_ALIGNED_ATTR
+
+#endif /* ESP_ATTR_H */
@@ -0,0 +1,23 @@
+/**
+ * @file esp_cpu.h
+ * @brief Host stand-in for the ESP-IDF CPU cycle counter.
+ *
+ * Counts nanoseconds of CLOCK_MONOTONIC, i.e. a virtual 1 GHz CPU.
+ */
+
+#ifndef ESP_CPU_H
+#define ESP_CPU_H
+
+#include <stdint.h>
+#include <time.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (esp_cpu_cycle_count_t)((uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec);
+}
+
+#endif /* ESP_CPU_H */
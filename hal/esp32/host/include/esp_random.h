@@ -0,0 +1,14 @@
+/**
+ * @file esp_random.h
+ * @brief Host stand-in for the ESP-IDF hardware random number generator.
+ */
+
+#ifndef ESP_RANDOM_H
+#define ESP_RANDOM_H
+
+#include <stdint.h>
+
+/** @brief 32 random bits from the host entropy source. */
+uint32_t esp_random(void);
+
+#endif /* ESP_RANDOM_H */
@@ -0,0 +1,18 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief Host stand-in for the ESP32 ROM CRC routines.
+ */
+
+#ifndef ESP_ROM_CRC_H
+#define ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) continuing from crc, as the ROM
+ *        routine and zlib's crc32(): pass 0 to start, the previous result
+ *        to continue.
+ */
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len);
+
+#endif /* ESP_ROM_CRC_H */
@@ -0,0 +1,17 @@
+/**
+ * @file esp_rom_sys.h
+ * @brief Host stand-in for the ESP-IDF ROM system helpers.
+ */
+
+#ifndef ESP_ROM_SYS_H
+#define ESP_ROM_SYS_H
+
+#include <stdint.h>
+
+/** @brief Cycle counter ticks per microsecond; esp_cpu.h counts nanoseconds. */
+static inline uint32_t esp_rom_get_cpu_ticks_per_us(void)
+{
+    return 1000u;
+}
+
+#endif /* ESP_ROM_SYS_H */
@@ -0,0 +1,14 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for the ESP-IDF high-resolution timer.
+ */
+
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+
+/** @brief Microseconds since the first call, from CLOCK_MONOTONIC. */
+int64_t esp_timer_get_time(void);
+
+#endif /* ESP_TIMER_H */
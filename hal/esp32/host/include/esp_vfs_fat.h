@@ -0,0 +1,41 @@
+/**
+ * @file esp_vfs_fat.h
+ * @brief Host stand-in for the ESP-IDF FAT filesystem VFS glue.
+ *
+ * Mounting binds the base path to an existing host directory, which then
+ * serves as the card's volume: stdio and POSIX calls on paths under it work
+ * natively. Contiguous files get a cluster range on the simulated card so
+ * raw sector access reaches them (sd_host.h).
+ */
+
+#ifndef ESP_VFS_FAT_H
+#define ESP_VFS_FAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/sdspi_host.h"
+#include "esp_err.h"
+#include "sdmmc_cmd.h"
+
+typedef struct
+{
+    bool format_if_mount_failed;
+    int max_files;
+    size_t allocation_unit_size;
+    bool disk_status_check_enable;
+} esp_vfs_fat_mount_config_t;
+
+typedef esp_vfs_fat_mount_config_t esp_vfs_fat_sdmmc_mount_config_t;
+
+esp_err_t esp_vfs_fat_sdspi_mount(const char *base_path, const sdmmc_host_t *host_config_input,
+                                  const sdspi_device_config_t *slot_config,
+                                  const esp_vfs_fat_mount_config_t *mount_config,
+                                  sdmmc_card_t **out_card);
+esp_err_t esp_vfs_fat_sdcard_unmount(const char *base_path, sdmmc_card_t *card);
+esp_err_t esp_vfs_fat_create_contiguous_file(const char *base_path, const char *full_path,
+                                             uint64_t size, bool alloc_now);
+esp_err_t esp_vfs_fat_test_contiguous_file(const char *base_path, const char *full_path,
+                                           bool *is_contiguous);
+
+#endif /* ESP_VFS_FAT_H */
@@ -0,0 +1,68 @@
+/**
+ * @file ff.h
+ * @brief Host stand-in for the FatFs API used by the ESP32 HAL.
+ *
+ * Only opening a file to learn its first cluster, and the volume geometry
+ * needed to turn that into a sector, are provided.
+ */
+
+#ifndef FF_H
+#define FF_H
+
+#include <stdint.h>
+
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef uint64_t QWORD;
+typedef unsigned int UINT;
+typedef uint32_t LBA_t;
+typedef QWORD FSIZE_t;
+
+typedef struct
+{
+    BYTE pdrv;      /**< Physical drive number. */
+    WORD csize;     /**< Sectors per cluster. */
+    DWORD n_fatent; /**< Clusters on the volume + 2. */
+    LBA_t database; /**< First sector of cluster 2. */
+} FATFS;
+
+typedef struct
+{
+    FATFS *fs;       /**< Volume the object lives on. */
+    DWORD sclust;    /**< First cluster, 0 if none. */
+    FSIZE_t objsize; /**< Object size. */
+} FFOBJID;
+
+typedef struct
+{
+    FFOBJID obj;
+    BYTE flag;
+    FSIZE_t fptr;
+} FIL;
+
+typedef enum
+{
+    FR_OK = 0,
+    FR_DISK_ERR,
+    FR_INT_ERR,
+    FR_NOT_READY,
+    FR_NO_FILE,
+    FR_NO_PATH,
+    FR_INVALID_NAME,
+    FR_DENIED,
+    FR_EXIST,
+    FR_INVALID_OBJECT,
+    FR_WRITE_PROTECTED,
+    FR_INVALID_DRIVE,
+    FR_NOT_ENABLED,
+    FR_NO_FILESYSTEM
+} FRESULT;
+
+#define FA_READ 0x01u
+#define FA_WRITE 0x02u
+
+FRESULT f_open(FIL *fp, const char *path, BYTE mode);
+FRESULT f_close(FIL *fp);
+
+#endif /* FF_H */
@@ -0,0 +1,34 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Minimal FreeRTOS surface used by the ESP32 HAL sources on the host.
+ *
+ * Only ticks, ISR yield hooks and portMUX critical sections (backed by a
+ * pthread mutex) are provided; HAL code reaches the kernel through the
+ * OSAL, which the POSIX port implements on the host.
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define configTICK_RATE_HZ 1000u
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED PTHREAD_MUTEX_INITIALIZER
+#define portMUX_INITIALIZE(mux) pthread_mutex_init((mux), NULL)
+#define portENTER_CRITICAL(mux) pthread_mutex_lock(mux)
+#define portEXIT_CRITICAL(mux) pthread_mutex_unlock(mux)
+
+#endif /* FREERTOS_H */
@@ -0,0 +1,11 @@
+/**
+ * @file portmacro.h
+ * @brief Host stand-in for the FreeRTOS port header.
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include "freertos/FreeRTOS.h"
+
+#endif /* PORTMACRO_H */
@@ -0,0 +1,14 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for the FreeRTOS task API used by the ESP32 HAL.
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+/** @brief Milliseconds since the first call, from CLOCK_MONOTONIC. */
+TickType_t xTaskGetTickCount(void);
+
+#endif /* TASK_H */
@@ -0,0 +1,24 @@
+/**
+ * @file gpio_host.h
+ * @brief Interrupt injection for the host GPIO stand-in.
+ */
+
+#ifndef GPIO_HOST_H
+#define GPIO_HOST_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "driver/gpio.h"
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+esp_err_t gpio_host_trigger_edge(gpio_num_t gpio_num);
+uint32_t gpio_host_get_interrupt_count(gpio_num_t gpio_num);
+int gpio_host_get_isr_service_flags(void);
+
+#endif /* GPIO_HOST_H */
@@ -0,0 +1,100 @@
+/**
+ * @file icm20948_sim.h
+ * @brief Register-level ICM-20948 simulator for the host SPI stand-in.
+ *
+ * Models the SPI register interface of the IMU as seen through the CS pin
+ * it is attached to: four register banks selected by REG_BANK_SEL, reset
+ * values, read-only and self-clearing bits, address auto-increment, the
+ * DEVICE_RESET and SLEEP bits, gyro/accel full-scale and sample-rate
+ * divider settings, RAW_DATA_0_RDY in INT_STATUS_1 (cleared on read), and
+ * the 512-byte FIFO fed with the outputs enabled in FIFO_EN_2. The
+ * magnetometer behind the I2C master is not modelled.
+ *
+ * While awake the device samples at 1125 / (1 + GYRO_SMPLRT_DIV) Hz on
+ * the esp_timer clock; each sample comes from a signal source in physical
+ * units.
+ */
+
+#ifndef ICM20948_SIM_H
+#define ICM20948_SIM_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "esp_err.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief WHO_AM_I value. */
+#define ICM20948_SIM_WHO_AM_I 0xEAu
+
+/** @brief Hardware FIFO size in bytes. */
+#define ICM20948_SIM_FIFO_BYTES 512u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief One sample in physical units.
+ */
+typedef struct
+{
+    double accel_g[3];   /**< Acceleration, X Y Z, in g. */
+    double gyro_dps[3];  /**< Angular rate, X Y Z, in degrees per second. */
+    double temp_c;       /**< Die temperature in degrees Celsius. */
+} icm20948_sim_sample_t;
+
+/**
+ * @brief Signal source, called for every sample the device takes.
+ *
+ * @param[in]  p_ctx    Context given to icm20948_sim_set_source().
+ * @param[in]  time_us  esp_timer time of the sample.
+ * @param[out] p_sample Receives the sample.
+ */
+typedef void (*icm20948_sim_source_t)(void *p_ctx, int64_t time_us,
+                                      icm20948_sim_sample_t *p_sample);
+
+/**
+ * @brief Simulator counters.
+ */
+typedef struct
+{
+    uint32_t transactions;   /**< CS assertions. */
+    uint32_t reads;          /**< Register bytes read. */
+    uint32_t writes;         /**< Register bytes written. */
+    uint32_t samples;        /**< Samples taken. */
+    uint32_t fifo_overflows; /**< FIFO bytes lost because the FIFO was full. */
+} icm20948_sim_stats_t;
+
+/**
+ * @brief Simulator instance; fields are private to icm20948_sim.c.
+ */
+typedef struct
+{
+    uint8_t regs[4][128];
+    uint8_t fifo[ICM20948_SIM_FIFO_BYTES];
+    uint32_t fifoHead;
+    uint32_t fifoCount;
+    int64_t epochUs;
+    uint64_t sampleIndex;
+    uint8_t awake;
+    icm20948_sim_source_t p_source;
+    void *p_sourceCtx;
+    icm20948_sim_stats_t stats;
+} icm20948_sim_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void icm20948_sim_init(icm20948_sim_t *p_sim);
+void icm20948_sim_set_source(icm20948_sim_t *p_sim, icm20948_sim_source_t p_source, void *p_ctx);
+esp_err_t icm20948_sim_attach(icm20948_sim_t *p_sim, int cs_pin);
+void icm20948_sim_get_stats(const icm20948_sim_t *p_sim, icm20948_sim_stats_t *p_stats);
+
+#endif /* ICM20948_SIM_H */
@@ -0,0 +1,63 @@
+/**
+ * @file sd_host.h
+ * @brief Card model and counters of the host SD card stand-in.
+ *
+ * Every sector command waits, in real time, for a per-command overhead
+ * plus the transfer at the modelled read or write rate, and after every
+ * busy_every_bytes written the card adds a housekeeping pause, so timings
+ * measured around raw sector writes look like a card's. Defaults are rough
+ * figures for a card on a 20 MHz SPI bus; override them with values
+ * measured on the board. Writes through stdio on the mounted directory
+ * reach the host filesystem directly and are not modelled.
+ */
+
+#ifndef SD_HOST_H
+#define SD_HOST_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Card timing and size.
+ */
+typedef struct
+{
+    uint32_t command_us;        /**< Command, response and busy wait of one sector command. */
+    uint32_t write_bytes_per_s; /**< Sustained write rate. */
+    uint32_t read_bytes_per_s;  /**< Sustained read rate. */
+    uint32_t busy_every_bytes;  /**< Written bytes between housekeeping pauses (0 = none). */
+    uint32_t busy_us;           /**< Length of a housekeeping pause. */
+    uint64_t card_bytes;        /**< Card capacity. */
+} sd_host_timing_t;
+
+/**
+ * @brief Counters accumulated since the last sd_host_reset_stats().
+ */
+typedef struct
+{
+    uint64_t sectors_written;  /**< Sectors written with sdmmc_write_sectors(). */
+    uint64_t sectors_read;     /**< Sectors read with sdmmc_read_sectors(). */
+    uint64_t card_time_us;     /**< Modelled time spent in sector commands. */
+    uint64_t bus_time_ns;      /**< Time SCLK ran for data at the card clock. */
+    uint32_t commands;         /**< Sector commands. */
+    uint32_t busy_pauses;      /**< Housekeeping pauses. */
+    uint32_t unmapped_sectors; /**< Sectors outside every contiguous file (dropped or zero). */
+} sd_host_stats_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void sd_host_get_default_timing(sd_host_timing_t *p_timing);
+void sd_host_set_timing(const sd_host_timing_t *p_timing);
+void sd_host_get_stats(sd_host_stats_t *p_stats);
+void sd_host_reset_stats(void);
+
+#endif /* SD_HOST_H */
@@ -0,0 +1,42 @@
+/**
+ * @file sdmmc_cmd.h
+ * @brief Host stand-in for the ESP-IDF SD/MMC card protocol layer.
+ *
+ * Sector reads and writes go to the files of the mounted host volume
+ * (sd_host.h) and are charged to its card timing model.
+ */
+
+#ifndef SDMMC_CMD_H
+#define SDMMC_CMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define SDMMC_FREQ_DEFAULT 20000
+
+typedef struct
+{
+    int slot;
+    int max_freq_khz;
+} sdmmc_host_t;
+
+typedef struct
+{
+    uint32_t capacity;    /**< Card size in sectors. */
+    uint32_t sector_size; /**< Sector size in bytes. */
+} sdmmc_csd_t;
+
+typedef struct
+{
+    sdmmc_host_t host;
+    sdmmc_csd_t csd;
+    uint32_t max_freq_khz;
+} sdmmc_card_t;
+
+esp_err_t sdmmc_write_sectors(sdmmc_card_t *card, const void *src, size_t start_sector,
+                              size_t sector_count);
+esp_err_t sdmmc_read_sectors(sdmmc_card_t *card, void *dst, size_t start_sector,
+                             size_t sector_count);
+
+#endif /* SDMMC_CMD_H */
@@ -0,0 +1,94 @@
+/**
+ * @file spi_host.h
+ * @brief Timing model and counters of the host SPI master stand-in.
+ *
+ * Every transaction is charged to a virtual bus clock: a per-mode software
+ * overhead, optional scheduling jitter for interrupt transactions, bus
+ * arbitration unless the device holds the bus, and the clocked bits at the
+ * device's clock_speed_hz. Defaults are rough ESP32-S3 figures; override
+ * them with values measured on the board.
+ *
+ * A device model attached to a CS pin sees the bytes clocked out to that
+ * device and supplies the bytes clocked back; without one, received bytes
+ * read as zero.
+ */
+
+#ifndef SPI_HOST_H
+#define SPI_HOST_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Per-transaction costs in nanoseconds.
+ */
+typedef struct
+{
+    uint32_t interrupt_overhead_ns; /**< Queue, ISR and task wake-up of an interrupt transaction. */
+    uint32_t interrupt_jitter_ns;   /**< Extra 0..jitter added to each interrupt transaction. */
+    uint32_t polling_overhead_ns;   /**< Set-up and completion spin of a polling transaction. */
+    uint32_t bus_acquire_ns;        /**< Bus arbitration when the device does not hold the bus. */
+} spi_host_timing_t;
+
+/**
+ * @brief Counters accumulated since the last spi_host_reset_stats().
+ */
+typedef struct
+{
+    uint64_t bus_time_ns;            /**< Virtual time spent in transactions, overheads included. */
+    uint64_t clocked_ns;             /**< Time SCLK was running (bus occupancy). */
+    uint64_t bytes;                  /**< Bytes clocked. */
+    uint32_t transactions;           /**< All transactions. */
+    uint32_t interrupt_transactions; /**< Transactions started with spi_device_queue_trans(). */
+    uint32_t polling_transactions;   /**< Transactions run with spi_device_polling_transmit(). */
+    uint32_t bus_acquisitions;       /**< Successful spi_device_acquire_bus() calls. */
+} spi_host_stats_t;
+
+/**
+ * @brief Counters of one device model, accumulated since it was attached.
+ */
+typedef struct
+{
+    uint64_t bytes;        /**< Bytes clocked with the device selected. */
+    uint64_t clocked_ns;   /**< Time SCLK ran for the device. */
+    uint32_t transactions; /**< Transactions addressed to the device (one CS assertion each). */
+} spi_host_device_stats_t;
+
+/**
+ * @brief Device model: one CS assertion of length bytes.
+ *
+ * Called with the bus lock held, so one model never sees overlapping
+ * transactions. p_tx and p_rx do not alias.
+ *
+ * @param[in]  p_ctx  Context given to spi_host_attach_device().
+ * @param[in]  p_tx   Bytes from the master.
+ * @param[out] p_rx   Bytes to the master, zeroed beforehand.
+ * @param[in]  length Bytes in the transaction.
+ */
+typedef void (*spi_host_device_fn_t)(void *p_ctx, const uint8_t *p_tx, uint8_t *p_rx,
+                                     size_t length);
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void spi_host_get_default_timing(spi_host_timing_t *p_timing);
+void spi_host_set_timing(const spi_host_timing_t *p_timing);
+void spi_host_get_stats(spi_host_stats_t *p_stats);
+void spi_host_reset_stats(void);
+uint64_t spi_host_last_transaction_ns(void);
+
+esp_err_t spi_host_attach_device(int cs_pin, spi_host_device_fn_t p_fn, void *p_ctx);
+void spi_host_detach_device(int cs_pin);
+esp_err_t spi_host_get_device_stats(int cs_pin, spi_host_device_stats_t *p_stats);
+
+#endif /* SPI_HOST_H */
@@ -0,0 +1,583 @@
+/**
+ * @file sd_host.c
+ * @brief Host stand-ins for the ESP-IDF SDSPI mount, FAT VFS, FatFs lookup
+ *        and SD sector commands.
+ *
+ * The mounted volume is a host directory. Files created with
+ * esp_vfs_fat_create_contiguous_file() are given consecutive cluster runs
+ * on a simulated card and recorded in a table; f_open() reports those
+ * clusters, and sector commands translate card sectors back to a file and
+ * offset and read or write the host file there. The cluster layout lives
+ * only as long as the mount, so a file left by an earlier run is not known
+ * to be contiguous and gets reallocated. Card timing comes from sd_host.h.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "diskio_sdmmc.h"
+#include "esp_vfs_fat.h"
+#include "ff.h"
+#include "sd_host.h"
+#include "sdmmc_cmd.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_SECTOR_BYTES 512u
+
+/** @brief Contiguous files a mount can track. */
+#define K_MAX_FILES 8
+
+/** @brief Longest path handled. */
+#define K_PATH_BYTES 128u
+
+/** @brief First sector of the data area (after boot sector and FATs). */
+#define K_DATA_START_SECTOR 8192u
+
+/** @brief First data cluster number in FAT. */
+#define K_FIRST_CLUSTER 2u
+
+/** @brief Cluster size used when the mount leaves allocation_unit_size at 0. */
+#define K_DEFAULT_CLUSTER_BYTES 16384u
+
+/** @brief Highest card clock in SPI mode, in kHz. */
+#define K_MAX_FREQ_KHZ 25000
+
+/** @brief Default card model, see sd_host_timing_t. */
+#define K_DEFAULT_COMMAND_US 250u
+#define K_DEFAULT_WRITE_BPS 1800000u
+#define K_DEFAULT_READ_BPS 2200000u
+#define K_DEFAULT_BUSY_EVERY (4u * 1024u * 1024u)
+#define K_DEFAULT_BUSY_US 40000u
+#define K_DEFAULT_CARD_BYTES (8ull * 1024u * 1024u * 1024u)
+
+/** @brief Physical drive number of the mounted card. */
+#define K_PDRV 0u
+
+/** @brief ff_diskio_get_pdrv_card() result for an unknown card. */
+#define K_NO_PDRV 0xFFu
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief A contiguous file on the simulated card.
+ */
+typedef struct
+{
+    char path[K_PATH_BYTES]; /**< Host path, under the base path. */
+    uint32_t firstCluster;
+    uint32_t clusters;
+    uint64_t bytes;
+    uint8_t used;
+} SdHostFile_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static sdmmc_card_t s_card;
+static FATFS s_fs;
+static uint8_t s_mounted = 0;
+static char s_basePath[K_PATH_BYTES];
+static SdHostFile_t s_files[K_MAX_FILES];
+static uint32_t s_nextCluster = K_FIRST_CLUSTER;
+
+static sd_host_timing_t s_timing = {
+    .command_us = K_DEFAULT_COMMAND_US,
+    .write_bytes_per_s = K_DEFAULT_WRITE_BPS,
+    .read_bytes_per_s = K_DEFAULT_READ_BPS,
+    .busy_every_bytes = K_DEFAULT_BUSY_EVERY,
+    .busy_us = K_DEFAULT_BUSY_US,
+    .card_bytes = K_DEFAULT_CARD_BYTES,
+};
+
+static sd_host_stats_t s_stats;
+
+/** @brief Bytes written since the last housekeeping pause. */
+static uint64_t s_sinceBusy = 0;
+
+/** @brief Serialises card commands and the file table, like the SPI bus lock. */
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static void sd_host_sleep_us(uint64_t us)
+{
+    struct timespec ts = {(time_t)(us / 1000000u), (long)((us % 1000000u) * 1000u)};
+    while (nanosleep(&ts, &ts) != 0)
+    {
+    }
+}
+
+/**
+ * @brief Wait for one sector command and count it. Call with s_lock held.
+ */
+static void sd_host_charge(uint64_t bytes, int write)
+{
+    uint32_t rate = write ? s_timing.write_bytes_per_s : s_timing.read_bytes_per_s;
+    uint64_t us = s_timing.command_us;
+
+    if (rate != 0u)
+    {
+        us += bytes * 1000000u / rate;
+    }
+    if (write && s_timing.busy_every_bytes != 0u)
+    {
+        s_sinceBusy += bytes;
+        while (s_sinceBusy >= s_timing.busy_every_bytes)
+        {
+            s_sinceBusy -= s_timing.busy_every_bytes;
+            us += s_timing.busy_us;
+            s_stats.busy_pauses += 1;
+        }
+    }
+
+    s_stats.commands += 1;
+    s_stats.card_time_us += us;
+    s_stats.bus_time_ns += bytes * 8u * 1000000u / (uint64_t)s_card.max_freq_khz;
+    sd_host_sleep_us(us);
+}
+
+static uint32_t sd_host_cluster_bytes(void)
+{
+    return (uint32_t)s_fs.csize * K_SECTOR_BYTES;
+}
+
+/**
+ * @brief Find a tracked file by host path. Call with s_lock held.
+ */
+static SdHostFile_t *sd_host_find_path(const char *p_path)
+{
+    for (int i = 0; i < K_MAX_FILES; i++)
+    {
+        if (s_files[i].used != 0u && strcmp(s_files[i].path, p_path) == 0)
+            return &s_files[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find the tracked file holding a card sector. Call with s_lock held.
+ *
+ * @param[in]  sector   Card sector.
+ * @param[out] p_offset Receives the byte offset in the file.
+ * @return The file, or NULL if the sector belongs to none.
+ */
+static SdHostFile_t *sd_host_find_sector(uint64_t sector, uint64_t *p_offset)
+{
+    if (sector < s_fs.database)
+        return NULL;
+
+    uint64_t cluster = (sector - s_fs.database) / s_fs.csize + K_FIRST_CLUSTER;
+    for (int i = 0; i < K_MAX_FILES; i++)
+    {
+        SdHostFile_t *p_file = &s_files[i];
+        if (p_file->used != 0u && cluster >= p_file->firstCluster &&
+            cluster < (uint64_t)p_file->firstCluster + p_file->clusters)
+        {
+            uint64_t first = s_fs.database + (uint64_t)(p_file->firstCluster - K_FIRST_CLUSTER) * s_fs.csize;
+            *p_offset = (sector - first) * K_SECTOR_BYTES;
+            return p_file;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Move sectors between the card and the files that own them.
+ *        Call with s_lock held.
+ *
+ * @return ESP_OK, or ESP_FAIL if a host file could not be accessed.
+ */
+static esp_err_t sd_host_transfer(uint8_t *p_data, size_t start_sector, size_t sector_count,
+                                  int write)
+{
+    for (size_t i = 0; i < sector_count; i++)
+    {
+        uint8_t *p_sector = &p_data[i * K_SECTOR_BYTES];
+        uint64_t offset = 0;
+        SdHostFile_t *p_file = sd_host_find_sector(start_sector + i, &offset);
+        if (p_file == NULL || offset >= p_file->bytes)
+        {
+            s_stats.unmapped_sectors += 1;
+            if (!write)
+            {
+                memset(p_sector, 0, K_SECTOR_BYTES);
+            }
+            continue;
+        }
+
+        /* Runs of sectors in the same file go in one call */
+        size_t run = 1;
+        while (i + run < sector_count && offset + (uint64_t)run * K_SECTOR_BYTES < p_file->bytes)
+        {
+            uint64_t nextOffset = 0;
+            if (sd_host_find_sector(start_sector + i + run, &nextOffset) != p_file)
+                break;
+            run += 1;
+        }
+
+        int fd = open(p_file->path, write ? O_WRONLY : O_RDONLY);
+        if (fd < 0)
+            return ESP_FAIL;
+        size_t bytes = run * K_SECTOR_BYTES;
+        ssize_t done = write ? pwrite(fd, p_sector, bytes, (off_t)offset)
+                             : pread(fd, p_sector, bytes, (off_t)offset);
+        close(fd);
+        if (done < 0)
+            return ESP_FAIL;
+        if (!write && (size_t)done < bytes)
+        {
+            memset(&p_sector[done], 0, bytes - (size_t)done);
+        }
+        i += run - 1u;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Check that full_path lies under the mounted base path.
+ */
+static bool sd_host_under_base(const char *p_base, const char *p_full)
+{
+    size_t len = strlen(p_base);
+    return s_mounted != 0u && strcmp(p_base, s_basePath) == 0 &&
+           strncmp(p_full, p_base, len) == 0 && p_full[len] == '/';
+}
+
+/* ============================================================================
+ * Public Functions — Driver Stand-In
+ * ========================================================================= */
+
+esp_err_t esp_vfs_fat_sdspi_mount(const char *base_path, const sdmmc_host_t *host_config_input,
+                                  const sdspi_device_config_t *slot_config,
+                                  const esp_vfs_fat_mount_config_t *mount_config,
+                                  sdmmc_card_t **out_card)
+{
+    struct stat st;
+
+    if (base_path == NULL || host_config_input == NULL || slot_config == NULL ||
+        mount_config == NULL || out_card == NULL || strlen(base_path) >= K_PATH_BYTES ||
+        host_config_input->max_freq_khz <= 0)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    if (s_mounted != 0u)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* A missing directory is an unformatted card */
+    if (stat(base_path, &st) != 0)
+    {
+        if (!mount_config->format_if_mount_failed || mkdir(base_path, 0755) != 0)
+        {
+            pthread_mutex_unlock(&s_lock);
+            return ESP_FAIL;
+        }
+    }
+    else if (!S_ISDIR(st.st_mode))
+    {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_FAIL;
+    }
+
+    size_t clusterBytes = (mount_config->allocation_unit_size >= K_SECTOR_BYTES)
+                              ? mount_config->allocation_unit_size
+                              : K_DEFAULT_CLUSTER_BYTES;
+    memset(&s_fs, 0, sizeof(s_fs));
+    s_fs.pdrv = K_PDRV;
+    s_fs.csize = (WORD)(clusterBytes / K_SECTOR_BYTES);
+    s_fs.database = K_DATA_START_SECTOR;
+    s_fs.n_fatent =
+        (DWORD)((s_timing.card_bytes / K_SECTOR_BYTES - K_DATA_START_SECTOR) / s_fs.csize) +
+        K_FIRST_CLUSTER;
+
+    memset(&s_card, 0, sizeof(s_card));
+    s_card.host = *host_config_input;
+    s_card.csd.capacity = (uint32_t)(s_timing.card_bytes / K_SECTOR_BYTES);
+    s_card.csd.sector_size = K_SECTOR_BYTES;
+    s_card.max_freq_khz = (uint32_t)((host_config_input->max_freq_khz < K_MAX_FREQ_KHZ)
+                                         ? host_config_input->max_freq_khz
+                                         : K_MAX_FREQ_KHZ);
+
+    memset(s_files, 0, sizeof(s_files));
+    s_nextCluster = K_FIRST_CLUSTER;
+    snprintf(s_basePath, sizeof(s_basePath), "%s", base_path);
+    s_mounted = 1;
+    *out_card = &s_card;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_fat_sdcard_unmount(const char *base_path, sdmmc_card_t *card)
+{
+    if (base_path == NULL || card == NULL)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_mounted != 0u && card == &s_card && strcmp(base_path, s_basePath) == 0)
+    {
+        s_mounted = 0;
+        memset(s_files, 0, sizeof(s_files));
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t esp_vfs_fat_create_contiguous_file(const char *base_path, const char *full_path,
+                                             uint64_t size, bool alloc_now)
+{
+    (void)alloc_now; /* Host files are sized at once either way */
+
+    if (base_path == NULL || full_path == NULL || size == 0u || strlen(full_path) >= K_PATH_BYTES)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    if (!sd_host_under_base(base_path, full_path))
+    {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint64_t clusters = (size + sd_host_cluster_bytes() - 1u) / sd_host_cluster_bytes();
+    SdHostFile_t *p_slot = sd_host_find_path(full_path);
+    for (int i = 0; p_slot == NULL && i < K_MAX_FILES; i++)
+    {
+        if (s_files[i].used == 0u)
+        {
+            p_slot = &s_files[i];
+        }
+    }
+    if (p_slot == NULL || s_nextCluster + clusters > s_fs.n_fatent)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int fd = open(full_path, O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd < 0)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_FAIL;
+    }
+    int err = ftruncate(fd, (off_t)size);
+    close(fd);
+    if (err != 0)
+    {
+        unlink(full_path);
+        pthread_mutex_unlock(&s_lock);
+        return ESP_FAIL;
+    }
+
+    memset(p_slot, 0, sizeof(*p_slot));
+    snprintf(p_slot->path, sizeof(p_slot->path), "%s", full_path);
+    p_slot->firstCluster = s_nextCluster;
+    p_slot->clusters = (uint32_t)clusters;
+    p_slot->bytes = size;
+    p_slot->used = 1;
+    s_nextCluster += (uint32_t)clusters;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_vfs_fat_test_contiguous_file(const char *base_path, const char *full_path,
+                                           bool *is_contiguous)
+{
+    struct stat st;
+
+    if (base_path == NULL || full_path == NULL || is_contiguous == NULL)
+        return ESP_ERR_INVALID_ARG;
+    if (stat(full_path, &st) != 0)
+        return ESP_FAIL;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (sd_host_under_base(base_path, full_path))
+    {
+        const SdHostFile_t *p_file = sd_host_find_path(full_path);
+        /* Files written through stdio have no known layout: treat as fragmented */
+        *is_contiguous = (p_file != NULL && (uint64_t)st.st_size <= p_file->bytes);
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+BYTE ff_diskio_get_pdrv_card(const sdmmc_card_t *card)
+{
+    return (s_mounted != 0u && card == &s_card) ? (BYTE)K_PDRV : (BYTE)K_NO_PDRV;
+}
+
+FRESULT f_open(FIL *fp, const char *path, BYTE mode)
+{
+    char hostPath[K_PATH_BYTES];
+    struct stat st;
+
+    (void)mode;
+    if (fp == NULL || path == NULL)
+        return FR_INVALID_OBJECT;
+
+    /* "<pdrv>:/name" */
+    char *p_end = NULL;
+    unsigned long pdrv = strtoul(path, &p_end, 10);
+    if (p_end == path || p_end[0] != ':' || pdrv != K_PDRV)
+        return FR_INVALID_DRIVE;
+    const char *p_name = p_end + 1;
+    while (*p_name == '/')
+    {
+        p_name++;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (s_mounted == 0u)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return FR_NOT_READY;
+    }
+    int len = snprintf(hostPath, sizeof(hostPath), "%s/%s", s_basePath, p_name);
+    if (len < 0 || (size_t)len >= sizeof(hostPath))
+    {
+        pthread_mutex_unlock(&s_lock);
+        return FR_INVALID_NAME;
+    }
+    if (stat(hostPath, &st) != 0)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return FR_NO_FILE;
+    }
+
+    const SdHostFile_t *p_file = sd_host_find_path(hostPath);
+    memset(fp, 0, sizeof(*fp));
+    fp->obj.fs = &s_fs;
+    fp->obj.sclust = (p_file != NULL) ? p_file->firstCluster : 0u;
+    fp->obj.objsize = (FSIZE_t)st.st_size;
+    pthread_mutex_unlock(&s_lock);
+    return FR_OK;
+}
+
+FRESULT f_close(FIL *fp)
+{
+    if (fp == NULL || fp->obj.fs == NULL)
+        return FR_INVALID_OBJECT;
+    fp->obj.fs = NULL;
+    return FR_OK;
+}
+
+esp_err_t sdmmc_write_sectors(sdmmc_card_t *card, const void *src, size_t start_sector,
+                              size_t sector_count)
+{
+    if (card == NULL || src == NULL || sector_count == 0u)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_mounted != 0u && card == &s_card)
+    {
+        ret = ESP_ERR_INVALID_SIZE;
+        if ((uint64_t)start_sector + sector_count <= card->csd.capacity)
+        {
+            sd_host_charge((uint64_t)sector_count * K_SECTOR_BYTES, 1);
+            ret = sd_host_transfer((uint8_t *)src, start_sector, sector_count, 1);
+            s_stats.sectors_written += sector_count;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t sdmmc_read_sectors(sdmmc_card_t *card, void *dst, size_t start_sector,
+                             size_t sector_count)
+{
+    if (card == NULL || dst == NULL || sector_count == 0u)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_mounted != 0u && card == &s_card)
+    {
+        ret = ESP_ERR_INVALID_SIZE;
+        if ((uint64_t)start_sector + sector_count <= card->csd.capacity)
+        {
+            sd_host_charge((uint64_t)sector_count * K_SECTOR_BYTES, 0);
+            ret = sd_host_transfer((uint8_t *)dst, start_sector, sector_count, 0);
+            s_stats.sectors_read += sector_count;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+/* ============================================================================
+ * Public Functions — Card Model
+ * ========================================================================= */
+
+/**
+ * @brief Get the built-in card model.
+ *
+ * @param[out] p_timing Receives the defaults.
+ */
+void sd_host_get_default_timing(sd_host_timing_t *p_timing)
+{
+    p_timing->command_us = K_DEFAULT_COMMAND_US;
+    p_timing->write_bytes_per_s = K_DEFAULT_WRITE_BPS;
+    p_timing->read_bytes_per_s = K_DEFAULT_READ_BPS;
+    p_timing->busy_every_bytes = K_DEFAULT_BUSY_EVERY;
+    p_timing->busy_us = K_DEFAULT_BUSY_US;
+    p_timing->card_bytes = K_DEFAULT_CARD_BYTES;
+}
+
+/**
+ * @brief Replace the card model. The capacity applies from the next mount.
+ *
+ * @param[in] p_timing New card model.
+ */
+void sd_host_set_timing(const sd_host_timing_t *p_timing)
+{
+    pthread_mutex_lock(&s_lock);
+    s_timing = *p_timing;
+    s_sinceBusy = 0;
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Read the counters.
+ *
+ * @param[out] p_stats Receives the counters.
+ */
+void sd_host_get_stats(sd_host_stats_t *p_stats)
+{
+    pthread_mutex_lock(&s_lock);
+    *p_stats = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Clear the counters.
+ */
+void sd_host_reset_stats(void)
+{
+    pthread_mutex_lock(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    pthread_mutex_unlock(&s_lock);
+}
@@ -0,0 +1,574 @@
+/**
+ * @file spi_master_host.c
+ * @brief Host stand-in for the ESP-IDF SPI master driver.
+ *
+ * Keeps the driver's contract where the HAL relies on it: devices per bus,
+ * per-device result queues of queue_size entries returned in order,
+ * pre/post callbacks, exclusive bus acquisition, and polling transactions.
+ * Data is exchanged with the device model attached to the device's
+ * spics_io_num (e.g. the sensor simulators); with no model, transmitted
+ * bytes are dropped and received bytes read as zero. Costs go to a virtual
+ * clock (spi_host.h).
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include "driver/spi_master.h"
+#include "spi_host.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Devices per bus (hardware CS lines of SPI2 on the ESP32-S3). */
+#define K_MAX_DEVICES 6
+
+/** @brief Largest queue_size accepted. */
+#define K_MAX_QUEUE 32
+
+/** @brief Device models that can be attached at once. */
+#define K_MAX_MODELS 8
+
+/** @brief Longest transaction passed to a device model, in bytes. */
+#define K_MODEL_MAX_BYTES 4096u
+
+/** @brief Default timing model, see spi_host_timing_t. */
+#define K_DEFAULT_INTERRUPT_OVERHEAD_NS 18000u
+#define K_DEFAULT_INTERRUPT_JITTER_NS 12000u
+#define K_DEFAULT_POLLING_OVERHEAD_NS 3000u
+#define K_DEFAULT_BUS_ACQUIRE_NS 1500u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Simulated device slot.
+ */
+struct spi_device_t
+{
+    spi_device_interface_config_t cfg;
+    spi_transaction_t *p_done[K_MAX_QUEUE];
+    uint32_t doneHead;
+    uint32_t doneCount;
+    uint8_t used;
+};
+
+/**
+ * @brief Device model attached to a CS pin.
+ */
+typedef struct
+{
+    int csPin;
+    spi_host_device_fn_t p_fn;
+    void *p_ctx;
+    spi_host_device_stats_t stats;
+} SpiHostModel_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static struct spi_device_t s_devices[K_MAX_DEVICES];
+static uint8_t s_busReady = 0;
+static spi_device_handle_t s_busOwner = NULL;
+
+static spi_host_timing_t s_timing = {
+    .interrupt_overhead_ns = K_DEFAULT_INTERRUPT_OVERHEAD_NS,
+    .interrupt_jitter_ns = K_DEFAULT_INTERRUPT_JITTER_NS,
+    .polling_overhead_ns = K_DEFAULT_POLLING_OVERHEAD_NS,
+    .bus_acquire_ns = K_DEFAULT_BUS_ACQUIRE_NS,
+};
+
+static spi_host_stats_t s_stats;
+static uint64_t s_lastTransactionNs = 0;
+static uint32_t s_jitterState = 0x2545F491u;
+
+static SpiHostModel_t s_models[K_MAX_MODELS];
+
+/** @brief Bytes exchanged with a model; tx and rx buffers of a transaction may alias. */
+static uint8_t s_modelTx[K_MODEL_MAX_BYTES];
+static uint8_t s_modelRx[K_MODEL_MAX_BYTES];
+
+/** @brief Serialises the driver state across POSIX OSAL tasks. */
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Deterministic pseudo-random jitter in [0, interrupt_jitter_ns].
+ */
+static uint32_t spi_host_jitter(void)
+{
+    if (s_timing.interrupt_jitter_ns == 0u)
+        return 0u;
+
+    s_jitterState ^= s_jitterState << 13;
+    s_jitterState ^= s_jitterState >> 17;
+    s_jitterState ^= s_jitterState << 5;
+    return s_jitterState % (s_timing.interrupt_jitter_ns + 1u);
+}
+
+/**
+ * @brief Find the model attached to a CS pin. Call with s_lock held.
+ *
+ * @param[in] cs_pin Chip select GPIO.
+ * @return The model, or NULL if none is attached.
+ */
+static SpiHostModel_t *spi_host_find_model(int cs_pin)
+{
+    for (int i = 0; i < K_MAX_MODELS; i++)
+    {
+        if (s_models[i].p_fn != NULL && s_models[i].csPin == cs_pin)
+            return &s_models[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run a transaction and charge its cost. Call with s_lock held.
+ *
+ * @param[in] dev         Device.
+ * @param[in] p_trans     Transaction.
+ * @param[in] overheadNs  Mode-specific software overhead.
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if another device holds the bus.
+ */
+static esp_err_t spi_host_run(spi_device_handle_t dev, spi_transaction_t *p_trans,
+                              uint32_t overheadNs)
+{
+    if (s_busOwner != NULL && s_busOwner != dev)
+        return ESP_ERR_INVALID_STATE;
+
+    size_t bytes = (p_trans->length + 7u) / 8u;
+    size_t rxBytes = (p_trans->rxlength != 0u) ? (p_trans->rxlength + 7u) / 8u : bytes;
+    uint8_t *p_rx = (p_trans->flags & SPI_TRANS_USE_RXDATA) ? p_trans->rx_data
+                                                             : (uint8_t *)p_trans->rx_buffer;
+    const uint8_t *p_tx = (p_trans->flags & SPI_TRANS_USE_TXDATA)
+                              ? p_trans->tx_data
+                              : (const uint8_t *)p_trans->tx_buffer;
+    if (p_trans->flags & SPI_TRANS_USE_RXDATA)
+    {
+        rxBytes = sizeof(p_trans->rx_data);
+    }
+
+    SpiHostModel_t *p_model = spi_host_find_model(dev->cfg.spics_io_num);
+    size_t modelBytes = (bytes < K_MODEL_MAX_BYTES) ? bytes : K_MODEL_MAX_BYTES;
+    if (p_model != NULL)
+    {
+        if (p_tx != NULL)
+        {
+            memcpy(s_modelTx, p_tx, modelBytes);
+        }
+        else
+        {
+            memset(s_modelTx, 0, modelBytes);
+        }
+    }
+
+    if (p_rx != NULL)
+    {
+        memset(p_rx, 0, rxBytes);
+    }
+
+    if (p_model != NULL)
+    {
+        memset(s_modelRx, 0, modelBytes);
+        p_model->p_fn(p_model->p_ctx, s_modelTx, s_modelRx, modelBytes);
+        if (p_rx != NULL)
+        {
+            memcpy(p_rx, s_modelRx, (rxBytes < modelBytes) ? rxBytes : modelBytes);
+        }
+    }
+
+    uint64_t clockedNs =
+        ((uint64_t)p_trans->length * 1000000000ull) / (uint64_t)dev->cfg.clock_speed_hz;
+    uint64_t costNs = overheadNs + clockedNs;
+    if (s_busOwner != dev)
+    {
+        costNs += s_timing.bus_acquire_ns;
+    }
+
+    s_stats.bus_time_ns += costNs;
+    s_stats.clocked_ns += clockedNs;
+    s_stats.bytes += bytes;
+    s_stats.transactions += 1;
+    s_lastTransactionNs = costNs;
+    if (p_model != NULL)
+    {
+        p_model->stats.bytes += bytes;
+        p_model->stats.clocked_ns += clockedNs;
+        p_model->stats.transactions += 1;
+    }
+    return ESP_OK;
+}
+
+/* ============================================================================
+ * Public Functions — Driver Stand-In
+ * ========================================================================= */
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config,
+                             int dma_chan)
+{
+    (void)host_id;
+    (void)dma_chan;
+
+    if (bus_config == NULL)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = (s_busReady != 0u) ? ESP_ERR_INVALID_STATE : ESP_OK;
+    s_busReady = 1;
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    (void)host_id;
+
+    pthread_mutex_lock(&s_lock);
+    for (int i = 0; i < K_MAX_DEVICES; i++)
+    {
+        if (s_devices[i].used != 0u)
+        {
+            pthread_mutex_unlock(&s_lock);
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    s_busReady = 0;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle)
+{
+    (void)host_id;
+
+    if (dev_config == NULL || handle == NULL || dev_config->clock_speed_hz <= 0 ||
+        dev_config->queue_size <= 0 || dev_config->queue_size > K_MAX_QUEUE)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    if (s_busReady == 0u)
+    {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    else
+    {
+        for (int i = 0; i < K_MAX_DEVICES; i++)
+        {
+            if (s_devices[i].used == 0u)
+            {
+                memset(&s_devices[i], 0, sizeof(s_devices[i]));
+                s_devices[i].cfg = *dev_config;
+                s_devices[i].used = 1;
+                *handle = &s_devices[i];
+                ret = ESP_OK;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    if (handle == NULL)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_OK;
+    if (handle->doneCount != 0u || s_busOwner == handle)
+    {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    else
+    {
+        handle->used = 0;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans_desc,
+                                 TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+
+    if (handle == NULL || trans_desc == NULL || trans_desc->length == 0u)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    if (handle->doneCount >= (uint32_t)handle->cfg.queue_size)
+    {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t ret =
+        spi_host_run(handle, trans_desc, s_timing.interrupt_overhead_ns + spi_host_jitter());
+    if (ret == ESP_OK)
+    {
+        uint32_t tail = (handle->doneHead + handle->doneCount) % K_MAX_QUEUE;
+        handle->p_done[tail] = trans_desc;
+        handle->doneCount += 1;
+        s_stats.interrupt_transactions += 1;
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    if (ret == ESP_OK)
+    {
+        if (handle->cfg.pre_cb != NULL)
+            handle->cfg.pre_cb(trans_desc);
+        if (handle->cfg.post_cb != NULL)
+            handle->cfg.post_cb(trans_desc);
+    }
+    return ret;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans_desc,
+                                      TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+
+    if (handle == NULL || trans_desc == NULL)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_TIMEOUT;
+    if (handle->doneCount != 0u)
+    {
+        *trans_desc = handle->p_done[handle->doneHead];
+        handle->doneHead = (handle->doneHead + 1u) % K_MAX_QUEUE;
+        handle->doneCount -= 1;
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+esp_err_t spi_device_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc)
+{
+    spi_transaction_t *p_done = NULL;
+
+    esp_err_t ret = spi_device_queue_trans(handle, trans_desc, portMAX_DELAY);
+    if (ret != ESP_OK)
+        return ret;
+
+    ret = spi_device_get_trans_result(handle, &p_done, portMAX_DELAY);
+    if (ret == ESP_OK && p_done != trans_desc)
+        return ESP_ERR_INVALID_STATE;
+    return ret;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans_desc)
+{
+    if (handle == NULL || trans_desc == NULL || trans_desc->length == 0u)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (handle->doneCount == 0u)
+    {
+        ret = spi_host_run(handle, trans_desc, s_timing.polling_overhead_ns);
+        if (ret == ESP_OK)
+        {
+            s_stats.polling_transactions += 1;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    if (ret == ESP_OK)
+    {
+        if (handle->cfg.pre_cb != NULL)
+            handle->cfg.pre_cb(trans_desc);
+        if (handle->cfg.post_cb != NULL)
+            handle->cfg.post_cb(trans_desc);
+    }
+    return ret;
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t device, TickType_t wait)
+{
+    if (device == NULL || wait != portMAX_DELAY)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_busOwner == NULL)
+    {
+        s_busOwner = device;
+        s_stats.bus_acquisitions += 1;
+        s_stats.bus_time_ns += s_timing.bus_acquire_ns;
+        ret = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ret;
+}
+
+void spi_device_release_bus(spi_device_handle_t dev)
+{
+    pthread_mutex_lock(&s_lock);
+    if (s_busOwner == dev)
+    {
+        s_busOwner = NULL;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+/* ============================================================================
+ * Public Functions — Timing Model
+ * ========================================================================= */
+
+/**
+ * @brief Get the built-in timing model.
+ *
+ * @param[out] p_timing Receives the defaults.
+ */
+void spi_host_get_default_timing(spi_host_timing_t *p_timing)
+{
+    p_timing->interrupt_overhead_ns = K_DEFAULT_INTERRUPT_OVERHEAD_NS;
+    p_timing->interrupt_jitter_ns = K_DEFAULT_INTERRUPT_JITTER_NS;
+    p_timing->polling_overhead_ns = K_DEFAULT_POLLING_OVERHEAD_NS;
+    p_timing->bus_acquire_ns = K_DEFAULT_BUS_ACQUIRE_NS;
+}
+
+/**
+ * @brief Replace the timing model.
+ *
+ * @param[in] p_timing New per-transaction costs.
+ */
+void spi_host_set_timing(const spi_host_timing_t *p_timing)
+{
+    pthread_mutex_lock(&s_lock);
+    s_timing = *p_timing;
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Read the counters.
+ *
+ * @param[out] p_stats Receives the counters.
+ */
+void spi_host_get_stats(spi_host_stats_t *p_stats)
+{
+    pthread_mutex_lock(&s_lock);
+    *p_stats = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Clear the counters.
+ */
+void spi_host_reset_stats(void)
+{
+    pthread_mutex_lock(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_lastTransactionNs = 0;
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Cost of the most recent transaction.
+ *
+ * @return Virtual nanoseconds charged to the last transaction.
+ */
+uint64_t spi_host_last_transaction_ns(void)
+{
+    pthread_mutex_lock(&s_lock);
+    uint64_t ns = s_lastTransactionNs;
+    pthread_mutex_unlock(&s_lock);
+    return ns;
+}
+
+/* ============================================================================
+ * Public Functions — Device Models
+ * ========================================================================= */
+
+/**
+ * @brief Connect a device model to a CS pin.
+ *
+ * Replaces any model on the same pin and clears its counters. Devices
+ * added to the bus with this spics_io_num exchange data with the model.
+ *
+ * @param[in] cs_pin Chip select GPIO.
+ * @param[in] p_fn   Model function.
+ * @param[in] p_ctx  Passed to p_fn.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if p_fn is NULL, ESP_ERR_NO_MEM if
+ *         every model slot is taken.
+ */
+esp_err_t spi_host_attach_device(int cs_pin, spi_host_device_fn_t p_fn, void *p_ctx)
+{
+    if (p_fn == NULL)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    SpiHostModel_t *p_model = spi_host_find_model(cs_pin);
+    for (int i = 0; p_model == NULL && i < K_MAX_MODELS; i++)
+    {
+        if (s_models[i].p_fn == NULL)
+        {
+            p_model = &s_models[i];
+        }
+    }
+    if (p_model != NULL)
+    {
+        memset(p_model, 0, sizeof(*p_model));
+        p_model->csPin = cs_pin;
+        p_model->p_fn = p_fn;
+        p_model->p_ctx = p_ctx;
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return (p_model != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+/**
+ * @brief Disconnect the device model on a CS pin, if any.
+ *
+ * @param[in] cs_pin Chip select GPIO.
+ */
+void spi_host_detach_device(int cs_pin)
+{
+    pthread_mutex_lock(&s_lock);
+    SpiHostModel_t *p_model = spi_host_find_model(cs_pin);
+    if (p_model != NULL)
+    {
+        p_model->p_fn = NULL;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief Read the counters of the device model on a CS pin.
+ *
+ * @param[in]  cs_pin  Chip select GPIO.
+ * @param[out] p_stats Receives the counters.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if p_stats is NULL, ESP_ERR_NOT_FOUND
+ *         if no model is attached to cs_pin.
+ */
+esp_err_t spi_host_get_device_stats(int cs_pin, spi_host_device_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+        return ESP_ERR_INVALID_ARG;
+
+    pthread_mutex_lock(&s_lock);
+    SpiHostModel_t *p_model = spi_host_find_model(cs_pin);
+    if (p_model != NULL)
+    {
+        *p_stats = p_model->stats;
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    return (p_model != NULL) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file acquisition.h
+ * @brief Data-ready driven sensor acquisition engine for the ESP32 HAL.
+ *
+ * A sensor's data-ready (DRDY) line raises a GPIO interrupt; a dedicated
+ * task woken by it (through a direct task notification where the OSAL
+ * offers one, an event group otherwise) reads the output registers in one SPI burst and pushes
+ * a timestamped sample into a lock-free ring drained by the consumer.
+ * Samples carry the time of the DRDY edge, so consumer scheduling jitter
+ * does not leak into the data.
+ */
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "spp/hal/gpio/gpio.h"
+#include "gpio_esp32.h"
+#include "spsc.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Largest register block one sample can hold. */
+#define SPP_ACQ_SAMPLE_MAX_BYTES 32u
+
+/** @brief Samples buffered between the acquisition task and the consumer (power of two). */
+#ifndef SPP_ACQ_RING_DEPTH
+#define SPP_ACQ_RING_DEPTH 16u
+#endif
+
+/** @brief Acquisition task stack depth used when the config leaves it at 0. */
+#define SPP_ACQ_DEFAULT_STACK_DEPTH 4096u
+
+/** @brief Acquisition task priority used when the config leaves it at 0. */
+#define SPP_ACQ_DEFAULT_PRIORITY 10u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief What to read and when.
+ */
+typedef struct
+{
+    void *spi_handler;           /**< Device handler from SPP_HAL_SPI_GetHandler(). */
+    spp_uint32_t drdy_pin;       /**< GPIO wired to the sensor's DRDY output. */
+    spp_uint32_t drdy_intr_type; /**< Edge to trigger on (gpio_int_type_t value). */
+    spp_uint32_t drdy_pull;      /**< 0 = none, 1 = pull-up, 2 = pull-down. */
+    spp_uint8_t start_reg;       /**< First register of the burst. */
+    spp_uint8_t length;          /**< Bytes per sample, 1 .. SPP_ACQ_SAMPLE_MAX_BYTES. */
+    spp_uint32_t task_priority;  /**< Acquisition task priority (0 = default). */
+    spp_uint32_t task_stack;     /**< Acquisition task stack depth (0 = default). */
+} spp_acq_config_t;
+
+/**
+ * @brief One sample as delivered to the consumer.
+ */
+typedef struct
+{
+    int64_t capture_us;                    /**< DRDY edge time (esp_timer). */
+    int64_t read_us;                       /**< Time the burst read completed. */
+    spp_uint32_t seq;                      /**< DRDY edge count; gaps mean missed edges. */
+    spp_uint8_t length;                    /**< Valid bytes in data. */
+    spp_uint8_t data[SPP_ACQ_SAMPLE_MAX_BYTES]; /**< Raw register block. */
+} spp_acq_sample_t;
+
+/**
+ * @brief Engine counters. Latencies are in microseconds.
+ */
+typedef struct
+{
+    spp_uint32_t samples;        /**< Samples pushed into the ring. */
+    spp_uint32_t dropped;        /**< Samples read but discarded because the ring was full. */
+    spp_uint32_t missed_edges;   /**< DRDY edges that arrived before the previous one was serviced. */
+    spp_uint32_t read_errors;    /**< Burst reads that failed. */
+    spp_uint32_t consumed;       /**< Samples handed to the consumer. */
+    int64_t read_latency_max;    /**< Worst DRDY edge to burst read completion. */
+    int64_t latency_min;         /**< Best DRDY edge to consumer delivery. */
+    int64_t latency_max;         /**< Worst DRDY edge to consumer delivery. */
+    int64_t latency_sum;         /**< Sum over consumed samples, for the mean. */
+} spp_acq_stats_t;
+
+/**
+ * @brief Engine instance. Allocate statically; fields are private to acquisition.c.
+ */
+typedef struct
+{
+    spp_acq_config_t cfg;
+    spp_spsc_t ring;
+    spp_acq_sample_t ringStorage[SPP_ACQ_RING_DEPTH];
+    spp_gpio_isr_ctx_t isrCtx;
+    spp_gpio_notify_ctx_t notifyCtx;
+    void *p_eventGroup;
+    void *p_task;
+    spp_uint32_t lastEdgeCount;
+    volatile spp_uint8_t running;
+    volatile spp_uint8_t taskExited;
+    spp_acq_stats_t stats;
+} spp_acq_engine_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_ACQ_Start(spp_acq_engine_t *p_engine, const spp_acq_config_t *p_cfg);
+retval_t SPP_HAL_ACQ_Read(spp_acq_engine_t *p_engine, spp_acq_sample_t *p_sample,
+                          spp_uint32_t timeout_ms);
+retval_t SPP_HAL_ACQ_GetStats(const spp_acq_engine_t *p_engine, spp_acq_stats_t *p_stats);
+retval_t SPP_HAL_ACQ_Stop(spp_acq_engine_t *p_engine);
+
+#endif /* ACQUISITION_H */
@@ -0,0 +1,108 @@
+/**
+ * @file compress.h
+ * @brief Streaming compression of multi-channel sensor samples.
+ *
+ * Samples of one stream (a timestamp plus a fixed set of integer channels)
+ * are delta-coded per channel and packed as zigzag varints into blocks
+ * laid out as spp_logfmt_block_t (logformat.h). A full block is optionally
+ * LZ-compressed and handed to a sink, normally the log writer. All working
+ * memory lives in the spp_compress_t; nothing is allocated.
+ */
+
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "logformat.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Entries of the LZ match table (power of two). */
+#ifndef SPP_COMPRESS_LZ_TABLE
+#define SPP_COMPRESS_LZ_TABLE 2048u
+#endif
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Destination of finished blocks. Matches SPP_HAL_LogWriter_Write()
+ *        with the writer passed as p_ctx.
+ */
+typedef retval_t (*spp_compress_sink_t)(void *p_ctx, spp_uint8_t type, int64_t time_us,
+                                        const void *p_data, spp_uint32_t length);
+
+/**
+ * @brief Stream setup.
+ */
+typedef struct
+{
+    spp_compress_sink_t p_sink;    /**< Block destination. */
+    void *p_sink_ctx;              /**< Passed to p_sink. */
+    spp_uint8_t frame_type;        /**< Passed to p_sink with every block. */
+    spp_uint8_t channels;          /**< Values per sample, 1 .. SPP_LOGFMT_BLOCK_MAX_CHANNELS. */
+    spp_uint16_t order2_mask;      /**< Channels coded as second differences (smooth signals). */
+    spp_uint8_t use_lz;            /**< Non-zero to LZ-compress blocks when it saves space. */
+    spp_uint32_t max_samples;      /**< Close a block after this many samples (0 = when full). */
+    spp_uint32_t raw_sample_bytes; /**< Uncompressed size of one sample, for the ratio
+                                        (0 = 8 + 4 per channel). */
+} spp_compress_config_t;
+
+/**
+ * @brief Stream counters.
+ */
+typedef struct
+{
+    spp_uint32_t samples;         /**< Samples pushed. */
+    spp_uint32_t blocks;          /**< Blocks handed to the sink. */
+    spp_uint32_t blocks_lz;       /**< Of those, blocks stored LZ-compressed. */
+    spp_uint32_t dropped_samples; /**< Samples in blocks the sink refused. */
+    uint64_t raw_bytes;           /**< samples * raw_sample_bytes. */
+    uint64_t packed_bytes;        /**< Delta/varint output before LZ. */
+    uint64_t out_bytes;           /**< Block bytes handed to the sink, headers included. */
+} spp_compress_stats_t;
+
+/**
+ * @brief Stream instance, about 13 KiB. Allocate statically; fields are
+ *        private to compress.c.
+ */
+typedef struct
+{
+    spp_compress_config_t cfg;
+    spp_uint32_t samples;
+    spp_uint32_t packedBytes;
+    int64_t baseTime;
+    int64_t prevTime;
+    int64_t prevTimeDelta;
+    int64_t prev[SPP_LOGFMT_BLOCK_MAX_CHANNELS];
+    int64_t prevDelta[SPP_LOGFMT_BLOCK_MAX_CHANNELS];
+    spp_compress_stats_t stats;
+    spp_uint16_t lzTable[SPP_COMPRESS_LZ_TABLE];
+    spp_uint8_t packed[SPP_LOGFMT_BLOCK_MAX_PACKED];
+    spp_uint8_t block[SPP_LOGFMT_MAX_PAYLOAD] __attribute__((aligned(4)));
+} spp_compress_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_Compress_Init(spp_compress_t *p_stream, const spp_compress_config_t *p_cfg);
+retval_t SPP_HAL_Compress_Push(spp_compress_t *p_stream, int64_t time_us,
+                               const int32_t *p_values);
+retval_t SPP_HAL_Compress_Flush(spp_compress_t *p_stream);
+retval_t SPP_HAL_Compress_GetStats(const spp_compress_t *p_stream, spp_compress_stats_t *p_stats);
+spp_uint32_t SPP_HAL_Compress_Lz(const spp_uint8_t *p_src, spp_uint32_t length, spp_uint8_t *p_dst,
+                                 spp_uint32_t capacity, spp_uint16_t *p_table);
+retval_t SPP_HAL_Compress_LogWriterSink(void *p_ctx, spp_uint8_t type, int64_t time_us,
+                                        const void *p_data, spp_uint32_t length);
+
+#endif /* COMPRESS_H */
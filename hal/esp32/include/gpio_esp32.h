@@ -0,0 +1,96 @@
+/**
+ * @file gpio_esp32.h
+ * @brief ESP32 GPIO HAL extensions beyond the core SPP GPIO interface.
+ *
+ * Edge timestamps recorded by the GPIO ISR, a ring that logs every edge
+ * of selected pins with its capture time, and an ISR mode that wakes a
+ * single task directly through a task notification instead of an event
+ * group; a pin's ISR can be detached again. Interrupt allocation flags are
+ * chosen by the caller; by default the ISR service is IRAM-resident so
+ * edges keep being serviced while the flash cache is disabled (SD card and
+ * flash writes), and per-pin counts and worst handler durations are kept
+ * for monitoring.
+ */
+
+#ifndef GPIO_ESP32_H
+#define GPIO_ESP32_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "esp_intr_alloc.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/**
+ * @brief Interrupt allocation flags the GPIO ISR service is installed with.
+ *
+ * ESP_INTR_FLAG_IRAM keeps the interrupt enabled while the flash cache is
+ * off. The whole handler path (this HAL's ISR and the OSAL FromISR calls
+ * it makes) is placed in IRAM, and ISR contexts must live in internal RAM.
+ */
+#ifndef SPP_GPIO_INTR_ALLOC_FLAGS
+#define SPP_GPIO_INTR_ALLOC_FLAGS ESP_INTR_FLAG_IRAM
+#endif
+
+/** @brief Capacity of the edge capture ring (power of two). */
+#ifndef SPP_GPIO_EDGE_RING_DEPTH
+#define SPP_GPIO_EDGE_RING_DEPTH 64u
+#endif
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief One captured edge.
+ */
+typedef struct
+{
+    int64_t time_us;   /**< esp_timer time taken in the ISR. */
+    spp_uint32_t pin;  /**< GPIO that fired. */
+    spp_uint32_t seq;  /**< Pin's edge count, as from SPP_HAL_GPIO_GetLastEdge(). */
+} spp_gpio_edge_t;
+
+/**
+ * @brief Interrupt statistics of one pin.
+ */
+typedef struct
+{
+    spp_uint32_t interrupts;         /**< Edges serviced since registration. */
+    spp_uint32_t max_handler_cycles; /**< Longest ISR run, in CPU cycles. */
+} spp_gpio_pin_stats_t;
+
+/**
+ * @brief ISR context for SPP_HAL_GPIO_RegisterISRNotify().
+ */
+typedef struct
+{
+    void *p_task;      /**< Task to wake, from SPP_OSAL_TaskCreate() or SPP_OSAL_TaskGetCurrent(). */
+    spp_uint32_t bits; /**< Bits OR-ed into the task's notification value. */
+} spp_gpio_notify_ctx_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_GPIO_SetIntrAllocFlags(int intr_alloc_flags);
+retval_t SPP_HAL_GPIO_RegisterISRNotify(spp_uint32_t pin, spp_gpio_notify_ctx_t *p_ctx);
+retval_t SPP_HAL_GPIO_UnregisterISR(spp_uint32_t pin);
+retval_t SPP_HAL_GPIO_GetLastEdge(spp_uint32_t pin, int64_t *p_time_us, spp_uint32_t *p_count);
+
+retval_t SPP_HAL_GPIO_SetEdgeCapture(spp_uint32_t pin, spp_uint8_t enable);
+retval_t SPP_HAL_GPIO_DrainEdges(spp_gpio_edge_t *p_edges, spp_uint32_t max_edges,
+                                 spp_uint32_t timeout_ms, spp_uint32_t *p_count);
+spp_uint32_t SPP_HAL_GPIO_GetEdgeOverflows(void);
+
+retval_t SPP_HAL_GPIO_GetPinStats(spp_uint32_t pin, spp_gpio_pin_stats_t *p_stats);
+retval_t SPP_HAL_GPIO_ResetPinStats(spp_uint32_t pin);
+
+#endif /* GPIO_ESP32_H */
@@ -0,0 +1,179 @@
+/**
+ * @file logformat.h
+ * @brief On-disk layout of SPP binary telemetry logs.
+ *
+ * A log is a 64-byte file header followed by frames. Every frame is a
+ * 16-byte header, its payload and a CRC-32 trailer; fields are
+ * little-endian and frames are not padded. The CRC (IEEE 802.3, as
+ * esp_rom_crc32_le) covers the frame header and payload and is seeded with
+ * the file's session number, so frames left over from an earlier log in a
+ * reused or preallocated file never validate.
+ *
+ * Before the first frame that starts at or after every multiple of
+ * sync_interval, the writer emits a SYNC frame; before the first frame at
+ * or after every multiple of index_interval, an INDEX frame listing the
+ * time and offset of every SYNC frame since the previous INDEX. A reader
+ * can therefore jump to any multiple of either interval, find the marker
+ * within max_frame_bytes, and binary-search the log by time without
+ * reading it. Frame times are expected to be non-decreasing.
+ *
+ * Shared by the firmware writer and the host tools; depends on <stdint.h>
+ * only.
+ */
+
+#ifndef LOGFORMAT_H
+#define LOGFORMAT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief File header magic, not NUL-terminated. */
+#define SPP_LOGFMT_FILE_MAGIC "SPPLOG01"
+
+#define SPP_LOGFMT_VERSION 1u
+
+/** @brief First two bytes of every frame (0x5A 0xA5 on disk). */
+#define SPP_LOGFMT_FRAME_MAGIC 0xA55Au
+
+/** @brief Largest payload of any frame. */
+#define SPP_LOGFMT_MAX_PAYLOAD 4096u
+
+/** @brief Frame header plus CRC trailer. */
+#define SPP_LOGFMT_FRAME_OVERHEAD 20u
+
+/** @brief Largest frame on disk. */
+#define SPP_LOGFMT_MAX_FRAME (SPP_LOGFMT_MAX_PAYLOAD + SPP_LOGFMT_FRAME_OVERHEAD)
+
+/** @brief Most SYNC entries one INDEX frame can carry. */
+#define SPP_LOGFMT_INDEX_MAX_ENTRIES 64u
+
+/** @brief SYNC payload pattern, not NUL-terminated. */
+#define SPP_LOGFMT_SYNC_PATTERN "SPPSYNC!"
+
+/** @brief spp_logfmt_index_t::prev_index_offset of the first INDEX frame. */
+#define SPP_LOGFMT_NO_OFFSET UINT64_MAX
+
+/** @brief Frame types; types from SPP_LOGFMT_TYPE_USER up are application records. */
+#define SPP_LOGFMT_TYPE_SYNC 0x01u
+#define SPP_LOGFMT_TYPE_INDEX 0x02u
+#define SPP_LOGFMT_TYPE_USER 0x10u
+
+/** @brief INDEX frame flag: written on close, covers the log up to its end. */
+#define SPP_LOGFMT_FLAG_FINAL 0x01u
+
+/** @brief Most channels in a compressed sample block. */
+#define SPP_LOGFMT_BLOCK_MAX_CHANNELS 16u
+
+/** @brief Largest packed (pre-LZ) body of a compressed sample block. */
+#define SPP_LOGFMT_BLOCK_MAX_PACKED (SPP_LOGFMT_MAX_PAYLOAD - 16u)
+
+/** @brief Compressed block flag: the body is LZ-compressed. */
+#define SPP_LOGFMT_BLOCK_LZ 0x01u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief File header at offset 0.
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t magic[8];         /**< SPP_LOGFMT_FILE_MAGIC. */
+    uint16_t version;         /**< SPP_LOGFMT_VERSION. */
+    uint16_t header_bytes;    /**< sizeof(spp_logfmt_file_header_t); frames start here. */
+    uint32_t session;         /**< CRC seed of every frame. */
+    uint32_t sync_interval;   /**< Bytes between SYNC frames. */
+    uint32_t index_interval;  /**< Bytes between INDEX frames, a multiple of sync_interval. */
+    uint32_t max_frame_bytes; /**< Largest frame the writer may emit. */
+    uint32_t flags;           /**< Reserved, 0. */
+    int64_t start_time_us;    /**< Writer clock (esp_timer) when the log was opened. */
+    uint64_t wall_time_us;    /**< UTC at start_time_us in us since the epoch, 0 if unknown. */
+    uint8_t reserved[12];     /**< 0. */
+    uint32_t crc;             /**< CRC-32 (seed 0) of the preceding bytes. */
+} spp_logfmt_file_header_t;
+
+/**
+ * @brief Frame header; followed by length payload bytes and a uint32_t CRC.
+ */
+typedef struct __attribute__((packed))
+{
+    uint16_t magic;  /**< SPP_LOGFMT_FRAME_MAGIC. */
+    uint8_t type;    /**< SPP_LOGFMT_TYPE_*. */
+    uint8_t flags;   /**< SPP_LOGFMT_FLAG_* for INDEX, application-defined otherwise. */
+    uint16_t length; /**< Payload bytes. */
+    uint16_t seq;    /**< Per-log frame counter, wraps; gaps show dropped frames. */
+    int64_t time_us; /**< Record time on the writer clock. */
+} spp_logfmt_frame_t;
+
+/**
+ * @brief SYNC payload.
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t pattern[8]; /**< SPP_LOGFMT_SYNC_PATTERN. */
+    uint64_t offset;    /**< File offset of this frame. */
+    uint32_t frames;    /**< Frames written before this one. */
+    uint32_t dropped;   /**< Frames the sink refused before this one. */
+} spp_logfmt_sync_t;
+
+/**
+ * @brief One INDEX entry: a SYNC frame and the time of the frame after it.
+ */
+typedef struct __attribute__((packed))
+{
+    int64_t time_us;
+    uint64_t offset;
+} spp_logfmt_index_entry_t;
+
+/**
+ * @brief INDEX payload header; followed by count entries.
+ */
+typedef struct __attribute__((packed))
+{
+    uint64_t prev_index_offset; /**< Previous INDEX frame, SPP_LOGFMT_NO_OFFSET if none. */
+    uint32_t count;             /**< Entries that follow. */
+    uint32_t reserved;          /**< 0. */
+} spp_logfmt_index_t;
+
+/**
+ * @brief Compressed sample block, carried as the payload of an application
+ *        frame; followed by the body.
+ *
+ * Each sample packs as a zigzag LEB128 varint of its time's second-order
+ * difference, then one zigzag varint per channel of the first difference
+ * (or, for channels in order2_mask, the second difference). Differences
+ * start from zero at every block, so blocks decode on their own. With
+ * SPP_LOGFMT_BLOCK_LZ the body is an LZ stream of the packed bytes: a
+ * sequence of [token: literals << 4 | (match - 4)] [literal length
+ * extension] [literals] [u16 offset] [match length extension], where a
+ * nibble of 15 continues in extension bytes (255 = add and continue); the
+ * last sequence ends after its literals.
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t flags;         /**< SPP_LOGFMT_BLOCK_*. */
+    uint8_t channels;      /**< Values per sample. */
+    uint16_t samples;      /**< Samples in the block. */
+    uint16_t packed_bytes; /**< Body size before LZ. */
+    uint16_t order2_mask;  /**< Channels coded as second differences. */
+    int64_t base_time_us;  /**< Time of the first sample. */
+} spp_logfmt_block_t;
+
+_Static_assert(sizeof(spp_logfmt_file_header_t) == 64, "file header layout");
+_Static_assert(sizeof(spp_logfmt_block_t) == 16, "block header layout");
+_Static_assert(sizeof(spp_logfmt_frame_t) + sizeof(uint32_t) == SPP_LOGFMT_FRAME_OVERHEAD,
+               "frame header layout");
+_Static_assert(sizeof(spp_logfmt_index_t) +
+                   SPP_LOGFMT_INDEX_MAX_ENTRIES * sizeof(spp_logfmt_index_entry_t) <=
+                   SPP_LOGFMT_MAX_PAYLOAD,
+               "INDEX frame fits a frame");
+
+#endif /* LOGFORMAT_H */
@@ -0,0 +1,122 @@
+/**
+ * @file logger.h
+ * @brief Buffered SD card logger for the ESP32 HAL.
+ *
+ * Producers append records into one of N preallocated buffers without
+ * waiting for the card; a writer task writes full buffers to a file on the
+ * volume mounted by SPP_HAL_Storage_Mount(). Card housekeeping stalls are
+ * absorbed by the spare buffers and only cause drops, which are counted,
+ * once all of them are full.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Largest number of buffers a logger can rotate through. */
+#define SPP_LOGGER_MAX_BUFFERS 8u
+
+/** @brief Buffer sizes must be a multiple of the card sector size. */
+#define SPP_LOGGER_SECTOR_BYTES 512u
+
+/**
+ * @brief Define static storage for a logger's buffers.
+ *
+ * Keeps the buffers word-aligned in internal RAM so the SD driver can DMA
+ * straight from them.
+ */
+#define SPP_LOGGER_STORAGE(name, count, bytes)                                                     \
+    static spp_uint8_t name[(count) * (bytes)] __attribute__((aligned(4)))
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Logger setup.
+ */
+typedef struct
+{
+    const char *p_path;             /**< File to append to, e.g. "/sdcard/log.bin". */
+    spp_uint8_t *p_buffers;         /**< buffer_count * buffer_bytes from SPP_LOGGER_STORAGE(). */
+    spp_uint32_t buffer_bytes;      /**< Multiple of SPP_LOGGER_SECTOR_BYTES; best equal to the
+                                         volume's allocation_unit_size. */
+    spp_uint32_t buffer_count;      /**< 2 .. SPP_LOGGER_MAX_BUFFERS. */
+    spp_uint32_t flush_interval_ms; /**< Write a partly filled buffer once no buffer filled up
+                                         for this long; 0 = only write full buffers. */
+    spp_uint32_t sync_every;        /**< fsync() after this many buffer writes; 0 = on stop only. */
+    spp_uint32_t task_priority;     /**< Writer task priority (0 = default). */
+    spp_uint32_t task_stack;        /**< Writer task stack depth (0 = default). */
+} spp_logger_config_t;
+
+/**
+ * @brief Logger counters. Times are in microseconds.
+ */
+typedef struct
+{
+    spp_uint32_t records;         /**< Records accepted. */
+    spp_uint32_t dropped_records; /**< Records refused because every buffer was full. */
+    uint64_t dropped_bytes;       /**< Bytes of the refused records. */
+    uint64_t bytes_written;       /**< Bytes written to the file. */
+    spp_uint32_t buffers_written; /**< Buffer writes issued. */
+    spp_uint32_t write_errors;    /**< Buffer writes that failed or were short. */
+    spp_uint32_t buffers_in_use;  /**< Buffers being filled or waiting for the writer now. */
+    spp_uint32_t buffers_peak;    /**< Highest buffers_in_use since start. */
+    int64_t write_max;            /**< Longest single buffer write, in us. */
+    int64_t write_total;          /**< Time spent writing, in us. */
+    spp_uint32_t stalls;          /**< Times producers found no free buffer. */
+    int64_t stall_total;          /**< Time producers spent without a free buffer, in us. */
+} spp_logger_stats_t;
+
+/**
+ * @brief Logger instance. Allocate statically; fields are private to logger.c.
+ */
+typedef struct
+{
+    spp_logger_config_t cfg;
+    FILE *p_file;
+    void *p_doorbell;
+    void *p_task;
+    portMUX_TYPE lock;
+    int32_t active;
+    spp_uint32_t activeOffset;
+    spp_uint8_t freeStack[SPP_LOGGER_MAX_BUFFERS];
+    spp_uint32_t freeCount;
+    spp_uint8_t fullRing[SPP_LOGGER_MAX_BUFFERS];
+    spp_uint32_t fullHead;
+    spp_uint32_t fullCount;
+    spp_uint32_t fullLength[SPP_LOGGER_MAX_BUFFERS];
+    volatile spp_uint32_t copying[SPP_LOGGER_MAX_BUFFERS];
+    volatile spp_uint8_t writing;
+    volatile spp_uint8_t running;
+    volatile spp_uint8_t taskExited;
+    spp_uint8_t closeHandoff; /**< Second of a timed-out stop and the exiting writer closes the file. */
+    int64_t stallStart;
+    spp_uint32_t sinceSync;
+    spp_logger_stats_t stats;
+} spp_logger_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_Logger_Start(spp_logger_t *p_logger, const spp_logger_config_t *p_cfg);
+retval_t SPP_HAL_Logger_Append(spp_logger_t *p_logger, const void *p_data, spp_uint32_t length);
+retval_t SPP_HAL_Logger_Flush(spp_logger_t *p_logger, spp_uint32_t timeout_ms);
+retval_t SPP_HAL_Logger_GetStats(spp_logger_t *p_logger, spp_logger_stats_t *p_stats);
+retval_t SPP_HAL_Logger_Stop(spp_logger_t *p_logger);
+
+#endif /* LOGGER_H */
@@ -0,0 +1,103 @@
+/**
+ * @file logwriter.h
+ * @brief Writer for the SPP binary telemetry log format (logformat.h).
+ *
+ * Frames records, inserts SYNC and INDEX frames on schedule and hands each
+ * finished frame to a sink in one call; SPP_HAL_LogWriter_LoggerSink()
+ * feeds an spp_logger_t. A writer is used from one task at a time.
+ */
+
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "logformat.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Default bytes between SYNC frames. */
+#define SPP_LOGWRITER_SYNC_INTERVAL (16u * 1024u)
+
+/** @brief Default bytes between INDEX frames. */
+#define SPP_LOGWRITER_INDEX_INTERVAL (1024u * 1024u)
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Destination of finished frames.
+ *
+ * Must take the whole frame or nothing; a refused frame is counted as
+ * dropped and leaves no trace in the file.
+ *
+ * @return SPP_OK if the frame was taken, any other value if it was refused.
+ */
+typedef retval_t (*spp_logwriter_sink_t)(void *p_ctx, const void *p_data, spp_uint32_t length);
+
+/**
+ * @brief Writer setup.
+ */
+typedef struct
+{
+    spp_logwriter_sink_t p_sink; /**< Frame destination. */
+    void *p_sink_ctx;            /**< Passed to p_sink. */
+    spp_uint32_t session;        /**< CRC seed, unique per log (0 = derive from the clock). */
+    spp_uint32_t sync_interval;  /**< Bytes between SYNC frames (0 = default). */
+    spp_uint32_t index_interval; /**< Bytes between INDEX frames, a multiple of sync_interval
+                                      and at most SPP_LOGFMT_INDEX_MAX_ENTRIES of them
+                                      (0 = default). */
+    uint64_t wall_time_us;       /**< UTC now in us since the epoch, 0 if unknown. */
+} spp_logwriter_config_t;
+
+/**
+ * @brief Writer counters.
+ */
+typedef struct
+{
+    spp_uint32_t frames;        /**< Frames taken by the sink, markers included. */
+    spp_uint32_t dropped;       /**< Frames the sink refused. */
+    uint64_t bytes;             /**< File size so far. */
+    spp_uint32_t sync_frames;   /**< SYNC frames written. */
+    spp_uint32_t index_frames;  /**< INDEX frames written. */
+} spp_logwriter_stats_t;
+
+/**
+ * @brief Writer instance. Allocate statically; fields are private to logwriter.c.
+ */
+typedef struct
+{
+    spp_logwriter_config_t cfg;
+    uint64_t offset;
+    uint64_t nextSync;
+    uint64_t nextIndex;
+    uint64_t lastIndex;
+    spp_uint16_t seq;
+    spp_uint32_t entryCount;
+    spp_logfmt_index_entry_t entries[SPP_LOGFMT_INDEX_MAX_ENTRIES];
+    spp_uint8_t open;
+    spp_logwriter_stats_t stats;
+    spp_uint8_t frame[SPP_LOGFMT_MAX_FRAME] __attribute__((aligned(4)));
+} spp_logwriter_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_LogWriter_Open(spp_logwriter_t *p_writer, const spp_logwriter_config_t *p_cfg);
+retval_t SPP_HAL_LogWriter_Write(spp_logwriter_t *p_writer, spp_uint8_t type, int64_t time_us,
+                                 const void *p_payload, spp_uint32_t length);
+retval_t SPP_HAL_LogWriter_Close(spp_logwriter_t *p_writer, int64_t time_us);
+retval_t SPP_HAL_LogWriter_GetStats(const spp_logwriter_t *p_writer,
+                                    spp_logwriter_stats_t *p_stats);
+retval_t SPP_HAL_LogWriter_LoggerSink(void *p_ctx, const void *p_data, spp_uint32_t length);
+
+#endif /* LOGWRITER_H */
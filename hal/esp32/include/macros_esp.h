@@ -41,9 +41,51 @@
 
 /** @brief ICM20948 IMU chip select GPIO pin. */
 #define CS_PIN_ICM 21
+/** @brief SD card chip select GPIO pin. */
 #define CS_PIN_SDC 8    // change to the correct GPIO
+
+/** @brief Number of device slots in the SPI descriptor table. */
 #define MAX_DEVICES 4
 
+/* ============================================================================
+ * Device Clock Limits
+ * ========================================================================= */
+
+/** @brief ICM20948 rated SPI clock (7 MHz). */
+#define ICM_MAX_CLOCK_HZ (7u * 1000u * 1000u)
+
+/** @brief BMP390 rated SPI clock (10 MHz). */
+#define BMP_MAX_CLOCK_HZ (10u * 1000u * 1000u)
+
+/** @brief SD card clock in SPI mode (default-speed cards, 20 MHz). */
+#define SDC_MAX_CLOCK_HZ (20u * 1000u * 1000u)
+
+/* ============================================================================
+ * SPI Burst Read
+ * ========================================================================= */
+
+/**
+ * @brief Number of DMA-capable burst buffers.
+ *
+ * Bounds how many SPP_HAL_SPI_BurstRead() calls can be in flight at once,
+ * typically one per sensor task.
+ */
+#ifndef SPI_BURST_POOL_SIZE
+#define SPI_BURST_POOL_SIZE 2
+#endif
+
+/**
+ * @brief Longest transfer, in bytes, run in polling mode by default.
+ *
+ * Polling busy-waits for the few microseconds a register access takes
+ * instead of paying for an interrupt and a context switch. Longer
+ * transfers use interrupt mode so the CPU is free meanwhile. Adjustable at
+ * run time with SPP_HAL_SPI_SetPollingMaxBytes().
+ */
+#ifndef SPI_POLLING_MAX_BYTES
+#define SPI_POLLING_MAX_BYTES 16u
+#endif
+
 /* ============================================================================
  * Device State Enumeration
  * ========================================================================= */
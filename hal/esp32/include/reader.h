@@ -0,0 +1,127 @@
+/**
+ * @file reader.h
+ * @brief Read-ahead SD card file reader for the ESP32 HAL.
+ *
+ * A prefetch task reads a file on the volume mounted by
+ * SPP_HAL_Storage_Mount() into N preallocated buffers ahead of the
+ * consumer, which borrows filled buffers as read-only views and returns
+ * them when done. Card latency is hidden behind the buffers in flight, so
+ * a downlink or replay task only waits when it outruns the card.
+ */
+
+#ifndef READER_H
+#define READER_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Largest number of buffers a reader can rotate through. */
+#define SPP_READER_MAX_BUFFERS 8u
+
+/** @brief Buffer sizes must be a multiple of the card sector size. */
+#define SPP_READER_SECTOR_BYTES 512u
+
+/**
+ * @brief Define static storage for a reader's buffers.
+ *
+ * Keeps the buffers word-aligned in internal RAM so the SD driver can DMA
+ * straight into them.
+ */
+#define SPP_READER_STORAGE(name, count, bytes)                                                     \
+    static spp_uint8_t name[(count) * (bytes)] __attribute__((aligned(4)))
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Reader setup.
+ */
+typedef struct
+{
+    const char *p_path;         /**< File to read, e.g. "/sdcard/log.bin". */
+    spp_uint8_t *p_buffers;     /**< buffer_count * buffer_bytes from SPP_READER_STORAGE(). */
+    spp_uint32_t buffer_bytes;  /**< Multiple of SPP_READER_SECTOR_BYTES; best equal to the
+                                     volume's allocation_unit_size. */
+    spp_uint32_t buffer_count;  /**< 2 .. SPP_READER_MAX_BUFFERS. */
+    uint64_t start_offset;      /**< First byte to read; keep it sector-aligned for speed. */
+    uint64_t length;            /**< Bytes to read from start_offset; 0 = to the end of file. */
+    spp_uint32_t task_priority; /**< Prefetch task priority (0 = default). */
+    spp_uint32_t task_stack;    /**< Prefetch task stack depth (0 = default). */
+} spp_reader_config_t;
+
+/**
+ * @brief A filled buffer lent to the consumer. Valid until released.
+ */
+typedef struct
+{
+    const spp_uint8_t *p_data; /**< Buffer contents. */
+    spp_uint32_t length;       /**< Valid bytes; 0 marks the end of the stream. */
+    uint64_t offset;           /**< File offset of p_data[0]. */
+    spp_uint8_t buffer;        /**< Private to reader.c. */
+} spp_reader_view_t;
+
+/**
+ * @brief Reader counters. Times are in microseconds.
+ */
+typedef struct
+{
+    uint64_t bytes_read;        /**< Bytes read from the file. */
+    uint64_t bytes_delivered;   /**< Bytes handed to the consumer. */
+    spp_uint32_t buffers_read;  /**< Buffer reads issued. */
+    spp_uint32_t read_errors;   /**< Reads that failed; the stream ends at the first one. */
+    int64_t read_max;           /**< Longest single buffer read, in us. */
+    int64_t read_total;         /**< Time spent reading, in us. */
+    spp_uint32_t buffers_ready; /**< Filled buffers waiting for the consumer now. */
+    spp_uint32_t buffers_lent;  /**< Buffers held by the consumer now. */
+    spp_uint32_t stalls;        /**< Acquires that found no filled buffer. */
+    int64_t stall_total;        /**< Time the consumer waited for the card, in us. */
+    int64_t elapsed;            /**< Time since open, or open to end of stream, in us. */
+} spp_reader_stats_t;
+
+/**
+ * @brief Reader instance. Allocate statically; fields are private to reader.c.
+ */
+typedef struct
+{
+    spp_reader_config_t cfg;
+    FILE *p_file;
+    void *p_free;
+    void *p_ready;
+    void *p_task;
+    portMUX_TYPE lock;
+    uint64_t endOffset;
+    uint64_t bufferOffset[SPP_READER_MAX_BUFFERS];
+    spp_uint32_t bufferLength[SPP_READER_MAX_BUFFERS];
+    int64_t openUs;
+    int64_t doneUs;
+    volatile spp_uint8_t running;
+    volatile spp_uint8_t taskExited;
+    spp_uint8_t closeHandoff; /**< Second of a timed-out close and the exiting task closes the file. */
+    spp_uint8_t ended;
+    spp_reader_stats_t stats;
+} spp_reader_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_Reader_Open(spp_reader_t *p_reader, const spp_reader_config_t *p_cfg);
+retval_t SPP_HAL_Reader_Acquire(spp_reader_t *p_reader, spp_reader_view_t *p_view,
+                                spp_uint32_t timeout_ms);
+retval_t SPP_HAL_Reader_Release(spp_reader_t *p_reader, spp_reader_view_t *p_view);
+retval_t SPP_HAL_Reader_GetStats(spp_reader_t *p_reader, spp_reader_stats_t *p_stats);
+retval_t SPP_HAL_Reader_Close(spp_reader_t *p_reader);
+
+#endif /* READER_H */
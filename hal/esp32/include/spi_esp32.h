@@ -0,0 +1,117 @@
+/**
+ * @file spi_esp32.h
+ * @brief ESP32 SPI HAL extensions beyond the core SPP SPI interface.
+ *
+ * A descriptor table of the devices on the bus, burst reads of a
+ * contiguous register range in a single transaction relying on the
+ * sensors' register address auto-increment, batches of transfers queued
+ * to the driver that complete in the background, and a low-latency path
+ * that holds the bus and polls short transfers.
+ */
+
+#ifndef SPI_ESP32_H
+#define SPI_ESP32_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "spp/osal/eventgroups.h"
+#include "driver/spi_master.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Largest number of data bytes a single burst read can return. */
+#define SPP_HAL_SPI_BURST_MAX_BYTES 60u
+
+/** @brief Maximum number of transfers in one async batch. */
+#define SPP_HAL_SPI_BATCH_MAX 8u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/** @brief Driver that talks to a device on the shared bus. */
+typedef enum
+{
+    SPP_SPI_DRIVER_HAL = 0,  /**< Added and driven by this HAL. */
+    SPP_SPI_DRIVER_SDSPI = 1 /**< Owned by the ESP-IDF SDSPI driver (storage.c). */
+} spp_spi_driver_t;
+
+/**
+ * @brief Static description of one device on the bus.
+ */
+typedef struct
+{
+    int cs_pin;                     /**< Chip select GPIO. */
+    spp_uint8_t mode;               /**< SPI mode 0..3. */
+    spp_uint32_t max_clock_hz;      /**< Highest SCLK the device is rated for; 0 = unused slot. */
+    spp_uint8_t read_dummy_bytes;   /**< Bytes between the address and read data. */
+    spp_uint8_t addr_bytes;         /**< Register address width in bytes. */
+    spp_uint8_t burst;              /**< Non-zero if reads auto-increment the address. */
+    spp_uint8_t driver;             /**< spp_spi_driver_t. */
+} spp_spi_device_desc_t;
+
+/**
+ * @brief Batch completion callback. Runs in ISR context.
+ *
+ * @param[in] p_ctx Context given to SPP_HAL_SPI_BatchInit().
+ */
+typedef void (*spp_spi_done_cb_t)(void *p_ctx);
+
+/**
+ * @brief One full-duplex transfer of an async batch.
+ *
+ * Buffers must stay valid until the batch has been reaped and should be
+ * DMA-capable (internal RAM, 4-byte aligned) to avoid driver copies.
+ */
+typedef struct
+{
+    void *handler;            /**< Device handler from SPP_HAL_SPI_GetHandler(). */
+    const spp_uint8_t *p_tx;  /**< Bytes to send. */
+    spp_uint8_t *p_rx;        /**< Receives the same number of bytes (may be NULL). */
+    spp_uint16_t length;      /**< Transfer length in bytes. */
+} spp_spi_xfer_t;
+
+/**
+ * @brief Async batch control block. Fields are private to spi_esp32.c.
+ */
+typedef struct
+{
+    spi_transaction_t trans[SPP_HAL_SPI_BATCH_MAX];
+    void *handlers[SPP_HAL_SPI_BATCH_MAX];
+    spp_uint8_t queued;
+    spp_uint8_t reaped;
+    volatile spp_uint8_t pending;
+    volatile spp_uint8_t failed;
+    void *p_eventGroup;
+    osal_eventbits_t bits;
+    spp_spi_done_cb_t p_callback;
+    void *p_callbackCtx;
+} spp_spi_batch_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_SPI_SetDeviceDesc(void *p_handler, const spp_spi_device_desc_t *p_desc);
+const spp_spi_device_desc_t *SPP_HAL_SPI_FindDeviceDesc(int cs_pin);
+
+retval_t SPP_HAL_SPI_BurstRead(void *handler, spp_uint8_t start_reg, spp_uint8_t *p_out,
+                               spp_uint8_t count);
+
+retval_t SPP_HAL_SPI_BatchInit(spp_spi_batch_t *p_batch, void *p_event_group,
+                               osal_eventbits_t bits, spp_spi_done_cb_t p_callback, void *p_ctx);
+retval_t SPP_HAL_SPI_BatchSubmit(spp_spi_batch_t *p_batch, const spp_spi_xfer_t *p_xfers,
+                                 spp_uint8_t count);
+retval_t SPP_HAL_SPI_BatchWait(spp_spi_batch_t *p_batch, spp_uint32_t timeout_ms);
+
+retval_t SPP_HAL_SPI_AcquireBus(void *handler);
+retval_t SPP_HAL_SPI_ReleaseBus(void *handler);
+retval_t SPP_HAL_SPI_SetPollingMaxBytes(spp_uint16_t max_bytes);
+
+#endif /* SPI_ESP32_H */
@@ -0,0 +1,74 @@
+/**
+ * @file storage_esp32.h
+ * @brief ESP32 storage HAL extensions beyond the core SPP storage interface.
+ *
+ * A mount mode that preallocates a contiguous log file of fixed size, and
+ * a raw multi-sector write path into that file's sectors. Raw writes go
+ * straight to the card with no FAT or directory updates, since the file's
+ * clusters and size are fixed at mount time.
+ */
+
+#ifndef STORAGE_ESP32_H
+#define STORAGE_ESP32_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "spp/hal/storage/storage.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Card sector size; raw writes are whole sectors. */
+#define SPP_STORAGE_SECTOR_BYTES 512u
+
+/** @brief Longest file name (relative to the base path) accepted for preallocation. */
+#define SPP_STORAGE_PREALLOC_NAME_MAX 32u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Mount parameters with a preallocated log file.
+ *
+ * Pass &cfg.base to SPP_HAL_Storage_Unmount().
+ */
+typedef struct
+{
+    SPP_Storage_InitCfg base;    /**< Standard mount parameters. */
+    const char *p_prealloc_name; /**< File name under the base path, e.g. "IMU.BIN" (8.3 unless
+                                      FATFS long names are enabled); NULL = no preallocation. */
+    uint64_t prealloc_bytes;     /**< File size; rounded down to whole sectors. */
+} spp_storage_prealloc_cfg_t;
+
+/**
+ * @brief Layout and counters of the raw write region.
+ */
+typedef struct
+{
+    spp_uint32_t start_sector;  /**< First card sector of the file. */
+    spp_uint32_t sector_count;  /**< Sectors in the file. */
+    spp_uint32_t next_sector;   /**< Offset of the next raw write, in sectors from the start. */
+    spp_uint32_t writes;        /**< Raw writes issued. */
+    spp_uint32_t write_errors;  /**< Raw writes the card rejected. */
+    int64_t write_max;          /**< Longest raw write, in us. */
+    int64_t write_total;        /**< Time spent in raw writes, in us. */
+} spp_storage_raw_info_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_HAL_Storage_MountPrealloc(const spp_storage_prealloc_cfg_t *p_cfg);
+retval_t SPP_HAL_Storage_RawWrite(const void *p_data, spp_uint32_t sector_count);
+retval_t SPP_HAL_Storage_RawSeek(spp_uint32_t sector);
+retval_t SPP_HAL_Storage_RawGetInfo(spp_storage_raw_info_t *p_info);
+retval_t SPP_HAL_Storage_DumpTrace(const char *p_path);
+
+#endif /* STORAGE_ESP32_H */
@@ -0,0 +1,569 @@
+/**
+ * @file logger.c
+ * @brief Buffered SD card logger for the ESP32 HAL.
+ *
+ * Buffers rotate between three places: the free stack, the single active
+ * buffer producers are filling, and the FIFO of sealed buffers waiting for
+ * the writer task. Producers only hold the logger's spinlock to reserve
+ * space (and to seal the active buffer when a record does not fit); the
+ * copy itself runs outside it, tracked by a per-buffer count the writer
+ * waits on before writing. Records are never split across buffers.
+ *
+ * Buffers are written whole with unbuffered stdio, so writes of a
+ * sector-multiple, word-aligned buffer reach FATFS without an extra copy
+ * and, when buffer_bytes equals the allocation unit, start on a cluster
+ * boundary. The same code runs on the host against a regular file.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "spp/osal/queue.h"
+#include "spp/osal/task.h"
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+#include "logger.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief active value while producers have no buffer. */
+#define K_NO_BUFFER (-1)
+
+/** @brief Writer wake-up period when time-based flushing is off. */
+#define K_IDLE_WAIT_MS 100u
+
+/** @brief Longest SPP_HAL_Logger_Stop() waits for the writer to finish. */
+#define K_STOP_TIMEOUT_MS 5000u
+
+/**
+ * @brief How long the writer spins on a producer still copying into a
+ *        sealed buffer before it sleeps a tick per check, in us.
+ */
+#define K_COPY_SPIN_US 50
+
+/** @brief Writer task stack depth used when the config leaves it at 0. */
+#define K_DEFAULT_STACK 4096u
+
+/** @brief Writer task priority used when the config leaves it at 0. */
+#define K_DEFAULT_PRIORITY 5u
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Refresh the buffer occupancy counters. Call with the lock held.
+ *
+ * @param[in] p_logger Logger instance.
+ */
+static void logger_update_in_use(spp_logger_t *p_logger)
+{
+    spp_uint32_t inUse = p_logger->fullCount + p_logger->writing;
+    if (p_logger->active != K_NO_BUFFER)
+    {
+        inUse += 1;
+    }
+
+    p_logger->stats.buffers_in_use = inUse;
+    if (inUse > p_logger->stats.buffers_peak)
+    {
+        p_logger->stats.buffers_peak = inUse;
+    }
+}
+
+/**
+ * @brief Make a free buffer the active one. Call with the lock held.
+ *
+ * Ends a stall if producers were waiting for a buffer.
+ *
+ * @param[in] p_logger Logger instance.
+ * @param[in] now_us   Current esp_timer time.
+ */
+static void logger_take_free(spp_logger_t *p_logger, int64_t now_us)
+{
+    if (p_logger->active != K_NO_BUFFER || p_logger->freeCount == 0u)
+        return;
+
+    p_logger->freeCount -= 1;
+    p_logger->active = p_logger->freeStack[p_logger->freeCount];
+    p_logger->activeOffset = 0;
+
+    if (p_logger->stallStart != 0)
+    {
+        p_logger->stats.stall_total += now_us - p_logger->stallStart;
+        p_logger->stallStart = 0;
+    }
+}
+
+/**
+ * @brief Queue the active buffer for the writer. Call with the lock held.
+ *
+ * @param[in] p_logger Logger instance.
+ * @param[in] now_us   Current esp_timer time.
+ * @return 1 if a buffer was sealed and the writer should be woken, 0 if
+ *         there was nothing to seal.
+ */
+static int logger_seal(spp_logger_t *p_logger, int64_t now_us)
+{
+    if (p_logger->active == K_NO_BUFFER || p_logger->activeOffset == 0u)
+        return 0;
+
+    spp_uint32_t idx = (spp_uint32_t)p_logger->active;
+    spp_uint32_t tail = (p_logger->fullHead + p_logger->fullCount) % p_logger->cfg.buffer_count;
+
+    p_logger->fullRing[tail] = (spp_uint8_t)idx;
+    p_logger->fullLength[idx] = p_logger->activeOffset;
+    p_logger->fullCount += 1;
+    p_logger->active = K_NO_BUFFER;
+
+    logger_take_free(p_logger, now_us);
+    return 1;
+}
+
+/**
+ * @brief Wake the writer task.
+ *
+ * @param[in] p_logger Logger instance.
+ */
+static void logger_ring(spp_logger_t *p_logger)
+{
+    spp_uint8_t token = 0;
+
+    /* A full doorbell already guarantees a pending wake-up */
+    (void)SPP_OSAL_QueueSend(p_logger->p_doorbell, &token, 0);
+}
+
+/**
+ * @brief Write every sealed buffer to the file, oldest first.
+ *
+ * @param[in] p_logger Logger instance.
+ */
+static void logger_drain(spp_logger_t *p_logger)
+{
+    for (;;)
+    {
+        portENTER_CRITICAL(&p_logger->lock);
+        if (p_logger->fullCount == 0u)
+        {
+            portEXIT_CRITICAL(&p_logger->lock);
+            return;
+        }
+        spp_uint32_t idx = p_logger->fullRing[p_logger->fullHead];
+        spp_uint32_t length = p_logger->fullLength[idx];
+        p_logger->fullHead = (p_logger->fullHead + 1u) % p_logger->cfg.buffer_count;
+        p_logger->fullCount -= 1;
+        p_logger->writing = 1;
+        portEXIT_CRITICAL(&p_logger->lock);
+
+        /* Producers that reserved space before the seal may still be copying.
+         * A copy takes microseconds, so spin briefly before sleeping: each
+         * SPP_OSAL_TaskDelay(1) lasts at least a whole tick. */
+        int64_t spinUntilUs = esp_timer_get_time() + K_COPY_SPIN_US;
+        while (__atomic_load_n(&p_logger->copying[idx], __ATOMIC_ACQUIRE) != 0u)
+        {
+            if (esp_timer_get_time() >= spinUntilUs)
+            {
+                SPP_OSAL_TaskDelay(1);
+            }
+        }
+
+        const spp_uint8_t *p_buffer = &p_logger->cfg.p_buffers[idx * p_logger->cfg.buffer_bytes];
+        int64_t startUs = esp_timer_get_time();
+        size_t written = fwrite(p_buffer, 1, length, p_logger->p_file);
+        if (p_logger->cfg.sync_every != 0u && ++p_logger->sinceSync >= p_logger->cfg.sync_every)
+        {
+            fflush(p_logger->p_file);
+            fsync(fileno(p_logger->p_file));
+            p_logger->sinceSync = 0;
+        }
+        int64_t endUs = esp_timer_get_time();
+        int64_t elapsedUs = endUs - startUs;
+
+        portENTER_CRITICAL(&p_logger->lock);
+        p_logger->stats.buffers_written += 1;
+        p_logger->stats.bytes_written += written;
+        if (written != length)
+        {
+            p_logger->stats.write_errors += 1;
+        }
+        p_logger->stats.write_total += elapsedUs;
+        if (elapsedUs > p_logger->stats.write_max)
+        {
+            p_logger->stats.write_max = elapsedUs;
+        }
+
+        p_logger->writing = 0;
+        p_logger->freeStack[p_logger->freeCount] = (spp_uint8_t)idx;
+        p_logger->freeCount += 1;
+        logger_take_free(p_logger, endUs);
+        logger_update_in_use(p_logger);
+        portEXIT_CRITICAL(&p_logger->lock);
+    }
+}
+
+/**
+ * @brief Sync and close the log file.
+ *
+ * @param[in] p_logger Logger instance.
+ * @return 0 on success, non-zero if closing failed.
+ */
+static int logger_close_file(spp_logger_t *p_logger)
+{
+    fflush(p_logger->p_file);
+    fsync(fileno(p_logger->p_file));
+    int err = fclose(p_logger->p_file);
+    p_logger->p_file = NULL;
+    return err;
+}
+
+/**
+ * @brief Writer task: wait for sealed buffers and write them.
+ *
+ * @param[in] p_arg The spp_logger_t being serviced.
+ */
+static void logger_task(void *p_arg)
+{
+    spp_logger_t *p_logger = (spp_logger_t *)p_arg;
+    spp_uint32_t waitMs =
+        (p_logger->cfg.flush_interval_ms != 0u) ? p_logger->cfg.flush_interval_ms : K_IDLE_WAIT_MS;
+
+    for (;;)
+    {
+        spp_uint8_t token = 0;
+        retval_t ret = SPP_OSAL_QueueReceive(p_logger->p_doorbell, &token, waitMs);
+
+        spp_uint8_t stopping = (p_logger->running == 0u);
+        if (stopping != 0u || (ret != SPP_OK && p_logger->cfg.flush_interval_ms != 0u))
+        {
+            portENTER_CRITICAL(&p_logger->lock);
+            (void)logger_seal(p_logger, esp_timer_get_time());
+            logger_update_in_use(p_logger);
+            portEXIT_CRITICAL(&p_logger->lock);
+        }
+
+        logger_drain(p_logger);
+
+        if (stopping != 0u)
+            break;
+    }
+
+    /* A stop that timed out has left the file for this task to close */
+    if (__atomic_exchange_n(&p_logger->closeHandoff, 1u, __ATOMIC_ACQ_REL) != 0u)
+    {
+        (void)logger_close_file(p_logger);
+    }
+    p_logger->taskExited = 1;
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Open the log file and start the writer task.
+ *
+ * The file is opened for appending; start from an empty file to keep
+ * buffer writes aligned to clusters. The storage volume must be mounted.
+ *
+ * @param[in] p_logger Logger instance, zero-initialised before first use.
+ * @param[in] p_cfg    Logger setup; copied into the logger.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the logger is running, the config is invalid, or the
+ *         file or an OSAL object could not be created.
+ */
+retval_t SPP_HAL_Logger_Start(spp_logger_t *p_logger, const spp_logger_config_t *p_cfg)
+{
+    if (p_logger == NULL || p_cfg == NULL || p_cfg->p_path == NULL || p_cfg->p_buffers == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_logger->running != 0u || (p_logger->p_task != NULL && p_logger->taskExited == 0u))
+    {
+        return SPP_ERROR;
+    }
+    if (p_cfg->buffer_bytes == 0u || (p_cfg->buffer_bytes % SPP_LOGGER_SECTOR_BYTES) != 0u ||
+        p_cfg->buffer_count < 2u || p_cfg->buffer_count > SPP_LOGGER_MAX_BUFFERS)
+    {
+        return SPP_ERROR;
+    }
+
+    if (p_logger->p_doorbell == NULL)
+    {
+        p_logger->p_doorbell = SPP_OSAL_QueueCreate(SPP_LOGGER_MAX_BUFFERS + 1u, sizeof(spp_uint8_t));
+        if (p_logger->p_doorbell == NULL)
+        {
+            return SPP_ERROR;
+        }
+    }
+    SPP_OSAL_QueueReset(p_logger->p_doorbell);
+
+    p_logger->p_file = fopen(p_cfg->p_path, "ab");
+    if (p_logger->p_file == NULL)
+    {
+        return SPP_ERROR;
+    }
+    /* Whole buffers go straight to the filesystem, no stdio copy */
+    setvbuf(p_logger->p_file, NULL, _IONBF, 0);
+
+    p_logger->cfg = *p_cfg;
+    portMUX_INITIALIZE(&p_logger->lock);
+    p_logger->active = K_NO_BUFFER;
+    p_logger->activeOffset = 0;
+    p_logger->freeCount = p_cfg->buffer_count;
+    for (spp_uint32_t i = 0; i < p_cfg->buffer_count; i++)
+    {
+        /* Hand buffer 0 out first */
+        p_logger->freeStack[i] = (spp_uint8_t)(p_cfg->buffer_count - 1u - i);
+        p_logger->copying[i] = 0;
+    }
+    p_logger->fullHead = 0;
+    p_logger->fullCount = 0;
+    p_logger->writing = 0;
+    p_logger->stallStart = 0;
+    p_logger->sinceSync = 0;
+    memset(&p_logger->stats, 0, sizeof(p_logger->stats));
+    logger_take_free(p_logger, 0);
+    logger_update_in_use(p_logger);
+
+    p_logger->taskExited = 0;
+    p_logger->closeHandoff = 0;
+    p_logger->running = 1;
+
+    spp_uint32_t stack = (p_cfg->task_stack != 0u) ? p_cfg->task_stack : K_DEFAULT_STACK;
+    spp_uint32_t priority = (p_cfg->task_priority != 0u) ? p_cfg->task_priority : K_DEFAULT_PRIORITY;
+
+    p_logger->p_task = SPP_OSAL_TaskCreate(logger_task, "logger", stack, p_logger, priority,
+                                           SPP_OSAL_GetTaskStorage());
+    if (p_logger->p_task == NULL)
+    {
+        p_logger->running = 0;
+        fclose(p_logger->p_file);
+        p_logger->p_file = NULL;
+        return SPP_ERROR;
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Append one record without waiting for the card.
+ *
+ * Safe to call from several tasks at once (not from ISRs). The record is
+ * kept whole within one buffer.
+ *
+ * @param[in] p_logger Logger instance.
+ * @param[in] p_data   Record bytes.
+ * @param[in] length   Record length, at most buffer_bytes.
+ * @return SPP_OK if the record was accepted, SPP_ERROR_NULL_POINTER if a
+ *         pointer is NULL, SPP_ERROR if the logger is stopped, the record is
+ *         too long, or every buffer is full (the record is counted as
+ *         dropped).
+ */
+retval_t SPP_HAL_Logger_Append(spp_logger_t *p_logger, const void *p_data, spp_uint32_t length)
+{
+    if (p_logger == NULL || p_data == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_logger->running == 0u || length == 0u || length > p_logger->cfg.buffer_bytes)
+    {
+        return SPP_ERROR;
+    }
+
+    int64_t nowUs = esp_timer_get_time();
+    int sealed = 0;
+
+    portENTER_CRITICAL(&p_logger->lock);
+    /* Stop clears running under the lock before the final seal, so no
+     * space is reserved in a buffer the writer will never see */
+    if (p_logger->running == 0u)
+    {
+        portEXIT_CRITICAL(&p_logger->lock);
+        return SPP_ERROR;
+    }
+    logger_take_free(p_logger, nowUs);
+    if (p_logger->active != K_NO_BUFFER &&
+        p_logger->activeOffset + length > p_logger->cfg.buffer_bytes)
+    {
+        sealed = logger_seal(p_logger, nowUs);
+    }
+
+    if (p_logger->active == K_NO_BUFFER)
+    {
+        p_logger->stats.dropped_records += 1;
+        p_logger->stats.dropped_bytes += length;
+        if (p_logger->stallStart == 0)
+        {
+            p_logger->stallStart = nowUs;
+            p_logger->stats.stalls += 1;
+        }
+        logger_update_in_use(p_logger);
+        portEXIT_CRITICAL(&p_logger->lock);
+
+        if (sealed != 0)
+        {
+            logger_ring(p_logger);
+        }
+        return SPP_ERROR;
+    }
+
+    spp_uint32_t idx = (spp_uint32_t)p_logger->active;
+    spp_uint8_t *p_dst =
+        &p_logger->cfg.p_buffers[idx * p_logger->cfg.buffer_bytes + p_logger->activeOffset];
+    p_logger->activeOffset += length;
+    __atomic_fetch_add(&p_logger->copying[idx], 1u, __ATOMIC_RELAXED);
+    p_logger->stats.records += 1;
+    logger_update_in_use(p_logger);
+    portEXIT_CRITICAL(&p_logger->lock);
+
+    if (sealed != 0)
+    {
+        logger_ring(p_logger);
+    }
+
+    memcpy(p_dst, p_data, length);
+    __atomic_fetch_sub(&p_logger->copying[idx], 1u, __ATOMIC_RELEASE);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Write everything appended so far and wait for it.
+ *
+ * The partly filled active buffer is written as is, so later buffer writes
+ * are no longer cluster-aligned.
+ *
+ * @param[in] p_logger   Logger instance.
+ * @param[in] timeout_ms Longest to wait for the writer.
+ * @return SPP_OK once the data is written, SPP_ERROR_NULL_POINTER if
+ *         p_logger is NULL, SPP_ERROR if the logger is stopped or the
+ *         writer did not finish in time.
+ */
+retval_t SPP_HAL_Logger_Flush(spp_logger_t *p_logger, spp_uint32_t timeout_ms)
+{
+    if (p_logger == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_logger->running == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    portENTER_CRITICAL(&p_logger->lock);
+    int sealed = logger_seal(p_logger, esp_timer_get_time());
+    logger_update_in_use(p_logger);
+    portEXIT_CRITICAL(&p_logger->lock);
+
+    if (sealed != 0)
+    {
+        logger_ring(p_logger);
+    }
+
+    /* Timed on the clock: each 1 ms delay lasts at least one tick */
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    for (;;)
+    {
+        portENTER_CRITICAL(&p_logger->lock);
+        spp_uint8_t busy = (p_logger->fullCount != 0u || p_logger->writing != 0u);
+        portEXIT_CRITICAL(&p_logger->lock);
+
+        if (busy == 0u)
+            return SPP_OK;
+        if (esp_timer_get_time() >= deadline)
+            return SPP_ERROR;
+        SPP_OSAL_TaskDelay(1);
+    }
+}
+
+/**
+ * @brief Copy the logger counters.
+ *
+ * @param[in]  p_logger Logger instance.
+ * @param[out] p_stats  Receives the counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL.
+ */
+retval_t SPP_HAL_Logger_GetStats(spp_logger_t *p_logger, spp_logger_stats_t *p_stats)
+{
+    if (p_logger == NULL || p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    portENTER_CRITICAL(&p_logger->lock);
+    *p_stats = p_logger->stats;
+    portEXIT_CRITICAL(&p_logger->lock);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Write out remaining data, stop the writer and close the file.
+ *
+ * Appends racing with the stop may be refused; an accepted one is
+ * written. The file is synced before it is closed. If the writer does not
+ * finish within K_STOP_TIMEOUT_MS (a stalled card), the call fails and the
+ * writer closes the file itself once it gets through; the logger cannot
+ * be started again until then.
+ *
+ * @param[in] p_logger Logger instance.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_logger is NULL,
+ *         SPP_ERROR if the logger is not running, the writer did not finish
+ *         in time or closing the file failed.
+ */
+retval_t SPP_HAL_Logger_Stop(spp_logger_t *p_logger)
+{
+    if (p_logger == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_logger->running == 0u)
+    {
+        /* Also keeps a never-started logger's lock untouched */
+        return SPP_ERROR;
+    }
+
+    /* Cleared again under the lock, so no append reserves space after this */
+    portENTER_CRITICAL(&p_logger->lock);
+    spp_uint8_t wasRunning = p_logger->running;
+    p_logger->running = 0;
+    portEXIT_CRITICAL(&p_logger->lock);
+
+    if (wasRunning == 0u)
+    {
+        return SPP_ERROR;
+    }
+    logger_ring(p_logger);
+
+    int64_t deadline = esp_timer_get_time() + (int64_t)K_STOP_TIMEOUT_MS * 1000;
+    int handoffTried = 0;
+    while (p_logger->taskExited == 0u)
+    {
+        /* Hand the file to the writer, unless it is already on its way out */
+        if (handoffTried == 0 && esp_timer_get_time() >= deadline)
+        {
+            handoffTried = 1;
+            if (__atomic_exchange_n(&p_logger->closeHandoff, 1u, __ATOMIC_ACQ_REL) == 0u)
+            {
+                return SPP_ERROR;
+            }
+        }
+        SPP_OSAL_TaskDelay(1);
+    }
+    p_logger->p_task = NULL;
+
+    int err = logger_close_file(p_logger);
+    return (err == 0) ? SPP_OK : SPP_ERROR;
+}
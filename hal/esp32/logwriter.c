@@ -0,0 +1,350 @@
+/**
+ * @file logwriter.c
+ * @brief Writer for the SPP binary telemetry log format.
+ *
+ * Each frame is assembled in the writer's frame buffer (payload first,
+ * then header and CRC) and passed to the sink in one call, so a sink such
+ * as the buffered logger either stores the whole frame or drops it. The
+ * writer tracks the file offset from what the sink accepted, which is
+ * what places SYNC and INDEX frames on their interval boundaries.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <string.h>
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+
+#include "esp_random.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+
+#include "logformat.h"
+#include "logger.h"
+#include "logwriter.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Smallest accepted sync interval. */
+#define K_MIN_SYNC_INTERVAL 1024u
+
+/** @brief Bytes of the file header covered by its CRC. */
+#define K_HEADER_CRC_BYTES (sizeof(spp_logfmt_file_header_t) - sizeof(uint32_t))
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Payload area of the frame buffer.
+ *
+ * @param[in] p_writer Writer instance.
+ * @return Where the payload of the next frame goes.
+ */
+static spp_uint8_t *logwriter_payload(spp_logwriter_t *p_writer)
+{
+    return &p_writer->frame[sizeof(spp_logfmt_frame_t)];
+}
+
+/**
+ * @brief Finish the frame whose payload is in the frame buffer and sink it.
+ *
+ * The sequence number advances even if the sink refuses the frame, so
+ * readers see the gap.
+ *
+ * @param[in] p_writer Writer instance.
+ * @param[in] type     Frame type.
+ * @param[in] flags    Frame flags.
+ * @param[in] time_us  Frame time.
+ * @param[in] length   Payload length already in the frame buffer.
+ * @return SPP_OK if the sink took the frame, SPP_ERROR if it was dropped.
+ */
+static retval_t logwriter_emit(spp_logwriter_t *p_writer, spp_uint8_t type, spp_uint8_t flags,
+                               int64_t time_us, spp_uint32_t length)
+{
+    spp_logfmt_frame_t header = {
+        .magic = SPP_LOGFMT_FRAME_MAGIC,
+        .type = type,
+        .flags = flags,
+        .length = (uint16_t)length,
+        .seq = p_writer->seq,
+        .time_us = time_us,
+    };
+    memcpy(p_writer->frame, &header, sizeof(header));
+
+    spp_uint32_t covered = (spp_uint32_t)sizeof(header) + length;
+    uint32_t crc = esp_rom_crc32_le(p_writer->cfg.session, p_writer->frame, covered);
+    memcpy(&p_writer->frame[covered], &crc, sizeof(crc));
+
+    p_writer->seq += 1;
+
+    spp_uint32_t total = covered + (spp_uint32_t)sizeof(crc);
+    if (p_writer->cfg.p_sink(p_writer->cfg.p_sink_ctx, p_writer->frame, total) != SPP_OK)
+    {
+        p_writer->stats.dropped += 1;
+        return SPP_ERROR;
+    }
+
+    p_writer->offset += total;
+    p_writer->stats.frames += 1;
+    p_writer->stats.bytes = p_writer->offset;
+    return SPP_OK;
+}
+
+/**
+ * @brief Emit an INDEX frame with the SYNC entries collected so far.
+ *
+ * @param[in] p_writer Writer instance.
+ * @param[in] flags    SPP_LOGFMT_FLAG_* for the frame.
+ * @param[in] time_us  Frame time.
+ * @return SPP_OK if written, SPP_ERROR if dropped (entries are kept).
+ */
+static retval_t logwriter_emit_index(spp_logwriter_t *p_writer, spp_uint8_t flags, int64_t time_us)
+{
+    spp_logfmt_index_t index = {
+        .prev_index_offset = p_writer->lastIndex,
+        .count = p_writer->entryCount,
+        .reserved = 0,
+    };
+    spp_uint8_t *p_payload = logwriter_payload(p_writer);
+    spp_uint32_t entryBytes = p_writer->entryCount * (spp_uint32_t)sizeof(spp_logfmt_index_entry_t);
+
+    memcpy(p_payload, &index, sizeof(index));
+    memcpy(&p_payload[sizeof(index)], p_writer->entries, entryBytes);
+
+    uint64_t frameOffset = p_writer->offset;
+    retval_t ret = logwriter_emit(p_writer, SPP_LOGFMT_TYPE_INDEX, flags, time_us,
+                                  (spp_uint32_t)sizeof(index) + entryBytes);
+    if (ret == SPP_OK)
+    {
+        p_writer->lastIndex = frameOffset;
+        p_writer->entryCount = 0;
+        p_writer->stats.index_frames += 1;
+    }
+    return ret;
+}
+
+/**
+ * @brief Emit the SYNC and INDEX frames that are due before a record.
+ *
+ * A marker the sink refuses is retried before the next record.
+ *
+ * @param[in] p_writer Writer instance.
+ * @param[in] time_us  Time of the record about to be written.
+ */
+static void logwriter_markers(spp_logwriter_t *p_writer, int64_t time_us)
+{
+    if (p_writer->offset >= p_writer->nextIndex)
+    {
+        uint64_t frameOffset = p_writer->offset;
+        if (logwriter_emit_index(p_writer, 0, time_us) == SPP_OK)
+        {
+            p_writer->nextIndex =
+                (frameOffset / p_writer->cfg.index_interval + 1u) * p_writer->cfg.index_interval;
+        }
+    }
+
+    if (p_writer->offset >= p_writer->nextSync)
+    {
+        uint64_t frameOffset = p_writer->offset;
+        spp_logfmt_sync_t sync = {
+            .offset = frameOffset,
+            .frames = p_writer->stats.frames,
+            .dropped = p_writer->stats.dropped,
+        };
+        memcpy(sync.pattern, SPP_LOGFMT_SYNC_PATTERN, sizeof(sync.pattern));
+        memcpy(logwriter_payload(p_writer), &sync, sizeof(sync));
+
+        if (logwriter_emit(p_writer, SPP_LOGFMT_TYPE_SYNC, 0, time_us, sizeof(sync)) == SPP_OK)
+        {
+            /* Full only if INDEX frames keep being dropped; the SYNC is still usable */
+            if (p_writer->entryCount < SPP_LOGFMT_INDEX_MAX_ENTRIES)
+            {
+                p_writer->entries[p_writer->entryCount].time_us = time_us;
+                p_writer->entries[p_writer->entryCount].offset = frameOffset;
+                p_writer->entryCount += 1;
+            }
+            p_writer->nextSync =
+                (frameOffset / p_writer->cfg.sync_interval + 1u) * p_writer->cfg.sync_interval;
+            p_writer->stats.sync_frames += 1;
+        }
+    }
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Start a log: check the setup and write the file header.
+ *
+ * The sink must start at the beginning of an empty file (or of a
+ * preallocated region), since frame offsets are counted from there.
+ *
+ * @param[in] p_writer Writer instance.
+ * @param[in] p_cfg    Writer setup; copied into the writer.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer or the
+ *         sink is NULL, SPP_ERROR if the intervals are invalid or the sink
+ *         refused the header.
+ */
+retval_t SPP_HAL_LogWriter_Open(spp_logwriter_t *p_writer, const spp_logwriter_config_t *p_cfg)
+{
+    if (p_writer == NULL || p_cfg == NULL || p_cfg->p_sink == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spp_logwriter_config_t cfg = *p_cfg;
+    if (cfg.sync_interval == 0u)
+    {
+        cfg.sync_interval = SPP_LOGWRITER_SYNC_INTERVAL;
+    }
+    if (cfg.index_interval == 0u)
+    {
+        cfg.index_interval = SPP_LOGWRITER_INDEX_INTERVAL;
+    }
+    if (cfg.session == 0u)
+    {
+        cfg.session = esp_random();
+    }
+    if (cfg.sync_interval < K_MIN_SYNC_INTERVAL || (cfg.index_interval % cfg.sync_interval) != 0u ||
+        cfg.index_interval / cfg.sync_interval > SPP_LOGFMT_INDEX_MAX_ENTRIES)
+    {
+        return SPP_ERROR;
+    }
+
+    spp_logfmt_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SPP_LOGFMT_FILE_MAGIC, sizeof(header.magic));
+    header.version = SPP_LOGFMT_VERSION;
+    header.header_bytes = (uint16_t)sizeof(header);
+    header.session = cfg.session;
+    header.sync_interval = cfg.sync_interval;
+    header.index_interval = cfg.index_interval;
+    header.max_frame_bytes = SPP_LOGFMT_MAX_FRAME;
+    header.start_time_us = esp_timer_get_time();
+    header.wall_time_us = cfg.wall_time_us;
+    header.crc = esp_rom_crc32_le(0, (const uint8_t *)&header, K_HEADER_CRC_BYTES);
+
+    if (cfg.p_sink(cfg.p_sink_ctx, &header, sizeof(header)) != SPP_OK)
+    {
+        return SPP_ERROR;
+    }
+
+    p_writer->cfg = cfg;
+    p_writer->offset = sizeof(header);
+    p_writer->nextSync = 0;
+    p_writer->nextIndex = cfg.index_interval;
+    p_writer->lastIndex = SPP_LOGFMT_NO_OFFSET;
+    p_writer->seq = 0;
+    p_writer->entryCount = 0;
+    memset(&p_writer->stats, 0, sizeof(p_writer->stats));
+    p_writer->stats.bytes = p_writer->offset;
+    p_writer->open = 1;
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Write one record frame.
+ *
+ * Due SYNC and INDEX frames go out first, stamped with the record's time.
+ *
+ * @param[in] p_writer  Writer instance.
+ * @param[in] type      Record type, SPP_LOGFMT_TYPE_USER or above.
+ * @param[in] time_us   Record time; should not go backwards.
+ * @param[in] p_payload Record bytes (may be NULL if length is 0).
+ * @param[in] length    Record length, at most SPP_LOGFMT_MAX_PAYLOAD.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_writer is NULL or
+ *         p_payload is NULL with a non-zero length, SPP_ERROR if the writer
+ *         is not open, the type or length is invalid, or the sink dropped
+ *         the frame.
+ */
+retval_t SPP_HAL_LogWriter_Write(spp_logwriter_t *p_writer, spp_uint8_t type, int64_t time_us,
+                                 const void *p_payload, spp_uint32_t length)
+{
+    if (p_writer == NULL || (p_payload == NULL && length != 0u))
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_writer->open == 0u || type < SPP_LOGFMT_TYPE_USER || length > SPP_LOGFMT_MAX_PAYLOAD)
+    {
+        return SPP_ERROR;
+    }
+
+    logwriter_markers(p_writer, time_us);
+
+    if (length != 0u)
+    {
+        memcpy(logwriter_payload(p_writer), p_payload, length);
+    }
+    return logwriter_emit(p_writer, type, 0, time_us, length);
+}
+
+/**
+ * @brief End a log with a final INDEX frame covering the remaining SYNCs.
+ *
+ * Does not close the sink.
+ *
+ * @param[in] p_writer Writer instance.
+ * @param[in] time_us  Time stamped on the final frame.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_writer is NULL,
+ *         SPP_ERROR if the writer is not open or the final frame was
+ *         dropped (the writer is closed either way).
+ */
+retval_t SPP_HAL_LogWriter_Close(spp_logwriter_t *p_writer, int64_t time_us)
+{
+    if (p_writer == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_writer->open == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    retval_t ret = logwriter_emit_index(p_writer, SPP_LOGFMT_FLAG_FINAL, time_us);
+    p_writer->open = 0;
+
+    return ret;
+}
+
+/**
+ * @brief Copy the writer counters.
+ *
+ * @param[in]  p_writer Writer instance.
+ * @param[out] p_stats  Receives the counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL.
+ */
+retval_t SPP_HAL_LogWriter_GetStats(const spp_logwriter_t *p_writer, spp_logwriter_stats_t *p_stats)
+{
+    if (p_writer == NULL || p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    *p_stats = p_writer->stats;
+    return SPP_OK;
+}
+
+/**
+ * @brief Sink that appends frames to a running spp_logger_t.
+ *
+ * Set p_sink_ctx to the logger. The logger keeps every frame whole within
+ * one of its buffers, so its buffer_bytes must be at least
+ * SPP_LOGFMT_MAX_FRAME for the largest frames to be accepted.
+ *
+ * @param[in] p_ctx  The spp_logger_t.
+ * @param[in] p_data Frame bytes.
+ * @param[in] length Frame length.
+ * @return Result of SPP_HAL_Logger_Append().
+ */
+retval_t SPP_HAL_LogWriter_LoggerSink(void *p_ctx, const void *p_data, spp_uint32_t length)
+{
+    return SPP_HAL_Logger_Append((spp_logger_t *)p_ctx, p_data, length);
+}
@@ -0,0 +1,439 @@
+/**
+ * @file reader.c
+ * @brief Read-ahead SD card file reader for the ESP32 HAL.
+ *
+ * Buffer indices circulate through two OSAL queues: the prefetch task
+ * takes an empty buffer from the free queue, fills it with the next part of
+ * the file and posts it to the ready queue; the consumer takes buffers from
+ * the ready queue as views and gives them back to the free queue. After
+ * the last buffer the task posts an end marker and exits. Both queues hold
+ * every buffer plus one marker, so posting never blocks.
+ *
+ * Reads of a whole sector-multiple, word-aligned buffer go through
+ * unbuffered stdio, so FATFS transfers straight into the buffer without a
+ * copy. The same code runs on the host against a regular file.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "spp/osal/queue.h"
+#include "spp/osal/task.h"
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+#include "reader.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Ready queue marker: no more buffers will follow. */
+#define K_END 0xFFu
+
+/** @brief Free queue marker: wake the task so it sees a stop request. */
+#define K_WAKE 0xFEu
+
+/** @brief Prefetch task wake-up period while every buffer is lent out or ready. */
+#define K_IDLE_WAIT_MS 100u
+
+/** @brief Longest SPP_HAL_Reader_Close() waits for the prefetch task to exit. */
+#define K_STOP_TIMEOUT_MS 5000u
+
+/** @brief Prefetch task stack depth used when the config leaves it at 0. */
+#define K_DEFAULT_STACK 4096u
+
+/** @brief Prefetch task priority used when the config leaves it at 0. */
+#define K_DEFAULT_PRIORITY 5u
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Fill one buffer from the file.
+ *
+ * @param[in] p_reader Reader instance.
+ * @param[in] idx      Buffer to fill.
+ * @param[in] offset   File offset the file position is at.
+ * @return Bytes read; 0 at the end of the file or on a read error.
+ */
+static spp_uint32_t reader_fill(spp_reader_t *p_reader, spp_uint32_t idx, uint64_t offset)
+{
+    uint64_t remaining = p_reader->endOffset - offset;
+    spp_uint32_t want = (remaining < p_reader->cfg.buffer_bytes) ? (spp_uint32_t)remaining
+                                                                  : p_reader->cfg.buffer_bytes;
+    spp_uint8_t *p_buffer = &p_reader->cfg.p_buffers[idx * p_reader->cfg.buffer_bytes];
+
+    int64_t startUs = esp_timer_get_time();
+    size_t got = fread(p_buffer, 1, want, p_reader->p_file);
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+
+    portENTER_CRITICAL(&p_reader->lock);
+    if (got != 0u)
+    {
+        p_reader->stats.buffers_read += 1;
+        p_reader->stats.bytes_read += got;
+        p_reader->stats.read_total += elapsedUs;
+        if (elapsedUs > p_reader->stats.read_max)
+        {
+            p_reader->stats.read_max = elapsedUs;
+        }
+    }
+    else if (ferror(p_reader->p_file) != 0)
+    {
+        p_reader->stats.read_errors += 1;
+    }
+    portEXIT_CRITICAL(&p_reader->lock);
+
+    return (spp_uint32_t)got;
+}
+
+/**
+ * @brief Prefetch task: keep every free buffer filled ahead of the consumer.
+ *
+ * @param[in] p_arg The spp_reader_t being serviced.
+ */
+static void reader_task(void *p_arg)
+{
+    spp_reader_t *p_reader = (spp_reader_t *)p_arg;
+    uint64_t offset = p_reader->cfg.start_offset;
+
+    while (p_reader->running != 0u)
+    {
+        spp_uint8_t idx = K_WAKE;
+
+        if (offset >= p_reader->endOffset)
+            break;
+        if (SPP_OSAL_QueueReceive(p_reader->p_free, &idx, K_IDLE_WAIT_MS) != SPP_OK ||
+            idx == K_WAKE)
+            continue;
+
+        spp_uint32_t got = reader_fill(p_reader, idx, offset);
+        if (got == 0u)
+        {
+            (void)SPP_OSAL_QueueSend(p_reader->p_free, &idx, 0);
+            break;
+        }
+
+        p_reader->bufferOffset[idx] = offset;
+        p_reader->bufferLength[idx] = got;
+        offset += got;
+
+        portENTER_CRITICAL(&p_reader->lock);
+        p_reader->stats.buffers_ready += 1;
+        portEXIT_CRITICAL(&p_reader->lock);
+        (void)SPP_OSAL_QueueSend(p_reader->p_ready, &idx, 0);
+    }
+
+    if (p_reader->running != 0u)
+    {
+        spp_uint8_t end = K_END;
+        p_reader->doneUs = esp_timer_get_time();
+        (void)SPP_OSAL_QueueSend(p_reader->p_ready, &end, 0);
+    }
+
+    /* A close that timed out has left the file for this task to close */
+    if (__atomic_exchange_n(&p_reader->closeHandoff, 1u, __ATOMIC_ACQ_REL) != 0u)
+    {
+        fclose(p_reader->p_file);
+        p_reader->p_file = NULL;
+    }
+    p_reader->taskExited = 1;
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Open a file and start reading it ahead.
+ *
+ * The storage volume must be mounted. Reading starts at once into every
+ * buffer.
+ *
+ * @param[in] p_reader Reader instance, zero-initialised before first use.
+ * @param[in] p_cfg    Reader setup; copied into the reader.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the reader is open, the config is invalid, or the
+ *         file or an OSAL object could not be opened or created.
+ */
+retval_t SPP_HAL_Reader_Open(spp_reader_t *p_reader, const spp_reader_config_t *p_cfg)
+{
+    if (p_reader == NULL || p_cfg == NULL || p_cfg->p_path == NULL || p_cfg->p_buffers == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_reader->running != 0u || (p_reader->p_task != NULL && p_reader->taskExited == 0u))
+    {
+        return SPP_ERROR;
+    }
+    if (p_cfg->buffer_bytes == 0u || (p_cfg->buffer_bytes % SPP_READER_SECTOR_BYTES) != 0u ||
+        p_cfg->buffer_count < 2u || p_cfg->buffer_count > SPP_READER_MAX_BUFFERS)
+    {
+        return SPP_ERROR;
+    }
+
+    if (p_reader->p_free == NULL)
+    {
+        p_reader->p_free = SPP_OSAL_QueueCreate(SPP_READER_MAX_BUFFERS + 1u, sizeof(spp_uint8_t));
+    }
+    if (p_reader->p_ready == NULL)
+    {
+        p_reader->p_ready = SPP_OSAL_QueueCreate(SPP_READER_MAX_BUFFERS + 1u, sizeof(spp_uint8_t));
+    }
+    if (p_reader->p_free == NULL || p_reader->p_ready == NULL)
+    {
+        return SPP_ERROR;
+    }
+    SPP_OSAL_QueueReset(p_reader->p_free);
+    SPP_OSAL_QueueReset(p_reader->p_ready);
+
+    p_reader->p_file = fopen(p_cfg->p_path, "rb");
+    if (p_reader->p_file == NULL)
+    {
+        return SPP_ERROR;
+    }
+    /* Whole buffers come straight from the filesystem, no stdio copy */
+    setvbuf(p_reader->p_file, NULL, _IONBF, 0);
+    if (fseeko(p_reader->p_file, (off_t)p_cfg->start_offset, SEEK_SET) != 0)
+    {
+        fclose(p_reader->p_file);
+        p_reader->p_file = NULL;
+        return SPP_ERROR;
+    }
+
+    p_reader->cfg = *p_cfg;
+    portMUX_INITIALIZE(&p_reader->lock);
+    p_reader->endOffset =
+        (p_cfg->length != 0u) ? p_cfg->start_offset + p_cfg->length : UINT64_MAX;
+    for (spp_uint32_t i = 0; i < p_cfg->buffer_count; i++)
+    {
+        spp_uint8_t idx = (spp_uint8_t)i;
+        (void)SPP_OSAL_QueueSend(p_reader->p_free, &idx, 0);
+    }
+    memset(&p_reader->stats, 0, sizeof(p_reader->stats));
+    p_reader->ended = 0;
+    p_reader->openUs = esp_timer_get_time();
+    p_reader->doneUs = 0;
+
+    p_reader->taskExited = 0;
+    p_reader->closeHandoff = 0;
+    p_reader->running = 1;
+
+    spp_uint32_t stack = (p_cfg->task_stack != 0u) ? p_cfg->task_stack : K_DEFAULT_STACK;
+    spp_uint32_t priority = (p_cfg->task_priority != 0u) ? p_cfg->task_priority : K_DEFAULT_PRIORITY;
+
+    p_reader->p_task = SPP_OSAL_TaskCreate(reader_task, "reader", stack, p_reader, priority,
+                                           SPP_OSAL_GetTaskStorage());
+    if (p_reader->p_task == NULL)
+    {
+        p_reader->running = 0;
+        fclose(p_reader->p_file);
+        p_reader->p_file = NULL;
+        return SPP_ERROR;
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Borrow the next filled buffer.
+ *
+ * Buffers come in file order. Several views may be held at once; each
+ * must be given back with SPP_HAL_Reader_Release() before the task can
+ * refill it. Call from one consumer task only.
+ *
+ * @param[in]  p_reader   Reader instance.
+ * @param[out] p_view     Receives the buffer; length 0 marks the end of the
+ *                        stream (end of file, the requested length, or a
+ *                        read error counted in the stats).
+ * @param[in]  timeout_ms Longest to wait for the card.
+ * @return SPP_OK if p_view is filled in, SPP_ERROR_NULL_POINTER if a
+ *         pointer is NULL, SPP_ERROR if the reader is closed or no buffer
+ *         was filled in time.
+ */
+retval_t SPP_HAL_Reader_Acquire(spp_reader_t *p_reader, spp_reader_view_t *p_view,
+                                spp_uint32_t timeout_ms)
+{
+    if (p_reader == NULL || p_view == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_reader->running == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    spp_uint8_t idx = K_END;
+    if (p_reader->ended == 0u && SPP_OSAL_QueueReceive(p_reader->p_ready, &idx, 0) != SPP_OK)
+    {
+        if (timeout_ms == 0u)
+            return SPP_ERROR;
+
+        int64_t startUs = esp_timer_get_time();
+        retval_t ret = SPP_OSAL_QueueReceive(p_reader->p_ready, &idx, timeout_ms);
+        int64_t waitedUs = esp_timer_get_time() - startUs;
+
+        portENTER_CRITICAL(&p_reader->lock);
+        p_reader->stats.stalls += 1;
+        p_reader->stats.stall_total += waitedUs;
+        portEXIT_CRITICAL(&p_reader->lock);
+
+        if (ret != SPP_OK)
+            return SPP_ERROR;
+    }
+
+    if (idx == K_END)
+    {
+        p_reader->ended = 1;
+        p_view->p_data = NULL;
+        p_view->length = 0;
+        p_view->offset = p_reader->cfg.start_offset + p_reader->stats.bytes_delivered;
+        p_view->buffer = K_END;
+        return SPP_OK;
+    }
+
+    p_view->p_data = &p_reader->cfg.p_buffers[idx * p_reader->cfg.buffer_bytes];
+    p_view->length = p_reader->bufferLength[idx];
+    p_view->offset = p_reader->bufferOffset[idx];
+    p_view->buffer = idx;
+
+    portENTER_CRITICAL(&p_reader->lock);
+    p_reader->stats.buffers_ready -= 1;
+    p_reader->stats.buffers_lent += 1;
+    p_reader->stats.bytes_delivered += p_view->length;
+    portEXIT_CRITICAL(&p_reader->lock);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Give a borrowed buffer back for refilling.
+ *
+ * Releasing the end-of-stream view is allowed and does nothing. The view
+ * is cleared so it cannot be released twice.
+ *
+ * @param[in]     p_reader Reader instance.
+ * @param[in,out] p_view   View from SPP_HAL_Reader_Acquire().
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the reader is closed or the view is not lent out.
+ */
+retval_t SPP_HAL_Reader_Release(spp_reader_t *p_reader, spp_reader_view_t *p_view)
+{
+    if (p_reader == NULL || p_view == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_reader->running == 0u)
+    {
+        return SPP_ERROR;
+    }
+    if (p_view->buffer == K_END)
+    {
+        return SPP_OK;
+    }
+    if (p_view->p_data == NULL || p_view->buffer >= p_reader->cfg.buffer_count)
+    {
+        return SPP_ERROR;
+    }
+
+    spp_uint8_t idx = p_view->buffer;
+    p_view->p_data = NULL;
+    p_view->length = 0;
+
+    portENTER_CRITICAL(&p_reader->lock);
+    p_reader->stats.buffers_lent -= 1;
+    portEXIT_CRITICAL(&p_reader->lock);
+
+    return SPP_OSAL_QueueSend(p_reader->p_free, &idx, 0);
+}
+
+/**
+ * @brief Copy the reader counters.
+ *
+ * Throughput is bytes_delivered / elapsed; the consumer was limited by the
+ * card for stall_total of it.
+ *
+ * @param[in]  p_reader Reader instance.
+ * @param[out] p_stats  Receives the counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL.
+ */
+retval_t SPP_HAL_Reader_GetStats(spp_reader_t *p_reader, spp_reader_stats_t *p_stats)
+{
+    if (p_reader == NULL || p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    int64_t nowUs = esp_timer_get_time();
+
+    portENTER_CRITICAL(&p_reader->lock);
+    *p_stats = p_reader->stats;
+    portEXIT_CRITICAL(&p_reader->lock);
+
+    int64_t doneUs = p_reader->doneUs;
+    p_stats->elapsed = ((doneUs != 0) ? doneUs : nowUs) - p_reader->openUs;
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Stop the prefetch task and close the file.
+ *
+ * Views still held become invalid. If the task does not exit within
+ * K_STOP_TIMEOUT_MS (a read stuck on the card), the call fails and the
+ * task closes the file itself once it gets through; the reader cannot be
+ * opened again until then.
+ *
+ * @param[in] p_reader Reader instance.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_reader is NULL,
+ *         SPP_ERROR if the reader is not open, the task did not exit in
+ *         time or closing the file failed.
+ */
+retval_t SPP_HAL_Reader_Close(spp_reader_t *p_reader)
+{
+    if (p_reader == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_reader->running == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    spp_uint8_t wake = K_WAKE;
+    p_reader->running = 0;
+    (void)SPP_OSAL_QueueSend(p_reader->p_free, &wake, 0);
+
+    int64_t deadline = esp_timer_get_time() + (int64_t)K_STOP_TIMEOUT_MS * 1000;
+    int handoffTried = 0;
+    while (p_reader->taskExited == 0u)
+    {
+        /* Hand the file to the task, unless it is already on its way out */
+        if (handoffTried == 0 && esp_timer_get_time() >= deadline)
+        {
+            handoffTried = 1;
+            if (__atomic_exchange_n(&p_reader->closeHandoff, 1u, __ATOMIC_ACQ_REL) == 0u)
+            {
+                return SPP_ERROR;
+            }
+        }
+        SPP_OSAL_TaskDelay(1);
+    }
+    p_reader->p_task = NULL;
+
+    int err = fclose(p_reader->p_file);
+    p_reader->p_file = NULL;
+
+    return (err == 0) ? SPP_OK : SPP_ERROR;
+}
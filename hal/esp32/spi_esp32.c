@@ -7,14 +7,161 @@
 #include <string.h>
 #include <stdint.h>
 #include "macros_esp.h"
+#include "spi_esp32.h"
+#include "trace.h"
+#include "esp_attr.h"
 
 static const char *TAG = "SPP_HAL_SPI";
-static void* p_bmp_handler;
 
-#define NUMBER_OF_DEVICES 2
+/** @brief Read flag in the first address byte of a register access. */
+#define REG_READ_FLAG 0x80u
 
-static spi_device_handle_t spi_handler[NUMBER_OF_DEVICES]; 
-static int device_state[NUMBER_OF_DEVICES] = {EMPTY};
+static spi_device_handle_t spi_handler[MAX_DEVICES]; 
+static int device_state[MAX_DEVICES] = {EMPTY};
+
+/**
+ * @brief Device descriptors, indexed like spi_handler.
+ *
+ * Handlers are handed out in table order, so the first two entries keep
+ * the ICM20948-then-BMP390 order that SPP drivers expect. Entries with
+ * max_clock_hz == 0 are free for SPP_HAL_SPI_SetDeviceDesc().
+ */
+static spp_spi_device_desc_t s_deviceDesc[MAX_DEVICES] = {
+    { CS_PIN_ICM, 0, ICM_MAX_CLOCK_HZ, 0, 1, 1, SPP_SPI_DRIVER_HAL },
+    { CS_PIN_BMP, 0, BMP_MAX_CLOCK_HZ, 1, 1, 1, SPP_SPI_DRIVER_HAL },
+    { CS_PIN_SDC, 0, SDC_MAX_CLOCK_HZ, 0, 0, 0, SPP_SPI_DRIVER_SDSPI },
+};
+
+/** @brief Transfers up to this many bytes use polling mode (0 = never poll). */
+static uint16_t s_pollingMaxBytes = SPI_POLLING_MAX_BYTES;
+
+/** @brief Async transfers queued on each device and not yet reaped. */
+static uint8_t s_asyncPending[MAX_DEVICES];
+
+/** @brief Round a byte count up to a whole number of 32-bit DMA words. */
+#define SPI_DMA_ROUND(bytes) (((bytes) + 3u) & ~3u)
+
+/**
+ * @brief Burst buffer size: address byte, up to 3 dummy bytes and the data,
+ *        a whole number of DMA words so every slot stays word aligned.
+ */
+#define BURST_BUFFER_BYTES SPI_DMA_ROUND(SPP_HAL_SPI_BURST_MAX_BYTES + 4u)
+
+/** @brief DMA-capable buffers shared by all burst reads. */
+DMA_ATTR static uint8_t s_burstBuffers[SPI_BURST_POOL_SIZE][BURST_BUFFER_BYTES];
+
+/** @brief Non-zero while the burst buffer of the same index is in use. */
+static uint8_t s_burstBusy[SPI_BURST_POOL_SIZE];
+
+/**
+ * @brief Claim a free burst buffer.
+ *
+ * @return The buffer, or NULL if all SPI_BURST_POOL_SIZE buffers are in use.
+ */
+static uint8_t *spi_burst_buffer_take(void)
+{
+    for (int i = 0; i < SPI_BURST_POOL_SIZE; i++)
+    {
+        if (__atomic_exchange_n(&s_burstBusy[i], 1u, __ATOMIC_ACQUIRE) == 0u)
+        {
+            return s_burstBuffers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Return a buffer claimed with spi_burst_buffer_take().
+ *
+ * @param[in] p_buffer Buffer to release.
+ */
+static void spi_burst_buffer_give(const uint8_t *p_buffer)
+{
+    int i = (int)((p_buffer - s_burstBuffers[0]) / BURST_BUFFER_BYTES);
+    __atomic_store_n(&s_burstBusy[i], 0u, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Map a handler from SPP_HAL_SPI_GetHandler() to its device index.
+ *
+ * @param[in] handler Device handler.
+ * @return Index into spi_handler, or -1 for a foreign pointer.
+ */
+static int spi_device_index(const void *handler)
+{
+    const spi_device_handle_t *p_handle = (const spi_device_handle_t *)handler;
+
+    if (p_handle < &spi_handler[0] || p_handle >= &spi_handler[MAX_DEVICES]) {
+        return -1;
+    }
+    return (int)(p_handle - &spi_handler[0]);
+}
+
+/**
+ * @brief Whether synchronous transfers must be refused on a device.
+ *
+ * The driver returns queued results in order, so a blocking transmit on a
+ * device with async transfers in flight would pick up the wrong result.
+ *
+ * @param[in] handler Device handler.
+ * @return true if async transfers are queued and not yet reaped.
+ */
+static spp_bool_t spi_async_busy(const void *handler)
+{
+    int dev = spi_device_index(handler);
+    return (dev >= 0) && (__atomic_load_n(&s_asyncPending[dev], __ATOMIC_ACQUIRE) != 0u);
+}
+
+/**
+ * @brief Run a synchronous transfer in the mode that suits its length.
+ *
+ * Short transfers busy-wait in polling mode, which avoids the interrupt
+ * and the two context switches of spi_device_transmit(); long ones block
+ * in interrupt mode and leave the CPU to other tasks.
+ *
+ * @param[in]     p_handler Driver device handle.
+ * @param[in,out] p_trans   Transaction to run.
+ * @return The driver's result.
+ */
+static esp_err_t spi_device_run(spi_device_handle_t p_handler, spi_transaction_t *p_trans)
+{
+    if (p_trans->length <= 8u * (size_t)s_pollingMaxBytes) {
+        return spi_device_polling_transmit(p_handler, p_trans);
+    }
+    return spi_device_transmit(p_handler, p_trans);
+}
+
+/**
+ * @brief Driver post-transaction callback, installed on every device.
+ *
+ * Runs in ISR context. Synchronous transfers carry no batch and are
+ * ignored; the last transfer of a batch signals its completion.
+ *
+ * @param[in] p_trans Finished transaction.
+ */
+static void IRAM_ATTR spi_async_post_cb(spi_transaction_t *p_trans)
+{
+    spp_spi_batch_t *p_batch = (spp_spi_batch_t *)p_trans->user;
+    if (p_batch == NULL) {
+        return;
+    }
+
+    if (__atomic_sub_fetch(&p_batch->pending, 1u, __ATOMIC_ACQ_REL) != 0u ||
+        __atomic_load_n(&p_batch->failed, __ATOMIC_ACQUIRE) != 0u) {
+        return;
+    }
+
+    if (p_batch->p_callback != NULL) {
+        p_batch->p_callback(p_batch->p_callbackCtx);
+    }
+    if (p_batch->p_eventGroup != NULL) {
+        spp_uint8_t hpw = 0;
+        OSAL_EventGroupSetBitsFromISR(p_batch->p_eventGroup, p_batch->bits, NULL, &hpw);
+        if (hpw != 0) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
 
 //---Init---
 retval_t SPP_HAL_SPI_BusInit(void)
@@ -43,47 +190,66 @@ retval_t SPP_HAL_SPI_BusInit(void)
     return SPP_OK;
 }
 
+/**
+ * @brief Hand out the next device slot driven by this HAL.
+ *
+ * Slots follow the descriptor table and skip devices owned by another
+ * driver (the SD card). A free slot can be given a descriptor with
+ * SPP_HAL_SPI_SetDeviceDesc() before SPP_HAL_SPI_DeviceInit().
+ *
+ * @return Device handler, or NULL once every slot has been handed out.
+ */
 void* SPP_HAL_SPI_GetHandler(void)
 {
     static spp_uint8_t i = 0;
-    if (i >= NUMBER_OF_DEVICES){
+
+    while (i < MAX_DEVICES && s_deviceDesc[i].driver != SPP_SPI_DRIVER_HAL) {
+        i++;
+    }
+    if (i >= MAX_DEVICES){
         return NULL;
     }
 
     return (void*)&spi_handler[i++];
 }
 
+/**
+ * @brief Add the device behind a handler to the bus, as its descriptor says.
+ *
+ * @param[in] p_handler Handler from SPP_HAL_SPI_GetHandler().
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_handler is NULL,
+ *         SPP_ERROR if the handler is foreign, already initialised, has no
+ *         descriptor, or the driver refused the device.
+ */
 retval_t SPP_HAL_SPI_DeviceInit(void* p_handler)
 { 
     if (p_handler == NULL) return SPP_ERROR_NULL_POINTER;
 
-    static uint8_t call_count = 0;   // Cuenta cuántas veces se ha llamado
-
-    if (call_count >= 2) {
+    int dev = spi_device_index(p_handler);
+    if (dev < 0) {
+        return SPP_ERROR;
+    }
+    if (device_state[dev] == READY) {
         ESP_LOGE(TAG, "SPI ya configurado (llamada extra)");
         return SPP_ERROR;
     }
 
+    const spp_spi_device_desc_t *p_desc = &s_deviceDesc[dev];
+    if ((p_desc->max_clock_hz == 0u) || (p_desc->driver != SPP_SPI_DRIVER_HAL)) {
+        ESP_LOGE(TAG, "SPI sin descriptor para el dispositivo %d", dev);
+        return SPP_ERROR;
+    }
+
     spi_device_handle_t *p_handle = (spi_device_handle_t*)p_handler;
     spi_device_interface_config_t devcfg = {0};
 
-    if (call_count == 0) {   // 1ª llamada → ICM
-        devcfg.clock_speed_hz = 1 * 1000 * 1000;
-        devcfg.mode           = 0;
-        devcfg.spics_io_num   = CS_PIN_ICM;
-        devcfg.queue_size     = 20;
-        devcfg.command_bits  = 0;
-        devcfg.dummy_bits    = 0;   
-    } 
-    else {                   // 2ª llamada → BMP
-        devcfg.clock_speed_hz = 500 * 1000;
-        devcfg.mode           = 0;
-        devcfg.spics_io_num   = CS_PIN_BMP;
-        devcfg.queue_size     = 20;
-        devcfg.command_bits  = 0;
-        devcfg.dummy_bits    = 0;
-        p_bmp_handler = p_handler; 
-    }
+    devcfg.clock_speed_hz = (int)p_desc->max_clock_hz;
+    devcfg.mode           = p_desc->mode;
+    devcfg.spics_io_num   = p_desc->cs_pin;
+    devcfg.queue_size     = 20;
+    devcfg.command_bits   = 0;
+    devcfg.dummy_bits     = 0;
+    devcfg.post_cb        = spi_async_post_cb;
 
     {
         esp_err_t ret = spi_bus_add_device(USED_HOST, &devcfg, p_handle);
@@ -93,9 +259,54 @@ retval_t SPP_HAL_SPI_DeviceInit(void* p_handler)
         }
     }
 
-    call_count++;
+    device_state[dev] = READY;
+    return SPP_OK;
+}
+
+/**
+ * @brief Replace the descriptor of a device slot before it is initialised.
+ *
+ * Use it to add devices beyond the built-in table or to change a clock,
+ * e.g. to lower the ICM20948 clock on a long harness.
+ *
+ * @param[in] p_handler Handler from SPP_HAL_SPI_GetHandler().
+ * @param[in] p_desc    New descriptor (copied).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the handler is foreign or already initialised.
+ */
+retval_t SPP_HAL_SPI_SetDeviceDesc(void* p_handler, const spp_spi_device_desc_t *p_desc)
+{
+    if ((p_handler == NULL) || (p_desc == NULL)) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    int dev = spi_device_index(p_handler);
+    if ((dev < 0) || (device_state[dev] == READY)) {
+        return SPP_ERROR;
+    }
+
+    s_deviceDesc[dev] = *p_desc;
     return SPP_OK;
 }
+
+/**
+ * @brief Look up the descriptor of the device on a CS pin.
+ *
+ * Lets drivers that own their device, such as the SD card, use the clock
+ * and mode from the same table.
+ *
+ * @param[in] cs_pin Chip select GPIO.
+ * @return The descriptor, or NULL if no table entry uses cs_pin.
+ */
+const spp_spi_device_desc_t *SPP_HAL_SPI_FindDeviceDesc(int cs_pin)
+{
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        if ((s_deviceDesc[i].max_clock_hz != 0u) && (s_deviceDesc[i].cs_pin == cs_pin)) {
+            return &s_deviceDesc[i];
+        }
+    }
+    return NULL;
+}
 //---End Init---
 
 //---ESP32-specific message sender---
@@ -108,33 +319,394 @@ retval_t SPP_HAL_SPI_Transmit(void* handler, spp_uint8_t* p_data, spp_uint8_t le
     if (p_handler == NULL) {
         return SPP_ERROR_NULL_POINTER;
     }
+    if (spi_async_busy(handler)) {
+        return SPP_ERROR;
+    }
+
+    int dev = spi_device_index(handler);
+    if (dev < 0) {
+        return SPP_ERROR;
+    }
+    const spp_spi_device_desc_t *p_desc = &s_deviceDesc[dev];
 
     esp_err_t trans_result = ESP_OK;  
 
     int i = 0;
        
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_SPI_TRANSMIT, p_desc->cs_pin, length);
     while (i < length){
         spi_transaction_t trans_desc = { 0 };
-        if (p_data[i] & 0x80 ) {
-            /* Reading from registers */
-            trans_desc.length    = 8 * 3;
-            trans_desc.tx_buffer = &p_data[i];
+        int frame = p_desc->addr_bytes + 1;
+        if (p_data[i] & REG_READ_FLAG ) {
+            /* Reading from registers: address, dummy bytes, then the value */
+            frame += p_desc->read_dummy_bytes;
             trans_desc.rx_buffer = &p_data[i];
-            if (handler != p_bmp_handler){
-                i+=2;
-            }else{
-                i+=3;
-            }
-        } else {
-            /* Writing to registers */
-            trans_desc.length    = 8 * 2;
-            trans_desc.tx_buffer = &p_data[i];
-            i += 2;
         }
-        trans_result = spi_device_transmit(p_handler, &trans_desc);
+        /* Writing to registers: address, then the value */
+        if (i + frame > length) {
+            SPP_TRACE_END(SPP_TRACE_EV_SPI_TRANSMIT, p_desc->cs_pin, SPP_ERROR);
+            return SPP_ERROR;
+        }
+        trans_desc.length    = 8u * (size_t)frame;
+        trans_desc.tx_buffer = &p_data[i];
+        i += frame;
+        trans_result = spi_device_run(p_handler, &trans_desc);
         if (trans_result != ESP_OK){
+            SPP_TRACE_END(SPP_TRACE_EV_SPI_TRANSMIT, p_desc->cs_pin, trans_result);
             return trans_result;
         }
     }
+    SPP_TRACE_END(SPP_TRACE_EV_SPI_TRANSMIT, p_desc->cs_pin, SPP_OK);
     return SPP_OK;
-}
\ No newline at end of file
+}
+//---End message sender---
+
+//---Burst read---
+/**
+ * @brief Read a contiguous register range in a single SPI transaction.
+ *
+ * Sends the start address once and clocks out count data bytes while the
+ * sensor auto-increments the register address, so CS toggles and the
+ * driver is entered once per block instead of once per register. Dummy
+ * bytes the device returns after the address (one on the BMP390) are
+ * skipped, as its descriptor says. The
+ * transfer goes through a DMA-capable buffer from an internal pool, so
+ * p_out may live anywhere.
+ *
+ * The transfer is padded to a multiple of 4 bytes, because the driver
+ * copies a receive length that is not a whole number of DMA words through
+ * a bounce buffer it allocates per transaction. Up to 3 registers past the
+ * block are clocked out and discarded, so do not end a burst just before a
+ * register that clears on read.
+ *
+ * On the ICM20948 the register bank must be selected beforehand.
+ *
+ * @param[in]  handler   Device handler from SPP_HAL_SPI_GetHandler().
+ * @param[in]  start_reg Address of the first register (read bit is added).
+ * @param[out] p_out     Receives count register values.
+ * @param[in]  count     Number of registers, 1 to SPP_HAL_SPI_BURST_MAX_BYTES.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if count is out of range, the device does not support
+ *         bursts, no burst buffer is free, an async batch is in flight on
+ *         the device or the transfer failed.
+ */
+retval_t SPP_HAL_SPI_BurstRead(void *handler, spp_uint8_t start_reg, spp_uint8_t *p_out,
+                               spp_uint8_t count)
+{
+    if ((handler == NULL) || (p_out == NULL)) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if ((count == 0u) || (count > SPP_HAL_SPI_BURST_MAX_BYTES)) {
+        return SPP_ERROR;
+    }
+
+    spi_device_handle_t p_handler = *(spi_device_handle_t*) handler;
+    if (p_handler == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (spi_async_busy(handler)) {
+        return SPP_ERROR;
+    }
+
+    int dev = spi_device_index(handler);
+    if ((dev < 0) || (s_deviceDesc[dev].burst == 0u)) {
+        return SPP_ERROR;
+    }
+
+    /* Address bytes, plus the dummy bytes the device sends before its data */
+    uint32_t header = (uint32_t)s_deviceDesc[dev].addr_bytes + s_deviceDesc[dev].read_dummy_bytes;
+    uint32_t total = SPI_DMA_ROUND(header + count);
+    if (header > (BURST_BUFFER_BYTES - SPP_HAL_SPI_BURST_MAX_BYTES)) {
+        return SPP_ERROR;
+    }
+
+    uint8_t *p_buffer = spi_burst_buffer_take();
+    if (p_buffer == NULL) {
+        return SPP_ERROR;
+    }
+
+    memset(p_buffer, 0, total);
+    p_buffer[0] = (uint8_t)(start_reg | REG_READ_FLAG);
+
+    spi_transaction_t trans_desc = { 0 };
+    trans_desc.length    = 8u * total;
+    trans_desc.rxlength  = 8u * total;
+    trans_desc.tx_buffer = p_buffer;
+    trans_desc.rx_buffer = p_buffer;
+
+    esp_err_t trans_result = spi_device_run(p_handler, &trans_desc);
+    if (trans_result == ESP_OK) {
+        memcpy(p_out, &p_buffer[header], count);
+    }
+
+    spi_burst_buffer_give(p_buffer);
+
+    if (trans_result != ESP_OK) {
+        ESP_LOGE(TAG, "burst read fallo: %s", esp_err_to_name(trans_result));
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+//---End burst read---
+
+//---Async batches---
+/**
+ * @brief Claim every device of a batch for its async transfers.
+ *
+ * Each device is claimed with a compare-exchange from 0 to its number of
+ * transfers, so two batches submitted at the same time can never both
+ * pass the idle check. If a device is already claimed, the devices claimed
+ * so far are released again.
+ *
+ * @param[in] p_xfers Validated transfers of the batch.
+ * @param[in] count   Number of transfers.
+ * @return SPP_OK if every device was claimed, SPP_ERROR if one is busy.
+ */
+static retval_t spi_async_reserve(const spp_spi_xfer_t *p_xfers, spp_uint8_t count)
+{
+    uint8_t perDevice[MAX_DEVICES] = { 0 };
+
+    for (spp_uint8_t i = 0; i < count; i++) {
+        perDevice[spi_device_index(p_xfers[i].handler)] += 1u;
+    }
+
+    for (int dev = 0; dev < MAX_DEVICES; dev++) {
+        uint8_t idle = 0;
+        if ((perDevice[dev] != 0u) &&
+            !__atomic_compare_exchange_n(&s_asyncPending[dev], &idle, perDevice[dev], 0,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            while (dev-- > 0) {
+                __atomic_sub_fetch(&s_asyncPending[dev], perDevice[dev], __ATOMIC_RELEASE);
+            }
+            return SPP_ERROR;
+        }
+    }
+    return SPP_OK;
+}
+
+/**
+ * @brief Prepare a batch and choose how its completion is signalled.
+ *
+ * When the last transfer of a submitted batch finishes, p_callback is
+ * called and then bits are set in p_event_group, both from ISR context.
+ * Either may be NULL; SPP_HAL_SPI_BatchWait() works without them.
+ *
+ * @param[out] p_batch       Batch to initialise (caller-owned, static).
+ * @param[in]  p_event_group Event group to signal, or NULL.
+ * @param[in]  bits          Bits to set in p_event_group.
+ * @param[in]  p_callback    ISR-safe completion callback, or NULL.
+ * @param[in]  p_ctx         Argument for p_callback.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_batch is NULL.
+ */
+retval_t SPP_HAL_SPI_BatchInit(spp_spi_batch_t *p_batch, void *p_event_group,
+                               osal_eventbits_t bits, spp_spi_done_cb_t p_callback, void *p_ctx)
+{
+    if (p_batch == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    memset(p_batch, 0, sizeof(*p_batch));
+    p_batch->p_eventGroup = p_event_group;
+    p_batch->bits = bits;
+    p_batch->p_callback = p_callback;
+    p_batch->p_callbackCtx = p_ctx;
+    return SPP_OK;
+}
+
+/**
+ * @brief Queue a batch of transfers, possibly across devices, and return.
+ *
+ * The transfers run in the background while the caller carries on; each
+ * device executes its own transfers in order. A device can take part in
+ * one batch at a time, and synchronous calls on it are refused until the
+ * batch has been reaped with SPP_HAL_SPI_BatchWait().
+ *
+ * If queueing fails part-way, completion is not signalled; the transfers
+ * already queued must still be reaped with SPP_HAL_SPI_BatchWait().
+ *
+ * @param[in,out] p_batch Batch set up with SPP_HAL_SPI_BatchInit() and reaped.
+ * @param[in]     p_xfers Transfers to queue; buffers must outlive the batch.
+ * @param[in]     count   Number of transfers, 1 to SPP_HAL_SPI_BATCH_MAX.
+ * @return SPP_OK if every transfer was queued, SPP_ERROR_NULL_POINTER if a
+ *         pointer is NULL, SPP_ERROR if a transfer is invalid, a device is
+ *         busy with another batch, the previous batch was not reaped or the
+ *         driver refused a transfer.
+ */
+retval_t SPP_HAL_SPI_BatchSubmit(spp_spi_batch_t *p_batch, const spp_spi_xfer_t *p_xfers,
+                                 spp_uint8_t count)
+{
+    if ((p_batch == NULL) || (p_xfers == NULL)) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if ((count == 0u) || (count > SPP_HAL_SPI_BATCH_MAX) || (p_batch->reaped < p_batch->queued)) {
+        return SPP_ERROR;
+    }
+
+    for (spp_uint8_t i = 0; i < count; i++) {
+        int dev = spi_device_index(p_xfers[i].handler);
+        if ((dev < 0) || (spi_handler[dev] == NULL) || (p_xfers[i].p_tx == NULL) ||
+            (p_xfers[i].length == 0u)) {
+            return SPP_ERROR;
+        }
+    }
+    if (spi_async_reserve(p_xfers, count) != SPP_OK) {
+        return SPP_ERROR;
+    }
+
+    p_batch->queued = 0;
+    p_batch->reaped = 0;
+    p_batch->failed = 0;
+    p_batch->pending = count;
+
+    for (spp_uint8_t i = 0; i < count; i++) {
+        spi_transaction_t *p_trans = &p_batch->trans[i];
+        int dev = spi_device_index(p_xfers[i].handler);
+
+        memset(p_trans, 0, sizeof(*p_trans));
+        p_trans->length    = 8u * p_xfers[i].length;
+        p_trans->tx_buffer = p_xfers[i].p_tx;
+        p_trans->rx_buffer = p_xfers[i].p_rx;
+        p_trans->user      = p_batch;
+        p_batch->handlers[i] = p_xfers[i].handler;
+
+        esp_err_t ret = spi_device_queue_trans(spi_handler[dev], p_trans, 0);
+        if (ret != ESP_OK) {
+            /* Give back the reservations of the transfers never queued */
+            for (spp_uint8_t j = i; j < count; j++) {
+                __atomic_sub_fetch(&s_asyncPending[spi_device_index(p_xfers[j].handler)], 1u,
+                                   __ATOMIC_RELEASE);
+            }
+            /* Mute the completion signal before dropping the unqueued count */
+            __atomic_store_n(&p_batch->failed, 1u, __ATOMIC_RELEASE);
+            __atomic_sub_fetch(&p_batch->pending, (spp_uint8_t)(count - i), __ATOMIC_ACQ_REL);
+            ESP_LOGE(TAG, "spi_device_queue_trans fallo: %s", esp_err_to_name(ret));
+            return SPP_ERROR;
+        }
+        p_batch->queued += 1u;
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Collect the results of a submitted batch.
+ *
+ * Hands every finished transaction back to the driver, which frees the
+ * devices for synchronous use and for the next batch. Can be called again
+ * after a timeout to continue where it stopped.
+ *
+ * @param[in,out] p_batch    Submitted batch.
+ * @param[in]     timeout_ms Maximum total wait in milliseconds (0 = only
+ *                           collect what has already finished).
+ * @return SPP_OK once every transfer is reaped, SPP_ERROR_NULL_POINTER if
+ *         p_batch is NULL, SPP_NOT_ENOUGH_PACKETS if transfers are still
+ *         running at the timeout, SPP_ERROR if submission or a transfer
+ *         failed.
+ */
+retval_t SPP_HAL_SPI_BatchWait(spp_spi_batch_t *p_batch, spp_uint32_t timeout_ms)
+{
+    if (p_batch == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t budget = pdMS_TO_TICKS(timeout_ms);
+    if ((timeout_ms != 0u) && (budget == 0u)) {
+        budget = 1u;
+    }
+
+    while (p_batch->reaped < p_batch->queued) {
+        spp_uint8_t i = p_batch->reaped;
+        int dev = spi_device_index(p_batch->handlers[i]);
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        TickType_t wait = (elapsed >= budget) ? 0u : (budget - elapsed);
+        spi_transaction_t *p_done = NULL;
+
+        esp_err_t ret = spi_device_get_trans_result(spi_handler[dev], &p_done, wait);
+        if (ret == ESP_ERR_TIMEOUT) {
+            return SPP_NOT_ENOUGH_PACKETS;
+        }
+        if ((ret != ESP_OK) || (p_done != &p_batch->trans[i])) {
+            p_batch->failed = 1u;
+        }
+
+        __atomic_sub_fetch(&s_asyncPending[dev], 1u, __ATOMIC_RELEASE);
+        p_batch->reaped += 1u;
+    }
+
+    return (p_batch->failed != 0u) ? SPP_ERROR : SPP_OK;
+}
+//---End async batches---
+
+//---Bus ownership and polling---
+/**
+ * @brief Reserve the bus for a sequence of accesses to one device.
+ *
+ * Until SPP_HAL_SPI_ReleaseBus(), transfers to this device skip bus
+ * arbitration and transfers to other devices wait. Keep the sequence
+ * short: an SD card write on the same bus is held off meanwhile.
+ *
+ * @param[in] handler Device handler from SPP_HAL_SPI_GetHandler().
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handler is NULL,
+ *         SPP_ERROR if an async batch is in flight on the device or the
+ *         driver refused.
+ */
+retval_t SPP_HAL_SPI_AcquireBus(void *handler)
+{
+    if (handler == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spi_device_handle_t p_handler = *(spi_device_handle_t*) handler;
+    if (p_handler == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (spi_async_busy(handler)) {
+        return SPP_ERROR;
+    }
+
+    /* The driver only supports waiting forever here */
+    esp_err_t ret = spi_device_acquire_bus(p_handler, portMAX_DELAY);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "spi_device_acquire_bus fallo: %s", esp_err_to_name(ret));
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+
+/**
+ * @brief Give the bus back after SPP_HAL_SPI_AcquireBus().
+ *
+ * @param[in] handler Device handler that acquired the bus.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handler is NULL.
+ */
+retval_t SPP_HAL_SPI_ReleaseBus(void *handler)
+{
+    if (handler == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spi_device_handle_t p_handler = *(spi_device_handle_t*) handler;
+    if (p_handler == NULL) {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spi_device_release_bus(p_handler);
+    return SPP_OK;
+}
+
+/**
+ * @brief Set the longest synchronous transfer that runs in polling mode.
+ *
+ * Applies to SPP_HAL_SPI_Transmit() and SPP_HAL_SPI_BurstRead(); async
+ * batches always use interrupt mode.
+ *
+ * @param[in] max_bytes Threshold in bytes, 0 to always use interrupt mode.
+ * @return SPP_OK.
+ */
+retval_t SPP_HAL_SPI_SetPollingMaxBytes(spp_uint16_t max_bytes)
+{
+    s_pollingMaxBytes = max_bytes;
+    return SPP_OK;
+}
+//---End bus ownership and polling---
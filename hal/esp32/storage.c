@@ -5,6 +5,12 @@
  * Wraps ESP-IDF FATFS and SDSPI APIs to provide mount/unmount functionality
  * for SD card access via the SPP storage abstraction.
  *
+ * SPP_HAL_Storage_MountPrealloc() additionally reserves a contiguous log
+ * file at mount time. Its sectors are located once through FatFs, after
+ * which SPP_HAL_Storage_RawWrite() writes them with multi-sector card
+ * commands and no filesystem involvement: the file already has its final
+ * size and cluster chain, so nothing in the FAT or directory changes.
+ *
  * @see https://docs.espressif.com/projects/esp-idf/en/stable/esp32/api-reference/peripherals/sdspi_host.html
  * @see https://docs.espressif.com/projects/esp-idf/en/stable/esp32/api-reference/storage/fatfs.html
  */
@@ -13,14 +19,51 @@
  * Includes
  * ========================================================================= */
 
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "spp/hal/storage/storage.h"
 #include "spp/core/types.h"
 #include "spp/core/returntypes.h"
 #include "macros_esp.h"
+#include "spi_esp32.h"
+#include "storage_esp32.h"
+#include "trace.h"
 #include "esp_vfs_fat.h"
 #include "sdmmc_cmd.h"
 #include "driver/sdspi_host.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "ff.h"
+#include "diskio_sdmmc.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Capacity of the VFS path built for the preallocated file. */
+#define K_PATH_BYTES 96u
+
+/** @brief ff_diskio_get_pdrv_card() result for an unregistered card. */
+#define K_NO_PDRV 0xFFu
+
+/** @brief First data cluster number in FAT. */
+#define K_FIRST_CLUSTER 2u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Sector range of the preallocated file and its write counters.
+ */
+typedef struct
+{
+    spp_bool_t ready;            /**< Region located and writable. */
+    spp_storage_raw_info_t info; /**< Layout, write position and counters. */
+} StorageRawRegion_t;
 
 /* ============================================================================
  * Private Variables
@@ -32,6 +75,112 @@ static spp_bool_t s_mounted = false;
 /** @brief Pointer to the SD/MMC card descriptor obtained during mount. */
 static sdmmc_card_t *s_card = NULL;
 
+/** @brief Raw write region inside the preallocated file. */
+static StorageRawRegion_t s_raw;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Create the contiguous log file, or keep a matching one.
+ *
+ * An existing file is reused if it has the requested size and is still
+ * contiguous; otherwise it is deleted and allocated again.
+ *
+ * @param[in] p_basePath VFS mount point.
+ * @param[in] p_fullPath VFS path of the file.
+ * @param[in] bytes      File size.
+ * @return SPP_OK on success, SPP_ERROR if the file cannot be allocated.
+ */
+static retval_t storage_prealloc_file(const char *p_basePath, const char *p_fullPath,
+                                      uint64_t bytes)
+{
+    struct stat st;
+
+    if (stat(p_fullPath, &st) == 0)
+    {
+        bool contiguous = false;
+        if ((uint64_t)st.st_size == bytes &&
+            esp_vfs_fat_test_contiguous_file(p_basePath, p_fullPath, &contiguous) == ESP_OK &&
+            contiguous)
+        {
+            return SPP_OK;
+        }
+        if (unlink(p_fullPath) != 0)
+        {
+            return SPP_ERROR;
+        }
+    }
+
+    if (esp_vfs_fat_create_contiguous_file(p_basePath, p_fullPath, bytes, true) != ESP_OK)
+    {
+        return SPP_ERROR;
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Find the first card sector of a file on the mounted volume.
+ *
+ * @param[in]  p_name     File name relative to the volume root.
+ * @param[out] p_sector   Receives the first sector.
+ * @return SPP_OK on success, SPP_ERROR if the file cannot be opened or has
+ *         no clusters.
+ */
+static retval_t storage_locate_file(const char *p_name, spp_uint32_t *p_sector)
+{
+    char ffPath[K_PATH_BYTES];
+    FIL file;
+
+    /* esp_vfs_fat registers the card's FatFs drive as "<pdrv>:" */
+    BYTE pdrv = ff_diskio_get_pdrv_card(s_card);
+    if (pdrv == K_NO_PDRV)
+    {
+        return SPP_ERROR;
+    }
+
+    int len = snprintf(ffPath, sizeof(ffPath), "%u:/%s", (unsigned)pdrv, p_name);
+    if (len < 0 || (size_t)len >= sizeof(ffPath))
+    {
+        return SPP_ERROR;
+    }
+
+    if (f_open(&file, ffPath, FA_READ) != FR_OK)
+    {
+        return SPP_ERROR;
+    }
+    FATFS *p_fs = file.obj.fs;
+    DWORD cluster = file.obj.sclust;
+    (void)f_close(&file);
+
+    if (cluster < K_FIRST_CLUSTER)
+    {
+        return SPP_ERROR;
+    }
+
+    *p_sector = (spp_uint32_t)(p_fs->database + (LBA_t)p_fs->csize * (cluster - K_FIRST_CLUSTER));
+    return SPP_OK;
+}
+
+/**
+ * @brief SPP_OSAL_TraceWrite() sink appending to a stdio file.
+ *
+ * @param[in] p_ctx  FILE pointer.
+ * @param[in] p_data Bytes to append.
+ * @param[in] length Number of bytes.
+ * @return SPP_OK if all bytes were written, SPP_ERROR otherwise.
+ */
+static retval_t storage_trace_sink(void *p_ctx, const void *p_data, size_t length)
+{
+    if (fwrite(p_data, 1, length, (FILE *)p_ctx) != length)
+    {
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+
 /* ============================================================================
  * Public Functions
  * ========================================================================= */
@@ -58,6 +207,13 @@ retval_t SPP_HAL_Storage_Mount(void *p_cfg)
 
     sdmmc_host_t host = SDSPI_HOST_DEFAULT(); /* Default SDSPI host config */
 
+    /* Run the card at the clock from the SPI device table */
+    const spp_spi_device_desc_t *p_desc = SPP_HAL_SPI_FindDeviceDesc(p_initCfg->pin_cs);
+    if (p_desc != NULL)
+    {
+        host.max_freq_khz = (int)(p_desc->max_clock_hz / 1000u);
+    }
+
     sdspi_device_config_t slotConfig =
         SDSPI_DEVICE_CONFIG_DEFAULT(); /* Default SDSPI device config */
     slotConfig.gpio_cs = p_initCfg->pin_cs;
@@ -101,6 +257,8 @@ retval_t SPP_HAL_Storage_Unmount(void *p_cfg)
 
     const SPP_Storage_InitCfg *p_initCfg = (const SPP_Storage_InitCfg *)p_cfg;
 
+    s_raw.ready = false; /* The raw region belongs to this mount */
+
     esp_err_t ret;
     ret = esp_vfs_fat_sdcard_unmount(p_initCfg->p_base_path, s_card);
 
@@ -116,3 +274,193 @@ retval_t SPP_HAL_Storage_Unmount(void *p_cfg)
 
     return SPP_OK;
 }
+
+/**
+ * @brief Mount the SD card and preallocate a contiguous log file.
+ *
+ * Mounts as SPP_HAL_Storage_Mount() (or keeps an existing mount), then
+ * makes sure the file exists with the requested size in one run of
+ * clusters and prepares raw writes at its first sector. If only the
+ * preallocation fails the card stays mounted.
+ *
+ * @param[in] p_cfg Mount parameters and file size.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_cfg is NULL,
+ *         SPP_ERROR if mounting or preallocation failed.
+ */
+retval_t SPP_HAL_Storage_MountPrealloc(const spp_storage_prealloc_cfg_t *p_cfg)
+{
+    if (p_cfg == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    retval_t ret = SPP_HAL_Storage_Mount((void *)&p_cfg->base);
+    if (ret != SPP_OK || p_cfg->p_prealloc_name == NULL)
+    {
+        return ret;
+    }
+
+    uint64_t bytes = p_cfg->prealloc_bytes - (p_cfg->prealloc_bytes % SPP_STORAGE_SECTOR_BYTES);
+    if (bytes == 0u || bytes / SPP_STORAGE_SECTOR_BYTES > UINT32_MAX ||
+        strlen(p_cfg->p_prealloc_name) > SPP_STORAGE_PREALLOC_NAME_MAX)
+    {
+        return SPP_ERROR;
+    }
+
+    char fullPath[K_PATH_BYTES];
+    int len = snprintf(fullPath, sizeof(fullPath), "%s/%s", p_cfg->base.p_base_path,
+                       p_cfg->p_prealloc_name);
+    if (len < 0 || (size_t)len >= sizeof(fullPath))
+    {
+        return SPP_ERROR;
+    }
+
+    memset(&s_raw, 0, sizeof(s_raw));
+
+    ret = storage_prealloc_file(p_cfg->base.p_base_path, fullPath, bytes);
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+
+    ret = storage_locate_file(p_cfg->p_prealloc_name, &s_raw.info.start_sector);
+    if (ret != SPP_OK)
+    {
+        return ret;
+    }
+
+    s_raw.info.sector_count = (spp_uint32_t)(bytes / SPP_STORAGE_SECTOR_BYTES);
+    s_raw.ready = true;
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Write whole sectors into the preallocated file.
+ *
+ * Writes at the current position and advances it; a multi-sector write is
+ * a single card command. No filesystem state is touched, so the file is
+ * not to be written through the VFS meanwhile, and other storage access
+ * must stay on the same task as the raw writes. p_data must be DMA-capable
+ * (internal RAM, word-aligned).
+ *
+ * @param[in] p_data       Data, sector_count * SPP_STORAGE_SECTOR_BYTES bytes.
+ * @param[in] sector_count Sectors to write.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_data is NULL,
+ *         SPP_ERROR if no region is prepared, the write would run past the
+ *         end of the file or the card rejected it.
+ */
+retval_t SPP_HAL_Storage_RawWrite(const void *p_data, spp_uint32_t sector_count)
+{
+    if (p_data == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (s_raw.ready == false || sector_count == 0u ||
+        sector_count > s_raw.info.sector_count - s_raw.info.next_sector)
+    {
+        return SPP_ERROR;
+    }
+
+    int64_t startUs = esp_timer_get_time();
+    esp_err_t err = sdmmc_write_sectors(s_card, p_data,
+                                        (size_t)(s_raw.info.start_sector + s_raw.info.next_sector),
+                                        (size_t)sector_count);
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+
+    s_raw.info.writes += 1;
+    s_raw.info.write_total += elapsedUs;
+    if (elapsedUs > s_raw.info.write_max)
+    {
+        s_raw.info.write_max = elapsedUs;
+    }
+
+    if (err != ESP_OK)
+    {
+        s_raw.info.write_errors += 1;
+        return SPP_ERROR;
+    }
+
+    s_raw.info.next_sector += sector_count;
+    return SPP_OK;
+}
+
+/**
+ * @brief Move the raw write position.
+ *
+ * @param[in] sector Offset from the start of the file, in sectors.
+ * @return SPP_OK on success, SPP_ERROR if no region is prepared or the
+ *         offset is past the end of the file.
+ */
+retval_t SPP_HAL_Storage_RawSeek(spp_uint32_t sector)
+{
+    if (s_raw.ready == false || sector > s_raw.info.sector_count)
+    {
+        return SPP_ERROR;
+    }
+
+    s_raw.info.next_sector = sector;
+    return SPP_OK;
+}
+
+/**
+ * @brief Report the raw region layout, write position and counters.
+ *
+ * @param[out] p_info Receives the snapshot.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_info is NULL,
+ *         SPP_ERROR if no region is prepared.
+ */
+retval_t SPP_HAL_Storage_RawGetInfo(spp_storage_raw_info_t *p_info)
+{
+    if (p_info == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (s_raw.ready == false)
+    {
+        return SPP_ERROR;
+    }
+
+    *p_info = s_raw.info;
+    return SPP_OK;
+}
+
+/**
+ * @brief Write the OSAL trace rings to a file on the mounted card.
+ *
+ * The file is replaced. Convert it on a host with tools/spptrace. Goes
+ * through the VFS, so do not call it while raw writes are in flight.
+ *
+ * @param[in] p_path VFS path of the dump, e.g. "/sdcard/TRACE.BIN".
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_path is NULL,
+ *         SPP_ERROR if the card is not mounted, the file cannot be written
+ *         or tracing is compiled out (SPP_TRACE_ENABLED).
+ */
+retval_t SPP_HAL_Storage_DumpTrace(const char *p_path)
+{
+    if (p_path == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (s_mounted == false)
+    {
+        return SPP_ERROR;
+    }
+
+    FILE *p_file = fopen(p_path, "wb");
+    if (p_file == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    retval_t ret = SPP_OSAL_TraceWrite(storage_trace_sink, p_file);
+    if (fclose(p_file) != 0)
+    {
+        ret = SPP_ERROR;
+    }
+    if (ret != SPP_OK)
+    {
+        (void)unlink(p_path);
+    }
+    return ret;
+}
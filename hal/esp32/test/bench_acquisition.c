@@ -0,0 +1,180 @@
+/**
+ * @file bench_acquisition.c
+ * @brief Host benchmark of the DRDY-driven acquisition engine.
+ *
+ * A thread plays the sensor, raising DRDY edges at a fixed rate through the
+ * GPIO stand-in, while the main thread consumes samples. Each run reports
+ * DRDY-to-consumer latency, worst DRDY-to-read latency and the missed-edge
+ * and drop counters. The last run stalls the consumer to show overflow
+ * being counted instead of blocking acquisition.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "spp/hal/spi/spi.h"
+#include "acquisition.h"
+#include "gpio_host.h"
+#include "macros_esp.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief GPIO standing in for the ICM20948 INT1 (DRDY) line. */
+#define K_DRDY_PIN 4u
+
+/** @brief ICM20948 ACCEL_XOUT_H: accel and gyro output block start. */
+#define K_ICM_ACCEL_XOUT_H 0x2Du
+
+/** @brief Accel + gyro, three 16-bit axes each. */
+#define K_SAMPLE_BYTES 12u
+
+/** @brief Edges generated per run. */
+#define K_EDGES 4000u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef struct
+{
+    uint32_t rate_hz;
+    uint32_t consumer_stall_ms; /**< Pause before draining, 0 = drain continuously. */
+} BenchRun_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static spp_acq_engine_t s_engine;
+
+static volatile int s_generatorDone;
+
+static const BenchRun_t s_runs[] = {
+    {1000u, 0u},
+    {4000u, 0u},
+    {1000u, 50u},
+};
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Raise K_EDGES DRDY edges at the requested rate.
+ *
+ * @param[in] p_arg Rate in Hz, cast to a pointer.
+ */
+static void *bench_drdy_generator(void *p_arg)
+{
+    uint32_t periodNs = 1000000000u / (uint32_t)(uintptr_t)p_arg;
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (uint32_t i = 0; i < K_EDGES; i++)
+    {
+        next.tv_nsec += periodNs;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec += 1;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        gpio_host_trigger_edge((gpio_num_t)K_DRDY_PIN);
+    }
+
+    s_generatorDone = 1;
+    return NULL;
+}
+
+/**
+ * @brief Run the engine at one rate and print a result line.
+ *
+ * @param[in] p_icm ICM20948 handler.
+ * @param[in] p_run Rate and consumer behaviour.
+ * @return 0 on success, non-zero on failure.
+ */
+static int bench_run(void *p_icm, const BenchRun_t *p_run)
+{
+    spp_acq_config_t cfg = {0};
+    spp_acq_sample_t sample;
+    spp_acq_stats_t stats;
+    pthread_t generator;
+
+    cfg.spi_handler = p_icm;
+    cfg.drdy_pin = K_DRDY_PIN;
+    cfg.drdy_intr_type = GPIO_INTR_POSEDGE;
+    cfg.start_reg = K_ICM_ACCEL_XOUT_H;
+    cfg.length = K_SAMPLE_BYTES;
+
+    if (SPP_HAL_ACQ_Start(&s_engine, &cfg) != SPP_OK)
+        return 1;
+
+    s_generatorDone = 0;
+    if (pthread_create(&generator, NULL, bench_drdy_generator,
+                       (void *)(uintptr_t)p_run->rate_hz) != 0)
+        return 1;
+
+    if (p_run->consumer_stall_ms != 0u)
+    {
+        struct timespec stall = {0, (long)p_run->consumer_stall_ms * 1000000L};
+        nanosleep(&stall, NULL);
+    }
+
+    /* Drain until the generator is done and the ring stays empty */
+    while (s_generatorDone == 0 || SPP_HAL_ACQ_Read(&s_engine, &sample, 20u) == SPP_OK)
+    {
+        SPP_HAL_ACQ_Read(&s_engine, &sample, 5u);
+    }
+
+    pthread_join(generator, NULL);
+    if (SPP_HAL_ACQ_Stop(&s_engine) != SPP_OK)
+        return 1;
+    while (SPP_HAL_ACQ_Read(&s_engine, &sample, 0u) == SPP_OK)
+    {
+    }
+
+    SPP_HAL_ACQ_GetStats(&s_engine, &stats);
+    printf("%7u %6u %8u %8u %7u %7u %6u %9.1f %8lld %8lld\n", p_run->rate_hz,
+           p_run->consumer_stall_ms, stats.samples, stats.consumed, stats.dropped,
+           stats.missed_edges, stats.read_errors,
+           (stats.consumed != 0u) ? (double)stats.latency_sum / stats.consumed : 0.0,
+           (long long)stats.latency_max, (long long)stats.read_latency_max);
+    return 0;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(void)
+{
+    if (SPP_HAL_SPI_BusInit() != SPP_OK)
+        return 1;
+
+    void *p_icm = SPP_HAL_SPI_GetHandler();
+    if (SPP_HAL_SPI_DeviceInit(p_icm) != SPP_OK)
+        return 1;
+
+    printf("%u DRDY edges per run, %u-byte bursts, ring depth %u (latencies in us)\n", K_EDGES,
+           K_SAMPLE_BYTES, SPP_ACQ_RING_DEPTH);
+    printf("%7s %6s %8s %8s %7s %7s %6s %9s %8s %8s\n", "rate_hz", "stall", "samples",
+           "consumed", "dropped", "missed", "errors", "lat_mean", "lat_max", "read_max");
+
+    for (size_t i = 0; i < sizeof(s_runs) / sizeof(s_runs[0]); i++)
+    {
+        if (bench_run(p_icm, &s_runs[i]) != 0)
+        {
+            fprintf(stderr, "run at %u Hz failed\n", s_runs[i].rate_hz);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file bench_compress.c
+ * @brief Host benchmark of the sensor stream compressor and its decoder.
+ *
+ * Each dataset is compressed with delta/varint packing alone, with the LZ
+ * stage, and with second-order differences on the smooth channels; every
+ * result is decoded with the host decoder (tools/spplog) and compared with
+ * the input. Reports the compression ratio against the raw record size
+ * and encode/decode throughput in input bytes per cycle, with cycles from
+ * esp_cpu_get_cycle_count() (a virtual 1 GHz clock on the host).
+ *
+ *     ./bench_compress                      synthetic datasets
+ *     ./bench_compress FILE CHANNELS [US]   recorded little-endian int16
+ *                                           samples, CHANNELS per record,
+ *                                           US apart (default 250)
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_cpu.h"
+#include "compress.h"
+#include "spplog.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Samples per synthetic dataset. */
+#define K_SAMPLES 200000u
+
+/** @brief Largest recorded dataset accepted, in samples. */
+#define K_MAX_SAMPLES 1000000u
+
+/** @brief Samples pushed between cycle counter reads. */
+#define K_CHUNK 1000u
+
+/** @brief Capacity of the captured block stream. */
+#define K_ARENA_BYTES (32u * 1024u * 1024u)
+
+#define K_FRAME_TYPE (SPP_LOGFMT_TYPE_USER + 2u)
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef struct
+{
+    const char *p_name;
+    uint32_t channels;
+    uint32_t samples;
+    uint32_t raw_sample_bytes; /**< Size of the original record (int16 values + 8-byte time). */
+    uint16_t smooth_mask;      /**< Channels worth second-order coding. */
+} BenchDataset_t;
+
+typedef struct
+{
+    const char *p_name;
+    uint8_t use_lz;
+    uint8_t order2;
+} BenchMode_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static spp_compress_t s_stream;
+
+static spplog_block_t s_block;
+
+static int64_t s_times[K_MAX_SAMPLES];
+
+static int32_t s_values[K_MAX_SAMPLES][SPP_LOGFMT_BLOCK_MAX_CHANNELS];
+
+/** @brief Captured blocks, each prefixed by its uint32_t length. */
+static uint8_t s_arena[K_ARENA_BYTES];
+
+static uint32_t s_arenaBytes;
+
+static uint32_t s_rng = 0x12345678u;
+
+static const BenchMode_t s_modes[] = {
+    {"delta", 0u, 0u},
+    {"delta+lz", 1u, 0u},
+    {"delta2+lz", 1u, 1u},
+};
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static double bench_noise(double sigma)
+{
+    /* Sum of four uniforms: close enough to Gaussian for sensor noise */
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++)
+    {
+        s_rng ^= s_rng << 13;
+        s_rng ^= s_rng >> 17;
+        s_rng ^= s_rng << 5;
+        sum += (double)s_rng / 4294967296.0 - 0.5;
+    }
+    return sum * sigma * 1.73;
+}
+
+static int32_t bench_clamp16(double value)
+{
+    if (value > 32767.0)
+        return 32767;
+    if (value < -32768.0)
+        return -32768;
+    return (int32_t)lrint(value);
+}
+
+/**
+ * @brief IMU (accel xyz, gyro xyz, temperature) at 4 kHz, at rest or moving.
+ */
+static void bench_make_imu(BenchDataset_t *p_set, int moving)
+{
+    p_set->p_name = moving ? "imu_flight" : "imu_rest";
+    p_set->channels = 7;
+    p_set->samples = K_SAMPLES;
+    p_set->raw_sample_bytes = 8u + 7u * 2u;
+    p_set->smooth_mask = moving ? 0x3Fu : 0x40u;
+
+    for (uint32_t i = 0; i < K_SAMPLES; i++)
+    {
+        double t = (double)i / 4000.0;
+        s_times[i] = (int64_t)i * 250 + (int64_t)bench_noise(2.0);
+
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            double accel = (axis == 2) ? 2048.0 : 0.0;
+            double gyro = 0.0;
+            if (moving)
+            {
+                accel += 900.0 * sin(2.0 * M_PI * (1.3 + axis) * t);
+                gyro += 4000.0 * sin(2.0 * M_PI * (0.7 + 0.4 * axis) * t + axis);
+            }
+            s_values[i][axis] = bench_clamp16(accel + bench_noise(3.0));
+            s_values[i][3 + axis] = bench_clamp16(gyro + bench_noise(2.0));
+        }
+        s_values[i][6] = bench_clamp16(8000.0 + 50.0 * t + bench_noise(0.5));
+    }
+}
+
+/**
+ * @brief Barometer (pressure in Pa * 100, temperature) at 50 Hz during a climb.
+ */
+static void bench_make_baro(BenchDataset_t *p_set)
+{
+    p_set->p_name = "baro";
+    p_set->channels = 2;
+    p_set->samples = K_SAMPLES / 10u;
+    p_set->raw_sample_bytes = 8u + 2u * 4u;
+    p_set->smooth_mask = 0x3u;
+
+    for (uint32_t i = 0; i < p_set->samples; i++)
+    {
+        double t = (double)i / 50.0;
+        s_times[i] = (int64_t)i * 20000;
+        s_values[i][0] = (int32_t)lrint(10132500.0 - 1200.0 * t + bench_noise(40.0));
+        s_values[i][1] = (int32_t)lrint(2500.0 - 0.65 * t + bench_noise(1.0));
+    }
+}
+
+/**
+ * @brief Load recorded int16 samples.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+static int bench_load(BenchDataset_t *p_set, const char *p_path, uint32_t channels,
+                      int64_t period_us)
+{
+    FILE *p_file = fopen(p_path, "rb");
+    if (p_file == NULL || channels == 0u || channels > SPP_LOGFMT_BLOCK_MAX_CHANNELS)
+        return 1;
+
+    p_set->p_name = p_path;
+    p_set->channels = channels;
+    p_set->samples = 0;
+    p_set->raw_sample_bytes = 8u + 2u * channels;
+    p_set->smooth_mask = (uint16_t)((1u << channels) - 1u);
+
+    int16_t record[SPP_LOGFMT_BLOCK_MAX_CHANNELS];
+    while (p_set->samples < K_MAX_SAMPLES &&
+           fread(record, sizeof(int16_t), channels, p_file) == channels)
+    {
+        s_times[p_set->samples] = (int64_t)p_set->samples * period_us;
+        for (uint32_t ch = 0; ch < channels; ch++)
+        {
+            s_values[p_set->samples][ch] = record[ch];
+        }
+        p_set->samples += 1;
+    }
+
+    fclose(p_file);
+    return (p_set->samples == 0u) ? 1 : 0;
+}
+
+static retval_t bench_sink(void *p_ctx, spp_uint8_t type, int64_t time_us, const void *p_data,
+                           spp_uint32_t length)
+{
+    (void)p_ctx;
+    (void)type;
+    (void)time_us;
+
+    if (s_arenaBytes + sizeof(uint32_t) + length > K_ARENA_BYTES)
+        return SPP_ERROR;
+    memcpy(&s_arena[s_arenaBytes], &length, sizeof(length));
+    memcpy(&s_arena[s_arenaBytes + sizeof(uint32_t)], p_data, length);
+    s_arenaBytes += (uint32_t)sizeof(uint32_t) + length;
+    return SPP_OK;
+}
+
+/**
+ * @brief Compress, decode and verify one dataset in one mode.
+ *
+ * @return 0 on success, non-zero on failure or mismatch.
+ */
+static int bench_run(const BenchDataset_t *p_set, const BenchMode_t *p_mode)
+{
+    spp_compress_config_t cfg = {0};
+    spp_compress_stats_t stats;
+
+    cfg.p_sink = bench_sink;
+    cfg.frame_type = K_FRAME_TYPE;
+    cfg.channels = (spp_uint8_t)p_set->channels;
+    cfg.order2_mask = p_mode->order2 ? p_set->smooth_mask : 0u;
+    cfg.use_lz = p_mode->use_lz;
+    cfg.raw_sample_bytes = p_set->raw_sample_bytes;
+    if (SPP_HAL_Compress_Init(&s_stream, &cfg) != SPP_OK)
+        return 1;
+
+    s_arenaBytes = 0;
+    uint64_t encodeCycles = 0;
+    for (uint32_t i = 0; i < p_set->samples; i += K_CHUNK)
+    {
+        uint32_t end = (i + K_CHUNK < p_set->samples) ? i + K_CHUNK : p_set->samples;
+        esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+        for (uint32_t s = i; s < end; s++)
+        {
+            if (SPP_HAL_Compress_Push(&s_stream, s_times[s], s_values[s]) != SPP_OK)
+                return 1;
+        }
+        encodeCycles += (esp_cpu_cycle_count_t)(esp_cpu_get_cycle_count() - start);
+    }
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    if (SPP_HAL_Compress_Flush(&s_stream) != SPP_OK)
+        return 1;
+    encodeCycles += (esp_cpu_cycle_count_t)(esp_cpu_get_cycle_count() - start);
+    SPP_HAL_Compress_GetStats(&s_stream, &stats);
+
+    uint64_t decodeCycles = 0;
+    uint32_t sample = 0;
+    for (uint32_t offset = 0; offset < s_arenaBytes;)
+    {
+        uint32_t length;
+        memcpy(&length, &s_arena[offset], sizeof(length));
+        offset += (uint32_t)sizeof(length);
+
+        start = esp_cpu_get_cycle_count();
+        int err = spplog_block_decode(&s_arena[offset], length, &s_block);
+        decodeCycles += (esp_cpu_cycle_count_t)(esp_cpu_get_cycle_count() - start);
+        if (err != SPPLOG_OK)
+            return 1;
+
+        for (uint32_t s = 0; s < s_block.header.samples; s++, sample++)
+        {
+            if (s_block.time_us[s] != s_times[sample] ||
+                memcmp(s_block.values[s], s_values[sample], p_set->channels * sizeof(int32_t)) != 0)
+                return 1;
+        }
+        offset += length;
+    }
+    if (sample != p_set->samples)
+        return 1;
+
+    printf("%-12s %-10s %10llu %9llu %6.2fx %5u/%-5u %8.3f %8.3f\n", p_set->p_name,
+           p_mode->p_name, (unsigned long long)stats.raw_bytes,
+           (unsigned long long)stats.out_bytes, (double)stats.raw_bytes / (double)stats.out_bytes,
+           stats.blocks_lz, stats.blocks, (double)stats.raw_bytes / (double)encodeCycles,
+           (double)stats.raw_bytes / (double)decodeCycles);
+    return 0;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(int argc, char **argv)
+{
+    BenchDataset_t sets[3];
+    uint32_t setCount = 0;
+
+    if (argc >= 3)
+    {
+        int64_t period = (argc >= 4) ? strtoll(argv[3], NULL, 0) : 250;
+        if (bench_load(&sets[0], argv[1], (uint32_t)strtoul(argv[2], NULL, 0), period) != 0)
+        {
+            fprintf(stderr, "cannot load %s\n", argv[1]);
+            return 1;
+        }
+        setCount = 1;
+    }
+
+    printf("%-12s %-10s %10s %9s %7s %11s %8s %8s\n", "dataset", "mode", "raw", "out", "ratio",
+           "lz/blocks", "enc_B/c", "dec_B/c");
+
+    int generated = (setCount == 0u) ? 3 : 0;
+    for (int g = 0; g < (generated ? generated : 1); g++)
+    {
+        BenchDataset_t *p_set = &sets[0];
+        if (generated)
+        {
+            if (g == 2)
+                bench_make_baro(p_set);
+            else
+                bench_make_imu(p_set, g);
+        }
+
+        for (size_t m = 0; m < sizeof(s_modes) / sizeof(s_modes[0]); m++)
+        {
+            if (bench_run(p_set, &s_modes[m]) != 0)
+            {
+                fprintf(stderr, "%s/%s: round trip failed\n", p_set->p_name, s_modes[m].p_name);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
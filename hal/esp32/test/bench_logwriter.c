@@ -0,0 +1,166 @@
+/**
+ * @file bench_logwriter.c
+ * @brief Host benchmark of the binary log writer on top of the logger.
+ *
+ * Writes a synthetic flight log (4 kHz IMU frames, 50 Hz barometer frames,
+ * timestamps on a virtual clock) through the log writer into the buffered
+ * logger as fast as the logger accepts it, retrying frames it refuses.
+ * Reports framing throughput and the marker counts, and leaves the file
+ * behind for tools/spplog:
+ *
+ *     ./bench_logwriter [MB]
+ *     spplog info /tmp/spp_logwriter_bench.bin
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "spp/osal/task.h"
+#include "logger.h"
+#include "logwriter.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_LOG_PATH "/tmp/spp_logwriter_bench.bin"
+
+#define K_BUFFER_BYTES (64u * SPP_LOGGER_SECTOR_BYTES)
+
+#define K_BUFFER_COUNT 4u
+
+/** @brief Log size written when no argument is given. */
+#define K_DEFAULT_MB 64u
+
+#define K_TYPE_IMU (SPP_LOGFMT_TYPE_USER + 0u)
+#define K_TYPE_BARO (SPP_LOGFMT_TYPE_USER + 1u)
+
+/** @brief IMU period on the virtual clock (4 kHz). */
+#define K_IMU_PERIOD_US 250
+
+/** @brief Barometer frame after every this many IMU frames (50 Hz). */
+#define K_BARO_EVERY 80u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef struct __attribute__((packed))
+{
+    int16_t accel[3];
+    int16_t gyro[3];
+    int16_t temp;
+    uint32_t drdy_seq;
+} BenchImu_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t pressure;
+    uint32_t temperature;
+} BenchBaro_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+SPP_LOGGER_STORAGE(s_buffers, K_BUFFER_COUNT, K_BUFFER_BYTES);
+
+static spp_logger_t s_logger;
+
+static spp_logwriter_t s_writer;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static double bench_now_s(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Write one frame, waiting for the logger while it is full.
+ *
+ * @return Number of refused attempts.
+ */
+static uint32_t bench_write(uint8_t type, int64_t time_us, const void *p_payload, uint32_t length)
+{
+    uint32_t refused = 0;
+
+    while (SPP_HAL_LogWriter_Write(&s_writer, type, time_us, p_payload, length) != SPP_OK)
+    {
+        refused += 1;
+        SPP_OSAL_TaskDelay(1);
+    }
+    return refused;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(int argc, char **argv)
+{
+    uint64_t targetBytes = (uint64_t)((argc > 1) ? strtoul(argv[1], NULL, 0) : K_DEFAULT_MB) << 20;
+    spp_logger_config_t loggerCfg = {0};
+    spp_logwriter_config_t writerCfg = {0};
+    spp_logwriter_stats_t stats;
+    uint64_t refused = 0;
+
+    remove(K_LOG_PATH);
+
+    loggerCfg.p_path = K_LOG_PATH;
+    loggerCfg.p_buffers = s_buffers;
+    loggerCfg.buffer_bytes = K_BUFFER_BYTES;
+    loggerCfg.buffer_count = K_BUFFER_COUNT;
+    loggerCfg.flush_interval_ms = 200u;
+    if (SPP_HAL_Logger_Start(&s_logger, &loggerCfg) != SPP_OK)
+        return 1;
+
+    writerCfg.p_sink = SPP_HAL_LogWriter_LoggerSink;
+    writerCfg.p_sink_ctx = &s_logger;
+    if (SPP_HAL_LogWriter_Open(&s_writer, &writerCfg) != SPP_OK)
+        return 1;
+
+    double startS = bench_now_s();
+    int64_t timeUs = 0;
+    for (uint32_t i = 0; s_writer.stats.bytes < targetBytes; i++)
+    {
+        BenchImu_t imu;
+        memset(&imu, 0, sizeof(imu));
+        imu.accel[2] = 2048;
+        imu.gyro[0] = (int16_t)(i & 0xFFu);
+        imu.drdy_seq = i;
+        refused += bench_write(K_TYPE_IMU, timeUs, &imu, sizeof(imu));
+
+        if ((i % K_BARO_EVERY) == 0u)
+        {
+            BenchBaro_t baro = {101325u + (i & 0x3Fu), 2500u};
+            refused += bench_write(K_TYPE_BARO, timeUs, &baro, sizeof(baro));
+        }
+        timeUs += K_IMU_PERIOD_US;
+    }
+
+    SPP_HAL_LogWriter_Close(&s_writer, timeUs);
+    if (SPP_HAL_Logger_Stop(&s_logger) != SPP_OK)
+        return 1;
+    double elapsedS = bench_now_s() - startS;
+
+    SPP_HAL_LogWriter_GetStats(&s_writer, &stats);
+    printf("%llu bytes, %u frames (%u SYNC, %u INDEX) in %.2f s: %.1f MB/s\n",
+           (unsigned long long)stats.bytes, stats.frames, stats.sync_frames, stats.index_frames,
+           elapsedS, (double)stats.bytes / elapsedS / 1e6);
+    printf("%u frames refused by the logger and retried (%llu attempts)\n", stats.dropped,
+           (unsigned long long)refused);
+    printf("virtual flight time %.1f s, log at %s\n", (double)timeUs / 1e6, K_LOG_PATH);
+
+    return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file bench_reader.c
+ * @brief Host benchmark of the read-ahead SD card reader.
+ *
+ * A downlink consumer streams a log out over a link paced at K_LINK_BPS,
+ * first with synchronous fread() calls between packets, then through the
+ * reader with 2, 4 and 8 buffers. Card behaviour is modelled by wrapping
+ * fread() (linked with -Wl,--wrap=fread): every read costs an access time
+ * plus transfer time, and every K_STALL_EVERY bytes the card takes a
+ * housekeeping pause. Each run reports throughput against the link rate,
+ * consumer stalls and the worst read, and checks the data by CRC; a
+ * link-only run from RAM gives the ceiling on this host's timers.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "esp_rom_crc.h"
+#include "reader.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_LOG_PATH "/tmp/spp_reader_bench.bin"
+
+#define K_FILE_BYTES (8u * 1024u * 1024u)
+
+/** @brief One 32 KiB allocation unit per buffer. */
+#define K_BUFFER_BYTES (64u * SPP_READER_SECTOR_BYTES)
+
+/** @brief Largest buffer count tried. */
+#define K_MAX_BUFFERS 8u
+
+/** @brief Bytes handed to the link per packet. */
+#define K_PACKET_BYTES 4096u
+
+/** @brief Downlink rate in bytes per second. */
+#define K_LINK_BPS 8000000.0
+
+/** @brief Modelled card: access time per read, transfer rate, housekeeping pause. */
+#define K_CARD_ACCESS_S 0.0003
+#define K_CARD_BPS 20000000.0
+#define K_STALL_EVERY (1024u * 1024u)
+#define K_STALL_S 0.025
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+SPP_READER_STORAGE(s_buffers, K_MAX_BUFFERS, K_BUFFER_BYTES);
+
+static uint8_t s_syncBuffer[K_BUFFER_BYTES];
+
+static spp_reader_t s_reader;
+
+/** @brief Bytes the modelled card has read since its last pause. */
+static uint64_t s_cardBytes;
+
+/** @brief Slowest modelled read of the current run, in seconds. */
+static double s_cardWorst;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+size_t __real_fread(void *p_ptr, size_t size, size_t count, FILE *p_file);
+
+static double bench_now_s(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void bench_sleep_until(double deadline_s)
+{
+    double now = bench_now_s();
+    if (deadline_s <= now)
+        return;
+
+    double wait = deadline_s - now;
+    struct timespec ts = {(time_t)wait, (long)((wait - (double)(time_t)wait) * 1e9)};
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief fread() as seen through the modelled card.
+ */
+size_t __wrap_fread(void *p_ptr, size_t size, size_t count, FILE *p_file)
+{
+    double start = bench_now_s();
+    size_t got = __real_fread(p_ptr, size, count, p_file);
+    double cost = K_CARD_ACCESS_S + (double)(got * size) / K_CARD_BPS;
+
+    s_cardBytes += got * size;
+    if (s_cardBytes >= K_STALL_EVERY)
+    {
+        s_cardBytes -= K_STALL_EVERY;
+        cost += K_STALL_S;
+    }
+    if (cost > s_cardWorst)
+    {
+        s_cardWorst = cost;
+    }
+
+    bench_sleep_until(start + cost);
+    return got;
+}
+
+/**
+ * @brief Send a buffer over the paced link.
+ *
+ * @param[in]     p_data   Bytes to send.
+ * @param[in]     length   Byte count.
+ * @param[in,out] p_linkS  Time the link is free again.
+ */
+static void bench_link_send(const uint8_t *p_data, uint32_t length, double *p_linkS)
+{
+    (void)p_data;
+    for (uint32_t sent = 0; sent < length; sent += K_PACKET_BYTES)
+    {
+        uint32_t packet = (length - sent < K_PACKET_BYTES) ? length - sent : K_PACKET_BYTES;
+        double now = bench_now_s();
+        if (*p_linkS < now)
+        {
+            *p_linkS = now;
+        }
+        *p_linkS += (double)packet / K_LINK_BPS;
+        bench_sleep_until(*p_linkS);
+    }
+}
+
+static int bench_make_file(uint32_t *p_crc)
+{
+    FILE *p_file = fopen(K_LOG_PATH, "wb");
+    if (p_file == NULL)
+        return 1;
+
+    uint32_t crc = 0;
+    uint32_t state = 0x2545F491u;
+    for (uint32_t done = 0; done < K_FILE_BYTES; done += K_BUFFER_BYTES)
+    {
+        for (uint32_t i = 0; i < K_BUFFER_BYTES; i++)
+        {
+            state = state * 1664525u + 1013904223u;
+            s_syncBuffer[i] = (uint8_t)(state >> 24);
+        }
+        crc = esp_rom_crc32_le(crc, s_syncBuffer, K_BUFFER_BYTES);
+        fwrite(s_syncBuffer, 1, K_BUFFER_BYTES, p_file);
+    }
+
+    *p_crc = crc;
+    return (fclose(p_file) == 0) ? 0 : 1;
+}
+
+static void bench_report(const char *p_name, double elapsedS, uint32_t crc, uint32_t expected,
+                         uint32_t stalls, double stallS)
+{
+    double mbps = (double)K_FILE_BYTES / elapsedS / 1e6;
+    printf("%-12s %8.2f MB/s %5.1f%% of link  stalls %5u (%7.1f ms)  worst read %5.1f ms  %s\n",
+           p_name, mbps, 100.0 * mbps * 1e6 / K_LINK_BPS, stalls, stallS * 1e3, s_cardWorst * 1e3,
+           (crc == expected) ? "crc ok" : "CRC MISMATCH");
+}
+
+/**
+ * @brief Ceiling: send the file's worth of bytes from RAM.
+ */
+static void bench_link_only(void)
+{
+    double linkS = 0.0;
+    double start = bench_now_s();
+    for (uint32_t sent = 0; sent < K_FILE_BYTES; sent += K_BUFFER_BYTES)
+    {
+        bench_link_send(s_syncBuffer, K_BUFFER_BYTES, &linkS);
+    }
+    double mbps = (double)K_FILE_BYTES / (bench_now_s() - start) / 1e6;
+    printf("%-12s %8.2f MB/s %5.1f%% of link\n", "link only", mbps, 100.0 * mbps * 1e6 / K_LINK_BPS);
+}
+
+/**
+ * @brief Baseline: read one buffer synchronously, send it, repeat.
+ */
+static int bench_sync(uint32_t expected)
+{
+    FILE *p_file = fopen(K_LOG_PATH, "rb");
+    if (p_file == NULL)
+        return 1;
+    setvbuf(p_file, NULL, _IONBF, 0);
+
+    uint32_t crc = 0;
+    uint32_t reads = 0;
+    double readS = 0.0;
+    double linkS = 0.0;
+    s_cardBytes = 0;
+    s_cardWorst = 0.0;
+
+    double start = bench_now_s();
+    for (;;)
+    {
+        double readStart = bench_now_s();
+        size_t got = fread(s_syncBuffer, 1, K_BUFFER_BYTES, p_file);
+        readS += bench_now_s() - readStart;
+        if (got == 0u)
+            break;
+        reads += 1;
+        crc = esp_rom_crc32_le(crc, s_syncBuffer, (uint32_t)got);
+        bench_link_send(s_syncBuffer, (uint32_t)got, &linkS);
+    }
+    double elapsed = bench_now_s() - start;
+    fclose(p_file);
+
+    /* Every read blocks the link */
+    bench_report("sync fread", elapsed, crc, expected, reads, readS);
+    return (crc == expected) ? 0 : 1;
+}
+
+/**
+ * @brief Stream the file through the reader with buffer_count buffers.
+ */
+static int bench_readahead(uint32_t buffer_count, uint32_t expected)
+{
+    spp_reader_config_t cfg = {0};
+    spp_reader_stats_t stats;
+    spp_reader_view_t view;
+    char name[32];
+
+    cfg.p_path = K_LOG_PATH;
+    cfg.p_buffers = s_buffers;
+    cfg.buffer_bytes = K_BUFFER_BYTES;
+    cfg.buffer_count = buffer_count;
+    s_cardBytes = 0;
+    s_cardWorst = 0.0;
+
+    if (SPP_HAL_Reader_Open(&s_reader, &cfg) != SPP_OK)
+        return 1;
+
+    uint32_t crc = 0;
+    double linkS = 0.0;
+    double start = bench_now_s();
+    while (SPP_HAL_Reader_Acquire(&s_reader, &view, 1000) == SPP_OK && view.length != 0u)
+    {
+        crc = esp_rom_crc32_le(crc, view.p_data, view.length);
+        bench_link_send(view.p_data, view.length, &linkS);
+        SPP_HAL_Reader_Release(&s_reader, &view);
+    }
+    double elapsed = bench_now_s() - start;
+
+    SPP_HAL_Reader_GetStats(&s_reader, &stats);
+    SPP_HAL_Reader_Close(&s_reader);
+
+    snprintf(name, sizeof(name), "read-ahead %u", (unsigned)buffer_count);
+    bench_report(name, elapsed, crc, expected, stats.stalls, (double)stats.stall_total / 1e6);
+    if (stats.bytes_delivered != K_FILE_BYTES || stats.read_errors != 0u)
+        return 1;
+    return (crc == expected) ? 0 : 1;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(void)
+{
+    uint32_t expected = 0;
+    int failed = 0;
+
+    if (bench_make_file(&expected) != 0)
+    {
+        fprintf(stderr, "cannot create %s\n", K_LOG_PATH);
+        return 1;
+    }
+
+    printf("%u KiB over a %.1f MB/s link; card %.1f MB/s, %.1f ms access, %.0f ms pause per MiB\n",
+           K_FILE_BYTES / 1024u, K_LINK_BPS / 1e6, K_CARD_BPS / 1e6, K_CARD_ACCESS_S * 1e3,
+           K_STALL_S * 1e3);
+
+    bench_link_only();
+    failed |= bench_sync(expected);
+    for (uint32_t count = 2; count <= K_MAX_BUFFERS; count *= 2u)
+    {
+        failed |= bench_readahead(count, expected);
+    }
+
+    remove(K_LOG_PATH);
+    return failed;
+}
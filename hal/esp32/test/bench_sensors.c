@@ -0,0 +1,407 @@
+/**
+ * @file bench_sensors.c
+ * @brief Host benchmark of sensor readout against the ICM20948 and BMP390
+ *        register simulators.
+ *
+ * Both simulators sit behind their chip selects from macros_esp.h and are
+ * driven through the unmodified SPI HAL. After an identity check the bench
+ * configures the ICM20948 for about 100 Hz and the BMP390 for 50 Hz normal
+ * mode, then polls the data-ready bits for K_RUN_US and reads each new
+ * sample twice over: once as one transaction per register, once with a
+ * single burst read. Decoded values are checked against the signal sources
+ * (the BMP390 through its own NVM compensation). Each run reports samples,
+ * transactions per device, clocked bytes and the share of the run the bus
+ * was busy.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "spp/hal/spi/spi.h"
+#include "bmp390_sim.h"
+#include "esp_timer.h"
+#include "icm20948_sim.h"
+#include "macros_esp.h"
+#include "spi_esp32.h"
+#include "spi_host.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_PI 3.14159265358979323846
+
+/** @brief Length of each run. */
+#define K_RUN_US 1000000
+
+/** @brief Pause between data-ready polls. */
+#define K_POLL_US 500u
+
+#define K_READ_FLAG 0x80u
+
+/** @brief ICM20948 registers (bank 0 unless noted) and settings. */
+#define K_ICM_WHO_AM_I 0x00u
+#define K_ICM_PWR_MGMT_1 0x06u
+#define K_ICM_INT_STATUS_1 0x1Au
+#define K_ICM_ACCEL_XOUT_H 0x2Du
+#define K_ICM_DATA_BYTES 14u
+#define K_ICM_REG_BANK_SEL 0x7Fu
+#define K_ICM_B2_GYRO_SMPLRT_DIV 0x00u
+#define K_ICM_CLKSEL_AUTO 0x01u
+#define K_ICM_RAW_DATA_RDY 0x01u
+#define K_ICM_SMPLRT_DIV 10u /* 1125 / 11 = 102 Hz */
+
+/** @brief ICM20948 scale at the reset full-scale ranges. */
+#define K_ICM_ACCEL_LSB_PER_G 16384.0
+#define K_ICM_GYRO_LSB_PER_DPS 131.0
+#define K_ICM_TEMP_LSB_PER_C 333.87
+#define K_ICM_TEMP_OFFSET_C 21.0
+
+/** @brief BMP390 registers and settings. */
+#define K_BMP_CHIP_ID 0x00u
+#define K_BMP_STATUS 0x03u
+#define K_BMP_DATA_0 0x04u
+#define K_BMP_DATA_BYTES 6u
+#define K_BMP_PWR_CTRL 0x1Bu
+#define K_BMP_OSR 0x1Cu
+#define K_BMP_ODR 0x1Du
+#define K_BMP_DRDY_PRESS 0x20u
+#define K_BMP_PWR_NORMAL 0x33u /* pressure and temperature on, normal mode */
+#define K_BMP_OSR_P8_T1 0x03u  /* about 19 ms per conversion */
+#define K_BMP_ODR_50HZ 0x02u
+
+/** @brief Largest read checked against the sources, per quantity. */
+#define K_TOL_ACCEL_G 0.01
+#define K_TOL_GYRO_DPS 5.0
+#define K_TOL_TEMP_C 0.05
+#define K_TOL_PRESSURE_PA 5.0
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef enum
+{
+    K_MODE_PER_REGISTER = 0,
+    K_MODE_BURST = 1
+} BenchMode_t;
+
+/**
+ * @brief Counters of one run.
+ */
+typedef struct
+{
+    uint32_t icmSamples;
+    uint32_t bmpSamples;
+    uint32_t polls;
+    uint32_t mismatches;
+} BenchRun_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static icm20948_sim_t s_icm;
+static bmp390_sim_t s_bmp;
+
+static uint8_t s_bmpNvm[BMP390_SIM_NVM_PAR_BYTES];
+
+static const char *const s_modeNames[] = {"per-register", "burst"};
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief IMU signal: slow roll oscillation with 1 g on Z.
+ */
+static void bench_icm_source(void *p_ctx, int64_t time_us, icm20948_sim_sample_t *p_sample)
+{
+    (void)p_ctx;
+    double phase = 2.0 * K_PI * 0.5 * (double)time_us / 1e6;
+
+    p_sample->accel_g[0] = 0.1 * cos(phase);
+    p_sample->accel_g[1] = -0.05;
+    p_sample->accel_g[2] = 1.0 + 0.2 * sin(phase);
+    p_sample->gyro_dps[0] = 100.0 * sin(phase);
+    p_sample->gyro_dps[1] = 0.0;
+    p_sample->gyro_dps[2] = -20.0 * cos(phase);
+    p_sample->temp_c = 30.0;
+}
+
+/**
+ * @brief Barometer signal: climbing at 10 m/s, 12 Pa per metre.
+ */
+static void bench_bmp_source(void *p_ctx, int64_t time_us, bmp390_sim_sample_t *p_sample)
+{
+    (void)p_ctx;
+    p_sample->pressure_pa = 101325.0 - 12.0 * 10.0 * (double)time_us / 1e6;
+    p_sample->temp_c = 20.0;
+}
+
+/**
+ * @brief Write one register.
+ */
+static int bench_write(void *p_dev, uint8_t reg, uint8_t value)
+{
+    spp_uint8_t frame[2] = {reg, value};
+    return (SPP_HAL_SPI_Transmit(p_dev, frame, 2u) == SPP_OK) ? 0 : 1;
+}
+
+/**
+ * @brief Read count registers as one transaction per register.
+ *
+ * All frames go in one SPP_HAL_SPI_Transmit() call, which still issues a
+ * transaction (and a CS assertion) per frame.
+ *
+ * @param[in]  p_dev  Device handler.
+ * @param[in]  dummy  Dummy bytes the device returns after the address.
+ * @param[in]  start  First register.
+ * @param[out] p_out  Receives count values.
+ * @param[in]  count  Registers to read.
+ * @return 0 on success, non-zero on a transfer error.
+ */
+static int bench_read_regs(void *p_dev, uint8_t dummy, uint8_t start, uint8_t *p_out,
+                           uint8_t count)
+{
+    spp_uint8_t frames[255];
+    uint32_t frame = 2u + dummy;
+
+    if ((uint32_t)count * frame > sizeof(frames))
+        return 1;
+
+    memset(frames, 0, (size_t)count * frame);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        frames[i * frame] = (spp_uint8_t)(K_READ_FLAG | (start + i));
+    }
+    if (SPP_HAL_SPI_Transmit(p_dev, frames, (spp_uint8_t)(count * frame)) != SPP_OK)
+        return 1;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        p_out[i] = frames[i * frame + frame - 1u];
+    }
+    return 0;
+}
+
+static int bench_read(void *p_dev, uint8_t dummy, uint8_t start, uint8_t *p_out, uint8_t count,
+                      BenchMode_t mode)
+{
+    if (mode == K_MODE_BURST)
+        return (SPP_HAL_SPI_BurstRead(p_dev, start, p_out, count) == SPP_OK) ? 0 : 1;
+    return bench_read_regs(p_dev, dummy, start, p_out, count);
+}
+
+static int16_t bench_be16(const uint8_t *p_data)
+{
+    return (int16_t)(((uint16_t)p_data[0] << 8) | p_data[1]);
+}
+
+static uint32_t bench_le24(const uint8_t *p_data)
+{
+    return (uint32_t)p_data[0] | ((uint32_t)p_data[1] << 8) | ((uint32_t)p_data[2] << 16);
+}
+
+/**
+ * @brief Check an ICM20948 data block against the source at the read time.
+ *
+ * @return Number of values out of tolerance.
+ */
+static uint32_t bench_check_icm(const uint8_t *p_data, int64_t time_us)
+{
+    icm20948_sim_sample_t expected;
+    uint32_t bad = 0;
+
+    bench_icm_source(NULL, time_us, &expected);
+    for (int axis = 0; axis < 3; axis++)
+    {
+        double accel = bench_be16(&p_data[2 * axis]) / K_ICM_ACCEL_LSB_PER_G;
+        double gyro = bench_be16(&p_data[6 + 2 * axis]) / K_ICM_GYRO_LSB_PER_DPS;
+        bad += (fabs(accel - expected.accel_g[axis]) > K_TOL_ACCEL_G);
+        bad += (fabs(gyro - expected.gyro_dps[axis]) > K_TOL_GYRO_DPS);
+    }
+    double temp = bench_be16(&p_data[12]) / K_ICM_TEMP_LSB_PER_C + K_ICM_TEMP_OFFSET_C;
+    bad += (fabs(temp - expected.temp_c) > K_TOL_TEMP_C);
+    return bad;
+}
+
+/**
+ * @brief Check a BMP390 data block against the source at the read time.
+ *
+ * @return Number of values out of tolerance.
+ */
+static uint32_t bench_check_bmp(const uint8_t *p_data, int64_t time_us)
+{
+    bmp390_sim_sample_t expected;
+    double pressure = 0.0;
+    double temp = 0.0;
+
+    bench_bmp_source(NULL, time_us, &expected);
+    bmp390_sim_compensate(s_bmpNvm, bench_le24(&p_data[0]), bench_le24(&p_data[3]), &pressure,
+                          &temp);
+    return (uint32_t)(fabs(pressure - expected.pressure_pa) > K_TOL_PRESSURE_PA) +
+           (uint32_t)(fabs(temp - expected.temp_c) > K_TOL_TEMP_C);
+}
+
+/**
+ * @brief Identify both devices, read the BMP390 trimming and start both.
+ *
+ * @return 0 on success, non-zero on a transfer error or wrong identity.
+ */
+static int bench_setup(void *p_icm, void *p_bmp)
+{
+    uint8_t id = 0;
+
+    if (bench_read_regs(p_icm, 0u, K_ICM_WHO_AM_I, &id, 1u) != 0 || id != ICM20948_SIM_WHO_AM_I)
+    {
+        fprintf(stderr, "ICM20948 WHO_AM_I 0x%02x\n", id);
+        return 1;
+    }
+    if (bench_read_regs(p_bmp, 1u, K_BMP_CHIP_ID, &id, 1u) != 0 || id != BMP390_SIM_CHIP_ID)
+    {
+        fprintf(stderr, "BMP390 CHIP_ID 0x%02x\n", id);
+        return 1;
+    }
+    if (SPP_HAL_SPI_BurstRead(p_bmp, BMP390_SIM_NVM_PAR_ADDR, s_bmpNvm, sizeof(s_bmpNvm)) != SPP_OK)
+        return 1;
+
+    int err = bench_write(p_icm, K_ICM_PWR_MGMT_1, K_ICM_CLKSEL_AUTO);
+    err |= bench_write(p_icm, K_ICM_REG_BANK_SEL, 0x20u);
+    err |= bench_write(p_icm, K_ICM_B2_GYRO_SMPLRT_DIV, K_ICM_SMPLRT_DIV);
+    err |= bench_write(p_icm, K_ICM_REG_BANK_SEL, 0x00u);
+    err |= bench_write(p_bmp, K_BMP_OSR, K_BMP_OSR_P8_T1);
+    err |= bench_write(p_bmp, K_BMP_ODR, K_BMP_ODR_50HZ);
+    err |= bench_write(p_bmp, K_BMP_PWR_CTRL, K_BMP_PWR_NORMAL);
+    return err;
+}
+
+/**
+ * @brief Poll both devices for K_RUN_US and read every new sample.
+ *
+ * @return 0 on success, non-zero on a transfer error.
+ */
+static int bench_run(void *p_icm, void *p_bmp, BenchMode_t mode, BenchRun_t *p_run)
+{
+    uint8_t data[K_ICM_DATA_BYTES];
+    uint8_t status = 0;
+
+    memset(p_run, 0, sizeof(*p_run));
+    int64_t endUs = esp_timer_get_time() + K_RUN_US;
+    while (esp_timer_get_time() < endUs)
+    {
+        if (bench_read_regs(p_icm, 0u, K_ICM_INT_STATUS_1, &status, 1u) != 0)
+            return 1;
+        if ((status & K_ICM_RAW_DATA_RDY) != 0u)
+        {
+            if (bench_read(p_icm, 0u, K_ICM_ACCEL_XOUT_H, data, K_ICM_DATA_BYTES, mode) != 0)
+                return 1;
+            p_run->mismatches += bench_check_icm(data, esp_timer_get_time());
+            p_run->icmSamples += 1;
+        }
+
+        if (bench_read_regs(p_bmp, 1u, K_BMP_STATUS, &status, 1u) != 0)
+            return 1;
+        if ((status & K_BMP_DRDY_PRESS) != 0u)
+        {
+            if (bench_read(p_bmp, 1u, K_BMP_DATA_0, data, K_BMP_DATA_BYTES, mode) != 0)
+                return 1;
+            p_run->mismatches += bench_check_bmp(data, esp_timer_get_time());
+            p_run->bmpSamples += 1;
+        }
+
+        p_run->polls += 1;
+        usleep(K_POLL_US);
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(void)
+{
+    spi_host_device_stats_t icmBefore;
+    spi_host_device_stats_t bmpBefore;
+    spi_host_device_stats_t icmAfter;
+    spi_host_device_stats_t bmpAfter;
+    BenchRun_t run;
+
+    if (SPP_HAL_SPI_BusInit() != SPP_OK)
+        return 1;
+
+    void *p_icm = SPP_HAL_SPI_GetHandler();
+    void *p_bmp = SPP_HAL_SPI_GetHandler();
+    if (SPP_HAL_SPI_DeviceInit(p_icm) != SPP_OK || SPP_HAL_SPI_DeviceInit(p_bmp) != SPP_OK)
+        return 1;
+
+    icm20948_sim_init(&s_icm);
+    icm20948_sim_set_source(&s_icm, bench_icm_source, NULL);
+    bmp390_sim_init(&s_bmp);
+    bmp390_sim_set_source(&s_bmp, bench_bmp_source, NULL);
+    if (icm20948_sim_attach(&s_icm, CS_PIN_ICM) != ESP_OK ||
+        bmp390_sim_attach(&s_bmp, CS_PIN_BMP) != ESP_OK)
+        return 1;
+
+    if (bench_setup(p_icm, p_bmp) != 0)
+    {
+        fprintf(stderr, "device setup failed\n");
+        return 1;
+    }
+
+    printf("%.1f s per run, data-ready polled every %u us\n", K_RUN_US / 1e6, K_POLL_US);
+    printf("%-13s %6s %6s %6s %8s %8s %9s %9s %9s %6s\n", "mode", "icm", "bmp", "polls",
+           "icm_tx", "bmp_tx", "tx/sample", "bytes", "busy_us", "busy%");
+
+    int failed = 0;
+    for (int mode = K_MODE_PER_REGISTER; mode <= K_MODE_BURST; mode++)
+    {
+        spi_host_get_device_stats(CS_PIN_ICM, &icmBefore);
+        spi_host_get_device_stats(CS_PIN_BMP, &bmpBefore);
+        if (bench_run(p_icm, p_bmp, (BenchMode_t)mode, &run) != 0)
+        {
+            fprintf(stderr, "mode %s failed\n", s_modeNames[mode]);
+            return 1;
+        }
+        spi_host_get_device_stats(CS_PIN_ICM, &icmAfter);
+        spi_host_get_device_stats(CS_PIN_BMP, &bmpAfter);
+
+        uint32_t icmTx = icmAfter.transactions - icmBefore.transactions;
+        uint32_t bmpTx = bmpAfter.transactions - bmpBefore.transactions;
+        /* Transactions per sample, the data-ready polls excluded */
+        uint32_t samples = run.icmSamples + run.bmpSamples;
+        double perSample =
+            (samples != 0u) ? (double)(icmTx + bmpTx - 2u * run.polls) / samples : 0.0;
+        uint64_t bytes = (icmAfter.bytes - icmBefore.bytes) + (bmpAfter.bytes - bmpBefore.bytes);
+        uint64_t busyNs = (icmAfter.clocked_ns - icmBefore.clocked_ns) +
+                          (bmpAfter.clocked_ns - bmpBefore.clocked_ns);
+
+        printf("%-13s %6u %6u %6u %8u %8u %9.2f %9llu %9.0f %5.2f%%\n", s_modeNames[mode],
+               run.icmSamples, run.bmpSamples, run.polls, icmTx, bmpTx, perSample,
+               (unsigned long long)bytes, (double)busyNs / 1000.0,
+               100.0 * (double)busyNs / (K_RUN_US * 1000.0));
+        if (run.mismatches != 0u || run.icmSamples == 0u || run.bmpSamples == 0u)
+        {
+            fprintf(stderr, "mode %s: %u values out of tolerance\n", s_modeNames[mode],
+                    run.mismatches);
+            failed = 1;
+        }
+    }
+
+    icm20948_sim_stats_t icmStats;
+    bmp390_sim_stats_t bmpStats;
+    icm20948_sim_get_stats(&s_icm, &icmStats);
+    bmp390_sim_get_stats(&s_bmp, &bmpStats);
+    printf("icm20948 sim  %u transactions, %u samples taken\n", icmStats.transactions,
+           icmStats.samples);
+    printf("bmp390 sim    %u transactions, %u measurements\n", bmpStats.transactions,
+           bmpStats.measurements);
+
+    return failed;
+}
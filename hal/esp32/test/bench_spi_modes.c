@@ -0,0 +1,155 @@
+/**
+ * @file bench_spi_modes.c
+ * @brief Host microbenchmark of the SPI HAL transfer modes.
+ *
+ * Runs the same control-loop readout (four ICM20948 register reads) in
+ * interrupt mode, polling mode, and polling mode with the bus held, against
+ * the SPI master stand-in. Costs come from the stand-in's virtual bus clock,
+ * so results show what each mode spends per sequence under the configured
+ * timing model, including worst case under interrupt scheduling jitter.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "spp/hal/spi/spi.h"
+#include "macros_esp.h"
+#include "spi_esp32.h"
+#include "spi_host.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Sequences measured per mode. */
+#define K_ITERATIONS 20000u
+
+/** @brief Register reads per sequence. */
+#define K_READS_PER_SEQUENCE 4u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef enum
+{
+    K_MODE_INTERRUPT = 0,
+    K_MODE_POLLING = 1,
+    K_MODE_POLLING_ACQUIRED = 2
+} BenchMode_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static uint64_t s_samples[K_ITERATIONS];
+
+static const char *const s_modeNames[] = {"interrupt", "polling", "polling+bus"};
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static int bench_compare_u64(const void *p_a, const void *p_b)
+{
+    uint64_t a = *(const uint64_t *)p_a;
+    uint64_t b = *(const uint64_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+static uint64_t bench_wall_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Run one mode and print a result line.
+ *
+ * @param[in] p_icm ICM20948 handler.
+ * @param[in] mode  Mode to measure.
+ * @return 0 on success, non-zero if a transfer failed.
+ */
+static int bench_run_mode(void *p_icm, BenchMode_t mode)
+{
+    /* ICM20948 read frame: address, value */
+    spp_uint8_t frame[2];
+    spi_host_stats_t stats;
+
+    SPP_HAL_SPI_SetPollingMaxBytes((mode == K_MODE_INTERRUPT) ? 0u : SPI_POLLING_MAX_BYTES);
+    spi_host_reset_stats();
+
+    uint64_t wallStart = bench_wall_ns();
+    for (uint32_t i = 0; i < K_ITERATIONS; i++)
+    {
+        uint64_t before;
+        spi_host_get_stats(&stats);
+        before = stats.bus_time_ns;
+
+        if (mode == K_MODE_POLLING_ACQUIRED && SPP_HAL_SPI_AcquireBus(p_icm) != SPP_OK)
+            return 1;
+
+        for (uint32_t r = 0; r < K_READS_PER_SEQUENCE; r++)
+        {
+            frame[0] = (spp_uint8_t)(0x80u | (0x2Du + r));
+            frame[1] = 0;
+            if (SPP_HAL_SPI_Transmit(p_icm, frame, 2u) != SPP_OK)
+                return 1;
+        }
+
+        if (mode == K_MODE_POLLING_ACQUIRED)
+            SPP_HAL_SPI_ReleaseBus(p_icm);
+
+        spi_host_get_stats(&stats);
+        s_samples[i] = stats.bus_time_ns - before;
+    }
+    uint64_t wallNs = bench_wall_ns() - wallStart;
+
+    spi_host_get_stats(&stats);
+    qsort(s_samples, K_ITERATIONS, sizeof(s_samples[0]), bench_compare_u64);
+
+    printf("%-12s %10.0f %10llu %10llu %10.1f %8u %8u %10.0f\n", s_modeNames[mode],
+           (double)stats.bus_time_ns / K_ITERATIONS,
+           (unsigned long long)s_samples[K_ITERATIONS / 2],
+           (unsigned long long)s_samples[(K_ITERATIONS * 99u) / 100u],
+           (double)s_samples[K_ITERATIONS - 1u] / 1000.0, stats.interrupt_transactions,
+           stats.polling_transactions, (double)wallNs / K_ITERATIONS);
+    return 0;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(void)
+{
+    if (SPP_HAL_SPI_BusInit() != SPP_OK)
+        return 1;
+
+    void *p_icm = SPP_HAL_SPI_GetHandler();
+    void *p_bmp = SPP_HAL_SPI_GetHandler();
+    if (SPP_HAL_SPI_DeviceInit(p_icm) != SPP_OK || SPP_HAL_SPI_DeviceInit(p_bmp) != SPP_OK)
+        return 1;
+
+    printf("%u sequences of %u register reads per mode (virtual ns unless noted)\n",
+           K_ITERATIONS, K_READS_PER_SEQUENCE);
+    printf("%-12s %10s %10s %10s %10s %8s %8s %10s\n", "mode", "mean", "p50", "p99",
+           "max_us", "irq_tx", "poll_tx", "host_ns");
+
+    for (int mode = K_MODE_INTERRUPT; mode <= K_MODE_POLLING_ACQUIRED; mode++)
+    {
+        if (bench_run_mode(p_icm, (BenchMode_t)mode) != 0)
+        {
+            fprintf(stderr, "mode %s failed\n", s_modeNames[mode]);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file bench_storage.c
+ * @brief Host benchmark of raw sector logging through the storage HAL.
+ *
+ * Mounts a host directory as the card through the unmodified storage HAL,
+ * preallocates the log file and fills it with raw multi-sector writes of
+ * K_CHUNK_SECTORS, the way the log writer drains its buffers. Card timing
+ * comes from the SD stand-in (sd_host.h), including its periodic
+ * housekeeping pauses. Reports sustained throughput, the worst write and
+ * the card model's counters, then checks the file contents byte for byte.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "spp/hal/storage/storage.h"
+#include "esp_timer.h"
+#include "macros_esp.h"
+#include "sd_host.h"
+#include "storage_esp32.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_BASE_PATH "/tmp/spp_sd"
+#define K_FILE_NAME "LOG.BIN"
+
+#define K_FILE_BYTES (6u * 1024u * 1024u)
+
+/** @brief Sectors per raw write (one 32 KiB allocation unit). */
+#define K_CHUNK_SECTORS 64u
+
+#define K_CHUNK_BYTES (K_CHUNK_SECTORS * SPP_STORAGE_SECTOR_BYTES)
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static uint8_t s_chunk[K_CHUNK_BYTES] __attribute__((aligned(4)));
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Fill a chunk with a pattern that identifies its position.
+ */
+static void bench_fill(uint8_t *p_data, uint32_t chunk)
+{
+    for (uint32_t i = 0; i < K_CHUNK_BYTES; i += 4u)
+    {
+        uint32_t word = (chunk * K_CHUNK_BYTES + i) ^ 0x5A5A5A5Au;
+        memcpy(&p_data[i], &word, sizeof(word));
+    }
+}
+
+/**
+ * @brief Compare the log file with the written pattern.
+ *
+ * @return Number of chunks that differ, or UINT32_MAX if unreadable.
+ */
+static uint32_t bench_verify(const char *p_path, uint32_t chunks)
+{
+    static uint8_t s_expected[K_CHUNK_BYTES];
+    uint32_t bad = 0;
+
+    FILE *p_file = fopen(p_path, "rb");
+    if (p_file == NULL)
+        return UINT32_MAX;
+    for (uint32_t c = 0; c < chunks; c++)
+    {
+        bench_fill(s_expected, c);
+        if (fread(s_chunk, 1, K_CHUNK_BYTES, p_file) != K_CHUNK_BYTES ||
+            memcmp(s_chunk, s_expected, K_CHUNK_BYTES) != 0)
+        {
+            bad += 1;
+        }
+    }
+    fclose(p_file);
+    return bad;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(void)
+{
+    spp_storage_prealloc_cfg_t cfg = {
+        .base = {.p_base_path = K_BASE_PATH,
+                 .pin_cs = CS_PIN_SDC,
+                 .spi_host_id = USED_HOST,
+                 .format_if_mount_failed = 1,
+                 .max_files = 4,
+                 .allocation_unit_size = K_CHUNK_BYTES},
+        .p_prealloc_name = K_FILE_NAME,
+        .prealloc_bytes = K_FILE_BYTES,
+    };
+    spp_storage_raw_info_t info;
+    sd_host_timing_t timing;
+    sd_host_stats_t stats;
+
+    /* Start from an empty card so the file is allocated by this run */
+    remove(K_BASE_PATH "/" K_FILE_NAME);
+
+    if (SPP_HAL_Storage_MountPrealloc(&cfg) != SPP_OK || SPP_HAL_Storage_RawGetInfo(&info) != SPP_OK)
+    {
+        fprintf(stderr, "mount or preallocation failed\n");
+        return 1;
+    }
+
+    sd_host_get_default_timing(&timing);
+    printf("card model: %u us/command, %.1f MB/s write, %u ms pause every %u KiB\n",
+           timing.command_us, timing.write_bytes_per_s / 1e6, timing.busy_us / 1000u,
+           timing.busy_every_bytes / 1024u);
+    printf("file %s: %u sectors from sector %u, %u-sector writes\n", K_FILE_NAME,
+           info.sector_count, info.start_sector, K_CHUNK_SECTORS);
+
+    uint32_t chunks = info.sector_count / K_CHUNK_SECTORS;
+    sd_host_reset_stats();
+    int64_t startUs = esp_timer_get_time();
+    for (uint32_t c = 0; c < chunks; c++)
+    {
+        bench_fill(s_chunk, c);
+        if (SPP_HAL_Storage_RawWrite(s_chunk, K_CHUNK_SECTORS) != SPP_OK)
+        {
+            fprintf(stderr, "raw write %u failed\n", c);
+            return 1;
+        }
+    }
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+
+    SPP_HAL_Storage_RawGetInfo(&info);
+    sd_host_get_stats(&stats);
+    printf("%u writes in %.3f s: %.2f MB/s, mean %.0f us, max %lld us\n", info.writes,
+           elapsedUs / 1e6, (double)chunks * K_CHUNK_BYTES / (double)elapsedUs,
+           (double)info.write_total / info.writes, (long long)info.write_max);
+    printf("card: %llu sectors, %u commands, %u pauses, bus %.1f ms, %u unmapped\n",
+           (unsigned long long)stats.sectors_written, stats.commands, stats.busy_pauses,
+           stats.bus_time_ns / 1e6, stats.unmapped_sectors);
+
+    uint32_t bad = bench_verify(K_BASE_PATH "/" K_FILE_NAME, chunks);
+    if (SPP_HAL_Storage_Unmount(&cfg.base) != SPP_OK)
+        return 1;
+    if (bad != 0u || stats.unmapped_sectors != 0u || info.write_errors != 0u)
+    {
+        fprintf(stderr, "%u chunks differ on the card\n", bad);
+        return 1;
+    }
+    printf("contents verified\n");
+    return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test.c
+ * @brief ESP32 HAL microbenchmark suite.
+ *
+ * Measures SPI transaction cost by transfer size and mode on the ICM20948
+ * device: single register reads and writes through SPP_HAL_SPI_Transmit()
+ * and burst reads of 1 to SPP_HAL_SPI_BURST_MAX_BYTES bytes, each in
+ * interrupt mode and in polling mode. Every call is timed with the CPU
+ * cycle counter, so results include driver entry, bus arbitration, the
+ * transfer and completion.
+ *
+ * Output is JSON Lines in the layout of the OSAL suite
+ * (osal/freertos/test/test.c): a header object with cycles_per_us, then
+ * per case n, errors, p50, p99, max and mean in cycles, a power-of-two
+ * histogram, and the transaction and byte rates implied by the mean.
+ *
+ * On target call SPP_HAL_BenchRun() with the ICM20948 handler once the SPI
+ * bus and devices are up. On a host the file builds as the
+ * hal_bench executable against the ESP-IDF stand-ins, where the transfer
+ * itself takes no wall time and the numbers show software overhead only.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "spp/hal/spi/spi.h"
+#include "spp/core/returntypes.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "macros_esp.h"
+#include "spi_esp32.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Calls timed per case. */
+#define K_SAMPLES 1000u
+
+/** @brief Histogram buckets, one per bit of a 32-bit cycle count. */
+#define K_HIST_BUCKETS 32u
+
+#define K_READ_FLAG 0x80u
+
+/** @brief ICM20948 registers used: harmless to read, and a scratch register to write. */
+#define K_REG_WHO_AM_I 0x00u
+#define K_REG_ACCEL_XOUT_H 0x2Du
+#define K_REG_FIFO_EN_1 0x66u
+
+#define K_BURST_SIZES 6u
+
+/** @brief Polling threshold above every transfer measured. */
+#define K_POLL_ALL 0xFFFFu
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef enum
+{
+    K_CASE_READ = 0,  /**< One register read with SPP_HAL_SPI_Transmit(). */
+    K_CASE_WRITE = 1, /**< One register write with SPP_HAL_SPI_Transmit(). */
+    K_CASE_BURST = 2  /**< SPP_HAL_SPI_BurstRead(). */
+} BenchCase_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static const spp_uint8_t s_burstSizes[K_BURST_SIZES] = {1u, 6u, 14u, 24u, 40u,
+                                                       SPP_HAL_SPI_BURST_MAX_BYTES};
+
+static const char *const s_caseNames[] = {"spi_read_reg", "spi_write_reg", "spi_burst_read"};
+
+static uint32_t s_samples[K_SAMPLES];
+
+static spp_uint8_t s_buffer[SPP_HAL_SPI_BURST_MAX_BYTES];
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static int bench_compare_u32(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Print one result line. Sorts the samples.
+ *
+ * @param[in]     p_bench   Benchmark name.
+ * @param[in]     p_mode    Transfer mode.
+ * @param[in]     bytes     Bytes clocked per call.
+ * @param[in,out] p_samples Samples in cycles.
+ * @param[in]     n         Number of samples.
+ * @param[in]     errors    Failed calls.
+ */
+static void bench_report(const char *p_bench, const char *p_mode, uint32_t bytes,
+                         uint32_t *p_samples, uint32_t n, uint32_t errors)
+{
+    uint32_t hist[K_HIST_BUCKETS] = {0};
+    uint64_t total = 0;
+    uint32_t top = 0;
+
+    qsort(p_samples, n, sizeof(p_samples[0]), bench_compare_u32);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t bucket = (p_samples[i] == 0u) ? 0u : 31u - (uint32_t)__builtin_clz(p_samples[i]);
+        hist[bucket] += 1;
+        top = (bucket > top) ? bucket : top;
+        total += p_samples[i];
+    }
+
+    double mean = (double)total / n;
+    double perSecond = (mean > 0.0) ? (double)esp_rom_get_cpu_ticks_per_us() * 1e6 / mean : 0.0;
+
+    printf("{\"suite\":\"hal\",\"bench\":\"%s\",\"mode\":\"%s\",\"bytes\":%u,\"n\":%u,"
+           "\"errors\":%u,\"unit\":\"cycles\",\"p50\":%u,\"p99\":%u,\"max\":%u,\"mean\":%.1f,"
+           "\"transactions_per_s\":%.0f,\"bytes_per_s\":%.0f,\"hist_log2\":[",
+           p_bench, p_mode, bytes, n, errors, p_samples[n / 2u], p_samples[(n * 99u) / 100u],
+           p_samples[n - 1u], mean, perSecond, perSecond * bytes);
+    for (uint32_t b = 0; b <= top; b++)
+    {
+        printf((b == 0u) ? "%u" : ",%u", hist[b]);
+    }
+    printf("]}\n");
+}
+
+/**
+ * @brief Time K_SAMPLES calls of one case and print the result.
+ *
+ * @param[in] p_dev  Device handler.
+ * @param[in] kind   Case to run.
+ * @param[in] count  Burst length (K_CASE_BURST only).
+ * @param[in] p_mode Mode name for the report.
+ */
+static void bench_spi_case(void *p_dev, BenchCase_t kind, spp_uint8_t count, const char *p_mode)
+{
+    uint32_t errors = 0;
+    uint32_t bytes = (kind == K_CASE_BURST) ? 1u + count : 2u;
+
+    for (uint32_t i = 0; i < K_SAMPLES; i++)
+    {
+        retval_t ret;
+        esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+        if (kind == K_CASE_BURST)
+        {
+            ret = SPP_HAL_SPI_BurstRead(p_dev, K_REG_ACCEL_XOUT_H, s_buffer, count);
+        }
+        else
+        {
+            /* Rewriting FIFO_EN_1 with 0 keeps the device as it was */
+            s_buffer[0] = (kind == K_CASE_READ) ? (K_READ_FLAG | K_REG_WHO_AM_I) : K_REG_FIFO_EN_1;
+            s_buffer[1] = 0;
+            ret = SPP_HAL_SPI_Transmit(p_dev, s_buffer, 2u);
+        }
+        s_samples[i] = (uint32_t)(esp_cpu_get_cycle_count() - start);
+        errors += (ret != SPP_OK);
+    }
+
+    bench_report(s_caseNames[kind], p_mode, bytes, s_samples, K_SAMPLES, errors);
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Run every HAL benchmark and print the results as JSON Lines.
+ *
+ * Leaves the polling threshold at SPI_POLLING_MAX_BYTES.
+ *
+ * @param[in] p_dev Initialised ICM20948 device handler.
+ * @return SPP_OK when the suite ran (errors are reported per result),
+ *         SPP_ERROR_NULL_POINTER if p_dev is NULL.
+ */
+retval_t SPP_HAL_BenchRun(void *p_dev)
+{
+    static const char *const s_modes[] = {"interrupt", "polling"};
+
+    if (p_dev == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    printf("{\"suite\":\"hal\",\"cycles_per_us\":%u,\"samples\":%u}\n",
+           esp_rom_get_cpu_ticks_per_us(), K_SAMPLES);
+
+    for (uint32_t mode = 0; mode < 2u; mode++)
+    {
+        SPP_HAL_SPI_SetPollingMaxBytes((mode == 0u) ? 0u : K_POLL_ALL);
+
+        bench_spi_case(p_dev, K_CASE_READ, 0u, s_modes[mode]);
+        bench_spi_case(p_dev, K_CASE_WRITE, 0u, s_modes[mode]);
+        for (uint32_t s = 0; s < K_BURST_SIZES; s++)
+        {
+            bench_spi_case(p_dev, K_CASE_BURST, s_burstSizes[s], s_modes[mode]);
+        }
+    }
+
+    SPP_HAL_SPI_SetPollingMaxBytes(SPI_POLLING_MAX_BYTES);
+    return SPP_OK;
+}
+
+#if !defined(ESP_PLATFORM)
+int main(void)
+{
+    if (SPP_HAL_SPI_BusInit() != SPP_OK)
+        return 1;
+
+    void *p_icm = SPP_HAL_SPI_GetHandler();
+    if (SPP_HAL_SPI_DeviceInit(p_icm) != SPP_OK)
+        return 1;
+
+    return (SPP_HAL_BenchRun(p_icm) == SPP_OK) ? 0 : 1;
+}
+#endif
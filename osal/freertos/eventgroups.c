@@ -2,8 +2,10 @@
  * @file eventgroups.c
  * @brief FreeRTOS OSAL event groups implementation for the SPP framework.
  *
- * Provides static event group creation, ISR-safe bit setting, and blocking
- * bit wait operations using FreeRTOS event group primitives.
+ * Provides static event group creation and deletion, ISR-safe bit setting,
+ * and blocking bit wait operations using FreeRTOS event group primitives.
+ * Buffers come from a pool whose slots are reused after deletion, and event
+ * group handles are generation-checked (handlepool.h).
  */
 
 /* ============================================================================
@@ -11,22 +13,90 @@
  * ========================================================================= */
 
 #include "spp/osal/eventgroups.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
 #include "spp/core/returntypes.h"
 #include "spp/core/types.h"
 #include "spp/core/macros.h"
+#include "internal_freertos.h"
 #include "macros_freertos.h"
+#include "handlepool.h"
+#include "eventgroups_ext.h"
+#include "trace.h"
 
 /* ============================================================================
  * Private Variables
  * ========================================================================= */
 
-/** @brief Static storage for FreeRTOS event group buffers. */
+/** @brief Static storage for FreeRTOS event group buffers, indexed like the pool. */
 static StaticEventGroup_t s_eventGroupBuffers[NUM_EVENT_GROUPS];
 
-/** @brief Number of event group buffers currently allocated. */
-static spp_uint8_t s_counter = 0;
+/** @brief Handle reserved with each buffer by SPP_OSAL_GetEventGroupsBuffer(). */
+static void *s_bufferHandles[NUM_EVENT_GROUPS];
+
+/** @brief Handle slots of the event group pool. */
+static spp_handle_slot_t s_eventGroupHandleSlots[NUM_EVENT_GROUPS];
+
+/** @brief Event group handle pool. */
+static spp_handle_pool_t s_eventGroupHandles =
+    SPP_HANDLE_POOL_INITIALIZER(SPP_HANDLE_TYPE_EVENTGROUP, s_eventGroupHandleSlots,
+                                NUM_EVENT_GROUPS);
+
+/** @brief Queue-set proxy semaphore of each event group, indexed like the pool. */
+static SemaphoreHandle_t s_setProxies[NUM_EVENT_GROUPS];
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Find the handle reserved with a pool buffer.
+ *
+ * @param[in] p_buffer Buffer passed to SPP_OSAL_EventGroupCreate().
+ * @return The reserved handle, or NULL if p_buffer is not a pool buffer.
+ */
+static void *spp_osal_eventgroup_buffer_handle(const void *p_buffer)
+{
+    const StaticEventGroup_t *p_first = &s_eventGroupBuffers[0];
+    const StaticEventGroup_t *p_egBuffer = (const StaticEventGroup_t *)p_buffer;
+
+    if (p_egBuffer < p_first || p_egBuffer >= &p_first[NUM_EVENT_GROUPS])
+        return NULL;
+
+    return s_bufferHandles[p_egBuffer - p_first];
+}
+
+/**
+ * @brief Give a queue-set proxy semaphore.
+ *
+ * Pended to the timer daemon behind the deferred set of the bits, so a
+ * task woken through the queue set always finds the bits already set.
+ *
+ * @param[in] p_proxy Proxy semaphore.
+ * @param[in] unused  Unused.
+ */
+static void spp_osal_eventgroup_give_proxy(void *p_proxy, uint32_t unused)
+{
+    (void)unused;
+    /* Already given means the set already holds an event for this group */
+    (void)xSemaphoreGive((SemaphoreHandle_t)p_proxy);
+}
+
+/**
+ * @brief Deferred call that signals the caller of
+ *        SPP_OSAL_EventGroupClearProxy().
+ *
+ * @param[in] p_done Binary semaphore to give.
+ * @param[in] unused Unused.
+ */
+static void spp_osal_eventgroup_proxy_barrier(void *p_done, uint32_t unused)
+{
+    (void)unused;
+    (void)xSemaphoreGive((SemaphoreHandle_t)p_done);
+}
 
 /* ============================================================================
  * Public Functions
@@ -35,20 +105,23 @@ static spp_uint8_t s_counter = 0;
 /**
  * @brief Allocate an event group buffer from the static pool.
  *
- * Each call returns the next available StaticEventGroup_t from
- * s_eventGroupBuffers.
+ * Reserves a pool slot and returns its StaticEventGroup_t. The slot and its
+ * buffer return to the pool on SPP_OSAL_EventGroupDelete().
  *
  * @return Pointer to the allocated buffer, or NULL if the pool is exhausted.
  */
 void *SPP_OSAL_GetEventGroupsBuffer()
 {
-    if (s_counter >= NUM_EVENT_GROUPS)
+    spp_uint32_t index = 0;
+    void *p_handle = SPP_OSAL_HandleAlloc(&s_eventGroupHandles, NULL, &index);
+
+    if (p_handle == NULL)
     {
         return NULL;
     }
-    StaticEventGroup_t *p_buffer = &s_eventGroupBuffers[s_counter];
-    s_counter += 1;
-    void *p_bufferEventGroup = (void *)p_buffer;
+    s_bufferHandles[index] = p_handle;
+
+    void *p_bufferEventGroup = (void *)&s_eventGroupBuffers[index];
     return p_bufferEventGroup;
 }
 
@@ -57,14 +130,30 @@ void *SPP_OSAL_GetEventGroupsBuffer()
  *
  * In static mode (STATIC defined), uses xEventGroupCreateStatic with the
  * provided buffer. In dynamic mode, the buffer is ignored and
- * xEventGroupCreate is used instead.
+ * xEventGroupCreate is used instead. A buffer from
+ * SPP_OSAL_GetEventGroupsBuffer() uses the pool slot reserved with it; any
+ * other buffer takes a fresh slot.
  *
  * @param[in] p_eventGroupBuffer Pointer to a StaticEventGroup_t buffer
  *                               (used only in static allocation mode).
- * @return Event group handle as void pointer, or NULL on failure.
+ * @return Generation-checked event group handle, or NULL on failure.
  */
 void *SPP_OSAL_EventGroupCreate(void *p_eventGroupBuffer)
 {
+    void *p_handle = spp_osal_eventgroup_buffer_handle(p_eventGroupBuffer);
+
+    if (p_handle == NULL)
+    {
+        p_handle = SPP_OSAL_HandleAlloc(&s_eventGroupHandles, NULL, NULL);
+        if (p_handle == NULL)
+            return NULL;
+    }
+    else if (SPP_OSAL_HandleResolve(&s_eventGroupHandles, p_handle) != NULL)
+    {
+        /* Buffer already holds a live event group */
+        return NULL;
+    }
+
 #ifdef STATIC
     EventGroupHandle_t eg = xEventGroupCreateStatic((StaticEventGroup_t *)p_eventGroupBuffer);
 #else
@@ -72,16 +161,67 @@ void *SPP_OSAL_EventGroupCreate(void *p_eventGroupBuffer)
     EventGroupHandle_t eg = xEventGroupCreate();
 #endif
 
-    if (eg == NULL)
+    if (eg == NULL || SPP_OSAL_HandleSetObject(&s_eventGroupHandles, p_handle, (void *)eg) != SPP_OK)
+    {
+        if (eg != NULL)
+        {
+            vEventGroupDelete(eg);
+        }
+        (void)SPP_OSAL_HandleFree(&s_eventGroupHandles, p_handle);
         return NULL;
-    return (void *)eg;
+    }
+    return p_handle;
+}
+
+/**
+ * @brief Delete an event group and invalidate its handle.
+ *
+ * The handle is released first, so later calls through any copy of it fail
+ * with SPP_ERROR. A pool buffer becomes available to
+ * SPP_OSAL_GetEventGroupsBuffer() again. Tasks blocked on the group are
+ * released by FreeRTOS.
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
+ *         SPP_ERROR if the handle is stale.
+ */
+retval_t SPP_OSAL_EventGroupDelete(void *p_eventGroup)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_eventGroup == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    EventGroupHandle_t eg =
+        (EventGroupHandle_t)SPP_OSAL_HandleResolve(&s_eventGroupHandles, p_eventGroup);
+
+    spp_uint32_t index = 0;
+    if (eg == NULL || SPP_OSAL_HandleIndex(&s_eventGroupHandles, p_eventGroup, &index) != SPP_OK ||
+        SPP_OSAL_HandleFree(&s_eventGroupHandles, p_eventGroup) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    __atomic_store_n(&s_setProxies[index], NULL, __ATOMIC_RELEASE);
+    vEventGroupDelete(eg);
+    return ret;
 }
 
 /**
  * @brief Set bits in an event group from ISR context.
  *
  * Wraps xEventGroupSetBitsFromISR and converts the FreeRTOS result to
- * SPP return types.
+ * SPP return types. If the group is in a queue set, its proxy semaphore
+ * is given after the bits through the same deferred call queue. If that
+ * queue fills up between the two calls, the proxy is given directly
+ * instead, so the set still wakes; its waiter may then run just before the
+ * daemon sets the bits, which a wait with a timeout absorbs. The result
+ * reflects the bit set alone. Placed in IRAM for interrupts allocated
+ * with ESP_INTR_FLAG_IRAM.
  *
  * @param[in]  p_eventGroup             Event group handle.
  * @param[in]  bits_to_set              Bits to set in the event group.
@@ -89,18 +229,40 @@ void *SPP_OSAL_EventGroupCreate(void *p_eventGroupBuffer)
  *                                      not fully supported by FreeRTOS ISR API).
  * @param[out] p_higherPriorityTaskWoken Set to 1 if a higher-priority task was
  *                                      woken, 0 otherwise.
- * @return SPP_OK on success, SPP_ERROR if the set operation failed.
+ * @return SPP_OK on success, SPP_ERROR if the handle is stale or the set
+ *         operation failed.
  */
-retval_t OSAL_EventGroupSetBitsFromISR(void *p_eventGroup, osal_eventbits_t bits_to_set,
-                                       osal_eventbits_t *p_previousBits,
-                                       spp_uint8_t *p_higherPriorityTaskWoken)
+retval_t IRAM_ATTR OSAL_EventGroupSetBitsFromISR(void *p_eventGroup, osal_eventbits_t bits_to_set,
+                                                 osal_eventbits_t *p_previousBits,
+                                                 spp_uint8_t *p_higherPriorityTaskWoken)
 {
-    EventGroupHandle_t eg = (EventGroupHandle_t)p_eventGroup;
+    EventGroupHandle_t eg =
+        (EventGroupHandle_t)SPP_OSAL_HandleResolve(&s_eventGroupHandles, p_eventGroup);
 
+    if (eg == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    SPP_TRACE_INSTANT(SPP_TRACE_EV_EG_SET_ISR, p_eventGroup, bits_to_set);
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     BaseType_t result =
         xEventGroupSetBitsFromISR(eg, (EventBits_t)bits_to_set, &xHigherPriorityTaskWoken);
 
+    spp_uint32_t index = 0;
+    if (result == pdPASS &&
+        SPP_OSAL_HandleIndex(&s_eventGroupHandles, p_eventGroup, &index) == SPP_OK)
+    {
+        SemaphoreHandle_t proxy = __atomic_load_n(&s_setProxies[index], __ATOMIC_ACQUIRE);
+        if (proxy != NULL &&
+            xTimerPendFunctionCallFromISR(spp_osal_eventgroup_give_proxy, (void *)proxy, 0u,
+                                          &xHigherPriorityTaskWoken) != pdPASS)
+        {
+            /* The bits are already on their way; only the set wake-up needs a fallback */
+            (void)xSemaphoreGiveFromISR(proxy, &xHigherPriorityTaskWoken);
+        }
+    }
+
     if (p_previousBits != NULL)
     {
         *p_previousBits = 0;
@@ -126,6 +288,85 @@ retval_t OSAL_EventGroupSetBitsFromISR(void *p_eventGroup, osal_eventbits_t bits
     return SPP_ERROR;
 }
 
+/**
+ * @brief Attach the queue-set proxy semaphore of an event group.
+ *
+ * Called by SPP_OSAL_QueueSetAddEventGroup(); an event group belongs to at
+ * most one queue set.
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @param[in] p_proxy      Binary semaphore that is a member of the set.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_ERROR if the handle is stale or the group already has a proxy.
+ */
+retval_t SPP_OSAL_EventGroupSetProxy(void *p_eventGroup, void *p_proxy)
+{
+    spp_uint32_t index = 0;
+
+    if (p_eventGroup == NULL || p_proxy == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (SPP_OSAL_HandleIndex(&s_eventGroupHandles, p_eventGroup, &index) != SPP_OK)
+    {
+        return SPP_ERROR;
+    }
+
+    SemaphoreHandle_t expected = NULL;
+    if (!__atomic_compare_exchange_n(&s_setProxies[index], &expected, (SemaphoreHandle_t)p_proxy,
+                                     0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+
+/**
+ * @brief Detach the queue-set proxy semaphore of an event group.
+ *
+ * Called by SPP_OSAL_QueueSetDelete(). Gives already deferred by
+ * OSAL_EventGroupSetBitsFromISR() run in the timer daemon, so this waits
+ * for its queue to pass them before returning; afterwards the proxy can
+ * be deleted. Interrupts that set the group's bits must be stopped first,
+ * and it must not be called from the timer daemon.
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @param[in] p_proxy      Proxy passed to SPP_OSAL_EventGroupSetProxy().
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_ERROR if the handle is stale or p_proxy is not its proxy.
+ */
+retval_t SPP_OSAL_EventGroupClearProxy(void *p_eventGroup, void *p_proxy)
+{
+    spp_uint32_t index = 0;
+
+    if (p_eventGroup == NULL || p_proxy == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (SPP_OSAL_HandleIndex(&s_eventGroupHandles, p_eventGroup, &index) != SPP_OK)
+    {
+        return SPP_ERROR;
+    }
+
+    SemaphoreHandle_t expected = (SemaphoreHandle_t)p_proxy;
+    if (!__atomic_compare_exchange_n(&s_setProxies[index], &expected, NULL, 0, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE))
+    {
+        return SPP_ERROR;
+    }
+
+    /* The daemon runs deferred calls in order, so ours runs after any give */
+    StaticSemaphore_t doneBuffer;
+    SemaphoreHandle_t done = xSemaphoreCreateBinaryStatic(&doneBuffer);
+    if (xTimerPendFunctionCall(spp_osal_eventgroup_proxy_barrier, (void *)done, 0u,
+                               portMAX_DELAY) == pdPASS)
+    {
+        (void)xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+    return SPP_OK;
+}
+
 /**
  * @brief Wait for bits to be set in an event group.
  *
@@ -139,27 +380,27 @@ retval_t OSAL_EventGroupSetBitsFromISR(void *p_eventGroup, osal_eventbits_t bits
  * @param[in]  timeout_ms       Maximum wait time in milliseconds (0 = no wait).
  * @param[out] p_actualBits     Receives the actual event bits at return time
  *                              (may be NULL).
- * @return SPP_OK if the requested bits were set, SPP_ERROR on timeout.
+ * @return SPP_OK if the requested bits were set, SPP_ERROR on timeout or if
+ *         the handle is stale.
  */
 retval_t OSAL_EventGroupWaitBits(void *p_eventGroup, osal_eventbits_t bits_to_wait,
                                  spp_uint8_t clear_on_exit, spp_uint8_t wait_for_all_bits,
                                  spp_uint32_t timeout_ms, osal_eventbits_t *p_actualBits)
 {
-    EventGroupHandle_t eg = (EventGroupHandle_t)p_eventGroup;
+    EventGroupHandle_t eg =
+        (EventGroupHandle_t)SPP_OSAL_HandleResolve(&s_eventGroupHandles, p_eventGroup);
     TickType_t timeoutTicks;
     BaseType_t waitAll;
     BaseType_t clearOnExitFlag;
     EventBits_t result;
 
-    if (timeout_ms == 0)
-    {
-        timeoutTicks = 0;
-    }
-    else
+    if (eg == NULL)
     {
-        timeoutTicks = pdMS_TO_TICKS(timeout_ms);
+        return SPP_ERROR;
     }
 
+    timeoutTicks = spp_osal_ms_to_ticks(timeout_ms);
+
     if (wait_for_all_bits != 0)
     {
         waitAll = pdTRUE;
@@ -178,8 +419,10 @@ retval_t OSAL_EventGroupWaitBits(void *p_eventGroup, osal_eventbits_t bits_to_wa
         clearOnExitFlag = pdFALSE;
     }
 
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_EG_WAIT, p_eventGroup, bits_to_wait);
     result =
         xEventGroupWaitBits(eg, (EventBits_t)bits_to_wait, clearOnExitFlag, waitAll, timeoutTicks);
+    SPP_TRACE_END(SPP_TRACE_EV_EG_WAIT, p_eventGroup, result);
 
     if (p_actualBits != NULL)
     {
@@ -0,0 +1,27 @@
+/**
+ * @file eventgroups_ext.h
+ * @brief OSAL event group extensions beyond the core SPP event group interface.
+ *
+ * Deletion, and the proxy semaphore through which an event group takes
+ * part in a queue set (SPP_OSAL_QueueSetAddEventGroup()).
+ */
+
+#ifndef EVENTGROUPS_EXT_H
+#define EVENTGROUPS_EXT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_OSAL_EventGroupDelete(void *p_eventGroup);
+retval_t SPP_OSAL_EventGroupSetProxy(void *p_eventGroup, void *p_proxy);
+retval_t SPP_OSAL_EventGroupClearProxy(void *p_eventGroup, void *p_proxy);
+
+#endif /* EVENTGROUPS_EXT_H */
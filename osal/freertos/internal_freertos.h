@@ -0,0 +1,43 @@
+/**
+ * @file internal_freertos.h
+ * @brief Helpers shared by the FreeRTOS OSAL translation units.
+ *
+ * Every OSAL timeout and delay is converted to ticks here, so a non-zero
+ * millisecond value means the same thing in every module.
+ */
+
+#ifndef INTERNAL_FREERTOS_H
+#define INTERNAL_FREERTOS_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+/* ============================================================================
+ * Inline Helpers
+ * ========================================================================= */
+
+/**
+ * @brief Convert a millisecond timeout to FreeRTOS ticks.
+ *
+ * Ensures that a non-zero millisecond value always produces at least 1 tick,
+ * avoiding silent rounding to zero.
+ *
+ * @param[in] timeoutMs Timeout in milliseconds.
+ * @return Equivalent TickType_t value.
+ */
+static inline TickType_t spp_osal_ms_to_ticks(uint32_t timeoutMs)
+{
+    if (timeoutMs == 0u)
+        return 0u;
+
+    TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+    if (ticks == 0u)
+        ticks = 1u; /* Avoid rounding to 0 */
+    return ticks;
+}
+
+#endif /* INTERNAL_FREERTOS_H */
@@ -6,7 +6,93 @@
 #ifndef MACROS_FREERTOS_H
 #define MACROS_FREERTOS_H
 
-/** @brief Maximum number of statically allocated event group buffers. */
+/** @brief Maximum number of live event groups (handle pool size). */
+#ifndef NUM_EVENT_GROUPS
 #define NUM_EVENT_GROUPS 5
+#endif
+
+/** @brief Maximum number of live queues (handle pool size). */
+#ifndef NUM_QUEUES
+#define NUM_QUEUES 32
+#endif
+
+/** @brief Maximum number of live tasks (TCB pool and handle pool size). */
+#ifndef NUM_TASKS
+#define NUM_TASKS 50
+#endif
+
+/** @brief Size in bytes of the arena that task stacks are carved from. */
+#ifndef TASK_STACK_ARENA_BYTES
+#define TASK_STACK_ARENA_BYTES (96u * 1024u)
+#endif
+
+/**
+ * @brief Thread-local storage slot used to reclaim task stacks on deletion.
+ *
+ * Reclaiming needs CONFIG_FREERTOS_TLSP_DELETION_CALLBACKS and
+ * configNUM_THREAD_LOCAL_STORAGE_POINTERS > TASK_STACK_TLS_INDEX. Index 0
+ * is taken by the ESP-IDF pthread layer.
+ */
+#ifndef TASK_STACK_TLS_INDEX
+#define TASK_STACK_TLS_INDEX 1
+#endif
+
+/**
+ * @brief Longest SPP_OSAL_TaskDelete() waits, in milliseconds, for a task
+ *        that has not started yet to register its stack reclaim callback.
+ */
+#ifndef TASK_DELETE_START_TIMEOUT_MS
+#define TASK_DELETE_START_TIMEOUT_MS 100u
+#endif
+
+/**
+ * @brief Task notification index used to block on SPSC rings.
+ *
+ * Needs configTASK_NOTIFICATION_ARRAY_ENTRIES > SPSC_NOTIFY_INDEX. Keep it
+ * apart from indices the application uses for its own notifications.
+ */
+#ifndef SPSC_NOTIFY_INDEX
+#define SPSC_NOTIFY_INDEX 0
+#endif
+
+/**
+ * @brief Task notification index behind SPP_OSAL_TaskNotifyFromISR().
+ *
+ * Must differ from SPSC_NOTIFY_INDEX: ring wake-ups increment the value,
+ * which would corrupt the bits carried here. Needs
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES > TASK_NOTIFY_INDEX
+ * (CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES in menuconfig).
+ */
+#ifndef TASK_NOTIFY_INDEX
+#define TASK_NOTIFY_INDEX 1
+#endif
+
+/** @brief Maximum number of slots in a loan queue (SPP_OSAL_LoanQueue*). */
+#ifndef LOAN_QUEUE_MAX_SLOTS
+#define LOAN_QUEUE_MAX_SLOTS 32
+#endif
+
+/** @brief Maximum number of queues and event groups in one queue set. */
+#ifndef QUEUE_SET_MAX_MEMBERS
+#define QUEUE_SET_MAX_MEMBERS 8
+#endif
+
+/**
+ * @brief Non-zero to compile the trace hooks (trace.h) into the OSAL and
+ *        HAL. At 0 every hook expands to nothing.
+ */
+#ifndef SPP_TRACE_ENABLED
+#define SPP_TRACE_ENABLED 0
+#endif
+
+/** @brief Records per trace ring (power of two); one ring per core. */
+#ifndef SPP_TRACE_RING_EVENTS
+#define SPP_TRACE_RING_EVENTS 1024u
+#endif
+
+/** @brief Task names kept for trace dumps. */
+#ifndef SPP_TRACE_MAX_NAMES
+#define SPP_TRACE_MAX_NAMES NUM_TASKS
+#endif
 
 #endif /* MACROS_FREERTOS_H */
@@ -3,7 +3,11 @@
  * @brief FreeRTOS OSAL queue implementation for the SPP framework.
  *
  * Wraps FreeRTOS queue APIs (dynamic and static creation, send, receive,
- * reset, and message count) behind the SPP OSAL queue interface.
+ * reset, deletion and message count) behind the SPP OSAL queue interface,
+ * plus ISR-context send, receive and peek, batched send/receive that move
+ * several items per context switch, a zero-copy loan queue and queue
+ * sets over queues and event groups. Queue handles are generation-checked
+ * (handlepool.h), so operations on a deleted queue are rejected.
  */
 
 /* ============================================================================
@@ -12,35 +16,240 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "spp/osal/queue.h"
 #include "spp/core/types.h"
 #include "spp/core/returntypes.h"
 #include "freertos/task.h"
+#include "queue_ext.h"
+#include "eventgroups_ext.h"
+#include "handlepool.h"
+#include "internal_freertos.h"
+#include "macros_freertos.h"
+#include "trace.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Loan queue slot states (spp_loan_queue_t::slotState). */
+#define K_LOAN_SLOT_FREE 0u
+#define K_LOAN_SLOT_RESERVED 1u
+#define K_LOAN_SLOT_READY 2u
+#define K_LOAN_SLOT_BORROWED 3u
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+/** @brief Handle slots of the queue pool. */
+static spp_handle_slot_t s_queueHandleSlots[NUM_QUEUES];
+
+/** @brief Queue handle pool. */
+static spp_handle_pool_t s_queueHandles =
+    SPP_HANDLE_POOL_INITIALIZER(SPP_HANDLE_TYPE_QUEUE, s_queueHandleSlots, NUM_QUEUES);
+
+/** @brief Item size of each queue, by handle pool index. */
+static uint32_t s_queueItemSizes[NUM_QUEUES];
+
+/** @brief Length of each queue, by handle pool index. */
+static uint32_t s_queueLengths[NUM_QUEUES];
 
 /* ============================================================================
  * Private Functions
  * ========================================================================= */
 
 /**
- * @brief Convert a millisecond timeout to FreeRTOS ticks.
+ * @brief Register a new FreeRTOS queue in the handle pool.
+ *
+ * Deletes the queue if the pool is full, so the caller only has to check
+ * for NULL.
  *
- * Ensures that a non-zero millisecond value always produces at least 1 tick,
- * avoiding silent rounding to zero.
+ * @param[in] q            FreeRTOS queue handle (may be NULL).
+ * @param[in] queue_length Length the queue was created with.
+ * @param[in] item_size    Item size the queue was created with.
+ * @return Generation-checked queue handle, or NULL on failure.
+ */
+static void *spp_osal_queue_register(QueueHandle_t q, uint32_t queue_length, uint32_t item_size)
+{
+    spp_uint32_t index;
+
+    if (q == NULL)
+        return NULL;
+
+    void *p_handle = SPP_OSAL_HandleAlloc(&s_queueHandles, (void *)q, &index);
+    if (p_handle == NULL)
+    {
+        vQueueDelete(q);
+        return NULL;
+    }
+    s_queueItemSizes[index] = item_size;
+    s_queueLengths[index] = queue_length;
+    return p_handle;
+}
+
+/**
+ * @brief Check that a batch item size matches the queue's item size.
  *
- * @param[in] timeoutMs Timeout in milliseconds.
- * @return Equivalent TickType_t value.
+ * @param[in] p_queueHandle Queue handle (already resolved by the caller).
+ * @param[in] item_size     Item size passed to the batch call.
+ * @return 1 if the sizes match, 0 otherwise.
  */
-static TickType_t spp_osal_ms_to_ticks(uint32_t timeoutMs)
+static int spp_osal_queue_item_size_ok(const void *p_queueHandle, uint32_t item_size)
 {
-    if (timeoutMs == 0u)
-        return 0u;
+    spp_uint32_t index;
 
-    TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
-    if (ticks == 0u)
-        ticks = 1u; /* Avoid rounding to 0 */
-    return ticks;
+    if (SPP_OSAL_HandleIndex(&s_queueHandles, p_queueHandle, &index) != SPP_OK)
+        return 0;
+    return (s_queueItemSizes[index] == item_size) ? 1 : 0;
+}
+
+/**
+ * @brief Send consecutive items without blocking, with the scheduler suspended.
+ *
+ * FreeRTOS has no multi-item copy, so every item is still its own
+ * xQueueSend() that takes and releases the queue lock and may move a
+ * blocked receiver to the ready list. Suspending the scheduler only defers
+ * the resulting context switch to xTaskResumeAll(), so a run costs one
+ * switch instead of one per item, but the kernel calls stay per item.
+ *
+ * @param[in] q         FreeRTOS queue handle.
+ * @param[in] p_items   First item to send.
+ * @param[in] item_size Size of each item in bytes.
+ * @param[in] count     Number of items available at p_items.
+ * @return Number of items actually sent.
+ */
+static uint32_t spp_osal_queue_send_run(QueueHandle_t q, const uint8_t *p_items, uint32_t item_size,
+                                        uint32_t count)
+{
+    uint32_t sent = 0;
+
+    vTaskSuspendAll();
+    while (sent < count && xQueueSend(q, &p_items[(size_t)sent * item_size], 0) == pdTRUE)
+    {
+        sent += 1;
+    }
+    (void)xTaskResumeAll();
+
+    return sent;
+}
+
+/**
+ * @brief Receive consecutive items without blocking, with the scheduler suspended.
+ *
+ * Same cost as spp_osal_queue_send_run(): one xQueueReceive() and queue
+ * lock round trip per item, one deferred context switch per run.
+ *
+ * @param[in]  q          FreeRTOS queue handle.
+ * @param[out] p_outItems Buffer for up to max_items items.
+ * @param[in]  item_size  Size of each item in bytes.
+ * @param[in]  max_items  Capacity of p_outItems in items.
+ * @return Number of items actually received.
+ */
+static uint32_t spp_osal_queue_receive_run(QueueHandle_t q, uint8_t *p_outItems, uint32_t item_size,
+                                           uint32_t max_items)
+{
+    uint32_t received = 0;
+
+    vTaskSuspendAll();
+    while (received < max_items &&
+           xQueueReceive(q, &p_outItems[(size_t)received * item_size], 0) == pdTRUE)
+    {
+        received += 1;
+    }
+    (void)xTaskResumeAll();
+
+    return received;
+}
+
+/**
+ * @brief Send an item from an ISR at the given queue position.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to enqueue.
+ * @param[in]  position                  queueSEND_TO_BACK, queueSEND_TO_FRONT
+ *                                       or queueOVERWRITE.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a context switch should
+ *                                       be requested (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue is full or the handle is stale.
+ */
+static retval_t IRAM_ATTR spp_osal_queue_send_isr(void *p_queueHandle, const void *p_item,
+                                                  BaseType_t position,
+                                                  spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+    if (p_queueHandle == NULL || p_item == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    BaseType_t result = xQueueGenericSendFromISR(q, p_item, &xHigherPriorityTaskWoken, position);
+
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = (xHigherPriorityTaskWoken == pdTRUE) ? 1u : 0u;
+    }
+    return (result == pdTRUE) ? SPP_OK : SPP_ERROR;
+}
+
+/**
+ * @brief Map a slot pointer back to its index in a loan queue.
+ *
+ * @param[in]  p_lq    Loan queue control block.
+ * @param[in]  p_slot  Slot pointer previously handed out by the loan queue.
+ * @param[out] p_index Receives the slot index.
+ * @return 1 if p_slot is the start of a slot of this queue, 0 otherwise.
+ */
+static int spp_osal_loan_slot_index(const spp_loan_queue_t *p_lq, const void *p_slot,
+                                    uint16_t *p_index)
+{
+    const uint8_t *p_byte = (const uint8_t *)p_slot;
+
+    if (p_byte < p_lq->p_slots)
+        return 0;
+
+    size_t offset = (size_t)(p_byte - p_lq->p_slots);
+    if ((offset % p_lq->itemSize) != 0u || (offset / p_lq->itemSize) >= p_lq->slotCount)
+        return 0;
+
+    *p_index = (uint16_t)(offset / p_lq->itemSize);
+    return 1;
+}
+
+/**
+ * @brief Move a loan slot from one state to another.
+ *
+ * The compare-exchange makes a repeated commit or release of the same slot
+ * fail instead of queueing its index twice.
+ *
+ * @param[in,out] p_lq  Loan queue control block.
+ * @param[in]     index Slot index.
+ * @param[in]     from  Required current state.
+ * @param[in]     to    New state.
+ * @return 1 if the slot was in state from and is now in state to, 0 otherwise.
+ */
+static int spp_osal_loan_slot_move(spp_loan_queue_t *p_lq, uint16_t index, uint8_t from,
+                                   uint8_t to)
+{
+    uint8_t expected = from;
+    int moved = __atomic_compare_exchange_n(&p_lq->slotState[index], &expected, to, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return moved ? 1 : 0;
 }
 
 /* ============================================================================
@@ -52,7 +261,7 @@ static TickType_t spp_osal_ms_to_ticks(uint32_t timeoutMs)
  *
  * @param[in] queue_length Maximum number of items the queue can hold.
  * @param[in] item_size    Size of each item in bytes.
- * @return Queue handle as void pointer, or NULL on failure.
+ * @return Generation-checked queue handle, or NULL on failure.
  */
 void *SPP_OSAL_QueueCreate(uint32_t queue_length, uint32_t item_size)
 {
@@ -61,10 +270,7 @@ void *SPP_OSAL_QueueCreate(uint32_t queue_length, uint32_t item_size)
 
     QueueHandle_t queueHandle = xQueueCreate(queue_length, item_size);
 
-    if (queueHandle == NULL)
-        return NULL;
-
-    return (void *)queueHandle;
+    return spp_osal_queue_register(queueHandle, queue_length, item_size);
 }
 
 /**
@@ -74,7 +280,7 @@ void *SPP_OSAL_QueueCreate(uint32_t queue_length, uint32_t item_size)
  * @param[in] item_size     Size of each item in bytes.
  * @param[in] p_queueStorage Pointer to the static storage area for queue items.
  * @param[in] p_queueBuffer  Pointer to the StaticQueue_t buffer.
- * @return Queue handle as void pointer, or NULL on failure.
+ * @return Generation-checked queue handle, or NULL on failure.
  */
 void *SPP_OSAL_QueueCreateStatic(uint32_t queue_length, uint32_t item_size, uint8_t *p_queueStorage,
                                  void *p_queueBuffer)
@@ -92,10 +298,41 @@ void *SPP_OSAL_QueueCreateStatic(uint32_t queue_length, uint32_t item_size, uint
     QueueHandle_t queueHandle =
         xQueueCreateStatic(queue_length, item_size, p_queueStorage, (void *)p_queueBuffer);
 
-    if (queueHandle == NULL)
-        return NULL;
+    return spp_osal_queue_register(queueHandle, queue_length, item_size);
+}
+
+/**
+ * @brief Delete a queue and invalidate its handle.
+ *
+ * The handle is released first, so later calls through any copy of it fail
+ * with SPP_ERROR instead of touching freed memory. Storage passed to
+ * SPP_OSAL_QueueCreateStatic() may be reused once this returns. No task may
+ * be blocked on the queue.
+ *
+ * @param[in] p_queueHandle Queue handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
+ *         SPP_ERROR if the handle is stale.
+ */
+retval_t SPP_OSAL_QueueDelete(void *p_queueHandle)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_queueHandle == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
 
-    return (void *)queueHandle;
+    if (q == NULL || SPP_OSAL_HandleFree(&s_queueHandles, p_queueHandle) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    vQueueDelete(q);
+    return ret;
 }
 
 /* ============================================================================
@@ -106,14 +343,15 @@ void *SPP_OSAL_QueueCreateStatic(uint32_t queue_length, uint32_t item_size, uint
  * @brief Get the number of messages currently waiting in a queue.
  *
  * @param[in] p_queueHandle Queue handle.
- * @return Number of queued items, or 0 if the handle is NULL.
+ * @return Number of queued items, or 0 if the handle is NULL or stale.
  */
 uint32_t SPP_OSAL_QueueMessagesWaiting(void *p_queueHandle)
 {
-    if (p_queueHandle == NULL)
+    QueueHandle_t rtosHandle =
+        (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (rtosHandle == NULL)
         return 0;
 
-    QueueHandle_t rtosHandle = (QueueHandle_t)p_queueHandle;
     uint32_t queuedItems = (uint32_t)uxQueueMessagesWaiting(rtosHandle);
 
     return queuedItems;
@@ -130,7 +368,7 @@ uint32_t SPP_OSAL_QueueMessagesWaiting(void *p_queueHandle)
  * @param[in] p_item        Pointer to the item to enqueue.
  * @param[in] timeout_ms    Maximum wait time in milliseconds.
  * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
- *         SPP_ERROR if the send timed out.
+ *         SPP_ERROR if the send timed out or the queue handle is stale.
  */
 retval_t SPP_OSAL_QueueSend(void *p_queueHandle, const void *p_item, uint32_t timeout_ms)
 {
@@ -142,14 +380,20 @@ retval_t SPP_OSAL_QueueSend(void *p_queueHandle, const void *p_item, uint32_t ti
         return ret;
     }
 
-    QueueHandle_t q = (QueueHandle_t)p_queueHandle;
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
     TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
 
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_QUEUE_SEND, p_queueHandle, timeout_ms);
     if (xQueueSend(q, p_item, ticks) != pdTRUE)
     {
         ret = SPP_ERROR;
-        return ret;
     }
+    SPP_TRACE_END(SPP_TRACE_EV_QUEUE_SEND, p_queueHandle, ret);
 
     return ret;
 }
@@ -161,6 +405,7 @@ retval_t SPP_OSAL_QueueSend(void *p_queueHandle, const void *p_item, uint32_t ti
  * @param[out] p_outItem     Pointer to the buffer that receives the dequeued item.
  * @param[in]  timeout_ms    Maximum wait time in milliseconds.
  * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue handle is stale,
  *         SPP_NOT_ENOUGH_PACKETS if no item was available within the timeout.
  */
 retval_t SPP_OSAL_QueueReceive(void *p_queueHandle, void *p_outItem, uint32_t timeout_ms)
@@ -173,15 +418,21 @@ retval_t SPP_OSAL_QueueReceive(void *p_queueHandle, void *p_outItem, uint32_t ti
         return ret;
     }
 
-    QueueHandle_t q = (QueueHandle_t)p_queueHandle;
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
     TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
 
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_QUEUE_RECEIVE, p_queueHandle, timeout_ms);
     if (xQueueReceive(q, p_outItem, ticks) != pdTRUE)
     {
         /* For datapool: no pointers were available within the given time */
         ret = SPP_NOT_ENOUGH_PACKETS;
-        return ret;
     }
+    SPP_TRACE_END(SPP_TRACE_EV_QUEUE_RECEIVE, p_queueHandle, ret);
 
     return ret;
 }
@@ -191,7 +442,7 @@ retval_t SPP_OSAL_QueueReceive(void *p_queueHandle, void *p_outItem, uint32_t ti
  *
  * @param[in] p_queueHandle Queue handle.
  * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
- *         SPP_ERROR if the reset failed.
+ *         SPP_ERROR if the handle is stale or the reset failed.
  */
 retval_t SPP_OSAL_QueueReset(void *p_queueHandle)
 {
@@ -203,7 +454,12 @@ retval_t SPP_OSAL_QueueReset(void *p_queueHandle)
         return ret;
     }
 
-    QueueHandle_t q = (QueueHandle_t)p_queueHandle;
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
 
     if (xQueueReset(q) != pdTRUE)
     {
@@ -213,3 +469,751 @@ retval_t SPP_OSAL_QueueReset(void *p_queueHandle)
 
     return ret;
 }
+
+/* ============================================================================
+ * Public Functions — ISR Send / Receive / Peek
+ * ========================================================================= */
+
+/**
+ * @brief Send an item to the back of a queue from an ISR.
+ *
+ * Never blocks. A task waiting on the queue receives the item directly,
+ * so an interrupt handler can hand data over without a separate wake-up
+ * through an event group. Placed in IRAM for interrupts allocated with
+ * ESP_INTR_FLAG_IRAM.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to enqueue.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a context switch should
+ *                                       be requested (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue is full or the handle is stale.
+ */
+retval_t IRAM_ATTR SPP_OSAL_QueueSendFromISR(void *p_queueHandle, const void *p_item,
+                                             spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    return spp_osal_queue_send_isr(p_queueHandle, p_item, queueSEND_TO_BACK,
+                                   p_higherPriorityTaskWoken);
+}
+
+/**
+ * @brief Send an item to the front of a queue from an ISR.
+ *
+ * The item is received before every item already queued. Never blocks.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to enqueue.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a context switch should
+ *                                       be requested (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue is full or the handle is stale.
+ */
+retval_t IRAM_ATTR SPP_OSAL_QueueSendToFrontFromISR(void *p_queueHandle, const void *p_item,
+                                                    spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    return spp_osal_queue_send_isr(p_queueHandle, p_item, queueSEND_TO_FRONT,
+                                   p_higherPriorityTaskWoken);
+}
+
+/**
+ * @brief Replace the item of a one-item queue from an ISR.
+ *
+ * Writes the item whether or not the queue is full, so the queue always
+ * holds the latest value (a mailbox). Only valid on queues created with a
+ * length of 1; other queues are refused here rather than left to the
+ * FreeRTOS assert.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to store.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a context switch should
+ *                                       be requested (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue length is not 1 or the handle is stale.
+ */
+retval_t IRAM_ATTR SPP_OSAL_QueueOverwriteFromISR(void *p_queueHandle, const void *p_item,
+                                                  spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    spp_uint32_t index = 0;
+
+    if (p_queueHandle != NULL &&
+        SPP_OSAL_HandleIndex(&s_queueHandles, p_queueHandle, &index) == SPP_OK &&
+        s_queueLengths[index] != 1u)
+    {
+        if (p_higherPriorityTaskWoken != NULL)
+        {
+            *p_higherPriorityTaskWoken = 0;
+        }
+        return SPP_ERROR;
+    }
+
+    return spp_osal_queue_send_isr(p_queueHandle, p_item, queueOVERWRITE,
+                                   p_higherPriorityTaskWoken);
+}
+
+/**
+ * @brief Receive an item from a queue from an ISR.
+ *
+ * Never blocks. Freeing a slot may wake a task blocked on a full queue.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[out] p_outItem                 Receives the dequeued item.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a context switch should
+ *                                       be requested (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the handle is stale,
+ *         SPP_NOT_ENOUGH_PACKETS if the queue is empty.
+ */
+retval_t IRAM_ATTR SPP_OSAL_QueueReceiveFromISR(void *p_queueHandle, void *p_outItem,
+                                                spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+    if (p_queueHandle == NULL || p_outItem == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    BaseType_t result = xQueueReceiveFromISR(q, p_outItem, &xHigherPriorityTaskWoken);
+
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = (xHigherPriorityTaskWoken == pdTRUE) ? 1u : 0u;
+    }
+    return (result == pdTRUE) ? SPP_OK : SPP_NOT_ENOUGH_PACKETS;
+}
+
+/**
+ * @brief Copy the oldest item of a queue from an ISR without removing it.
+ *
+ * Never blocks and never wakes a task, so there is no woken flag.
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[out] p_outItem     Receives a copy of the item.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the handle is stale,
+ *         SPP_NOT_ENOUGH_PACKETS if the queue is empty.
+ */
+retval_t IRAM_ATTR SPP_OSAL_QueuePeekFromISR(void *p_queueHandle, void *p_outItem)
+{
+    if (p_queueHandle == NULL || p_outItem == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    return (xQueuePeekFromISR(q, p_outItem) == pdTRUE) ? SPP_OK : SPP_NOT_ENOUGH_PACKETS;
+}
+
+/* ============================================================================
+ * Public Functions — Batched Send / Receive
+ * ========================================================================= */
+
+/**
+ * @brief Send up to count items to a queue in one call.
+ *
+ * Items that fit are enqueued back to back with the scheduler suspended, so
+ * the caller is switched out at most once per batch. Each item is still a
+ * separate xQueueSend() with its own queue lock round trip (see
+ * spp_osal_queue_send_run()); the saving is in context switches, not in
+ * kernel calls. The timeout is converted once and only applies while the
+ * queue is completely full; after the first item is in, the remaining
+ * items are sent only while space is free.
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[in]  p_items       Array of count items.
+ * @param[in]  item_size     Size of each item in bytes; must equal the queue's.
+ * @param[in]  count         Number of items to send.
+ * @param[in]  timeout_ms    Maximum wait for the first free slot in milliseconds.
+ * @param[out] p_sent        Receives the number of items sent (may be NULL).
+ * @return SPP_OK if at least one item was sent (or count is 0),
+ *         SPP_ERROR_NULL_POINTER if handles are NULL, SPP_ERROR if the queue
+ *         stayed full for the whole timeout, the queue handle is stale or
+ *         item_size does not match the queue.
+ */
+retval_t SPP_OSAL_QueueSendBatch(void *p_queueHandle, const void *p_items, uint32_t item_size,
+                                 uint32_t count, uint32_t timeout_ms, uint32_t *p_sent)
+{
+    retval_t ret = SPP_OK;
+    uint32_t sent = 0;
+
+    if (p_queueHandle == NULL || p_items == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL || spp_osal_queue_item_size_ok(p_queueHandle, item_size) == 0)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+    const uint8_t *p_bytes = (const uint8_t *)p_items;
+
+    sent = spp_osal_queue_send_run(q, p_bytes, item_size, count);
+
+    if (sent == 0u && count > 0u)
+    {
+        TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
+
+        if (ticks != 0u && xQueueSend(q, p_bytes, ticks) == pdTRUE)
+        {
+            sent = 1u + spp_osal_queue_send_run(q, &p_bytes[item_size], item_size, count - 1u);
+        }
+        else
+        {
+            ret = SPP_ERROR;
+        }
+    }
+
+    if (p_sent != NULL)
+    {
+        *p_sent = sent;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Receive up to max_items items from a queue in one call.
+ *
+ * Waits at most timeout_ms for the first item, then drains whatever else is
+ * already queued with the scheduler suspended, so the caller is switched
+ * out at most once per batch. As with SPP_OSAL_QueueSendBatch(), every
+ * item is still its own xQueueReceive().
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[out] p_outItems    Buffer for up to max_items items.
+ * @param[in]  item_size     Size of each item in bytes; must equal the queue's.
+ * @param[in]  max_items     Capacity of p_outItems in items.
+ * @param[in]  timeout_ms    Maximum wait for the first item in milliseconds.
+ * @param[out] p_received    Receives the number of items read (may be NULL).
+ * @return SPP_OK if at least one item was received (or max_items is 0),
+ *         SPP_ERROR_NULL_POINTER if handles are NULL, SPP_ERROR if the queue
+ *         handle is stale or item_size does not match the queue,
+ *         SPP_NOT_ENOUGH_PACKETS if no item arrived within the timeout.
+ */
+retval_t SPP_OSAL_QueueReceiveBatch(void *p_queueHandle, void *p_outItems, uint32_t item_size,
+                                    uint32_t max_items, uint32_t timeout_ms,
+                                    uint32_t *p_received)
+{
+    retval_t ret = SPP_OK;
+    uint32_t received = 0;
+
+    if (p_queueHandle == NULL || p_outItems == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL || spp_osal_queue_item_size_ok(p_queueHandle, item_size) == 0)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+    uint8_t *p_bytes = (uint8_t *)p_outItems;
+
+    received = spp_osal_queue_receive_run(q, p_bytes, item_size, max_items);
+
+    if (received == 0u && max_items > 0u)
+    {
+        TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
+
+        if (ticks != 0u && xQueueReceive(q, p_bytes, ticks) == pdTRUE)
+        {
+            received = 1u + spp_osal_queue_receive_run(q, &p_bytes[item_size], item_size,
+                                                       max_items - 1u);
+        }
+        else
+        {
+            ret = SPP_NOT_ENOUGH_PACKETS;
+        }
+    }
+
+    if (p_received != NULL)
+    {
+        *p_received = received;
+    }
+
+    return ret;
+}
+
+/* ============================================================================
+ * Public Functions — Loan Queue
+ * ========================================================================= */
+
+/**
+ * @brief Create a zero-copy loan queue over caller-provided slot storage.
+ *
+ * Creates the two index queues inside p_loanBuffer with
+ * xQueueCreateStatic, so the loan queue needs no heap memory.
+ *
+ * @param[in] queue_length  Number of slots (at most LOAN_QUEUE_MAX_SLOTS).
+ * @param[in] item_size     Size of each slot in bytes.
+ * @param[in] p_slotStorage Slot storage of queue_length * item_size bytes.
+ * @param[in] p_loanBuffer  Pointer to an spp_loan_queue_t.
+ * @return Loan queue handle as void pointer, or NULL on failure.
+ */
+void *SPP_OSAL_LoanQueueCreateStatic(uint32_t queue_length, uint32_t item_size,
+                                     uint8_t *p_slotStorage, void *p_loanBuffer)
+{
+    if (queue_length == 0 || queue_length > LOAN_QUEUE_MAX_SLOTS || item_size == 0 ||
+        p_slotStorage == NULL || p_loanBuffer == NULL)
+    {
+        return NULL;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanBuffer;
+
+    p_lq->p_slots = p_slotStorage;
+    p_lq->slotCount = queue_length;
+    p_lq->itemSize = item_size;
+    memset(p_lq->slotState, K_LOAN_SLOT_FREE, sizeof(p_lq->slotState));
+
+    p_lq->freeQueue = xQueueCreateStatic(queue_length, sizeof(uint16_t),
+                                         (uint8_t *)p_lq->freeStorage, &p_lq->freeQueueBuffer);
+    if (p_lq->freeQueue == NULL)
+        return NULL;
+
+    p_lq->readyQueue = xQueueCreateStatic(queue_length, sizeof(uint16_t),
+                                          (uint8_t *)p_lq->readyStorage, &p_lq->readyQueueBuffer);
+    if (p_lq->readyQueue == NULL)
+    {
+        vQueueDelete(p_lq->freeQueue);
+        p_lq->freeQueue = NULL;
+        return NULL;
+    }
+
+    for (uint16_t i = 0; i < (uint16_t)queue_length; i++)
+    {
+        (void)xQueueSend(p_lq->freeQueue, &i, 0);
+    }
+
+    return (void *)p_lq;
+}
+
+/**
+ * @brief Reserve a free slot for the producer to fill in place.
+ *
+ * @param[in]  p_loanQueue Loan queue handle.
+ * @param[out] pp_slot     Receives a pointer to item_size writable bytes.
+ * @param[in]  timeout_ms  Maximum wait for a free slot in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if no slot became free within the timeout.
+ */
+retval_t SPP_OSAL_LoanQueueReserve(void *p_loanQueue, void **pp_slot, uint32_t timeout_ms)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || pp_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
+    uint16_t index;
+
+    if (xQueueReceive(p_lq->freeQueue, &index, ticks) != pdTRUE)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    __atomic_store_n(&p_lq->slotState[index], K_LOAN_SLOT_RESERVED, __ATOMIC_RELEASE);
+    *pp_slot = (void *)&p_lq->p_slots[(size_t)index * p_lq->itemSize];
+    return ret;
+}
+
+/**
+ * @brief Publish a reserved slot to the consumer.
+ *
+ * @param[in] p_loanQueue Loan queue handle.
+ * @param[in] p_slot      Slot obtained from SPP_OSAL_LoanQueueReserve().
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if p_slot does not belong to this queue or is not
+ *         currently reserved (e.g. already committed).
+ */
+retval_t SPP_OSAL_LoanQueueCommit(void *p_loanQueue, void *p_slot)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || p_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    uint16_t index;
+
+    if (spp_osal_loan_slot_index(p_lq, p_slot, &index) == 0 ||
+        spp_osal_loan_slot_move(p_lq, index, K_LOAN_SLOT_RESERVED, K_LOAN_SLOT_READY) == 0)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    /* Every index lives in exactly one queue, so this send never waits */
+    if (xQueueSend(p_lq->readyQueue, &index, 0) != pdTRUE)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Borrow the oldest committed slot for the consumer to read in place.
+ *
+ * @param[in]  p_loanQueue Loan queue handle.
+ * @param[out] pp_slot     Receives a pointer to the committed payload.
+ * @param[in]  timeout_ms  Maximum wait for a committed slot in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if nothing was committed within the timeout.
+ */
+retval_t SPP_OSAL_LoanQueueBorrow(void *p_loanQueue, void **pp_slot, uint32_t timeout_ms)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || pp_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
+    uint16_t index;
+
+    if (xQueueReceive(p_lq->readyQueue, &index, ticks) != pdTRUE)
+    {
+        ret = SPP_NOT_ENOUGH_PACKETS;
+        return ret;
+    }
+
+    __atomic_store_n(&p_lq->slotState[index], K_LOAN_SLOT_BORROWED, __ATOMIC_RELEASE);
+    *pp_slot = (void *)&p_lq->p_slots[(size_t)index * p_lq->itemSize];
+    return ret;
+}
+
+/**
+ * @brief Return a slot to the free list.
+ *
+ * Used by the consumer when done with a borrowed slot, or by the producer to
+ * abandon a reservation without committing it.
+ *
+ * @param[in] p_loanQueue Loan queue handle.
+ * @param[in] p_slot      Borrowed or reserved slot.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if p_slot does not belong to this queue or is neither
+ *         reserved nor borrowed (e.g. already released, or committed but not
+ *         yet borrowed).
+ */
+retval_t SPP_OSAL_LoanQueueRelease(void *p_loanQueue, void *p_slot)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || p_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    uint16_t index;
+
+    if (spp_osal_loan_slot_index(p_lq, p_slot, &index) == 0 ||
+        (spp_osal_loan_slot_move(p_lq, index, K_LOAN_SLOT_BORROWED, K_LOAN_SLOT_FREE) == 0 &&
+         spp_osal_loan_slot_move(p_lq, index, K_LOAN_SLOT_RESERVED, K_LOAN_SLOT_FREE) == 0))
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    if (xQueueSend(p_lq->freeQueue, &index, 0) != pdTRUE)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the number of committed slots waiting to be borrowed.
+ *
+ * @param[in] p_loanQueue Loan queue handle.
+ * @return Number of committed slots, or 0 if the handle is NULL.
+ */
+uint32_t SPP_OSAL_LoanQueueMessagesWaiting(void *p_loanQueue)
+{
+    if (p_loanQueue == NULL)
+        return 0;
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    return (uint32_t)uxQueueMessagesWaiting(p_lq->readyQueue);
+}
+
+/* ============================================================================
+ * Public Functions — Queue Set
+ * ========================================================================= */
+
+/**
+ * @brief Initialize an empty queue set.
+ *
+ * Backed by a FreeRTOS queue set, which holds one event per item waiting
+ * in a member queue and one per event group with new bits. capacity must
+ * cover the sum of the lengths of the queues to be added plus one per
+ * event group; SPP_OSAL_QueueSetAddQueue() and
+ * SPP_OSAL_QueueSetAddEventGroup() reject members beyond it.
+ *
+ * @param[out] p_set    Set control block.
+ * @param[in]  capacity Events the set can hold.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_set is NULL,
+ *         SPP_ERROR if capacity is 0 or the set cannot be allocated.
+ */
+retval_t SPP_OSAL_QueueSetInit(spp_queue_set_t *p_set, uint32_t capacity)
+{
+    if (p_set == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (capacity == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    p_set->set = xQueueCreateSet((UBaseType_t)capacity);
+    if (p_set->set == NULL)
+    {
+        return SPP_ERROR;
+    }
+    p_set->capacity = capacity;
+    p_set->reserved = 0;
+    p_set->memberCount = 0;
+    return SPP_OK;
+}
+
+/**
+ * @brief Add a queue to a queue set.
+ *
+ * The queue must be empty and in no other set. Add every member before
+ * the set is used. Once SPP_OSAL_QueueSetSelect() returns the queue, take
+ * exactly one item from it with a zero timeout.
+ *
+ * @param[in,out] p_set         Initialized set.
+ * @param[in]     p_queueHandle Queue handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_ERROR if the handle is stale, the queue is not empty or
+ *         already in a set, or the set is full.
+ */
+retval_t SPP_OSAL_QueueSetAddQueue(spp_queue_set_t *p_set, void *p_queueHandle)
+{
+    if (p_set == NULL || p_queueHandle == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    QueueHandle_t q = (QueueHandle_t)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+    if (q == NULL || p_set->memberCount >= QUEUE_SET_MAX_MEMBERS ||
+        uxQueueMessagesWaiting(q) != 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    /* An empty queue has its whole length free */
+    uint32_t length = (uint32_t)uxQueueSpacesAvailable(q);
+    if (length > p_set->capacity - p_set->reserved || xQueueAddToSet(q, p_set->set) != pdPASS)
+    {
+        return SPP_ERROR;
+    }
+
+    spp_queue_set_member_t *p_member = &p_set->members[p_set->memberCount];
+    p_member->p_handle = p_queueHandle;
+    p_member->member = q;
+    p_member->isEventGroup = 0;
+    p_set->memberCount += 1;
+    p_set->reserved += length;
+    return SPP_OK;
+}
+
+/**
+ * @brief Add an event group to a queue set.
+ *
+ * FreeRTOS event groups cannot join a queue set themselves, so the group
+ * gets a binary proxy semaphore in the set. OSAL_EventGroupSetBitsFromISR()
+ * gives it after the bits are applied, and SPP_OSAL_QueueSetSelect() takes
+ * it before returning the group. Bits set several times before a select
+ * yield one event; read them with OSAL_EventGroupWaitBits() and a zero
+ * timeout.
+ *
+ * @param[in,out] p_set        Initialized set.
+ * @param[in]     p_eventGroup Event group handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_ERROR if the handle is stale, the group is already in a set
+ *         or the set is full.
+ */
+retval_t SPP_OSAL_QueueSetAddEventGroup(spp_queue_set_t *p_set, void *p_eventGroup)
+{
+    if (p_set == NULL || p_eventGroup == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_set->memberCount >= QUEUE_SET_MAX_MEMBERS || p_set->reserved >= p_set->capacity)
+    {
+        return SPP_ERROR;
+    }
+
+    SemaphoreHandle_t proxy =
+        xSemaphoreCreateBinaryStatic(&p_set->proxyBuffers[p_set->memberCount]);
+    if (proxy == NULL)
+    {
+        return SPP_ERROR;
+    }
+    if (xQueueAddToSet(proxy, p_set->set) != pdPASS)
+    {
+        vSemaphoreDelete(proxy);
+        return SPP_ERROR;
+    }
+    if (SPP_OSAL_EventGroupSetProxy(p_eventGroup, (void *)proxy) != SPP_OK)
+    {
+        (void)xQueueRemoveFromSet(proxy, p_set->set);
+        vSemaphoreDelete(proxy);
+        return SPP_ERROR;
+    }
+
+    spp_queue_set_member_t *p_member = &p_set->members[p_set->memberCount];
+    p_member->p_handle = p_eventGroup;
+    p_member->member = proxy;
+    p_member->isEventGroup = 1;
+    p_set->memberCount += 1;
+    p_set->reserved += 1u;
+    return SPP_OK;
+}
+
+/**
+ * @brief Block until a member of a queue set is ready.
+ *
+ * Returns members in the order their events arrived. A returned queue
+ * holds at least one item for the caller; a returned event group had bits
+ * set since it was last returned.
+ *
+ * @param[in]  p_set      Initialized set.
+ * @param[in]  timeout_ms Maximum wait time in milliseconds (0 = no wait).
+ * @param[out] pp_member  Receives the queue or event group handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if no member became ready within the timeout.
+ */
+retval_t SPP_OSAL_QueueSetSelect(spp_queue_set_t *p_set, uint32_t timeout_ms, void **pp_member)
+{
+    if (p_set == NULL || pp_member == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    *pp_member = NULL;
+    QueueSetMemberHandle_t ready =
+        xQueueSelectFromSet(p_set->set, spp_osal_ms_to_ticks(timeout_ms));
+    if (ready == NULL)
+    {
+        return SPP_NOT_ENOUGH_PACKETS;
+    }
+
+    for (uint32_t i = 0; i < p_set->memberCount; i++)
+    {
+        spp_queue_set_member_t *p_member = &p_set->members[i];
+        if (p_member->member == ready)
+        {
+            if (p_member->isEventGroup != 0u)
+            {
+                (void)xSemaphoreTake((SemaphoreHandle_t)ready, 0);
+            }
+            *pp_member = p_member->p_handle;
+            break;
+        }
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Tear down a queue set and release its FreeRTOS set.
+ *
+ * Detaches every event group from its proxy, removes the members from the
+ * set and deletes the proxies and the set. The members themselves are
+ * left alive and can join another set. Member queues must be drained
+ * first, no task may be in SPP_OSAL_QueueSetSelect(), and interrupts that
+ * set member bits must be stopped. Members deleted before the set are
+ * skipped.
+ *
+ * @param[in,out] p_set Initialized set; must be initialized again before reuse.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_set is NULL,
+ *         SPP_ERROR if a member queue still holds items. Nothing is torn
+ *         down on error.
+ */
+retval_t SPP_OSAL_QueueSetDelete(spp_queue_set_t *p_set)
+{
+    if (p_set == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (p_set->set == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    for (uint32_t i = 0; i < p_set->memberCount; i++)
+    {
+        const spp_queue_set_member_t *p_member = &p_set->members[i];
+        if (p_member->isEventGroup == 0u &&
+            SPP_OSAL_HandleResolve(&s_queueHandles, p_member->p_handle) != NULL &&
+            uxQueueMessagesWaiting((QueueHandle_t)p_member->member) != 0u)
+        {
+            return SPP_ERROR;
+        }
+    }
+
+    for (uint32_t i = 0; i < p_set->memberCount; i++)
+    {
+        spp_queue_set_member_t *p_member = &p_set->members[i];
+        if (p_member->isEventGroup != 0u)
+        {
+            /* A stale group already dropped its proxy on delete */
+            (void)SPP_OSAL_EventGroupClearProxy(p_member->p_handle, (void *)p_member->member);
+            (void)xSemaphoreTake((SemaphoreHandle_t)p_member->member, 0);
+            (void)xQueueRemoveFromSet(p_member->member, p_set->set);
+            vSemaphoreDelete((SemaphoreHandle_t)p_member->member);
+        }
+        else if (SPP_OSAL_HandleResolve(&s_queueHandles, p_member->p_handle) != NULL)
+        {
+            (void)xQueueRemoveFromSet(p_member->member, p_set->set);
+        }
+        p_member->p_handle = NULL;
+        p_member->member = NULL;
+    }
+
+    vQueueDelete(p_set->set);
+    p_set->set = NULL;
+    p_set->capacity = 0;
+    p_set->reserved = 0;
+    p_set->memberCount = 0;
+    return SPP_OK;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file queue_ext.h
+ * @brief OSAL queue extensions beyond the core SPP queue interface.
+ *
+ * Queue deletion, ISR-context send, receive and peek, batched transfers
+ * that move several items per context switch, a loan-based queue that hands
+ * out slots in caller-provided storage so large payloads are produced and
+ * consumed in place without copies, and queue sets that let one task
+ * block on several queues and event groups at once.
+ */
+
+#ifndef QUEUE_EXT_H
+#define QUEUE_EXT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "macros_freertos.h"
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Loan queue control block.
+ *
+ * Slot indices circulate between a free queue and a ready queue; the
+ * payload itself never moves. Allocate statically and pass to
+ * SPP_OSAL_LoanQueueCreateStatic(). Fields are private to queue.c.
+ */
+typedef struct
+{
+    uint8_t *p_slots;
+    uint32_t slotCount;
+    uint32_t itemSize;
+    QueueHandle_t freeQueue;
+    QueueHandle_t readyQueue;
+    StaticQueue_t freeQueueBuffer;
+    StaticQueue_t readyQueueBuffer;
+    uint16_t freeStorage[LOAN_QUEUE_MAX_SLOTS];
+    uint16_t readyStorage[LOAN_QUEUE_MAX_SLOTS];
+    uint8_t slotState[LOAN_QUEUE_MAX_SLOTS]; /**< Free, reserved, ready or borrowed. */
+} spp_loan_queue_t;
+
+/**
+ * @brief One member of a queue set. Fields are private to queue.c.
+ */
+typedef struct
+{
+    void *p_handle;                /**< SPP queue or event group handle. */
+    QueueSetMemberHandle_t member; /**< Queue, or proxy semaphore of an event group. */
+    uint8_t isEventGroup;
+} spp_queue_set_member_t;
+
+/**
+ * @brief Queue set control block.
+ *
+ * Allocate statically, initialize with SPP_OSAL_QueueSetInit() and tear
+ * down with SPP_OSAL_QueueSetDelete(). Fields are private to queue.c.
+ */
+typedef struct
+{
+    QueueSetHandle_t set;
+    uint32_t capacity;    /**< Events the set can hold. */
+    uint32_t reserved;    /**< Events reserved by the members added so far. */
+    uint32_t memberCount;
+    spp_queue_set_member_t members[QUEUE_SET_MAX_MEMBERS];
+    StaticSemaphore_t proxyBuffers[QUEUE_SET_MAX_MEMBERS];
+} spp_queue_set_t;
+
+/* ============================================================================
+ * Public Functions — Queue Deletion
+ * ========================================================================= */
+
+retval_t SPP_OSAL_QueueDelete(void *p_queueHandle);
+
+/* ============================================================================
+ * Public Functions — ISR Send / Receive / Peek
+ * ========================================================================= */
+
+retval_t SPP_OSAL_QueueSendFromISR(void *p_queueHandle, const void *p_item,
+                                   spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_QueueSendToFrontFromISR(void *p_queueHandle, const void *p_item,
+                                          spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_QueueOverwriteFromISR(void *p_queueHandle, const void *p_item,
+                                        spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_QueueReceiveFromISR(void *p_queueHandle, void *p_outItem,
+                                      spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_QueuePeekFromISR(void *p_queueHandle, void *p_outItem);
+
+/* ============================================================================
+ * Public Functions — Batched Send / Receive
+ * ========================================================================= */
+
+retval_t SPP_OSAL_QueueSendBatch(void *p_queueHandle, const void *p_items, uint32_t item_size,
+                                 uint32_t count, uint32_t timeout_ms, uint32_t *p_sent);
+retval_t SPP_OSAL_QueueReceiveBatch(void *p_queueHandle, void *p_outItems, uint32_t item_size,
+                                    uint32_t max_items, uint32_t timeout_ms,
+                                    uint32_t *p_received);
+
+/* ============================================================================
+ * Public Functions — Loan Queue
+ * ========================================================================= */
+
+void *SPP_OSAL_LoanQueueCreateStatic(uint32_t queue_length, uint32_t item_size,
+                                     uint8_t *p_slotStorage, void *p_loanBuffer);
+retval_t SPP_OSAL_LoanQueueReserve(void *p_loanQueue, void **pp_slot, uint32_t timeout_ms);
+retval_t SPP_OSAL_LoanQueueCommit(void *p_loanQueue, void *p_slot);
+retval_t SPP_OSAL_LoanQueueBorrow(void *p_loanQueue, void **pp_slot, uint32_t timeout_ms);
+retval_t SPP_OSAL_LoanQueueRelease(void *p_loanQueue, void *p_slot);
+uint32_t SPP_OSAL_LoanQueueMessagesWaiting(void *p_loanQueue);
+
+/* ============================================================================
+ * Public Functions — Queue Set
+ * ========================================================================= */
+
+retval_t SPP_OSAL_QueueSetInit(spp_queue_set_t *p_set, uint32_t capacity);
+retval_t SPP_OSAL_QueueSetAddQueue(spp_queue_set_t *p_set, void *p_queueHandle);
+retval_t SPP_OSAL_QueueSetAddEventGroup(spp_queue_set_t *p_set, void *p_eventGroup);
+retval_t SPP_OSAL_QueueSetSelect(spp_queue_set_t *p_set, uint32_t timeout_ms, void **pp_member);
+retval_t SPP_OSAL_QueueSetDelete(spp_queue_set_t *p_set);
+
+#endif /* QUEUE_EXT_H */
@@ -0,0 +1,345 @@
+/**
+ * @file spsc.c
+ * @brief FreeRTOS OSAL single-producer/single-consumer ring implementation.
+ *
+ * Push and pop never enter a critical section: the producer owns the head
+ * index, the consumer owns the tail index, and each publishes its index with
+ * release semantics. When a side has to block it records its task handle
+ * and sleeps on a task notification; the opposite side checks that handle
+ * after every successful operation and notifies it directly. The FromISR
+ * paths live in IRAM so they stay callable while the flash cache is off.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "internal_freertos.h"
+#include "macros_freertos.h"
+#include "spsc.h"
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Copy one item into the ring if there is space.
+ *
+ * @param[in] p_ring Ring control block.
+ * @param[in] p_item Item to copy in.
+ * @return 1 if the item was stored, 0 if the ring is full.
+ */
+static int IRAM_ATTR spp_spsc_try_push(spp_spsc_t *p_ring, const void *p_item)
+{
+    uint32_t head = p_ring->head;
+    uint32_t tail = __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+
+    if ((head - tail) > p_ring->mask)
+        return 0;
+
+    memcpy(&p_ring->p_storage[(head & p_ring->mask) * p_ring->itemSize], p_item,
+           p_ring->itemSize);
+    __atomic_store_n(&p_ring->head, head + 1u, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * @brief Copy one item out of the ring if it is not empty.
+ *
+ * @param[in]  p_ring    Ring control block.
+ * @param[out] p_outItem Receives the item.
+ * @return 1 if an item was read, 0 if the ring is empty.
+ */
+static int IRAM_ATTR spp_spsc_try_pop(spp_spsc_t *p_ring, void *p_outItem)
+{
+    uint32_t tail = p_ring->tail;
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail)
+        return 0;
+
+    memcpy(p_outItem, &p_ring->p_storage[(tail & p_ring->mask) * p_ring->itemSize],
+           p_ring->itemSize);
+    __atomic_store_n(&p_ring->tail, tail + 1u, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * @brief Read the task parked on the opposite side of the ring.
+ *
+ * The full fence orders our index update before the read, pairing with the
+ * fence a blocking task issues between publishing its handle and
+ * re-checking the ring. One of the two sides is therefore guaranteed to see
+ * the other.
+ *
+ * @param[in] p_waiter Address of waitingConsumer or waitingProducer.
+ * @return Task to notify, or NULL if nobody is blocked.
+ */
+static TaskHandle_t IRAM_ATTR spp_spsc_waiter(volatile TaskHandle_t *p_waiter)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return *p_waiter;
+}
+
+/**
+ * @brief Block the calling task until the ring changes or the timeout expires.
+ *
+ * @param[in]     p_waiter   Slot in which to publish the calling task.
+ * @param[in]     p_ring     Ring control block.
+ * @param[in]     blocked_when_full 1 when waiting for space, 0 when waiting
+ *                           for data.
+ * @param[in,out] p_timeOut  Timeout state from vTaskSetTimeOutState().
+ * @param[in,out] p_ticks    Remaining ticks; updated on return.
+ * @return 1 if the caller should retry, 0 if the timeout expired.
+ */
+static int spp_spsc_block(volatile TaskHandle_t *p_waiter, spp_spsc_t *p_ring,
+                          int blocked_when_full, TimeOut_t *p_timeOut, TickType_t *p_ticks)
+{
+    *p_waiter = xTaskGetCurrentTaskHandle();
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    uint32_t count = SPP_OSAL_SpscCount(p_ring);
+    int stillBlocked = blocked_when_full ? (count > p_ring->mask) : (count == 0u);
+
+    if (stillBlocked)
+    {
+        (void)ulTaskNotifyTakeIndexed(SPSC_NOTIFY_INDEX, pdTRUE, *p_ticks);
+    }
+
+    *p_waiter = NULL;
+
+    if (xTaskCheckForTimeOut(p_timeOut, p_ticks) == pdTRUE)
+        return 0;
+    return 1;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Initialize an SPSC ring over caller-provided storage.
+ *
+ * @param[out] p_ring    Ring control block to initialize.
+ * @param[in]  p_storage Storage of capacity * item_size bytes.
+ * @param[in]  capacity  Number of items; must be a power of two.
+ * @param[in]  item_size Size of each item in bytes.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if capacity is not a power of two or item_size is 0.
+ */
+retval_t SPP_OSAL_SpscInit(spp_spsc_t *p_ring, uint8_t *p_storage, uint32_t capacity,
+                           uint32_t item_size)
+{
+    if (p_ring == NULL || p_storage == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    if (capacity == 0u || (capacity & (capacity - 1u)) != 0u || item_size == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    p_ring->p_storage = p_storage;
+    p_ring->mask = capacity - 1u;
+    p_ring->itemSize = item_size;
+    p_ring->head = 0;
+    p_ring->tail = 0;
+    p_ring->waitingConsumer = NULL;
+    p_ring->waitingProducer = NULL;
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Push an item from task context.
+ *
+ * @param[in] p_ring     Ring control block.
+ * @param[in] p_item     Item to copy into the ring.
+ * @param[in] timeout_ms Maximum time to wait for space in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the ring stayed full for the whole timeout.
+ */
+retval_t SPP_OSAL_SpscPush(spp_spsc_t *p_ring, const void *p_item, uint32_t timeout_ms)
+{
+    if (p_ring == NULL || p_item == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+
+    /* After a timeout, one last attempt catches space freed at the deadline */
+    int timedOut = (ticks == 0u) ? 1 : 0;
+    for (;;)
+    {
+        if (spp_spsc_try_push(p_ring, p_item) != 0)
+        {
+            TaskHandle_t consumer = spp_spsc_waiter(&p_ring->waitingConsumer);
+            if (consumer != NULL)
+            {
+                xTaskNotifyGiveIndexed(consumer, SPSC_NOTIFY_INDEX);
+            }
+            return SPP_OK;
+        }
+
+        if (timedOut != 0)
+        {
+            break;
+        }
+        timedOut = spp_spsc_block(&p_ring->waitingProducer, p_ring, 1, &timeOut, &ticks) ? 0 : 1;
+    }
+
+    return SPP_ERROR;
+}
+
+/**
+ * @brief Pop an item from task context.
+ *
+ * @param[in]  p_ring     Ring control block.
+ * @param[out] p_outItem  Receives the item.
+ * @param[in]  timeout_ms Maximum time to wait for data in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if the ring stayed empty for the whole
+ *         timeout.
+ */
+retval_t SPP_OSAL_SpscPop(spp_spsc_t *p_ring, void *p_outItem, uint32_t timeout_ms)
+{
+    if (p_ring == NULL || p_outItem == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    TickType_t ticks = spp_osal_ms_to_ticks(timeout_ms);
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+
+    /* After a timeout, one last attempt catches data pushed at the deadline */
+    int timedOut = (ticks == 0u) ? 1 : 0;
+    for (;;)
+    {
+        if (spp_spsc_try_pop(p_ring, p_outItem) != 0)
+        {
+            TaskHandle_t producer = spp_spsc_waiter(&p_ring->waitingProducer);
+            if (producer != NULL)
+            {
+                xTaskNotifyGiveIndexed(producer, SPSC_NOTIFY_INDEX);
+            }
+            return SPP_OK;
+        }
+
+        if (timedOut != 0)
+        {
+            break;
+        }
+        timedOut = spp_spsc_block(&p_ring->waitingConsumer, p_ring, 0, &timeOut, &ticks) ? 0 : 1;
+    }
+
+    return SPP_NOT_ENOUGH_PACKETS;
+}
+
+/**
+ * @brief Push an item from ISR context without blocking.
+ *
+ * @param[in]  p_ring                    Ring control block.
+ * @param[in]  p_item                    Item to copy into the ring.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a higher-priority task was
+ *                                       woken, 0 otherwise (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the ring is full.
+ */
+retval_t IRAM_ATTR SPP_OSAL_SpscPushFromISR(spp_spsc_t *p_ring, const void *p_item,
+                                            spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    retval_t ret = SPP_ERROR;
+
+    if (p_ring == NULL || p_item == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    if (spp_spsc_try_push(p_ring, p_item) != 0)
+    {
+        TaskHandle_t consumer = spp_spsc_waiter(&p_ring->waitingConsumer);
+        if (consumer != NULL)
+        {
+            vTaskNotifyGiveIndexedFromISR(consumer, SPSC_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+        }
+        ret = SPP_OK;
+    }
+
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = (xHigherPriorityTaskWoken == pdTRUE) ? 1 : 0;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Pop an item from ISR context without blocking.
+ *
+ * @param[in]  p_ring                    Ring control block.
+ * @param[out] p_outItem                 Receives the item.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a higher-priority task was
+ *                                       woken, 0 otherwise (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if the ring is empty.
+ */
+retval_t IRAM_ATTR SPP_OSAL_SpscPopFromISR(spp_spsc_t *p_ring, void *p_outItem,
+                                           spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    retval_t ret = SPP_NOT_ENOUGH_PACKETS;
+
+    if (p_ring == NULL || p_outItem == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    if (spp_spsc_try_pop(p_ring, p_outItem) != 0)
+    {
+        TaskHandle_t producer = spp_spsc_waiter(&p_ring->waitingProducer);
+        if (producer != NULL)
+        {
+            vTaskNotifyGiveIndexedFromISR(producer, SPSC_NOTIFY_INDEX, &xHigherPriorityTaskWoken);
+        }
+        ret = SPP_OK;
+    }
+
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = (xHigherPriorityTaskWoken == pdTRUE) ? 1 : 0;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the number of items currently stored in the ring.
+ *
+ * Exact when called by the producer or the consumer; a snapshot otherwise.
+ *
+ * @param[in] p_ring Ring control block.
+ * @return Number of queued items, or 0 if p_ring is NULL.
+ */
+uint32_t SPP_OSAL_SpscCount(const spp_spsc_t *p_ring)
+{
+    if (p_ring == NULL)
+        return 0;
+
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
@@ -3,51 +3,315 @@
  * @brief FreeRTOS OSAL task implementation for the SPP framework.
  *
  * Provides static task creation from a pre-allocated pool, task deletion,
- * and millisecond-based delay using FreeRTOS primitives.
+ * and millisecond-based delay using FreeRTOS primitives. Stacks are carved
+ * from a shared arena at the requested depth, and both the stack and the
+ * TCB slot are returned to the pool once FreeRTOS has finished deleting the
+ * task. Task handles are generation-checked (handlepool.h), so deleting a
+ * task through a stale handle is rejected. Pool tasks can be listed with
+ * their stack high-water mark and CPU load for monitoring, and can be woken
+ * from an ISR by a task notification.
  */
 
 /* ============================================================================
  * Includes
  * ========================================================================= */
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "spp/osal/task.h"
 #include "spp/core/types.h"
 #include "spp/core/macros.h"
+#include "internal_freertos.h"
+#include "macros_freertos.h"
+#include "task_ext.h"
+#include "handlepool.h"
+#include "trace.h"
 
 /* ============================================================================
  * Private Constants
  * ========================================================================= */
 
 /** @brief Maximum number of statically allocated tasks. */
-#define K_MAX_TASKS 50
+#define K_MAX_TASKS NUM_TASKS
 
-/** @brief Stack depth (in StackType_t words) for each task. */
-#define K_MAX_STACK 4096
+/** @brief Stack depth (in StackType_t words) used when a caller passes 0. */
+#define K_DEFAULT_STACK 4096
+
+/** @brief Stack alignment in StackType_t words (16 bytes on Xtensa/RISC-V). */
+#define K_STACK_ALIGN (16u / sizeof(StackType_t))
+
+/** @brief Arena size in StackType_t words. */
+#define K_ARENA_WORDS (TASK_STACK_ARENA_BYTES / sizeof(StackType_t))
+
+/** @brief Upper bound on arena blocks: every live stack plus the gaps around them. */
+#define K_MAX_BLOCKS (2 * K_MAX_TASKS + 1)
+
+/**
+ * @brief Whether stacks of deleted tasks can be reclaimed.
+ *
+ * FreeRTOS only stops touching a static TCB and stack after the idle task
+ * has cleaned up a self-deleted task. The ESP-IDF TLS deletion callback is
+ * invoked exactly at that point, so reclamation depends on it.
+ */
+#if defined(CONFIG_FREERTOS_TLSP_DELETION_CALLBACKS) &&                                            \
+    (configNUM_THREAD_LOCAL_STORAGE_POINTERS > TASK_STACK_TLS_INDEX)
+#define K_RECLAIM_STACKS 1
+#else
+#define K_RECLAIM_STACKS 0
+#endif
+
+#define K_STR_(x) #x
+#define K_STR(x) K_STR_(x)
+
+#pragma message("SPP OSAL task memory budget: stack arena " K_STR(TASK_STACK_ARENA_BYTES) \
+                " bytes, " K_STR(K_MAX_TASKS) " TCB slots")
+#if K_RECLAIM_STACKS == 0
+#pragma message("SPP OSAL: TLS deletion callbacks unavailable, deleted task stacks are not reclaimed")
+#endif
+#if SPP_OSAL_TASK_NOTIFY == 0
+#pragma message("SPP OSAL: configTASK_NOTIFICATION_ARRAY_ENTRIES <= TASK_NOTIFY_INDEX, SPP_OSAL_TaskNotify* unavailable")
+#endif
 
 /* ============================================================================
  * Private Types
  * ========================================================================= */
 
+/** @brief Life cycle of a TCB slot. */
+typedef enum
+{
+    K_SLOT_FREE = 0,     /**< On the free list. */
+    K_SLOT_RESERVED = 1, /**< Returned by SPP_OSAL_GetTaskStorage(). */
+    K_SLOT_CREATED = 2,  /**< Task created but its entry has not run yet. */
+    K_SLOT_RUNNING = 3   /**< Deletion callback registered; reclaim on delete. */
+} TaskSlotState_t;
+
 /**
- * @brief Static storage for a single FreeRTOS task (stack + TCB buffer).
+ * @brief Static storage for a single FreeRTOS task (TCB buffer + stack slice).
  */
 typedef struct
 {
-    StackType_t stack[K_MAX_STACK];
     StaticTask_t buffer;
+    StackType_t *p_stack;
+    uint32_t stackDepth;
+    TaskFunction_t p_function;
+    void *p_customData;
+    uint32_t prevRunTime;
+    uint64_t runTimeTotal;
+    void *p_handle;
+    volatile uint8_t state;
 } TaskStorage_t;
 
+/**
+ * @brief Contiguous range of the stack arena, in StackType_t words.
+ */
+typedef struct
+{
+    uint32_t offset;
+    uint32_t size;
+    uint8_t used;
+} ArenaBlock_t;
+
 /* ============================================================================
  * Private Variables
  * ========================================================================= */
 
-/** @brief Pool of pre-allocated task storage slots. */
+/** @brief Memory that task stacks are carved from. */
+static StackType_t s_stackArena[K_ARENA_WORDS] __attribute__((aligned(16)));
+
+/** @brief Arena blocks sorted by offset, covering the whole arena. */
+static ArenaBlock_t s_blocks[K_MAX_BLOCKS];
+
+/** @brief Number of valid entries in s_blocks (0 until first use). */
+static uint32_t s_blockCount = 0;
+
+/** @brief Pool of TCB slots, indexed like s_taskHandles. */
 static TaskStorage_t s_taskPool[K_MAX_TASKS];
 
-/** @brief Number of task storage slots currently allocated. */
-static uint32_t s_taskCount = 0;
+/** @brief Handle slots; allocating one reserves the TCB slot of the same index. */
+static spp_handle_slot_t s_taskHandleSlots[K_MAX_TASKS];
+
+/** @brief Task handle pool. */
+static spp_handle_pool_t s_taskHandles =
+    SPP_HANDLE_POOL_INITIALIZER(SPP_HANDLE_TYPE_TASK, s_taskHandleSlots, K_MAX_TASKS);
+
+/** @brief Running usage counters reported by SPP_OSAL_TaskArenaGetStats(). */
+static spp_task_arena_stats_t s_stats;
+
+/** @brief Run-time counter value at the previous SPP_OSAL_TaskGetStats() call. */
+static uint32_t s_prevStatsTime = 0;
+
+/** @brief Protects the arena and s_stats. */
+static portMUX_TYPE s_taskLock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Lazily set up the arena. Call with s_taskLock held.
+ */
+static void spp_osal_task_pool_init(void)
+{
+    if (s_blockCount != 0u)
+        return;
+
+    s_blocks[0].offset = 0;
+    s_blocks[0].size = K_ARENA_WORDS;
+    s_blocks[0].used = 0;
+    s_blockCount = 1;
+
+    s_stats.arena_bytes = TASK_STACK_ARENA_BYTES;
+    s_stats.tasks_max = K_MAX_TASKS;
+}
+
+/**
+ * @brief First-fit allocation from the arena. Call with s_taskLock held.
+ *
+ * @param[in] words Stack size in StackType_t words (already aligned).
+ * @return Offset of the allocated range, or UINT32_MAX if nothing fits.
+ */
+static uint32_t spp_osal_arena_alloc(uint32_t words)
+{
+    for (uint32_t i = 0; i < s_blockCount; i++)
+    {
+        ArenaBlock_t *p_block = &s_blocks[i];
+        if (p_block->used != 0u || p_block->size < words)
+            continue;
+
+        if (p_block->size > words && s_blockCount < K_MAX_BLOCKS)
+        {
+            /* Split: the remainder becomes a new free block right after */
+            for (uint32_t j = s_blockCount; j > i + 1u; j--)
+            {
+                s_blocks[j] = s_blocks[j - 1u];
+            }
+            s_blocks[i + 1u].offset = p_block->offset + words;
+            s_blocks[i + 1u].size = p_block->size - words;
+            s_blocks[i + 1u].used = 0;
+            s_blockCount += 1;
+            p_block->size = words;
+        }
+
+        p_block->used = 1;
+        s_stats.used_bytes += p_block->size * sizeof(StackType_t);
+        if (s_stats.used_bytes > s_stats.peak_used_bytes)
+        {
+            s_stats.peak_used_bytes = s_stats.used_bytes;
+        }
+        return p_block->offset;
+    }
+
+    return UINT32_MAX;
+}
+
+/**
+ * @brief Remove entry i from s_blocks. Call with s_taskLock held.
+ *
+ * @param[in] i Index of the block to drop.
+ */
+static void spp_osal_arena_remove_block(uint32_t i)
+{
+    for (uint32_t j = i; j + 1u < s_blockCount; j++)
+    {
+        s_blocks[j] = s_blocks[j + 1u];
+    }
+    s_blockCount -= 1;
+}
+
+/**
+ * @brief Return a range to the arena and merge it with free neighbours.
+ *        Call with s_taskLock held.
+ *
+ * @param[in] offset Offset returned by spp_osal_arena_alloc().
+ */
+static void spp_osal_arena_free(uint32_t offset)
+{
+    for (uint32_t i = 0; i < s_blockCount; i++)
+    {
+        if (s_blocks[i].offset != offset || s_blocks[i].used == 0u)
+            continue;
+
+        s_blocks[i].used = 0;
+        s_stats.used_bytes -= s_blocks[i].size * sizeof(StackType_t);
+
+        if (i + 1u < s_blockCount && s_blocks[i + 1u].used == 0u)
+        {
+            s_blocks[i].size += s_blocks[i + 1u].size;
+            spp_osal_arena_remove_block(i + 1u);
+        }
+        if (i > 0u && s_blocks[i - 1u].used == 0u)
+        {
+            s_blocks[i - 1u].size += s_blocks[i].size;
+            spp_osal_arena_remove_block(i);
+        }
+        return;
+    }
+}
+
+#if K_RECLAIM_STACKS
+/**
+ * @brief Return a slot and its stack to the pool.
+ *
+ * Releasing the handle bumps its generation, so copies of it still held by
+ * the application are rejected from now on.
+ *
+ * @param[in] p_taskStorage Slot to release.
+ */
+static void spp_osal_task_slot_release(TaskStorage_t *p_taskStorage)
+{
+    taskENTER_CRITICAL(&s_taskLock);
+    if (p_taskStorage->p_stack != NULL)
+    {
+        spp_osal_arena_free((uint32_t)(p_taskStorage->p_stack - s_stackArena));
+        p_taskStorage->p_stack = NULL;
+    }
+    taskEXIT_CRITICAL(&s_taskLock);
+
+    p_taskStorage->state = K_SLOT_FREE;
+    (void)SPP_OSAL_HandleFree(&s_taskHandles, p_taskStorage->p_handle);
+}
+
+/**
+ * @brief TLS deletion callback: FreeRTOS no longer references the TCB or stack.
+ *
+ * @param[in] index   TLS index (unused).
+ * @param[in] p_value Slot of the deleted task.
+ */
+static void spp_osal_task_reclaim(int index, void *p_value)
+{
+    (void)index;
+
+    spp_osal_task_slot_release((TaskStorage_t *)p_value);
+}
+#endif
+
+/**
+ * @brief Entry point of every OSAL task.
+ *
+ * Registers the reclaim callback from the task itself, so the registration
+ * can never race with the task deleting itself, then runs the user function.
+ *
+ * @param[in] p_arg Slot of the task.
+ */
+static void spp_osal_task_entry(void *p_arg)
+{
+    TaskStorage_t *p_taskStorage = (TaskStorage_t *)p_arg;
+
+#if K_RECLAIM_STACKS
+    vTaskSetThreadLocalStoragePointerAndDelCallback(NULL, TASK_STACK_TLS_INDEX, p_taskStorage,
+                                                    spp_osal_task_reclaim);
+#endif
+    __atomic_store_n(&p_taskStorage->state, K_SLOT_RUNNING, __ATOMIC_RELEASE);
+
+    p_taskStorage->p_function(p_taskStorage->p_customData);
+
+    /* FreeRTOS tasks must not return */
+    vTaskDelete(NULL);
+}
 
 /* ============================================================================
  * Public Functions
@@ -56,19 +320,32 @@ static uint32_t s_taskCount = 0;
 /**
  * @brief Allocate a task storage slot from the static pool.
  *
- * Each call returns the next available TaskStorage_t from s_taskPool.
+ * Slots of deleted tasks are reused. The slot's handle is reserved here and
+ * returned by SPP_OSAL_TaskCreate(); the stack is only assigned there, once
+ * the requested depth is known.
  *
  * @return Pointer to the allocated TaskStorage_t, or NULL if the pool is
  *         exhausted.
  */
 void *SPP_OSAL_GetTaskStorage()
 {
-    if (s_taskCount >= K_MAX_TASKS)
+    spp_uint32_t index = 0;
+    void *p_handle = SPP_OSAL_HandleAlloc(&s_taskHandles, NULL, &index);
+
+    if (p_handle == NULL)
     {
+        taskENTER_CRITICAL(&s_taskLock);
+        s_stats.alloc_failures += 1;
+        taskEXIT_CRITICAL(&s_taskLock);
         return NULL;
     }
-    TaskStorage_t *p_taskStorage = &s_taskPool[s_taskCount];
-    s_taskCount += 1;
+
+    TaskStorage_t *p_taskStorage = &s_taskPool[index];
+    p_taskStorage->p_handle = p_handle;
+    p_taskStorage->p_stack = NULL;
+    p_taskStorage->state = K_SLOT_RESERVED;
+    (void)SPP_OSAL_HandleSetObject(&s_taskHandles, p_handle, p_taskStorage);
+
     return p_taskStorage;
 }
 
@@ -77,49 +354,87 @@ void *SPP_OSAL_GetTaskStorage()
  *
  * @param[in] p_function   Task entry function pointer.
  * @param[in] task_name    Human-readable task name string.
- * @param[in] stack_depth  Requested stack depth (unused; actual depth comes
- *                         from the storage pool).
+ * @param[in] stack_depth  Stack depth in StackType_t words, carved from the
+ *                         stack arena (0 selects K_DEFAULT_STACK).
  * @param[in] p_custom_data Opaque pointer passed to the task function.
  * @param[in] priority     FreeRTOS task priority.
  * @param[in] p_storage    Pointer to a TaskStorage_t obtained from
  *                         SPP_OSAL_GetTaskStorage().
- * @return Task handle as void pointer, or NULL on failure.
+ * @return Generation-checked task handle, or NULL on failure.
  */
 void *SPP_OSAL_TaskCreate(void *p_function, const char *const task_name, const uint32_t stack_depth,
                           void *const p_custom_data, spp_uint32_t priority, void *p_storage)
 {
-    if (p_function == NULL || task_name == NULL)
+    if (p_function == NULL || task_name == NULL || p_storage == NULL)
     {
         return NULL;
     }
 
     TaskStorage_t *p_taskStorage = (TaskStorage_t *)p_storage;
 
-    StackType_t *p_stack = p_taskStorage->stack;
-    StaticTask_t *p_taskBuffer = &p_taskStorage->buffer;
+    uint32_t depth = (stack_depth == 0u) ? K_DEFAULT_STACK : stack_depth;
+    if (depth < configMINIMAL_STACK_SIZE)
+    {
+        depth = configMINIMAL_STACK_SIZE;
+    }
+    depth = (depth + K_STACK_ALIGN - 1u) & ~(uint32_t)(K_STACK_ALIGN - 1u);
+
+    taskENTER_CRITICAL(&s_taskLock);
+    spp_osal_task_pool_init();
+    uint32_t offset = spp_osal_arena_alloc(depth);
+    if (offset == UINT32_MAX)
+    {
+        s_stats.alloc_failures += 1;
+    }
+    taskEXIT_CRITICAL(&s_taskLock);
+
+    if (offset == UINT32_MAX)
+    {
+        return NULL;
+    }
 
-    UBaseType_t realStackDepth = sizeof(p_taskStorage->stack) / sizeof(StackType_t);
+    p_taskStorage->p_stack = &s_stackArena[offset];
+    p_taskStorage->stackDepth = depth;
+    p_taskStorage->p_function = (TaskFunction_t)p_function;
+    p_taskStorage->p_customData = p_custom_data;
+    p_taskStorage->prevRunTime = 0;
+    p_taskStorage->runTimeTotal = 0;
+    p_taskStorage->state = K_SLOT_CREATED;
 
-    TaskHandle_t p_task =
-        xTaskCreateStatic((TaskFunction_t)p_function, task_name, realStackDepth, p_custom_data,
-                          (UBaseType_t)priority, p_stack, p_taskBuffer);
+    TaskHandle_t p_task = xTaskCreateStatic(spp_osal_task_entry, task_name, depth, p_taskStorage,
+                                            (UBaseType_t)priority, p_taskStorage->p_stack,
+                                            &p_taskStorage->buffer);
     if (p_task == NULL)
     {
+        taskENTER_CRITICAL(&s_taskLock);
+        spp_osal_arena_free(offset);
+        taskEXIT_CRITICAL(&s_taskLock);
+        p_taskStorage->p_stack = NULL;
+        p_taskStorage->state = K_SLOT_RESERVED;
         return NULL;
     }
+    SPP_TRACE_NAME(p_task, task_name);
+    SPP_TRACE_INSTANT(SPP_TRACE_EV_TASK_CREATE, p_task, priority);
 
-    void *p_taskHandle = (void *)p_task;
-    return p_taskHandle;
+    return p_taskStorage->p_handle;
 }
 
 /**
  * @brief Delete a FreeRTOS task.
  *
  * If p_task is NULL or contains a NULL handle, the calling task is deleted.
+ * The task's stack and slot return to the pool once FreeRTOS has finished
+ * with them. A task that has not started running yet is given up to
+ * TASK_DELETE_START_TIMEOUT_MS to register its reclaim callback before it
+ * is deleted; if it is starved or suspended for longer, it is left alone
+ * and the call fails so it can be retried.
  *
  * @param[in] p_task Pointer to the task handle, or NULL to delete the
  *                   calling task.
- * @return SPP_OK (note: if the calling task is deleted, this does not return).
+ * @return SPP_OK on success (if the calling task is deleted, this does not
+ *         return), SPP_ERROR if the handle is stale or was not returned by
+ *         SPP_OSAL_TaskCreate(), or if the task has not started running
+ *         within the timeout or before the scheduler was started.
  */
 retval_t SPP_OSAL_TaskDelete(void *p_task)
 {
@@ -130,25 +445,284 @@ retval_t SPP_OSAL_TaskDelete(void *p_task)
         return SPP_OK;
     }
 
-    TaskHandle_t taskHandle = *(TaskHandle_t *)p_task;
+    void *p_handle = *(void **)p_task;
 
     /* If caller passed a NULL handle inside the pointer, delete current task */
-    if (taskHandle == NULL)
+    if (p_handle == NULL)
     {
         vTaskDelete(NULL);
         return SPP_OK;
     }
 
-    vTaskDelete(taskHandle);
+    TaskStorage_t *p_taskStorage = SPP_OSAL_HandleResolve(&s_taskHandles, p_handle);
+    if (p_taskStorage == NULL || p_taskStorage->state == K_SLOT_RESERVED)
+    {
+        return SPP_ERROR;
+    }
+
+#if K_RECLAIM_STACKS
+    if (__atomic_load_n(&p_taskStorage->state, __ATOMIC_ACQUIRE) == K_SLOT_CREATED)
+    {
+        /* Waiting needs the scheduler; before it starts the entry cannot run */
+        if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+        {
+            return SPP_ERROR;
+        }
+
+        TickType_t start = xTaskGetTickCount();
+        TickType_t limit = spp_osal_ms_to_ticks(TASK_DELETE_START_TIMEOUT_MS);
+        while (__atomic_load_n(&p_taskStorage->state, __ATOMIC_ACQUIRE) == K_SLOT_CREATED)
+        {
+            if ((TickType_t)(xTaskGetTickCount() - start) >= limit)
+            {
+                return SPP_ERROR;
+            }
+            vTaskDelay(1);
+        }
+    }
+#endif
+
+    vTaskDelete((TaskHandle_t)&p_taskStorage->buffer);
     return SPP_OK;
 }
 
 /**
  * @brief Delay the calling task for a specified number of milliseconds.
  *
+ * A non-zero delay shorter than one tick still waits one tick; 0 only
+ * yields.
+ *
  * @param[in] blocktime_ms Delay duration in milliseconds.
  */
 void SPP_OSAL_TaskDelay(spp_uint32_t blocktime_ms)
 {
-    vTaskDelay(pdMS_TO_TICKS(blocktime_ms));
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_TASK_DELAY, 0u, blocktime_ms);
+    vTaskDelay(spp_osal_ms_to_ticks(blocktime_ms));
+    SPP_TRACE_END(SPP_TRACE_EV_TASK_DELAY, 0u, blocktime_ms);
+}
+
+/**
+ * @brief Get the handle of the calling task.
+ *
+ * @return Handle as returned by SPP_OSAL_TaskCreate(), or NULL if the
+ *         caller was not created through the OSAL.
+ */
+void *SPP_OSAL_TaskGetCurrent(void)
+{
+    uintptr_t current = (uintptr_t)xTaskGetCurrentTaskHandle();
+    uintptr_t first = (uintptr_t)&s_taskPool[0];
+
+    if (current < first || current >= (uintptr_t)&s_taskPool[K_MAX_TASKS])
+    {
+        return NULL;
+    }
+
+    TaskStorage_t *p_taskStorage = &s_taskPool[(current - first) / sizeof(TaskStorage_t)];
+    if ((uintptr_t)&p_taskStorage->buffer != current)
+    {
+        return NULL;
+    }
+
+    return p_taskStorage->p_handle;
+}
+
+/**
+ * @brief Wake a task from an ISR, OR-ing bits into its notification value.
+ *
+ * The task is made ready directly, without the deferred call through the
+ * timer daemon task that OSAL_EventGroupSetBitsFromISR() costs. Bits sent
+ * before the task waits are kept until SPP_OSAL_TaskNotifyWait() collects
+ * them. Placed in IRAM for interrupts allocated with ESP_INTR_FLAG_IRAM.
+ *
+ * @param[in]  p_task                    Task handle from SPP_OSAL_TaskCreate().
+ * @param[in]  bits                      Bits to set in the notification value.
+ * @param[out] p_higherPriorityTaskWoken Set to 1 if a context switch should
+ *                                       be requested (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_task is NULL,
+ *         SPP_ERROR if the handle is stale, the task has not been created
+ *         yet or notifications are unavailable in this build.
+ */
+retval_t IRAM_ATTR SPP_OSAL_TaskNotifyFromISR(void *p_task, spp_uint32_t bits,
+                                              spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+    if (p_task == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+#if SPP_OSAL_TASK_NOTIFY
+    TaskStorage_t *p_taskStorage = SPP_OSAL_HandleResolve(&s_taskHandles, p_task);
+    if (p_taskStorage == NULL || p_taskStorage->state == K_SLOT_RESERVED)
+    {
+        return SPP_ERROR;
+    }
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xTaskNotifyIndexedFromISR((TaskHandle_t)&p_taskStorage->buffer, TASK_NOTIFY_INDEX, bits,
+                              eSetBits, &xHigherPriorityTaskWoken);
+
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = (xHigherPriorityTaskWoken == pdTRUE) ? 1u : 0u;
+    }
+    return SPP_OK;
+#else
+    (void)bits;
+    return SPP_ERROR;
+#endif
+}
+
+/**
+ * @brief Wait for a notification sent to the calling task.
+ *
+ * Collects and clears every bit set since the previous wait.
+ *
+ * @param[in]  timeout_ms Maximum wait time in milliseconds (0 = no wait).
+ * @param[out] p_bits     Receives the collected bits (may be NULL).
+ * @return SPP_OK if a notification arrived, SPP_ERROR on timeout or if
+ *         notifications are unavailable in this build.
+ */
+retval_t SPP_OSAL_TaskNotifyWait(spp_uint32_t timeout_ms, spp_uint32_t *p_bits)
+{
+    uint32_t value = 0;
+
+    if (p_bits != NULL)
+    {
+        *p_bits = 0;
+    }
+
+#if SPP_OSAL_TASK_NOTIFY
+    if (xTaskNotifyWaitIndexed(TASK_NOTIFY_INDEX, 0, UINT32_MAX, &value,
+                               spp_osal_ms_to_ticks(timeout_ms)) != pdTRUE)
+    {
+        return SPP_ERROR;
+    }
+
+    if (p_bits != NULL)
+    {
+        *p_bits = value;
+    }
+    return SPP_OK;
+#else
+    (void)timeout_ms;
+    (void)value;
+    return SPP_ERROR;
+#endif
+}
+
+/**
+ * @brief Report stack arena and TCB pool usage.
+ *
+ * @param[out] p_stats Receives the current counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_stats is NULL.
+ */
+retval_t SPP_OSAL_TaskArenaGetStats(spp_task_arena_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spp_handle_pool_stats_t handleStats = {0};
+    (void)SPP_OSAL_HandlePoolGetStats(SPP_HANDLE_TYPE_TASK, &handleStats);
+
+    taskENTER_CRITICAL(&s_taskLock);
+    spp_osal_task_pool_init();
+    *p_stats = s_stats;
+    p_stats->tasks_live = handleStats.in_use;
+    p_stats->tasks_peak = handleStats.peak;
+    p_stats->largest_free_bytes = 0;
+    for (uint32_t i = 0; i < s_blockCount; i++)
+    {
+        uint32_t bytes = s_blocks[i].size * sizeof(StackType_t);
+        if (s_blocks[i].used == 0u && bytes > p_stats->largest_free_bytes)
+        {
+            p_stats->largest_free_bytes = bytes;
+        }
+    }
+    taskEXIT_CRITICAL(&s_taskLock);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief List every task created through SPP_OSAL_TaskCreate().
+ *
+ * Each entry carries name, priority, core, arena stack size, stack
+ * high-water mark, accumulated run time and the load since the previous
+ * call. The cost is one vTaskGetInfo() per task, including its stack scan,
+ * which is fine at a once-per-second monitoring rate. Load figures assume a
+ * single caller, typically a monitor task.
+ *
+ * @param[out] p_stats     Array of at least max_entries entries.
+ * @param[in]  max_entries Capacity of p_stats.
+ * @param[out] p_count     Receives the number of entries written.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if FreeRTOS was built without configUSE_TRACE_FACILITY.
+ */
+retval_t SPP_OSAL_TaskGetStats(spp_task_stats_t *p_stats, spp_uint32_t max_entries,
+                               spp_uint32_t *p_count)
+{
+    if (p_stats == NULL || p_count == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    *p_count = 0;
+
+#if (configUSE_TRACE_FACILITY == 1)
+#if (configGENERATE_RUN_TIME_STATS == 1)
+    uint32_t now = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+#else
+    uint32_t now = 0;
+#endif
+    uint32_t elapsed = now - s_prevStatsTime;
+    s_prevStatsTime = now;
+
+    for (uint32_t i = 0; i < K_MAX_TASKS && *p_count < max_entries; i++)
+    {
+        TaskStorage_t *p_taskStorage = &s_taskPool[i];
+        uint8_t state = __atomic_load_n(&p_taskStorage->state, __ATOMIC_ACQUIRE);
+
+        if (state != K_SLOT_CREATED && state != K_SLOT_RUNNING)
+            continue;
+
+        TaskHandle_t taskHandle = (TaskHandle_t)&p_taskStorage->buffer;
+        TaskStatus_t status;
+        vTaskGetInfo(taskHandle, &status, pdTRUE, eInvalid);
+
+        spp_task_stats_t *p_entry = &p_stats[*p_count];
+        strncpy(p_entry->name, status.pcTaskName, SPP_TASK_NAME_LEN - 1);
+        p_entry->name[SPP_TASK_NAME_LEN - 1] = '\0';
+        p_entry->p_handle = p_taskStorage->p_handle;
+        p_entry->priority = (spp_uint32_t)status.uxCurrentPriority;
+#if (configTASKLIST_INCLUDE_COREID == 1)
+        p_entry->core = (status.xCoreID == tskNO_AFFINITY) ? -1 : (int32_t)status.xCoreID;
+#else
+        p_entry->core = -1;
+#endif
+        p_entry->stack_size_bytes = p_taskStorage->stackDepth * sizeof(StackType_t);
+        p_entry->stack_min_free_bytes =
+            (spp_uint32_t)status.usStackHighWaterMark * sizeof(StackType_t);
+
+        /* Widen the (possibly 32-bit) FreeRTOS counter into a 64-bit total */
+        uint32_t delta = (uint32_t)status.ulRunTimeCounter - p_taskStorage->prevRunTime;
+        p_taskStorage->prevRunTime = (uint32_t)status.ulRunTimeCounter;
+        p_taskStorage->runTimeTotal += delta;
+        p_entry->runtime = p_taskStorage->runTimeTotal;
+        p_entry->load_permille =
+            (elapsed == 0u) ? 0u : (spp_uint32_t)(((uint64_t)delta * 1000u) / elapsed);
+
+        *p_count += 1;
+    }
+
+    return SPP_OK;
+#else
+    (void)max_entries;
+    return SPP_ERROR;
+#endif
 }
@@ -0,0 +1,85 @@
+/**
+ * @file task_ext.h
+ * @brief OSAL task extensions beyond the core SPP task interface.
+ *
+ * Memory accounting for the task stack arena, a per-task snapshot of
+ * stack usage and CPU load for tasks created through the OSAL, and direct
+ * task notifications that wake a task from an ISR without going through
+ * the timer daemon the way event groups do.
+ */
+
+#ifndef TASK_EXT_H
+#define TASK_EXT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "macros_freertos.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Capacity of spp_task_stats_t::name, including the terminator. */
+#define SPP_TASK_NAME_LEN 16
+
+/** @brief Non-zero if the SPP_OSAL_TaskNotify* calls are available in this build. */
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES > TASK_NOTIFY_INDEX
+#define SPP_OSAL_TASK_NOTIFY 1
+#else
+#define SPP_OSAL_TASK_NOTIFY 0
+#endif
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Snapshot of the task stack arena and TCB pool usage.
+ */
+typedef struct
+{
+    spp_uint32_t arena_bytes;        /**< Total arena size. */
+    spp_uint32_t used_bytes;         /**< Bytes currently assigned to stacks. */
+    spp_uint32_t peak_used_bytes;    /**< Highest used_bytes since boot. */
+    spp_uint32_t largest_free_bytes; /**< Largest stack that can be created now. */
+    spp_uint32_t tasks_max;          /**< Number of TCB slots. */
+    spp_uint32_t tasks_live;         /**< Slots handed out and not yet reclaimed. */
+    spp_uint32_t tasks_peak;         /**< Highest tasks_live since boot. */
+    spp_uint32_t alloc_failures;     /**< Creations rejected for lack of memory. */
+} spp_task_arena_stats_t;
+
+/**
+ * @brief Per-task snapshot returned by SPP_OSAL_TaskGetStats().
+ */
+typedef struct
+{
+    char name[SPP_TASK_NAME_LEN];      /**< Task name (truncated). */
+    void *p_handle;                    /**< Handle returned by SPP_OSAL_TaskCreate(). */
+    spp_uint32_t priority;             /**< Current priority. */
+    int32_t core;                      /**< Core affinity, -1 if not pinned/unknown. */
+    spp_uint32_t stack_size_bytes;     /**< Stack assigned from the arena. */
+    spp_uint32_t stack_min_free_bytes; /**< High-water mark: least free stack seen. */
+    uint64_t runtime;                  /**< Accumulated run time in run-time counter units. */
+    spp_uint32_t load_permille;        /**< Load on one core since the previous snapshot, in 0.1 %. */
+} spp_task_stats_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_OSAL_TaskArenaGetStats(spp_task_arena_stats_t *p_stats);
+retval_t SPP_OSAL_TaskGetStats(spp_task_stats_t *p_stats, spp_uint32_t max_entries,
+                               spp_uint32_t *p_count);
+
+void *SPP_OSAL_TaskGetCurrent(void);
+retval_t SPP_OSAL_TaskNotifyFromISR(void *p_task, spp_uint32_t bits,
+                                    spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_TaskNotifyWait(spp_uint32_t timeout_ms, spp_uint32_t *p_bits);
+
+#endif /* TASK_EXT_H */
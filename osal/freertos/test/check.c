@@ -0,0 +1,728 @@
+/**
+ * @file check.c
+ * @brief OSAL behaviour checks.
+ *
+ * Pass/fail checks of the contracts the OSAL extensions promise, through
+ * the public and extension API, so the same file runs on the FreeRTOS port
+ * on target and on the POSIX port on a host. Only the SPSC index wrap
+ * reaches into a control block, to start the indices near 2^32:
+ *
+ * - spsc: full and empty return codes from task and ISR context, FIFO
+ *   order while the indices wrap around the storage and around 2^32;
+ * - loan: double commit, double release and release of a pointer that is
+ *   not an outstanding loan are rejected; a failed create gives its
+ *   queues back;
+ * - handles: a queue, event group or task handle is rejected with
+ *   SPP_ERROR once deleted, also after its slot was reused, and a slot's
+ *   generation wraps after 2^16 reuses without corrupting the handle;
+ * - queue_isr: the FromISR send, send-to-front, overwrite, receive and
+ *   peek return codes on full, empty, wrong-length and stale queues, item
+ *   order, and a task blocked on the queue woken by an ISR-side send;
+ * - queue_set: select returns each ready queue and event group member,
+ *   times out on an empty set, keeps ISR-set bits when the deferred call
+ *   queue fills, and a deleted set refuses undrained members and releases
+ *   the rest for another set.
+ *
+ * Each group prints one line, "PASS <group>" or "FAIL <group>", preceded
+ * by one line per failed check with its source line. On target call
+ * SPP_OSAL_CheckRun() from a task; on a host the file builds as the
+ * osal_check executable, which exits non-zero on any failure and is
+ * registered with CTest.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "spp/osal/eventgroups.h"
+#include "spp/osal/queue.h"
+#include "spp/osal/task.h"
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "eventgroups_ext.h"
+#include "handlepool.h"
+#include "queue_ext.h"
+#include "spsc.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Capacity of the checked SPSC ring (power of two). */
+#define K_SPSC_CAPACITY 4u
+
+/** @brief Short timeout of calls expected to fail, in milliseconds. */
+#define K_SHORT_TIMEOUT_MS 10u
+
+/** @brief Slots of the checked loan queue. */
+#define K_LOAN_SLOTS 4u
+
+/** @brief Payload bytes of one loan slot. */
+#define K_LOAN_ITEM_BYTES 16u
+
+/** @brief Create and delete cycles that take one slot through every generation. */
+#define K_GENERATIONS 0x10000u
+
+/**
+ * @brief Polls, each a 1 ms (at least one tick) delay, for a deleted task
+ *        to give its slot back.
+ */
+#define K_POLL_ATTEMPTS 1000u
+
+/** @brief How long the checked task parks, in milliseconds. */
+#define K_PARK_MS 10000u
+
+/** @brief Timeout of calls expected to succeed, in milliseconds. */
+#define K_TIMEOUT_MS 1000u
+
+#define K_TASK_STACK 4096u
+#define K_TASK_PRIORITY 5u
+
+/** @brief Length of each queue in the checked queue set. */
+#define K_SET_QUEUE_LENGTH 2u
+
+/** @brief Events the checked queue set holds: two queues and one event group. */
+#define K_SET_CAPACITY (2u * K_SET_QUEUE_LENGTH + 1u)
+
+/** @brief Upper bound of the ISR bit-set calls that try to fill the deferred call queue. */
+#define K_FLOOD_CALLS 64u
+
+/** @brief Event bits usable on every port. */
+#define K_EVENT_BITS 24u
+
+/* ============================================================================
+ * Private Macros
+ * ========================================================================= */
+
+/**
+ * @brief Record a failed check with its expression and source line.
+ */
+#define CHECK(cond)                                                                                \
+    do                                                                                             \
+    {                                                                                              \
+        if (!(cond))                                                                               \
+        {                                                                                          \
+            printf("  line %d: %s\n", __LINE__, #cond);                                            \
+            s_groupFailures++;                                                                     \
+        }                                                                                          \
+    } while (0)
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static uint32_t s_groupFailures = 0;
+static uint32_t s_failedGroups = 0;
+
+static spp_spsc_t s_ring;
+static uint32_t s_ringStorage[K_SPSC_CAPACITY];
+
+static spp_loan_queue_t s_loanQueue;
+static spp_loan_queue_t s_loanQueueSpare;
+static uint8_t s_loanSlots[K_LOAN_SLOTS * K_LOAN_ITEM_BYTES];
+
+static spp_queue_set_t s_set;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Print the verdict of one group and reset its failure count.
+ *
+ * @param[in] p_group Group name.
+ */
+static void check_report(const char *p_group)
+{
+    if (s_groupFailures != 0u)
+    {
+        printf("FAIL %s\n", p_group);
+        s_failedGroups++;
+    }
+    else
+    {
+        printf("PASS %s\n", p_group);
+    }
+    s_groupFailures = 0;
+}
+
+/**
+ * @brief SPSC ring: argument checks, full and empty, wrap-around.
+ */
+static void check_spsc(void)
+{
+    uint8_t *p_storage = (uint8_t *)s_ringStorage;
+    spp_uint8_t woken = 0;
+    uint32_t item = 0;
+    uint32_t next = 0;
+    uint32_t expected = 0;
+
+    CHECK(SPP_OSAL_SpscInit(NULL, p_storage, K_SPSC_CAPACITY, sizeof(uint32_t)) ==
+          SPP_ERROR_NULL_POINTER);
+    CHECK(SPP_OSAL_SpscInit(&s_ring, p_storage, 3u, sizeof(uint32_t)) == SPP_ERROR);
+    CHECK(SPP_OSAL_SpscInit(&s_ring, p_storage, K_SPSC_CAPACITY, 0u) == SPP_ERROR);
+    CHECK(SPP_OSAL_SpscInit(&s_ring, p_storage, K_SPSC_CAPACITY, sizeof(uint32_t)) == SPP_OK);
+
+    /* Empty */
+    CHECK(SPP_OSAL_SpscCount(&s_ring) == 0u);
+    CHECK(SPP_OSAL_SpscPop(&s_ring, &item, 0) == SPP_NOT_ENOUGH_PACKETS);
+    CHECK(SPP_OSAL_SpscPop(&s_ring, &item, K_SHORT_TIMEOUT_MS) == SPP_NOT_ENOUGH_PACKETS);
+    CHECK(SPP_OSAL_SpscPopFromISR(&s_ring, &item, &woken) == SPP_NOT_ENOUGH_PACKETS);
+
+    /* Full, from task and ISR context */
+    for (uint32_t i = 0; i < K_SPSC_CAPACITY; i++)
+    {
+        CHECK(SPP_OSAL_SpscPush(&s_ring, &next, 0) == SPP_OK);
+        next++;
+    }
+    CHECK(SPP_OSAL_SpscCount(&s_ring) == K_SPSC_CAPACITY);
+    CHECK(SPP_OSAL_SpscPush(&s_ring, &next, 0) == SPP_ERROR);
+    CHECK(SPP_OSAL_SpscPush(&s_ring, &next, K_SHORT_TIMEOUT_MS) == SPP_ERROR);
+    CHECK(SPP_OSAL_SpscPushFromISR(&s_ring, &next, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_SpscCount(&s_ring) == K_SPSC_CAPACITY);
+
+    /* Keep the ring between one and capacity - 1 items so every slot is reused */
+    for (uint32_t i = 0; i < 5u * K_SPSC_CAPACITY; i++)
+    {
+        CHECK(SPP_OSAL_SpscPopFromISR(&s_ring, &item, &woken) == SPP_OK);
+        CHECK(item == expected);
+        expected++;
+        CHECK(SPP_OSAL_SpscPushFromISR(&s_ring, &next, &woken) == SPP_OK);
+        next++;
+    }
+    while (SPP_OSAL_SpscPop(&s_ring, &item, 0) == SPP_OK)
+    {
+        CHECK(item == expected);
+        expected++;
+    }
+    CHECK(expected == next);
+    CHECK(SPP_OSAL_SpscCount(&s_ring) == 0u);
+
+    /* Free-running indices: start just below 2^32 and cross it */
+    CHECK(SPP_OSAL_SpscInit(&s_ring, p_storage, K_SPSC_CAPACITY, sizeof(uint32_t)) == SPP_OK);
+    s_ring.head = UINT32_MAX - 1u;
+    s_ring.tail = UINT32_MAX - 1u;
+    next = 0;
+    expected = 0;
+    for (uint32_t i = 0; i < K_SPSC_CAPACITY; i++)
+    {
+        CHECK(SPP_OSAL_SpscPush(&s_ring, &next, 0) == SPP_OK);
+        next++;
+    }
+    CHECK(SPP_OSAL_SpscCount(&s_ring) == K_SPSC_CAPACITY);
+    CHECK(SPP_OSAL_SpscPush(&s_ring, &next, 0) == SPP_ERROR);
+    for (uint32_t i = 0; i < K_SPSC_CAPACITY; i++)
+    {
+        CHECK(SPP_OSAL_SpscPop(&s_ring, &item, 0) == SPP_OK);
+        CHECK(item == expected);
+        expected++;
+    }
+    CHECK(SPP_OSAL_SpscCount(&s_ring) == 0u);
+    CHECK(SPP_OSAL_SpscPop(&s_ring, &item, 0) == SPP_NOT_ENOUGH_PACKETS);
+
+    check_report("spsc");
+}
+
+/**
+ * @brief Loan queue: slot state checks and the create error path.
+ */
+static void check_loan(void)
+{
+    void *p_slot = NULL;
+    void *p_borrowed = NULL;
+    void *p_reserved[K_LOAN_SLOTS];
+    uint8_t notASlot = 0;
+
+    CHECK(SPP_OSAL_LoanQueueCreateStatic(0u, K_LOAN_ITEM_BYTES, s_loanSlots, &s_loanQueue) ==
+          NULL);
+    CHECK(SPP_OSAL_LoanQueueCreateStatic(LOAN_QUEUE_MAX_SLOTS + 1u, K_LOAN_ITEM_BYTES,
+                                         s_loanSlots, &s_loanQueue) == NULL);
+
+    void *p_lq =
+        SPP_OSAL_LoanQueueCreateStatic(K_LOAN_SLOTS, K_LOAN_ITEM_BYTES, s_loanSlots, &s_loanQueue);
+    CHECK(p_lq != NULL);
+    if (p_lq == NULL)
+    {
+        check_report("loan");
+        return;
+    }
+
+    /* Commit once, then every second commit or early release fails */
+    CHECK(SPP_OSAL_LoanQueueReserve(p_lq, &p_slot, 0) == SPP_OK);
+    memset(p_slot, 0xA5, K_LOAN_ITEM_BYTES);
+    CHECK(SPP_OSAL_LoanQueueCommit(p_lq, p_slot) == SPP_OK);
+    CHECK(SPP_OSAL_LoanQueueCommit(p_lq, p_slot) == SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueRelease(p_lq, p_slot) == SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueMessagesWaiting(p_lq) == 1u);
+
+    /* Pointers that are not outstanding loans */
+    CHECK(SPP_OSAL_LoanQueueRelease(p_lq, &notASlot) == SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueRelease(p_lq, &s_loanSlots[1]) == SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueRelease(p_lq, &s_loanSlots[K_LOAN_SLOTS * K_LOAN_ITEM_BYTES]) ==
+          SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueCommit(p_lq, &notASlot) == SPP_ERROR);
+
+    /* Borrow, release once */
+    CHECK(SPP_OSAL_LoanQueueBorrow(p_lq, &p_borrowed, 0) == SPP_OK);
+    CHECK(p_borrowed == p_slot);
+    CHECK(p_borrowed != NULL && ((uint8_t *)p_borrowed)[K_LOAN_ITEM_BYTES - 1u] == 0xA5u);
+    CHECK(SPP_OSAL_LoanQueueCommit(p_lq, p_borrowed) == SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueRelease(p_lq, p_borrowed) == SPP_OK);
+    CHECK(SPP_OSAL_LoanQueueRelease(p_lq, p_borrowed) == SPP_ERROR);
+    CHECK(SPP_OSAL_LoanQueueBorrow(p_lq, &p_borrowed, 0) == SPP_NOT_ENOUGH_PACKETS);
+
+    /* Exhaust the slots, then abandon every reservation */
+    for (uint32_t i = 0; i < K_LOAN_SLOTS; i++)
+    {
+        p_reserved[i] = NULL;
+        CHECK(SPP_OSAL_LoanQueueReserve(p_lq, &p_reserved[i], 0) == SPP_OK);
+    }
+    CHECK(SPP_OSAL_LoanQueueReserve(p_lq, &p_slot, 0) == SPP_ERROR);
+    for (uint32_t i = 0; i < K_LOAN_SLOTS; i++)
+    {
+        CHECK(SPP_OSAL_LoanQueueRelease(p_lq, p_reserved[i]) == SPP_OK);
+    }
+    CHECK(SPP_OSAL_LoanQueueMessagesWaiting(p_lq) == 0u);
+
+#if !defined(ESP_PLATFORM)
+    /* The host builds the index queues from the queue pool: leave room for
+     * one, so the second fails and the first must be given back. */
+    spp_handle_pool_stats_t stats;
+    void *p_fill[NUM_QUEUES];
+    uint32_t filled = 0;
+
+    CHECK(SPP_OSAL_HandlePoolGetStats(SPP_HANDLE_TYPE_QUEUE, &stats) == SPP_OK);
+    while (stats.in_use + 1u < stats.capacity && filled < NUM_QUEUES)
+    {
+        p_fill[filled] = SPP_OSAL_QueueCreate(1u, 1u);
+        if (p_fill[filled] == NULL)
+            break;
+        filled++;
+        (void)SPP_OSAL_HandlePoolGetStats(SPP_HANDLE_TYPE_QUEUE, &stats);
+    }
+    CHECK(stats.in_use + 1u == stats.capacity);
+    CHECK(SPP_OSAL_LoanQueueCreateStatic(K_LOAN_SLOTS, K_LOAN_ITEM_BYTES, s_loanSlots,
+                                         &s_loanQueueSpare) == NULL);
+    (void)SPP_OSAL_HandlePoolGetStats(SPP_HANDLE_TYPE_QUEUE, &stats);
+    CHECK(stats.in_use + 1u == stats.capacity);
+    while (filled > 0u)
+    {
+        filled--;
+        CHECK(SPP_OSAL_QueueDelete(p_fill[filled]) == SPP_OK);
+    }
+#else
+    (void)s_loanQueueSpare;
+#endif
+
+    check_report("loan");
+}
+
+/**
+ * @brief Task body of the handle checks: park until deleted.
+ *
+ * @param[in] p_arg Unused.
+ */
+static void check_park_task(void *p_arg)
+{
+    (void)p_arg;
+    SPP_OSAL_TaskDelay(K_PARK_MS);
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/**
+ * @brief Create a helper task.
+ *
+ * @param[in] p_function Task body.
+ * @param[in] p_arg      Argument passed to it.
+ * @return Task handle, or NULL if no storage or task could be had.
+ */
+static void *check_spawn(void *p_function, void *p_arg)
+{
+    void *p_storage = SPP_OSAL_GetTaskStorage();
+
+    for (uint32_t i = 0; p_storage == NULL && i < K_POLL_ATTEMPTS; i++)
+    {
+        SPP_OSAL_TaskDelay(1u);
+        p_storage = SPP_OSAL_GetTaskStorage();
+    }
+    if (p_storage == NULL)
+        return NULL;
+
+    return SPP_OSAL_TaskCreate(p_function, "check", K_TASK_STACK, p_arg, K_TASK_PRIORITY,
+                               p_storage);
+}
+
+/**
+ * @brief Delete a task and wait until its handle is rejected.
+ *
+ * A deleted task gives its slot back once the port has finished it, so
+ * the handle turns stale shortly after SPP_OSAL_TaskDelete() returns.
+ *
+ * @param[in] p_task Task handle.
+ * @return 1 if the handle became stale, 0 otherwise.
+ */
+static int check_task_retire(void *p_task)
+{
+    if (SPP_OSAL_TaskDelete(&p_task) != SPP_OK)
+        return 0;
+
+    for (uint32_t i = 0; i < K_POLL_ATTEMPTS; i++)
+    {
+        SPP_OSAL_TaskDelay(1u);
+        if (SPP_OSAL_TaskDelete(&p_task) == SPP_ERROR)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Handles: stale after delete, stale after reuse, generation wrap.
+ */
+static void check_handles(void)
+{
+    uint32_t item = 1;
+    osal_eventbits_t bits = 0;
+
+    /* Queue: delete, reuse the slot, the old handle stays dead */
+    void *p_old = SPP_OSAL_QueueCreate(1u, sizeof(uint32_t));
+    CHECK(p_old != NULL);
+    CHECK(SPP_OSAL_QueueDelete(p_old) == SPP_OK);
+    CHECK(SPP_OSAL_QueueDelete(p_old) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueSend(p_old, &item, 0) == SPP_ERROR);
+
+    void *p_new = SPP_OSAL_QueueCreate(1u, sizeof(uint32_t));
+    CHECK(p_new != NULL && p_new != p_old);
+    CHECK(SPP_OSAL_QueueSend(p_new, &item, 0) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSend(p_old, &item, 0) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueReceive(p_old, &item, 0) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueMessagesWaiting(p_old) == 0u);
+    CHECK(SPP_OSAL_QueueMessagesWaiting(p_new) == 1u);
+    CHECK(SPP_OSAL_QueueDelete(p_old) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueDelete(p_new) == SPP_OK);
+
+    /* Generation wrap: the free list hands the same slot back every cycle,
+     * so after 2^16 cycles the handle repeats and was valid all along */
+    void *p_first = SPP_OSAL_QueueCreate(1u, sizeof(uint32_t));
+    void *p_prev = p_first;
+    uint32_t failures = 0;
+
+    CHECK(p_first != NULL && SPP_OSAL_QueueDelete(p_first) == SPP_OK);
+    for (uint32_t i = 1; i < K_GENERATIONS && p_first != NULL; i++)
+    {
+        void *p_queue = SPP_OSAL_QueueCreate(1u, sizeof(uint32_t));
+        if (p_queue == NULL || p_queue == p_prev ||
+            SPP_OSAL_QueueSend(p_queue, &item, 0) != SPP_OK ||
+            SPP_OSAL_QueueSend(p_prev, &item, 0) != SPP_ERROR ||
+            SPP_OSAL_QueueDelete(p_queue) != SPP_OK)
+        {
+            failures++;
+        }
+        p_prev = p_queue;
+    }
+    CHECK(failures == 0u);
+    void *p_wrapped = SPP_OSAL_QueueCreate(1u, sizeof(uint32_t));
+    CHECK(p_wrapped == p_first);
+    CHECK(p_wrapped != NULL && SPP_OSAL_QueueSend(p_wrapped, &item, 0) == SPP_OK);
+    CHECK(p_wrapped != NULL && SPP_OSAL_QueueDelete(p_wrapped) == SPP_OK);
+
+    /* Event group */
+    p_old = SPP_OSAL_EventGroupCreate(SPP_OSAL_GetEventGroupsBuffer());
+    CHECK(p_old != NULL);
+    CHECK(SPP_OSAL_EventGroupDelete(p_old) == SPP_OK);
+    CHECK(SPP_OSAL_EventGroupDelete(p_old) == SPP_ERROR);
+    p_new = SPP_OSAL_EventGroupCreate(SPP_OSAL_GetEventGroupsBuffer());
+    CHECK(p_new != NULL && p_new != p_old);
+    CHECK(OSAL_EventGroupSetBitsFromISR(p_old, 1u, NULL, NULL) == SPP_ERROR);
+    CHECK(OSAL_EventGroupWaitBits(p_old, 1u, 1u, 0u, 0u, &bits) == SPP_ERROR);
+    CHECK(SPP_OSAL_EventGroupDelete(p_old) == SPP_ERROR);
+    CHECK(SPP_OSAL_EventGroupDelete(p_new) == SPP_OK);
+
+    /* Task */
+    p_old = check_spawn((void *)check_park_task, NULL);
+    CHECK(p_old != NULL);
+    CHECK(p_old != NULL && check_task_retire(p_old) == 1);
+    p_new = check_spawn((void *)check_park_task, NULL);
+    CHECK(p_new != NULL && p_new != p_old);
+    CHECK(SPP_OSAL_TaskDelete(&p_old) == SPP_ERROR);
+    CHECK(p_new != NULL && check_task_retire(p_new) == 1);
+
+    check_report("handles");
+}
+
+/**
+ * @brief Task body of the ISR queue check: receive one item, echo it + 1.
+ *
+ * @param[in] p_arg Array of two queue handles, request then reply.
+ */
+static void check_echo_task(void *p_arg)
+{
+    void **pp_queues = (void **)p_arg;
+    uint32_t item = 0;
+
+    if (SPP_OSAL_QueueReceive(pp_queues[0], &item, K_TIMEOUT_MS) == SPP_OK)
+    {
+        item++;
+        (void)SPP_OSAL_QueueSend(pp_queues[1], &item, K_TIMEOUT_MS);
+    }
+    SPP_OSAL_TaskDelay(K_PARK_MS);
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/**
+ * @brief ISR queue operations: return codes, order and wake-up.
+ */
+static void check_queue_isr(void)
+{
+    spp_uint8_t woken = 0;
+    uint32_t item = 0;
+    uint32_t value = 0;
+
+    void *p_queue = SPP_OSAL_QueueCreate(2u, sizeof(uint32_t));
+    void *p_single = SPP_OSAL_QueueCreate(1u, sizeof(uint32_t));
+    CHECK(p_queue != NULL && p_single != NULL);
+    if (p_queue == NULL || p_single == NULL)
+    {
+        check_report("queue_isr");
+        return;
+    }
+
+    CHECK(SPP_OSAL_QueueSendFromISR(NULL, &item, &woken) == SPP_ERROR_NULL_POINTER);
+    CHECK(SPP_OSAL_QueueReceiveFromISR(NULL, &item, &woken) == SPP_ERROR_NULL_POINTER);
+
+    /* Empty */
+    CHECK(SPP_OSAL_QueueReceiveFromISR(p_queue, &item, &woken) == SPP_NOT_ENOUGH_PACKETS);
+    CHECK(SPP_OSAL_QueuePeekFromISR(p_queue, &item) == SPP_NOT_ENOUGH_PACKETS);
+
+    /* Back and front, then full */
+    value = 1;
+    CHECK(SPP_OSAL_QueueSendFromISR(p_queue, &value, &woken) == SPP_OK);
+    value = 0;
+    CHECK(SPP_OSAL_QueueSendToFrontFromISR(p_queue, &value, &woken) == SPP_OK);
+    value = 2;
+    CHECK(SPP_OSAL_QueueSendFromISR(p_queue, &value, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueSendToFrontFromISR(p_queue, &value, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueMessagesWaiting(p_queue) == 2u);
+
+    /* Peek leaves the item, receive takes them in order */
+    CHECK(SPP_OSAL_QueuePeekFromISR(p_queue, &item) == SPP_OK && item == 0u);
+    CHECK(SPP_OSAL_QueueMessagesWaiting(p_queue) == 2u);
+    CHECK(SPP_OSAL_QueueReceiveFromISR(p_queue, &item, &woken) == SPP_OK && item == 0u);
+    CHECK(SPP_OSAL_QueueReceiveFromISR(p_queue, &item, &woken) == SPP_OK && item == 1u);
+    CHECK(SPP_OSAL_QueueReceiveFromISR(p_queue, &item, &woken) == SPP_NOT_ENOUGH_PACKETS);
+
+    /* Overwrite needs a one-item queue and replaces its item */
+    CHECK(SPP_OSAL_QueueOverwriteFromISR(p_queue, &value, &woken) == SPP_ERROR);
+    value = 5;
+    CHECK(SPP_OSAL_QueueOverwriteFromISR(p_single, &value, &woken) == SPP_OK);
+    value = 6;
+    CHECK(SPP_OSAL_QueueOverwriteFromISR(p_single, &value, &woken) == SPP_OK);
+    CHECK(SPP_OSAL_QueueMessagesWaiting(p_single) == 1u);
+    CHECK(SPP_OSAL_QueueReceiveFromISR(p_single, &item, &woken) == SPP_OK && item == 6u);
+
+    /* A task blocked in receive is woken by the ISR-side send */
+    void *p_queues[2] = {p_queue, p_single};
+    void *p_task = check_spawn((void *)check_echo_task, p_queues);
+    CHECK(p_task != NULL);
+    if (p_task != NULL)
+    {
+        SPP_OSAL_TaskDelay(K_SHORT_TIMEOUT_MS);
+        value = 41;
+        CHECK(SPP_OSAL_QueueSendFromISR(p_queue, &value, &woken) == SPP_OK);
+        CHECK(SPP_OSAL_QueueReceive(p_single, &item, K_TIMEOUT_MS) == SPP_OK && item == 42u);
+        CHECK(check_task_retire(p_task) == 1);
+    }
+
+    /* Stale */
+    CHECK(SPP_OSAL_QueueDelete(p_queue) == SPP_OK);
+    CHECK(SPP_OSAL_QueueDelete(p_single) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSendFromISR(p_queue, &value, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueSendToFrontFromISR(p_queue, &value, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueOverwriteFromISR(p_single, &value, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueReceiveFromISR(p_queue, &item, &woken) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueuePeekFromISR(p_queue, &item) == SPP_ERROR);
+
+    check_report("queue_isr");
+}
+
+/**
+ * @brief Select every ready member of a set once and drain what it holds.
+ *
+ * @param[in]  pp_members Members, queues first, then one event group.
+ * @param[in]  count      Number of members.
+ * @param[out] p_seen     Per member, number of times it was selected.
+ * @return Number of selects that returned a handle outside pp_members.
+ */
+static uint32_t check_set_drain(void *const *pp_members, uint32_t count, uint32_t *p_seen)
+{
+    void *p_member = NULL;
+    uint32_t unknown = 0;
+    uint32_t item = 0;
+
+    while (SPP_OSAL_QueueSetSelect(&s_set, K_SHORT_TIMEOUT_MS, &p_member) == SPP_OK)
+    {
+        uint32_t i = 0;
+        while (i < count && pp_members[i] != p_member)
+        {
+            i++;
+        }
+        if (i == count)
+        {
+            unknown++;
+            continue;
+        }
+        p_seen[i]++;
+        if (i + 1u < count)
+        {
+            (void)SPP_OSAL_QueueReceive(p_member, &item, 0);
+        }
+    }
+    return unknown;
+}
+
+/**
+ * @brief Queue set: select across members, set-bits under a full deferred
+ *        call queue, teardown and reuse of the members.
+ *
+ * Each flood pass sets bits from ISR context until a call fails or
+ * K_FLOOD_CALLS is reached. On target each call takes two slots of the
+ * timer daemon queue, one for the bits and one for the proxy give, so
+ * with the check task above the daemon on its core one of the two passes,
+ * with or without a one-slot filler, leaves room for the bits only. Every
+ * call that returned SPP_OK must still have its bits applied and the
+ * group selected. On a host the calls never fail.
+ */
+static void check_queue_set(void)
+{
+    osal_eventbits_t bits = 0;
+    void *p_member = NULL;
+    uint32_t item = 7;
+
+    void *p_queueA = SPP_OSAL_QueueCreate(K_SET_QUEUE_LENGTH, sizeof(uint32_t));
+    void *p_queueB = SPP_OSAL_QueueCreate(K_SET_QUEUE_LENGTH, sizeof(uint32_t));
+    void *p_group = SPP_OSAL_EventGroupCreate(SPP_OSAL_GetEventGroupsBuffer());
+    void *p_filler = SPP_OSAL_EventGroupCreate(SPP_OSAL_GetEventGroupsBuffer());
+    retval_t ret = SPP_ERROR;
+    if (p_queueA != NULL && p_queueB != NULL && p_group != NULL && p_filler != NULL)
+    {
+        ret = SPP_OSAL_QueueSetInit(&s_set, K_SET_CAPACITY);
+    }
+    CHECK(ret == SPP_OK);
+    if (ret != SPP_OK)
+    {
+        check_report("queue_set");
+        return;
+    }
+    void *p_members[3] = {p_queueA, p_queueB, p_group};
+
+    /* Membership rules */
+    CHECK(SPP_OSAL_QueueSetAddQueue(NULL, p_queueA) == SPP_ERROR_NULL_POINTER);
+    CHECK(SPP_OSAL_QueueSetAddEventGroup(&s_set, NULL) == SPP_ERROR_NULL_POINTER);
+    CHECK(SPP_OSAL_QueueSend(p_queueA, &item, 0) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddQueue(&s_set, p_queueA) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueReceive(p_queueA, &item, 0) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddQueue(&s_set, p_queueA) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddQueue(&s_set, p_queueA) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueSetAddQueue(&s_set, p_queueB) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddEventGroup(&s_set, p_group) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddEventGroup(&s_set, p_group) == SPP_ERROR);
+
+    /* Nothing ready */
+    CHECK(SPP_OSAL_QueueSetSelect(&s_set, 0u, &p_member) == SPP_NOT_ENOUGH_PACKETS);
+    CHECK(p_member == NULL);
+    CHECK(SPP_OSAL_QueueSetSelect(&s_set, K_SHORT_TIMEOUT_MS, &p_member) ==
+          SPP_NOT_ENOUGH_PACKETS);
+
+    /* One event on each member: each is selected exactly once */
+    uint32_t seen[3] = {0, 0, 0};
+    CHECK(SPP_OSAL_QueueSend(p_queueB, &item, 0) == SPP_OK);
+    CHECK(OSAL_EventGroupSetBitsFromISR(p_group, 1u, NULL, NULL) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSendFromISR(p_queueA, &item, NULL) == SPP_OK);
+    CHECK(check_set_drain(p_members, 3u, seen) == 0u);
+    CHECK(seen[0] == 1u && seen[1] == 1u && seen[2] == 1u);
+    CHECK(OSAL_EventGroupWaitBits(p_group, 1u, 1u, 0u, K_TIMEOUT_MS, &bits) == SPP_OK);
+
+    /* Bits set while the deferred call queue fills are kept, and the group
+     * is still selected when only the bits found room */
+    for (uint32_t pass = 0; pass < 2u; pass++)
+    {
+        osal_eventbits_t expected = 0;
+        if (pass == 1u)
+        {
+            CHECK(OSAL_EventGroupSetBitsFromISR(p_filler, 1u, NULL, NULL) == SPP_OK);
+        }
+        for (uint32_t i = 0; i < K_FLOOD_CALLS; i++)
+        {
+            osal_eventbits_t bit = (osal_eventbits_t)1u << (i % K_EVENT_BITS);
+            if (OSAL_EventGroupSetBitsFromISR(p_group, bit, NULL, NULL) != SPP_OK)
+            {
+                break;
+            }
+            expected |= bit;
+        }
+        CHECK(expected != 0u);
+        CHECK(OSAL_EventGroupWaitBits(p_group, expected, 1u, 1u, K_TIMEOUT_MS, &bits) == SPP_OK);
+        seen[2] = 0;
+        CHECK(check_set_drain(p_members, 3u, seen) == 0u);
+        CHECK(seen[2] >= 1u);
+    }
+
+    /* Teardown refuses a member with items, then frees the members for
+     * another set */
+    CHECK(SPP_OSAL_QueueSend(p_queueA, &item, 0) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetDelete(&s_set) == SPP_ERROR);
+    CHECK(SPP_OSAL_QueueReceive(p_queueA, &item, 0) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetDelete(&s_set) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetDelete(NULL) == SPP_ERROR_NULL_POINTER);
+
+    CHECK(SPP_OSAL_QueueSetInit(&s_set, K_SET_CAPACITY) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddQueue(&s_set, p_queueA) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetAddEventGroup(&s_set, p_group) == SPP_OK);
+    CHECK(OSAL_EventGroupSetBitsFromISR(p_group, 2u, NULL, NULL) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetSelect(&s_set, K_TIMEOUT_MS, &p_member) == SPP_OK &&
+          p_member == p_group);
+    CHECK(OSAL_EventGroupWaitBits(p_group, 2u, 1u, 0u, K_TIMEOUT_MS, &bits) == SPP_OK);
+    CHECK(SPP_OSAL_QueueSetDelete(&s_set) == SPP_OK);
+
+    CHECK(SPP_OSAL_QueueDelete(p_queueA) == SPP_OK);
+    CHECK(SPP_OSAL_QueueDelete(p_queueB) == SPP_OK);
+    CHECK(SPP_OSAL_EventGroupDelete(p_group) == SPP_OK);
+    CHECK(SPP_OSAL_EventGroupDelete(p_filler) == SPP_OK);
+
+    check_report("queue_set");
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Run every check group.
+ *
+ * @return SPP_OK if every check passed, SPP_ERROR otherwise.
+ */
+retval_t SPP_OSAL_CheckRun(void)
+{
+    s_failedGroups = 0;
+
+    check_spsc();
+    check_loan();
+    check_handles();
+    check_queue_isr();
+    check_queue_set();
+
+    if (s_failedGroups != 0u)
+    {
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+
+#if !defined(ESP_PLATFORM)
+int main(void)
+{
+    return (SPP_OSAL_CheckRun() == SPP_OK) ? 0 : 1;
+}
+#endif
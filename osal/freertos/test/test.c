@@ -0,0 +1,656 @@
+/**
+ * @file test.c
+ * @brief OSAL microbenchmark suite.
+ *
+ * Measures, through the public OSAL API only, so the same file runs on the
+ * FreeRTOS port on target and on the POSIX port on a host:
+ *
+ * - queue_latency: send to a waiting receiver task until it wakes, per
+ *   item size;
+ * - queue_throughput: items per second streamed to a receiver task, per
+ *   item size;
+ * - eventgroup_isr_wake: OSAL_EventGroupSetBitsFromISR() until the task
+ *   waiting on the bit runs. On target the bit is set from a one-shot
+ *   gptimer alarm interrupt, and the time includes the timer daemon hop
+ *   the ISR API takes; on a host the bench thread stands in for the ISR;
+ * - task_create, task_start, task_delete: cost of SPP_OSAL_TaskCreate(),
+ *   create until the new task's first instruction, and deleting a blocked
+ *   task.
+ *
+ * Times are in CPU cycles. On target they are esp_timer microseconds scaled
+ * by cycles_per_us, so 1 us resolution: the cycle counter is per core and
+ * helper tasks are not pinned, so a stamp taken on one core and compared
+ * on the other would be meaningless. On a host they are CLOCK_MONOTONIC
+ * nanoseconds (a virtual 1 GHz counter, as the host ESP-IDF stand-in).
+ * Results are printed as JSON Lines: a
+ * header object with the port and cycles_per_us, then one object per
+ * measurement with n, errors, p50, p99, max and mean in cycles and a
+ * power-of-two histogram (hist_log2[i] counts samples in [2^i, 2^(i+1)),
+ * samples of 0 in bucket 0). Compare runs on the same hardware and build
+ * before accepting a change to a port.
+ *
+ * On target call SPP_OSAL_BenchRun() from a task (helper tasks run at
+ * K_HELPER_PRIORITY); on a host the file builds as the osal_bench
+ * executable. Every run creates its queues and event group and deletes
+ * them at the end, so the suite can be run repeatedly.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spp/osal/eventgroups.h"
+#include "spp/osal/queue.h"
+#include "spp/osal/task.h"
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "eventgroups_ext.h"
+#include "queue_ext.h"
+
+#if defined(ESP_PLATFORM)
+#include <stdbool.h>
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#else
+#include <time.h>
+#endif
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Samples per latency measurement. */
+#define K_SAMPLES 1000u
+
+/** @brief Items per throughput measurement. */
+#define K_THROUGHPUT_ITEMS 20000u
+
+/**
+ * @brief Tasks created by the task benchmarks, one after the other; the
+ *        slot of each deleted task is reused.
+ */
+#define K_TASK_SAMPLES 200u
+
+/** @brief Queue item sizes measured. */
+#define K_ITEM_SIZES 4u
+#define K_MAX_ITEM_BYTES 256u
+
+#define K_QUEUE_LENGTH 16u
+
+/** @brief Timeout of every blocking call; a timeout counts as an error. */
+#define K_TIMEOUT_MS 1000u
+
+/** @brief How long a parked task waits before giving up on being deleted. */
+#define K_PARK_MS 10000u
+
+#define K_HELPER_STACK 4096u
+#define K_HELPER_PRIORITY 5u
+
+#define K_WAKE_BIT 0x01u
+
+/** @brief Delay from arming the gptimer to its alarm interrupt, in us. */
+#define K_ISR_DELAY_US 50u
+
+/** @brief Histogram buckets, one per bit of a 32-bit cycle count. */
+#define K_HIST_BUCKETS 32u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Receiver side of one item size.
+ */
+typedef struct
+{
+    void *p_queue;
+    uint32_t itemBytes;
+    uint32_t errors;
+} BenchQueue_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static const uint32_t s_itemSizes[K_ITEM_SIZES] = {4u, 16u, 64u, 256u};
+
+static BenchQueue_t s_queues[K_ITEM_SIZES];
+
+/** @brief Receiver-to-bench acknowledgements. */
+static void *s_ack = NULL;
+
+static void *s_eventGroup = NULL;
+
+static uint32_t s_samples[K_SAMPLES];
+static uint32_t s_taskCreate[K_TASK_SAMPLES];
+static uint32_t s_taskDelete[K_TASK_SAMPLES];
+
+/** @brief Cycle count at the event to be timed, written before signalling. */
+static volatile uint32_t s_stamp = 0;
+
+/** @brief Errors seen by helper tasks of the current measurement. */
+static volatile uint32_t s_helperErrors = 0;
+
+#if defined(ESP_PLATFORM)
+/** @brief Interrupt source of eventgroup_isr_wake. */
+static gptimer_handle_t s_timer = NULL;
+
+/** @brief Failed bit sets in the alarm interrupt. */
+static volatile uint32_t s_isrErrors = 0;
+#endif
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static inline uint32_t bench_cycles_per_us(void)
+{
+#if defined(ESP_PLATFORM)
+    return esp_rom_get_cpu_ticks_per_us();
+#else
+    return 1000u;
+#endif
+}
+
+/**
+ * @brief Current time in cycles, comparable across tasks and cores.
+ */
+static inline uint32_t bench_cycles(void)
+{
+#if defined(ESP_PLATFORM)
+    return (uint32_t)((uint64_t)esp_timer_get_time() * bench_cycles_per_us());
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec);
+#endif
+}
+
+static int bench_compare_u32(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Print one latency result line. Sorts the samples.
+ *
+ * @param[in]     p_bench   Benchmark name.
+ * @param[in]     p_param   Name of the swept parameter, or NULL.
+ * @param[in]     param     Its value.
+ * @param[in,out] p_samples Samples in cycles.
+ * @param[in]     n         Number of samples.
+ * @param[in]     errors    Failed or timed-out operations.
+ */
+static void bench_report(const char *p_bench, const char *p_param, uint32_t param,
+                         uint32_t *p_samples, uint32_t n, uint32_t errors)
+{
+    uint32_t hist[K_HIST_BUCKETS] = {0};
+    uint64_t total = 0;
+    uint32_t top = 0;
+
+    printf("{\"suite\":\"osal\",\"bench\":\"%s\"", p_bench);
+    if (p_param != NULL)
+    {
+        printf(",\"%s\":%u", p_param, param);
+    }
+    printf(",\"n\":%u,\"errors\":%u", n, errors);
+    if (n == 0u)
+    {
+        printf("}\n");
+        return;
+    }
+
+    qsort(p_samples, n, sizeof(p_samples[0]), bench_compare_u32);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t bucket = (p_samples[i] == 0u) ? 0u : 31u - (uint32_t)__builtin_clz(p_samples[i]);
+        hist[bucket] += 1;
+        top = (bucket > top) ? bucket : top;
+        total += p_samples[i];
+    }
+
+    printf(",\"unit\":\"cycles\",\"p50\":%u,\"p99\":%u,\"max\":%u,\"mean\":%.1f,\"hist_log2\":[",
+           p_samples[n / 2u], p_samples[(n * 99u) / 100u], p_samples[n - 1u], (double)total / n);
+    for (uint32_t b = 0; b <= top; b++)
+    {
+        printf((b == 0u) ? "%u" : ",%u", hist[b]);
+    }
+    printf("]}\n");
+}
+
+/**
+ * @brief Print one throughput result line.
+ */
+static void bench_report_rate(const char *p_bench, uint32_t itemBytes, uint32_t items,
+                              uint32_t cycles, uint32_t errors)
+{
+    double seconds = (double)cycles / ((double)bench_cycles_per_us() * 1e6);
+    double rate = (seconds > 0.0) ? (double)items / seconds : 0.0;
+
+    printf("{\"suite\":\"osal\",\"bench\":\"%s\",\"item_bytes\":%u,\"n\":%u,\"errors\":%u,"
+           "\"cycles\":%u,\"items_per_s\":%.0f,\"bytes_per_s\":%.0f}\n",
+           p_bench, itemBytes, items, errors, cycles, rate, rate * itemBytes);
+}
+
+/**
+ * @brief Receiver of one item size: timed items with an acknowledgement
+ *        each, then a stream acknowledged once at the end.
+ *
+ * @param[in] p_arg The BenchQueue_t to serve.
+ */
+static void bench_queue_task(void *p_arg)
+{
+    BenchQueue_t *p_bq = (BenchQueue_t *)p_arg;
+    uint8_t item[K_MAX_ITEM_BYTES];
+    uint32_t token = 0;
+
+    for (uint32_t i = 0; i < K_SAMPLES; i++)
+    {
+        if (SPP_OSAL_QueueReceive(p_bq->p_queue, item, K_TIMEOUT_MS) == SPP_OK)
+        {
+            uint32_t now = bench_cycles();
+            uint32_t stamp;
+            memcpy(&stamp, item, sizeof(stamp));
+            s_samples[i] = now - stamp;
+        }
+        else
+        {
+            s_samples[i] = 0;
+            p_bq->errors += 1;
+        }
+        (void)SPP_OSAL_QueueSend(s_ack, &token, K_TIMEOUT_MS);
+    }
+
+    for (uint32_t i = 0; i < K_THROUGHPUT_ITEMS; i++)
+    {
+        if (SPP_OSAL_QueueReceive(p_bq->p_queue, item, K_TIMEOUT_MS) != SPP_OK)
+        {
+            p_bq->errors += 1;
+        }
+    }
+    (void)SPP_OSAL_QueueSend(s_ack, &token, K_TIMEOUT_MS);
+
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/**
+ * @brief Waiter of the event-group benchmark.
+ */
+static void bench_event_task(void *p_arg)
+{
+    (void)p_arg;
+    uint32_t token = 0;
+
+    for (uint32_t i = 0; i < K_SAMPLES; i++)
+    {
+        osal_eventbits_t bits = 0;
+        if (OSAL_EventGroupWaitBits(s_eventGroup, K_WAKE_BIT, 1u, 0u, K_TIMEOUT_MS, &bits) ==
+                SPP_OK &&
+            (bits & K_WAKE_BIT) != 0u)
+        {
+            s_samples[i] = bench_cycles() - s_stamp;
+        }
+        else
+        {
+            s_samples[i] = 0;
+            s_helperErrors += 1;
+        }
+        (void)SPP_OSAL_QueueSend(s_ack, &token, K_TIMEOUT_MS);
+    }
+
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+#if defined(ESP_PLATFORM)
+/**
+ * @brief gptimer alarm interrupt of eventgroup_isr_wake: stamp and set the bit.
+ *
+ * @return true if a higher-priority task was woken.
+ */
+static bool IRAM_ATTR bench_timer_isr(gptimer_handle_t timer,
+                                      const gptimer_alarm_event_data_t *p_event, void *p_ctx)
+{
+    spp_uint8_t woken = 0;
+    (void)timer;
+    (void)p_event;
+    (void)p_ctx;
+
+    s_stamp = bench_cycles();
+    if (OSAL_EventGroupSetBitsFromISR(s_eventGroup, K_WAKE_BIT, NULL, &woken) != SPP_OK)
+    {
+        s_isrErrors += 1;
+    }
+    return woken != 0u;
+}
+#endif
+
+/**
+ * @brief Create the interrupt source of eventgroup_isr_wake.
+ *
+ * @return SPP_OK, or SPP_ERROR if the gptimer cannot be set up.
+ */
+static retval_t bench_isr_open(void)
+{
+#if defined(ESP_PLATFORM)
+    gptimer_config_t timerCfg = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000u,
+    };
+    gptimer_event_callbacks_t callbacks = {.on_alarm = bench_timer_isr};
+
+    s_isrErrors = 0;
+    if (gptimer_new_timer(&timerCfg, &s_timer) != ESP_OK)
+    {
+        s_timer = NULL;
+        return SPP_ERROR;
+    }
+    if (gptimer_register_event_callbacks(s_timer, &callbacks, NULL) != ESP_OK ||
+        gptimer_enable(s_timer) != ESP_OK)
+    {
+        (void)gptimer_del_timer(s_timer);
+        s_timer = NULL;
+        return SPP_ERROR;
+    }
+#endif
+    return SPP_OK;
+}
+
+/**
+ * @brief Raise one wake-up: arm a one-shot alarm on target, set the bit
+ *        directly on a host.
+ *
+ * @return SPP_OK if the wake-up was raised.
+ */
+static retval_t bench_isr_fire(void)
+{
+#if defined(ESP_PLATFORM)
+    gptimer_alarm_config_t alarm = {.alarm_count = K_ISR_DELAY_US};
+
+    /* Stopped after the previous alarm; fails harmlessly the first time */
+    (void)gptimer_stop(s_timer);
+    if (gptimer_set_raw_count(s_timer, 0) != ESP_OK ||
+        gptimer_set_alarm_action(s_timer, &alarm) != ESP_OK || gptimer_start(s_timer) != ESP_OK)
+    {
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+#else
+    spp_uint8_t woken = 0;
+    s_stamp = bench_cycles();
+    return OSAL_EventGroupSetBitsFromISR(s_eventGroup, K_WAKE_BIT, NULL, &woken);
+#endif
+}
+
+/**
+ * @brief Delete the interrupt source and collect the errors seen in it.
+ *
+ * @return Failed bit sets in the interrupt.
+ */
+static uint32_t bench_isr_close(void)
+{
+#if defined(ESP_PLATFORM)
+    (void)gptimer_stop(s_timer);
+    (void)gptimer_disable(s_timer);
+    (void)gptimer_del_timer(s_timer);
+    s_timer = NULL;
+    return s_isrErrors;
+#else
+    return 0u;
+#endif
+}
+
+/**
+ * @brief Task of the task benchmarks: time its start, report, then park
+ *        until deleted.
+ *
+ * @param[in] p_arg Slot of s_samples that receives the start latency.
+ */
+static void bench_start_task(void *p_arg)
+{
+    uint32_t now = bench_cycles();
+    uint32_t *p_slot = (uint32_t *)p_arg;
+    uint32_t token = 0;
+
+    *p_slot = now - s_stamp;
+    (void)SPP_OSAL_QueueSend(s_ack, &token, K_TIMEOUT_MS);
+
+    /* Parked in a plain delay, so no object the bench deletes is in use.
+     * Only returns if the bench failed to delete this task. */
+    SPP_OSAL_TaskDelay(K_PARK_MS);
+    SPP_OSAL_TaskDelete(NULL);
+}
+
+/**
+ * @brief Delete the queues and event group created by bench_setup().
+ */
+static void bench_teardown(void)
+{
+    for (uint32_t s = 0; s < K_ITEM_SIZES; s++)
+    {
+        if (s_queues[s].p_queue != NULL)
+            (void)SPP_OSAL_QueueDelete(s_queues[s].p_queue);
+        s_queues[s].p_queue = NULL;
+    }
+    if (s_eventGroup != NULL)
+        (void)SPP_OSAL_EventGroupDelete(s_eventGroup);
+    if (s_ack != NULL)
+        (void)SPP_OSAL_QueueDelete(s_ack);
+    s_eventGroup = NULL;
+    s_ack = NULL;
+}
+
+/**
+ * @brief Create the queues and event group of one run.
+ *
+ * @return SPP_OK, or SPP_ERROR if an object cannot be created.
+ */
+static retval_t bench_setup(void)
+{
+    for (uint32_t s = 0; s < K_ITEM_SIZES; s++)
+    {
+        s_queues[s].itemBytes = s_itemSizes[s];
+        s_queues[s].p_queue = SPP_OSAL_QueueCreate(K_QUEUE_LENGTH, s_itemSizes[s]);
+        if (s_queues[s].p_queue == NULL)
+        {
+            bench_teardown();
+            return SPP_ERROR;
+        }
+    }
+    s_eventGroup = SPP_OSAL_EventGroupCreate(SPP_OSAL_GetEventGroupsBuffer());
+    s_ack = SPP_OSAL_QueueCreate(K_QUEUE_LENGTH, sizeof(uint32_t));
+    if (s_eventGroup == NULL || s_ack == NULL)
+    {
+        bench_teardown();
+        return SPP_ERROR;
+    }
+    return SPP_OK;
+}
+
+/**
+ * @brief Get a task slot, waiting for deleted tasks to hand theirs back.
+ *
+ * Deletion can finish asynchronously (on the POSIX port, and on FreeRTOS
+ * for a task on the other core), so the previous sample's slot may not be
+ * free yet.
+ *
+ * @return Task storage, or NULL if none became free within K_TIMEOUT_MS.
+ */
+static void *bench_task_storage(void)
+{
+    void *p_storage = SPP_OSAL_GetTaskStorage();
+
+    for (uint32_t waited = 0; p_storage == NULL && waited < K_TIMEOUT_MS; waited++)
+    {
+        SPP_OSAL_TaskDelay(1u);
+        p_storage = SPP_OSAL_GetTaskStorage();
+    }
+    return p_storage;
+}
+
+static void *bench_spawn(void *p_function, const char *p_name, void *p_arg)
+{
+    void *p_storage = bench_task_storage();
+    if (p_storage == NULL)
+        return NULL;
+    return SPP_OSAL_TaskCreate(p_function, p_name, K_HELPER_STACK, p_arg, K_HELPER_PRIORITY,
+                               p_storage);
+}
+
+static void bench_queues(void)
+{
+    uint8_t item[K_MAX_ITEM_BYTES] = {0};
+    uint32_t token = 0;
+
+    for (uint32_t s = 0; s < K_ITEM_SIZES; s++)
+    {
+        BenchQueue_t *p_bq = &s_queues[s];
+        uint32_t errors = 0;
+
+        p_bq->errors = 0;
+        (void)SPP_OSAL_QueueReset(p_bq->p_queue);
+        (void)SPP_OSAL_QueueReset(s_ack);
+        if (bench_spawn(bench_queue_task, "bench_q", p_bq) == NULL)
+        {
+            bench_report("queue_latency", "item_bytes", p_bq->itemBytes, s_samples, 0u, 1u);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < K_SAMPLES; i++)
+        {
+            uint32_t stamp = bench_cycles();
+            memcpy(item, &stamp, sizeof(stamp));
+            errors += (SPP_OSAL_QueueSend(p_bq->p_queue, item, K_TIMEOUT_MS) != SPP_OK);
+            errors += (SPP_OSAL_QueueReceive(s_ack, &token, K_TIMEOUT_MS) != SPP_OK);
+        }
+        bench_report("queue_latency", "item_bytes", p_bq->itemBytes, s_samples, K_SAMPLES,
+                     errors + p_bq->errors);
+
+        errors = 0;
+        p_bq->errors = 0;
+        uint32_t start = bench_cycles();
+        for (uint32_t i = 0; i < K_THROUGHPUT_ITEMS; i++)
+        {
+            errors += (SPP_OSAL_QueueSend(p_bq->p_queue, item, K_TIMEOUT_MS) != SPP_OK);
+        }
+        errors += (SPP_OSAL_QueueReceive(s_ack, &token, K_TIMEOUT_MS) != SPP_OK);
+        uint32_t cycles = bench_cycles() - start;
+        bench_report_rate("queue_throughput", p_bq->itemBytes, K_THROUGHPUT_ITEMS, cycles,
+                          errors + p_bq->errors);
+    }
+}
+
+static void bench_event_groups(void)
+{
+    uint32_t token = 0;
+    uint32_t errors = 0;
+
+    s_helperErrors = 0;
+    (void)SPP_OSAL_QueueReset(s_ack);
+    if (bench_isr_open() != SPP_OK)
+    {
+        bench_report("eventgroup_isr_wake", NULL, 0u, s_samples, 0u, 1u);
+        return;
+    }
+    if (bench_spawn(bench_event_task, "bench_eg", NULL) == NULL)
+    {
+        (void)bench_isr_close();
+        bench_report("eventgroup_isr_wake", NULL, 0u, s_samples, 0u, 1u);
+        return;
+    }
+
+    for (uint32_t i = 0; i < K_SAMPLES; i++)
+    {
+        errors += (bench_isr_fire() != SPP_OK);
+        errors += (SPP_OSAL_QueueReceive(s_ack, &token, K_TIMEOUT_MS) != SPP_OK);
+    }
+    errors += bench_isr_close();
+    bench_report("eventgroup_isr_wake", NULL, 0u, s_samples, K_SAMPLES, errors + s_helperErrors);
+}
+
+static void bench_tasks(void)
+{
+    uint32_t token = 0;
+    uint32_t errors = 0;
+    uint32_t n = 0;
+
+    (void)SPP_OSAL_QueueReset(s_ack);
+    for (; n < K_TASK_SAMPLES; n++)
+    {
+        void *p_storage = bench_task_storage();
+        if (p_storage == NULL)
+        {
+            errors += 1;
+            break;
+        }
+
+        s_stamp = bench_cycles();
+        void *p_task = SPP_OSAL_TaskCreate(bench_start_task, "bench_t", K_HELPER_STACK,
+                                           &s_samples[n], K_HELPER_PRIORITY, p_storage);
+        s_taskCreate[n] = bench_cycles() - s_stamp;
+        if (p_task == NULL || SPP_OSAL_QueueReceive(s_ack, &token, K_TIMEOUT_MS) != SPP_OK)
+        {
+            errors += 1;
+            break;
+        }
+
+        uint32_t start = bench_cycles();
+        errors += (SPP_OSAL_TaskDelete(&p_task) != SPP_OK);
+        s_taskDelete[n] = bench_cycles() - start;
+    }
+
+    bench_report("task_create", NULL, 0u, s_taskCreate, n, errors);
+    bench_report("task_start", NULL, 0u, s_samples, n, errors);
+    bench_report("task_delete", NULL, 0u, s_taskDelete, n, errors);
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Run every OSAL benchmark and print the results as JSON Lines.
+ *
+ * Blocks for a few seconds. Call from a task with a priority below
+ * K_HELPER_PRIORITY so helper tasks preempt it as soon as they are woken.
+ *
+ * @return SPP_OK when the suite ran (errors are reported per result),
+ *         SPP_ERROR if its queues or event group cannot be created.
+ */
+retval_t SPP_OSAL_BenchRun(void)
+{
+    if (bench_setup() != SPP_OK)
+    {
+        printf("{\"suite\":\"osal\",\"error\":\"setup\"}\n");
+        return SPP_ERROR;
+    }
+
+#if defined(ESP_PLATFORM)
+    const char *p_port = "freertos";
+#else
+    const char *p_port = "posix";
+#endif
+    printf("{\"suite\":\"osal\",\"port\":\"%s\",\"cycles_per_us\":%u,\"samples\":%u}\n", p_port,
+           bench_cycles_per_us(), K_SAMPLES);
+
+    bench_queues();
+    bench_event_groups();
+    bench_tasks();
+    bench_teardown();
+    return SPP_OK;
+}
+
+#if !defined(ESP_PLATFORM)
+int main(void)
+{
+    return (SPP_OSAL_BenchRun() == SPP_OK) ? 0 : 1;
+}
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file tracefmt.h
+ * @brief Record and dump layout of the SPP binary trace.
+ *
+ * A dump (SPP_OSAL_TraceWrite()) is a file header, then per core a ring
+ * header followed by ring_events records in slot order, then names
+ * task-name entries. Slots at or past head are unused; once head exceeds
+ * ring_events the ring has wrapped and the oldest record sits at slot
+ * head % ring_events. Times are ticks of tick_hz and wrap at 32 bits.
+ * Fields are little-endian.
+ *
+ * Task ids are port-specific. The FreeRTOS port records the TCB pointer
+ * (xTaskGetCurrentTaskHandle()), so tasks the OSAL did not create, such as
+ * idle or the timer daemon, still get an id; the POSIX port records the
+ * OSAL task handle. Each port names tasks by the id it records, so a dump
+ * is consistent in itself, but ids cannot be compared across ports.
+ *
+ * Shared by both OSAL ports and tools/spptrace, so the writer and the
+ * reader cannot drift apart; depends on <stdint.h> only.
+ */
+
+#ifndef TRACEFMT_H
+#define TRACEFMT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Dump magic, not NUL-terminated. */
+#define SPP_TRACE_FILE_MAGIC "SPPTRACE"
+
+#define SPP_TRACE_VERSION 1u
+
+/** @brief Capacity of spp_trace_name_t::name, including the terminator. */
+#define SPP_TRACE_NAME_LEN 16u
+
+/** @brief Traced calls; ids from SPP_TRACE_EV_USER up are application events. */
+#define SPP_TRACE_EV_QUEUE_SEND 0x01u    /**< object: queue, arg: timeout ms / result. */
+#define SPP_TRACE_EV_QUEUE_RECEIVE 0x02u /**< object: queue, arg: timeout ms / result. */
+#define SPP_TRACE_EV_EG_SET_ISR 0x03u    /**< object: event group, arg: bits set. */
+#define SPP_TRACE_EV_EG_WAIT 0x04u       /**< object: event group, arg: bits waited / bits seen. */
+#define SPP_TRACE_EV_TASK_CREATE 0x05u   /**< object: new task id, arg: priority. */
+#define SPP_TRACE_EV_TASK_DELAY 0x06u    /**< arg: delay ms. */
+#define SPP_TRACE_EV_SPI_TRANSMIT 0x07u  /**< object: CS pin, arg: length / result. */
+#define SPP_TRACE_EV_GPIO_ISR 0x08u      /**< object: pin. */
+#define SPP_TRACE_EV_USER 0x80u
+
+/** @brief spp_trace_event_t::flags fields. */
+#define SPP_TRACE_CORE_MASK 0x0Fu
+#define SPP_TRACE_PHASE_INSTANT 0x00u
+#define SPP_TRACE_PHASE_BEGIN 0x10u
+#define SPP_TRACE_PHASE_END 0x20u
+#define SPP_TRACE_PHASE_MASK 0x30u
+#define SPP_TRACE_FLAG_ISR 0x40u /**< Recorded in interrupt context. */
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief One trace record.
+ */
+typedef struct __attribute__((packed))
+{
+    uint32_t time;   /**< Timestamp in ticks of tick_hz, wrapping. */
+    uint32_t task;   /**< Running (or interrupted) task, low 32 bits of its port id. */
+    uint32_t object; /**< Queue, event group, task, pin; see SPP_TRACE_EV_*. */
+    uint16_t arg;    /**< Event argument, low 16 bits. */
+    uint8_t event;   /**< SPP_TRACE_EV_*. */
+    uint8_t flags;   /**< Core, phase and SPP_TRACE_FLAG_ISR. */
+} spp_trace_event_t;
+
+/**
+ * @brief Dump header at offset 0.
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t magic[8];     /**< SPP_TRACE_FILE_MAGIC. */
+    uint16_t version;     /**< SPP_TRACE_VERSION. */
+    uint16_t event_bytes; /**< sizeof(spp_trace_event_t). */
+    uint32_t tick_hz;     /**< Timestamp rate. */
+    uint32_t cores;       /**< Rings that follow. */
+    uint32_t ring_events; /**< Records per ring. */
+    uint32_t names;       /**< Name entries after the rings. */
+    uint32_t reserved;    /**< 0. */
+} spp_trace_file_header_t;
+
+/**
+ * @brief Ring header; followed by ring_events records.
+ */
+typedef struct __attribute__((packed))
+{
+    uint32_t core; /**< Core the ring belongs to. */
+    uint32_t head; /**< Records ever written to the ring, wrapping. */
+} spp_trace_ring_header_t;
+
+/**
+ * @brief Name of a task id seen in spp_trace_event_t::task.
+ */
+typedef struct __attribute__((packed))
+{
+    uint32_t task;
+    char name[SPP_TRACE_NAME_LEN];
+} spp_trace_name_t;
+
+_Static_assert(sizeof(spp_trace_event_t) == 16, "trace record layout");
+_Static_assert(sizeof(spp_trace_file_header_t) == 32, "trace header layout");
+
+#endif /* TRACEFMT_H */
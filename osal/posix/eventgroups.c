@@ -0,0 +1,407 @@
+/**
+ * @file eventgroups.c
+ * @brief POSIX OSAL event groups implementation for the SPP framework.
+ *
+ * Provides static event group creation and deletion, "ISR" bit setting
+ * (any thread or simulated interrupt context on the host), and blocking bit
+ * wait operations using a mutex and a monotonic-clock condition variable.
+ * Control blocks come from a pool whose slots are reused after deletion,
+ * and handles are generation-checked (handlepool.h), as on FreeRTOS. A
+ * group in a queue set signals the set after every bit set.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <errno.h>
+#include <pthread.h>
+#include "spp/osal/eventgroups.h"
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "spp/core/macros.h"
+#include "macros_posix.h"
+#include "internal_posix.h"
+#include "handlepool.h"
+#include "eventgroups_ext.h"
+#include "trace.h"
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Storage for a single POSIX event group.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    osal_eventbits_t bits;
+    void *p_set;        /**< Queue set the group belongs to, or NULL. */
+    uint32_t setMember; /**< Index of the group in the set. */
+} PosixEventGroup_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+/** @brief Static storage for event group control blocks, indexed like the pool. */
+static PosixEventGroup_t s_eventGroupBuffers[NUM_EVENT_GROUPS];
+
+/** @brief Handle reserved with each buffer by SPP_OSAL_GetEventGroupsBuffer(). */
+static void *s_bufferHandles[NUM_EVENT_GROUPS];
+
+/** @brief Handle slots of the event group pool. */
+static spp_handle_slot_t s_eventGroupHandleSlots[NUM_EVENT_GROUPS];
+
+/** @brief Event group handle pool. */
+static spp_handle_pool_t s_eventGroupHandles =
+    SPP_HANDLE_POOL_INITIALIZER(SPP_HANDLE_TYPE_EVENTGROUP, s_eventGroupHandleSlots,
+                                NUM_EVENT_GROUPS);
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Check whether a bit pattern satisfies a wait request.
+ *
+ * @param[in] current           Current event group bits.
+ * @param[in] bits_to_wait      Requested bit mask.
+ * @param[in] wait_for_all_bits Non-zero to require all bits.
+ * @return 1 if the wait condition is met, 0 otherwise.
+ */
+static int spp_posix_bits_match(osal_eventbits_t current, osal_eventbits_t bits_to_wait,
+                                spp_uint8_t wait_for_all_bits)
+{
+    if (wait_for_all_bits != 0)
+    {
+        return ((current & bits_to_wait) == bits_to_wait) ? 1 : 0;
+    }
+    return ((current & bits_to_wait) != 0) ? 1 : 0;
+}
+
+/**
+ * @brief Find the handle reserved with a pool buffer.
+ *
+ * @param[in] p_buffer Buffer passed to SPP_OSAL_EventGroupCreate().
+ * @return The reserved handle, or NULL if p_buffer is not a pool buffer.
+ */
+static void *spp_posix_eventgroup_buffer_handle(const void *p_buffer)
+{
+    const PosixEventGroup_t *p_first = &s_eventGroupBuffers[0];
+    const PosixEventGroup_t *p_egBuffer = (const PosixEventGroup_t *)p_buffer;
+
+    if (p_egBuffer < p_first || p_egBuffer >= &p_first[NUM_EVENT_GROUPS])
+        return NULL;
+
+    return s_bufferHandles[p_egBuffer - p_first];
+}
+
+/**
+ * @brief Map an event group handle to its control block.
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @return Control block, or NULL if the handle is NULL or stale.
+ */
+static PosixEventGroup_t *spp_posix_eventgroup_resolve(const void *p_eventGroup)
+{
+    return (PosixEventGroup_t *)SPP_OSAL_HandleResolve(&s_eventGroupHandles, p_eventGroup);
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Allocate an event group buffer from the static pool.
+ *
+ * Reserves a pool slot and returns its control block. The slot and its
+ * buffer return to the pool on SPP_OSAL_EventGroupDelete().
+ *
+ * @return Pointer to the allocated buffer, or NULL if the pool is exhausted.
+ */
+void *SPP_OSAL_GetEventGroupsBuffer()
+{
+    spp_uint32_t index = 0;
+    void *p_handle = SPP_OSAL_HandleAlloc(&s_eventGroupHandles, NULL, &index);
+
+    if (p_handle == NULL)
+    {
+        return NULL;
+    }
+    s_bufferHandles[index] = p_handle;
+
+    void *p_bufferEventGroup = (void *)&s_eventGroupBuffers[index];
+    return p_bufferEventGroup;
+}
+
+/**
+ * @brief Create a new event group.
+ *
+ * A buffer from SPP_OSAL_GetEventGroupsBuffer() uses the pool slot
+ * reserved with it. Any other buffer, or NULL, takes a fresh slot and
+ * uses that slot's control block; the caller's buffer is not touched,
+ * since its size is defined by the FreeRTOS port (StaticEventGroup_t).
+ *
+ * @param[in] p_eventGroupBuffer Buffer from SPP_OSAL_GetEventGroupsBuffer(),
+ *                               or NULL.
+ * @return Generation-checked event group handle, or NULL on failure.
+ */
+void *SPP_OSAL_EventGroupCreate(void *p_eventGroupBuffer)
+{
+    spp_uint32_t index = 0;
+    void *p_handle = spp_posix_eventgroup_buffer_handle(p_eventGroupBuffer);
+
+    if (p_handle == NULL)
+    {
+        p_handle = SPP_OSAL_HandleAlloc(&s_eventGroupHandles, NULL, NULL);
+        if (p_handle == NULL)
+            return NULL;
+    }
+    else if (SPP_OSAL_HandleResolve(&s_eventGroupHandles, p_handle) != NULL)
+    {
+        /* Buffer already holds a live event group */
+        return NULL;
+    }
+
+    if (SPP_OSAL_HandleIndex(&s_eventGroupHandles, p_handle, &index) != SPP_OK)
+    {
+        return NULL;
+    }
+
+    PosixEventGroup_t *p_eg = &s_eventGroupBuffers[index];
+    pthread_mutex_init(&p_eg->lock, NULL);
+    spp_posix_cond_init(&p_eg->changed);
+    p_eg->bits = 0;
+    p_eg->p_set = NULL;
+    p_eg->setMember = 0;
+
+    (void)SPP_OSAL_HandleSetObject(&s_eventGroupHandles, p_handle, p_eg);
+    return p_handle;
+}
+
+/**
+ * @brief Delete an event group and invalidate its handle.
+ *
+ * The handle is released first, so later calls through any copy of it fail
+ * with SPP_ERROR. A pool buffer becomes available to
+ * SPP_OSAL_GetEventGroupsBuffer() again. Unlike FreeRTOS, waiters are not
+ * released: no task may be blocked on the group, and the group must not
+ * be in a queue set.
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
+ *         SPP_ERROR if the handle is stale.
+ */
+retval_t SPP_OSAL_EventGroupDelete(void *p_eventGroup)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_eventGroup == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixEventGroup_t *p_eg = spp_posix_eventgroup_resolve(p_eventGroup);
+
+    if (p_eg == NULL || SPP_OSAL_HandleFree(&s_eventGroupHandles, p_eventGroup) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    pthread_cond_destroy(&p_eg->changed);
+    pthread_mutex_destroy(&p_eg->lock);
+    return ret;
+}
+
+/**
+ * @brief Set bits in an event group from ISR context.
+ *
+ * On the host there is no interrupt context; this may be called from any
+ * thread, including simulated interrupt sources.
+ *
+ * @param[in]  p_eventGroup             Event group handle.
+ * @param[in]  bits_to_set              Bits to set in the event group.
+ * @param[out] p_previousBits           Receives the bit values before the set.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0; there is nothing to
+ *                                      yield to on the host.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
+ *         SPP_ERROR if the handle is stale.
+ */
+retval_t OSAL_EventGroupSetBitsFromISR(void *p_eventGroup, osal_eventbits_t bits_to_set,
+                                       osal_eventbits_t *p_previousBits,
+                                       spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_eventGroup == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    PosixEventGroup_t *p_eg = spp_posix_eventgroup_resolve(p_eventGroup);
+    if (p_eg == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    SPP_TRACE_INSTANT(SPP_TRACE_EV_EG_SET_ISR, p_eventGroup, bits_to_set);
+    pthread_mutex_lock(&p_eg->lock);
+    if (p_previousBits != NULL)
+    {
+        *p_previousBits = p_eg->bits;
+    }
+    p_eg->bits |= bits_to_set;
+    pthread_cond_broadcast(&p_eg->changed);
+    pthread_mutex_unlock(&p_eg->lock);
+
+    if (p_eg->p_set != NULL)
+    {
+        spp_posix_queue_set_signal(p_eg->p_set, p_eg->setMember);
+    }
+
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Record the queue set an event group belongs to (internal_posix.h).
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @param[in] p_set        Queue set.
+ * @param[in] member       Index of the group in the set.
+ * @return SPP_OK on success, SPP_ERROR if the group is already in a set or
+ *         the handle is stale.
+ */
+retval_t spp_posix_eventgroup_join_set(void *p_eventGroup, void *p_set, uint32_t member)
+{
+    PosixEventGroup_t *p_eg = spp_posix_eventgroup_resolve(p_eventGroup);
+    retval_t ret = SPP_OK;
+
+    if (p_eg == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    pthread_mutex_lock(&p_eg->lock);
+    if (p_eg->p_set != NULL)
+    {
+        ret = SPP_ERROR;
+    }
+    else
+    {
+        p_eg->p_set = p_set;
+        p_eg->setMember = member;
+    }
+    pthread_mutex_unlock(&p_eg->lock);
+
+    return ret;
+}
+
+/**
+ * @brief Drop an event group from a queue set (internal_posix.h).
+ *
+ * Does nothing if the handle is stale or the group is in another set.
+ *
+ * @param[in] p_eventGroup Event group handle.
+ * @param[in] p_set        Queue set being deleted.
+ */
+void spp_posix_eventgroup_leave_set(void *p_eventGroup, const void *p_set)
+{
+    PosixEventGroup_t *p_eg = spp_posix_eventgroup_resolve(p_eventGroup);
+
+    if (p_eg == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&p_eg->lock);
+    if (p_eg->p_set == p_set)
+    {
+        p_eg->p_set = NULL;
+        p_eg->setMember = 0;
+    }
+    pthread_mutex_unlock(&p_eg->lock);
+}
+
+/**
+ * @brief Wait for bits to be set in an event group.
+ *
+ * Blocks the calling task until the requested bits are set or the timeout
+ * expires. Supports both wait-for-all and wait-for-any semantics.
+ *
+ * @param[in]  p_eventGroup     Event group handle.
+ * @param[in]  bits_to_wait     Bit mask to wait on.
+ * @param[in]  clear_on_exit    Non-zero to clear matched bits on return.
+ * @param[in]  wait_for_all_bits Non-zero to require all bits, zero for any.
+ * @param[in]  timeout_ms       Maximum wait time in milliseconds (0 = no wait).
+ * @param[out] p_actualBits     Receives the actual event bits at return time
+ *                              (may be NULL).
+ * @return SPP_OK if the requested bits were set, SPP_ERROR_NULL_POINTER if
+ *         the handle is NULL, SPP_ERROR on timeout or if the handle is stale.
+ */
+retval_t OSAL_EventGroupWaitBits(void *p_eventGroup, osal_eventbits_t bits_to_wait,
+                                 spp_uint8_t clear_on_exit, spp_uint8_t wait_for_all_bits,
+                                 spp_uint32_t timeout_ms, osal_eventbits_t *p_actualBits)
+{
+    if (p_eventGroup == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    PosixEventGroup_t *p_eg = spp_posix_eventgroup_resolve(p_eventGroup);
+    osal_eventbits_t actualBits;
+    int matched;
+
+    if (p_eg == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_EG_WAIT, p_eventGroup, bits_to_wait);
+    pthread_mutex_lock(&p_eg->lock);
+
+    matched = spp_posix_bits_match(p_eg->bits, bits_to_wait, wait_for_all_bits);
+    if (matched == 0 && timeout_ms != 0)
+    {
+        struct timespec deadline;
+        spp_posix_deadline(timeout_ms, &deadline);
+
+        int err = 0;
+        pthread_cleanup_push(spp_posix_unlock_cleanup, &p_eg->lock);
+        while (matched == 0 && err != ETIMEDOUT)
+        {
+            err = pthread_cond_timedwait(&p_eg->changed, &p_eg->lock, &deadline);
+            matched = spp_posix_bits_match(p_eg->bits, bits_to_wait, wait_for_all_bits);
+        }
+        pthread_cleanup_pop(0);
+    }
+
+    /* Like FreeRTOS, report the bits as they were before clearing */
+    actualBits = p_eg->bits;
+    if (p_actualBits != NULL)
+    {
+        *p_actualBits = actualBits;
+    }
+
+    if (matched != 0 && clear_on_exit != 0)
+    {
+        p_eg->bits &= ~bits_to_wait;
+    }
+
+    pthread_mutex_unlock(&p_eg->lock);
+    SPP_TRACE_END(SPP_TRACE_EV_EG_WAIT, p_eventGroup, actualBits);
+
+    if (matched != 0)
+    {
+        return SPP_OK;
+    }
+
+    return SPP_ERROR;
+}
@@ -0,0 +1,25 @@
+/**
+ * @file eventgroups_ext.h
+ * @brief OSAL event group extensions beyond the core SPP event group interface.
+ *
+ * Deletion. Queue set membership needs no proxy on the host; see
+ * SPP_OSAL_QueueSetAddEventGroup().
+ */
+
+#ifndef EVENTGROUPS_EXT_H
+#define EVENTGROUPS_EXT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_OSAL_EventGroupDelete(void *p_eventGroup);
+
+#endif /* EVENTGROUPS_EXT_H */
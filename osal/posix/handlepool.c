@@ -0,0 +1,310 @@
+/**
+ * @file handlepool.c
+ * @brief POSIX OSAL generation-checked handle pool implementation.
+ *
+ * Every pool is a caller-owned slot array threaded into a free list, so
+ * allocation and release are O(1) and slots are reused indefinitely. A
+ * handle is the 32-bit value
+ *
+ *     [31:28] type | [27:12] generation | [11:0] index + 1
+ *
+ * cast to void*. Releasing a slot bumps its generation, which invalidates
+ * every handle issued for the previous occupant. Resolving a handle takes
+ * no lock, mirroring the FreeRTOS port where it is called from ISRs.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "spp/core/returntypes.h"
+#include "spp/core/types.h"
+#include "handlepool.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Free-list terminator. */
+#define K_NO_SLOT (-1)
+
+/** @brief nextFree value of a slot that is handed out. */
+#define K_SLOT_ALLOCATED (-2)
+
+#define K_TYPE_SHIFT 28u
+#define K_GEN_SHIFT 12u
+#define K_GEN_MASK 0xFFFFu
+#define K_INDEX_MASK 0xFFFu
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+/** @brief Pools by handle type, registered on first use for stats lookup. */
+static spp_handle_pool_t *s_pools[SPP_HANDLE_TYPE_COUNT];
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Build the free list on first use. Call with the pool lock held.
+ *
+ * @param[in] p_pool Pool to set up.
+ */
+static void spp_osal_handle_pool_init(spp_handle_pool_t *p_pool)
+{
+    if (p_pool->initialized != 0u)
+        return;
+
+    for (uint16_t i = 0; i < p_pool->capacity; i++)
+    {
+        p_pool->p_slots[i].p_object = NULL;
+        p_pool->p_slots[i].generation = 0;
+        p_pool->p_slots[i].nextFree = (i + 1u < p_pool->capacity) ? (int16_t)(i + 1u) : K_NO_SLOT;
+    }
+    p_pool->freeHead = (p_pool->capacity > 0u) ? 0 : K_NO_SLOT;
+    p_pool->stats.capacity = p_pool->capacity;
+    p_pool->initialized = 1;
+
+    if (p_pool->type < SPP_HANDLE_TYPE_COUNT)
+    {
+        s_pools[p_pool->type] = p_pool;
+    }
+}
+
+/**
+ * @brief Encode a handle.
+ *
+ * @param[in] type       Handle type.
+ * @param[in] generation Slot generation.
+ * @param[in] index      Slot index.
+ * @return The handle.
+ */
+static void *spp_osal_handle_encode(uint8_t type, uint16_t generation, uint32_t index)
+{
+    uintptr_t value = ((uintptr_t)type << K_TYPE_SHIFT) |
+                      ((uintptr_t)generation << K_GEN_SHIFT) | (uintptr_t)(index + 1u);
+    return (void *)value;
+}
+
+/**
+ * @brief Decode and validate a handle against a pool.
+ *
+ * Counts a rejection for any non-NULL handle that does not name a live slot
+ * of this pool. Lock-free: the checked fields are single aligned words.
+ *
+ * @param[in] p_pool   Pool the handle should belong to.
+ * @param[in] p_handle Handle to check.
+ * @return The slot, or NULL if the handle is NULL, foreign or stale.
+ */
+static spp_handle_slot_t *spp_osal_handle_lookup(spp_handle_pool_t *p_pool, const void *p_handle)
+{
+    if (p_pool == NULL || p_handle == NULL)
+        return NULL;
+
+    uintptr_t value = (uintptr_t)p_handle;
+    uint32_t type = (uint32_t)(value >> K_TYPE_SHIFT) & 0xFu;
+    uint16_t generation = (uint16_t)((value >> K_GEN_SHIFT) & K_GEN_MASK);
+    uint32_t index = (uint32_t)(value & K_INDEX_MASK);
+
+    if (p_pool->initialized != 0u && type == p_pool->type && index != 0u &&
+        index <= p_pool->capacity && (uintptr_t)(uint32_t)value == value)
+    {
+        spp_handle_slot_t *p_slot = &p_pool->p_slots[index - 1u];
+        if (p_slot->nextFree == K_SLOT_ALLOCATED &&
+            __atomic_load_n(&p_slot->generation, __ATOMIC_ACQUIRE) == generation)
+        {
+            return p_slot;
+        }
+    }
+
+    __atomic_fetch_add(&p_pool->stats.stale_rejects, 1u, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Take a slot from a pool.
+ *
+ * @param[in]  p_pool   Pool to allocate from.
+ * @param[in]  p_object Native object to attach (may be NULL and set later
+ *                      with SPP_OSAL_HandleSetObject()).
+ * @param[out] p_index  Receives the slot index (may be NULL).
+ * @return The new handle, or NULL if the pool is exhausted.
+ */
+void *SPP_OSAL_HandleAlloc(spp_handle_pool_t *p_pool, void *p_object, spp_uint32_t *p_index)
+{
+    void *p_handle = NULL;
+
+    if (p_pool == NULL)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&p_pool->lock);
+    spp_osal_handle_pool_init(p_pool);
+    if (p_pool->freeHead != K_NO_SLOT)
+    {
+        uint32_t index = (uint32_t)p_pool->freeHead;
+        spp_handle_slot_t *p_slot = &p_pool->p_slots[index];
+
+        p_pool->freeHead = p_slot->nextFree;
+        p_slot->nextFree = K_SLOT_ALLOCATED;
+        p_slot->p_object = p_object;
+        p_handle = spp_osal_handle_encode(p_pool->type, p_slot->generation, index);
+
+        p_pool->stats.in_use += 1;
+        if (p_pool->stats.in_use > p_pool->stats.peak)
+        {
+            p_pool->stats.peak = p_pool->stats.in_use;
+        }
+        if (p_index != NULL)
+        {
+            *p_index = index;
+        }
+    }
+    else
+    {
+        p_pool->stats.alloc_failures += 1;
+    }
+    pthread_mutex_unlock(&p_pool->lock);
+
+    return p_handle;
+}
+
+/**
+ * @brief Attach the native object to an allocated slot.
+ *
+ * @param[in] p_pool   Pool owning the handle.
+ * @param[in] p_handle Handle from SPP_OSAL_HandleAlloc().
+ * @param[in] p_object Native object.
+ * @return SPP_OK on success, SPP_ERROR if the handle is stale or foreign.
+ */
+retval_t SPP_OSAL_HandleSetObject(spp_handle_pool_t *p_pool, const void *p_handle, void *p_object)
+{
+    spp_handle_slot_t *p_slot = spp_osal_handle_lookup(p_pool, p_handle);
+    if (p_slot == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    __atomic_store_n(&p_slot->p_object, p_object, __ATOMIC_RELEASE);
+    return SPP_OK;
+}
+
+/**
+ * @brief Map a handle to its native object. Takes no lock.
+ *
+ * @param[in] p_pool   Pool the handle should belong to.
+ * @param[in] p_handle Handle to resolve.
+ * @return The native object, or NULL if the handle is NULL, stale, foreign
+ *         or its object has not been attached yet.
+ */
+void *SPP_OSAL_HandleResolve(spp_handle_pool_t *p_pool, const void *p_handle)
+{
+    spp_handle_slot_t *p_slot = spp_osal_handle_lookup(p_pool, p_handle);
+    if (p_slot == NULL)
+    {
+        return NULL;
+    }
+
+    return __atomic_load_n(&p_slot->p_object, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Get the slot index of a live handle. Takes no lock.
+ *
+ * @param[in]  p_pool   Pool the handle should belong to.
+ * @param[in]  p_handle Handle to look up.
+ * @param[out] p_index  Receives the slot index.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_index is NULL,
+ *         SPP_ERROR if the handle is stale or foreign.
+ */
+retval_t SPP_OSAL_HandleIndex(spp_handle_pool_t *p_pool, const void *p_handle,
+                              spp_uint32_t *p_index)
+{
+    if (p_index == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    spp_handle_slot_t *p_slot = spp_osal_handle_lookup(p_pool, p_handle);
+    if (p_slot == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    *p_index = (spp_uint32_t)(p_slot - p_pool->p_slots);
+    return SPP_OK;
+}
+
+/**
+ * @brief Return a slot to its pool.
+ *
+ * The slot's generation is bumped, so the handle and every copy of it are
+ * rejected from now on.
+ *
+ * @param[in] p_pool   Pool owning the handle.
+ * @param[in] p_handle Handle to release.
+ * @return SPP_OK on success, SPP_ERROR if the handle is stale or foreign
+ *         (including a second release of the same handle).
+ */
+retval_t SPP_OSAL_HandleFree(spp_handle_pool_t *p_pool, const void *p_handle)
+{
+    retval_t ret = SPP_ERROR;
+
+    if (p_pool == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&p_pool->lock);
+    spp_handle_slot_t *p_slot = spp_osal_handle_lookup(p_pool, p_handle);
+    if (p_slot != NULL)
+    {
+        __atomic_store_n(&p_slot->generation, (uint16_t)(p_slot->generation + 1u),
+                         __ATOMIC_RELEASE);
+        p_slot->p_object = NULL;
+        p_slot->nextFree = p_pool->freeHead;
+        p_pool->freeHead = (int16_t)(p_slot - p_pool->p_slots);
+        p_pool->stats.in_use -= 1;
+        ret = SPP_OK;
+    }
+    pthread_mutex_unlock(&p_pool->lock);
+
+    return ret;
+}
+
+/**
+ * @brief Report the usage counters of the pool behind a handle type.
+ *
+ * @param[in]  type    One of the SPP_HANDLE_TYPE_* values.
+ * @param[out] p_stats Receives the counters.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_stats is NULL,
+ *         SPP_ERROR if the type is unknown or its pool has not been used yet.
+ */
+retval_t SPP_OSAL_HandlePoolGetStats(spp_uint8_t type, spp_handle_pool_stats_t *p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (type >= SPP_HANDLE_TYPE_COUNT || s_pools[type] == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    spp_handle_pool_t *p_pool = s_pools[type];
+    pthread_mutex_lock(&p_pool->lock);
+    *p_stats = p_pool->stats;
+    pthread_mutex_unlock(&p_pool->lock);
+
+    return SPP_OK;
+}
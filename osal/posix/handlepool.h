@@ -0,0 +1,106 @@
+/**
+ * @file handlepool.h
+ * @brief POSIX OSAL generation-checked handle pool.
+ *
+ * Same pool and handle encoding as the FreeRTOS port (handlepool.h there),
+ * with a pthread mutex in place of the port spinlock, so a handle used
+ * after its object was deleted is rejected on the host as on target.
+ */
+
+#ifndef HANDLEPOOL_H
+#define HANDLEPOOL_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Handle type of tasks. */
+#define SPP_HANDLE_TYPE_TASK 1u
+
+/** @brief Handle type of queues. */
+#define SPP_HANDLE_TYPE_QUEUE 2u
+
+/** @brief Handle type of event groups. */
+#define SPP_HANDLE_TYPE_EVENTGROUP 3u
+
+/** @brief Number of handle types (valid types are 1 .. SPP_HANDLE_TYPE_COUNT - 1). */
+#define SPP_HANDLE_TYPE_COUNT 4u
+
+/** @brief Largest pool capacity the handle encoding can address. */
+#define SPP_HANDLE_MAX_CAPACITY 4095u
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief One pool slot. Fields are private to handlepool.c.
+ */
+typedef struct
+{
+    void *p_object;      /**< Native object, NULL while reserved or free. */
+    uint16_t generation; /**< Bumped on every release. */
+    int16_t nextFree;    /**< Free-list link. */
+} spp_handle_slot_t;
+
+/**
+ * @brief Usage counters of a handle pool.
+ */
+typedef struct
+{
+    spp_uint32_t capacity;       /**< Number of slots. */
+    spp_uint32_t in_use;         /**< Slots currently allocated. */
+    spp_uint32_t peak;           /**< Highest in_use since start-up. */
+    spp_uint32_t alloc_failures; /**< Allocations rejected because the pool was full. */
+    spp_uint32_t stale_rejects;  /**< Stale or foreign handles rejected. */
+} spp_handle_pool_stats_t;
+
+/**
+ * @brief Handle pool. Define statically with SPP_HANDLE_POOL_INITIALIZER().
+ */
+typedef struct
+{
+    spp_handle_slot_t *p_slots;
+    uint16_t capacity;
+    uint8_t type;
+    uint8_t initialized;
+    int16_t freeHead;
+    spp_handle_pool_stats_t stats;
+    pthread_mutex_t lock;
+} spp_handle_pool_t;
+
+/**
+ * @brief Static initializer for a handle pool over a slot array.
+ *
+ * @param type     One of the SPP_HANDLE_TYPE_* values.
+ * @param slots    Array of spp_handle_slot_t.
+ * @param capacity Number of elements in slots (at most SPP_HANDLE_MAX_CAPACITY).
+ */
+#define SPP_HANDLE_POOL_INITIALIZER(type, slots, capacity)                                          \
+    {                                                                                              \
+        (slots), (uint16_t)(capacity), (uint8_t)(type), 0, -1, {(capacity), 0, 0, 0, 0},          \
+            PTHREAD_MUTEX_INITIALIZER                                                              \
+    }
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void *SPP_OSAL_HandleAlloc(spp_handle_pool_t *p_pool, void *p_object, spp_uint32_t *p_index);
+retval_t SPP_OSAL_HandleSetObject(spp_handle_pool_t *p_pool, const void *p_handle, void *p_object);
+void *SPP_OSAL_HandleResolve(spp_handle_pool_t *p_pool, const void *p_handle);
+retval_t SPP_OSAL_HandleIndex(spp_handle_pool_t *p_pool, const void *p_handle,
+                              spp_uint32_t *p_index);
+retval_t SPP_OSAL_HandleFree(spp_handle_pool_t *p_pool, const void *p_handle);
+retval_t SPP_OSAL_HandlePoolGetStats(spp_uint8_t type, spp_handle_pool_stats_t *p_stats);
+
+#endif /* HANDLEPOOL_H */
@@ -0,0 +1,99 @@
+/**
+ * @file internal_posix.h
+ * @brief Helpers shared by the POSIX OSAL translation units.
+ *
+ * All timed waits use CLOCK_MONOTONIC so wall-clock adjustments on the
+ * host never stretch or shorten an OSAL timeout. Also declares the glue
+ * between queue sets (queue.c) and event groups (eventgroups.c).
+ */
+
+#ifndef INTERNAL_POSIX_H
+#define INTERNAL_POSIX_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include "spp/core/returntypes.h"
+#include "macros_posix.h"
+
+/* ============================================================================
+ * Inline Helpers
+ * ========================================================================= */
+
+/**
+ * @brief Initialize a condition variable bound to CLOCK_MONOTONIC.
+ *
+ * @param[out] p_cond Condition variable to initialize.
+ */
+static inline void spp_posix_cond_init(pthread_cond_t *p_cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(p_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @brief Scale a millisecond value by POSIX_TIME_DIVIDER.
+ *
+ * A non-zero input never rounds down to zero, mirroring the FreeRTOS
+ * port's ms-to-ticks conversion.
+ *
+ * @param[in] timeout_ms Duration in milliseconds.
+ * @return Scaled duration in microseconds.
+ */
+static inline uint64_t spp_posix_scaled_us(uint32_t timeout_ms)
+{
+    uint64_t us = ((uint64_t)timeout_ms * 1000u) / POSIX_TIME_DIVIDER;
+    if (timeout_ms != 0u && us == 0u)
+        us = 1u;
+    return us;
+}
+
+/**
+ * @brief Compute an absolute CLOCK_MONOTONIC deadline.
+ *
+ * @param[in]  timeout_ms Relative timeout in milliseconds.
+ * @param[out] p_deadline Receives the absolute deadline.
+ */
+static inline void spp_posix_deadline(uint32_t timeout_ms, struct timespec *p_deadline)
+{
+    uint64_t us = spp_posix_scaled_us(timeout_ms);
+
+    clock_gettime(CLOCK_MONOTONIC, p_deadline);
+    p_deadline->tv_sec += (time_t)(us / 1000000u);
+    p_deadline->tv_nsec += (long)((us % 1000000u) * 1000u);
+    if (p_deadline->tv_nsec >= 1000000000L)
+    {
+        p_deadline->tv_sec += 1;
+        p_deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @brief Cancellation cleanup handler that releases a mutex.
+ *
+ * Pushed around every timed wait so SPP_OSAL_TaskDelete on a blocked task
+ * never leaves an OSAL object locked.
+ *
+ * @param[in] p_mutex Mutex to unlock.
+ */
+static inline void spp_posix_unlock_cleanup(void *p_mutex)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)p_mutex);
+}
+
+/* ============================================================================
+ * Shared Functions
+ * ========================================================================= */
+
+void spp_posix_queue_set_signal(void *p_set, uint32_t member);
+retval_t spp_posix_eventgroup_join_set(void *p_eventGroup, void *p_set, uint32_t member);
+void spp_posix_eventgroup_leave_set(void *p_eventGroup, const void *p_set);
+
+#endif /* INTERNAL_POSIX_H */
@@ -0,0 +1,71 @@
+/**
+ * @file macros_posix.h
+ * @brief POSIX OSAL configuration constants.
+ */
+
+#ifndef MACROS_POSIX_H
+#define MACROS_POSIX_H
+
+/** @brief Maximum number of statically allocated event group buffers. */
+#ifndef NUM_EVENT_GROUPS
+#define NUM_EVENT_GROUPS 5
+#endif
+
+/** @brief Maximum number of queue control blocks (static and dynamic). */
+#ifndef NUM_QUEUES
+#define NUM_QUEUES 32
+#endif
+
+/** @brief Maximum number of task storage slots. */
+#ifndef NUM_TASKS
+#define NUM_TASKS 50
+#endif
+
+/** @brief Minimum pthread stack size in bytes (host libc needs far more
+ *         than a FreeRTOS task). */
+#define POSIX_MIN_STACK_BYTES (64u * 1024u)
+
+/**
+ * @brief Divider applied to every delay and timeout.
+ *
+ * Values above 1 run the system faster than real time, e.g. 10 turns a
+ * 100 ms SPP_OSAL_TaskDelay into 10 ms. Override from the build system.
+ */
+#ifndef POSIX_TIME_DIVIDER
+#define POSIX_TIME_DIVIDER 1u
+#endif
+
+/** @brief Maximum number of slots in a loan queue (SPP_OSAL_LoanQueue*). */
+#ifndef LOAN_QUEUE_MAX_SLOTS
+#define LOAN_QUEUE_MAX_SLOTS 32
+#endif
+
+/** @brief Maximum number of queues and event groups in one queue set. */
+#ifndef QUEUE_SET_MAX_MEMBERS
+#define QUEUE_SET_MAX_MEMBERS 8
+#endif
+
+/**
+ * @brief Non-zero to compile the trace hooks (trace.h) into the OSAL and
+ *        HAL. At 0 every hook expands to nothing.
+ */
+#ifndef SPP_TRACE_ENABLED
+#define SPP_TRACE_ENABLED 0
+#endif
+
+/** @brief Records per trace ring (power of two); one ring per core. */
+#ifndef SPP_TRACE_RING_EVENTS
+#define SPP_TRACE_RING_EVENTS 1024u
+#endif
+
+/** @brief Trace rings; host CPUs map onto them modulo this count. */
+#ifndef SPP_TRACE_CORES
+#define SPP_TRACE_CORES 4u
+#endif
+
+/** @brief Task names kept for trace dumps. */
+#ifndef SPP_TRACE_MAX_NAMES
+#define SPP_TRACE_MAX_NAMES NUM_TASKS
+#endif
+
+#endif /* MACROS_POSIX_H */
@@ -0,0 +1,1348 @@
+/**
+ * @file queue.c
+ * @brief POSIX OSAL queue implementation for the SPP framework.
+ *
+ * Implements the SPP OSAL queue interface (dynamic and static creation,
+ * send, receive, reset, and message count) as a copy-in/copy-out ring
+ * buffer guarded by a mutex and two monotonic-clock condition variables.
+ * Control blocks come from a pool whose slots are reused after
+ * SPP_OSAL_QueueDelete(), and handles are generation-checked
+ * (handlepool.h), so operations on a deleted queue are rejected. ISR
+ * variants of send, send-to-front, overwrite, receive and peek never
+ * block. Batched send/receive move several items under a single lock
+ * acquisition. A queue set waits on one condition variable that every
+ * member signals when it becomes ready.
+ * The zero-copy loan queue is layered on top of these queues.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spp/osal/queue.h"
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "macros_posix.h"
+#include "internal_posix.h"
+#include "handlepool.h"
+#include "queue_ext.h"
+#include "trace.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Loan queue slot states (spp_loan_queue_t::slotState). */
+#define K_LOAN_SLOT_FREE 0u
+#define K_LOAN_SLOT_RESERVED 1u
+#define K_LOAN_SLOT_READY 2u
+#define K_LOAN_SLOT_BORROWED 3u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Control block of a POSIX queue.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    uint8_t *p_storage;
+    uint32_t length;
+    uint32_t itemSize;
+    uint32_t head;
+    uint32_t count;
+    uint8_t ownsStorage;    /**< p_storage was allocated by SPP_OSAL_QueueCreate(). */
+    spp_queue_set_t *p_set; /**< Queue set the queue belongs to, or NULL. */
+    uint32_t setMember;     /**< Index in p_set->members. */
+} PosixQueue_t;
+
+/**
+ * @brief Where an ISR send puts its item.
+ */
+typedef enum
+{
+    K_QUEUE_BACK = 0,     /**< Behind every queued item. */
+    K_QUEUE_FRONT = 1,    /**< Ahead of every queued item. */
+    K_QUEUE_OVERWRITE = 2 /**< Replace the item of a one-item queue. */
+} QueuePosition_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+/** @brief Pool of queue control blocks, indexed like s_queueHandles. */
+static PosixQueue_t s_queuePool[NUM_QUEUES];
+
+/** @brief Handle slots of the queue pool. */
+static spp_handle_slot_t s_queueHandleSlots[NUM_QUEUES];
+
+/** @brief Queue handle pool. */
+static spp_handle_pool_t s_queueHandles =
+    SPP_HANDLE_POOL_INITIALIZER(SPP_HANDLE_TYPE_QUEUE, s_queueHandleSlots, NUM_QUEUES);
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Take a control block from the pool, initialize it and register it.
+ *
+ * The caller-visible p_queueBuffer of the static API is not used as the
+ * control block, because its size is defined by FreeRTOS (StaticQueue_t)
+ * and cannot hold a mutex and two condition variables.
+ *
+ * @param[in] queue_length Maximum number of items.
+ * @param[in] item_size    Size of each item in bytes.
+ * @param[in] p_storage    Item storage of queue_length * item_size bytes.
+ * @param[in] ownsStorage  Non-zero if p_storage is freed on deletion.
+ * @return Generation-checked queue handle, or NULL if the pool is exhausted.
+ */
+static void *spp_posix_queue_register(uint32_t queue_length, uint32_t item_size,
+                                      uint8_t *p_storage, uint8_t ownsStorage)
+{
+    spp_uint32_t index;
+    void *p_handle = SPP_OSAL_HandleAlloc(&s_queueHandles, NULL, &index);
+
+    if (p_handle == NULL)
+        return NULL;
+
+    PosixQueue_t *p_queue = &s_queuePool[index];
+    pthread_mutex_init(&p_queue->lock, NULL);
+    spp_posix_cond_init(&p_queue->notEmpty);
+    spp_posix_cond_init(&p_queue->notFull);
+    p_queue->p_storage = p_storage;
+    p_queue->length = queue_length;
+    p_queue->itemSize = item_size;
+    p_queue->head = 0;
+    p_queue->count = 0;
+    p_queue->ownsStorage = ownsStorage;
+    p_queue->p_set = NULL;
+    p_queue->setMember = 0;
+
+    (void)SPP_OSAL_HandleSetObject(&s_queueHandles, p_handle, p_queue);
+    return p_handle;
+}
+
+/**
+ * @brief Map a queue handle to its control block.
+ *
+ * @param[in] p_queueHandle Queue handle.
+ * @return Control block, or NULL if the handle is NULL or stale.
+ */
+static PosixQueue_t *spp_posix_queue_resolve(const void *p_queueHandle)
+{
+    return (PosixQueue_t *)SPP_OSAL_HandleResolve(&s_queueHandles, p_queueHandle);
+}
+
+/**
+ * @brief Wait on a condition until a predicate holds or a timeout expires.
+ *
+ * Must be called with p_queue->lock held. A zero timeout never blocks.
+ *
+ * @param[in] p_queue    Queue whose lock is held.
+ * @param[in] p_cond     Condition variable to wait on.
+ * @param[in] p_counter  Value that must differ from blocked_value to proceed.
+ * @param[in] blocked_value Value of *p_counter that means "keep waiting".
+ * @param[in] timeout_ms Maximum wait time in milliseconds.
+ * @return 1 if the predicate holds, 0 on timeout.
+ */
+static int spp_posix_queue_wait(PosixQueue_t *p_queue, pthread_cond_t *p_cond,
+                                const uint32_t *p_counter, uint32_t blocked_value,
+                                uint32_t timeout_ms)
+{
+    if (*p_counter != blocked_value)
+        return 1;
+    if (timeout_ms == 0u)
+        return 0;
+
+    struct timespec deadline;
+    spp_posix_deadline(timeout_ms, &deadline);
+
+    int err = 0;
+    pthread_cleanup_push(spp_posix_unlock_cleanup, &p_queue->lock);
+    while (*p_counter == blocked_value && err != ETIMEDOUT)
+    {
+        err = pthread_cond_timedwait(p_cond, &p_queue->lock, &deadline);
+    }
+    pthread_cleanup_pop(0);
+
+    return (*p_counter != blocked_value) ? 1 : 0;
+}
+
+/**
+ * @brief Map a slot pointer back to its index in a loan queue.
+ *
+ * @param[in]  p_lq    Loan queue control block.
+ * @param[in]  p_slot  Slot pointer previously handed out by the loan queue.
+ * @param[out] p_index Receives the slot index.
+ * @return 1 if p_slot is the start of a slot of this queue, 0 otherwise.
+ */
+static int spp_osal_loan_slot_index(const spp_loan_queue_t *p_lq, const void *p_slot,
+                                    uint16_t *p_index)
+{
+    const uint8_t *p_byte = (const uint8_t *)p_slot;
+
+    if (p_byte < p_lq->p_slots)
+        return 0;
+
+    size_t offset = (size_t)(p_byte - p_lq->p_slots);
+    if ((offset % p_lq->itemSize) != 0u || (offset / p_lq->itemSize) >= p_lq->slotCount)
+        return 0;
+
+    *p_index = (uint16_t)(offset / p_lq->itemSize);
+    return 1;
+}
+
+/**
+ * @brief Move a loan slot from one state to another.
+ *
+ * The compare-exchange makes a repeated commit or release of the same slot
+ * fail instead of queueing its index twice.
+ *
+ * @param[in,out] p_lq  Loan queue control block.
+ * @param[in]     index Slot index.
+ * @param[in]     from  Required current state.
+ * @param[in]     to    New state.
+ * @return 1 if the slot was in state from and is now in state to, 0 otherwise.
+ */
+static int spp_osal_loan_slot_move(spp_loan_queue_t *p_lq, uint16_t index, uint8_t from,
+                                   uint8_t to)
+{
+    uint8_t expected = from;
+    int moved = __atomic_compare_exchange_n(&p_lq->slotState[index], &expected, to, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return moved ? 1 : 0;
+}
+
+/**
+ * @brief Wake a queue set waiting on a queue that just received items.
+ *
+ * Called after q->lock is released; membership is fixed before use.
+ *
+ * @param[in] q Queue that became non-empty.
+ */
+static void spp_posix_queue_notify_set(const PosixQueue_t *q)
+{
+    if (q->p_set != NULL)
+    {
+        spp_posix_queue_set_signal(q->p_set, q->setMember);
+    }
+}
+
+/**
+ * @brief Non-blocking send shared by the ISR variants.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to enqueue.
+ * @param[in]  position                  Where the item goes.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0 (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue is full, or for K_QUEUE_OVERWRITE if its
+ *         length is not 1, or the handle is stale.
+ */
+static retval_t spp_posix_queue_send_isr(void *p_queueHandle, const void *p_item,
+                                         QueuePosition_t position,
+                                         spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+    if (p_queueHandle == NULL || p_item == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    uint32_t slot;
+
+    if (q == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    if (position == K_QUEUE_OVERWRITE)
+    {
+        if (q->length != 1u)
+        {
+            pthread_mutex_unlock(&q->lock);
+            return SPP_ERROR;
+        }
+        slot = q->head;
+        q->count = 1;
+    }
+    else if (q->count == q->length)
+    {
+        pthread_mutex_unlock(&q->lock);
+        return SPP_ERROR;
+    }
+    else if (position == K_QUEUE_FRONT)
+    {
+        q->head = (q->head + q->length - 1u) % q->length;
+        slot = q->head;
+        q->count += 1;
+    }
+    else
+    {
+        slot = (q->head + q->count) % q->length;
+        q->count += 1;
+    }
+    memcpy(&q->p_storage[(size_t)slot * q->itemSize], p_item, q->itemSize);
+    pthread_cond_signal(&q->notEmpty);
+    pthread_mutex_unlock(&q->lock);
+    spp_posix_queue_notify_set(q);
+
+    return SPP_OK;
+}
+
+/* ============================================================================
+ * Public Functions — Queue Creation
+ * ========================================================================= */
+
+/**
+ * @brief Create a new queue using dynamic memory allocation.
+ *
+ * @param[in] queue_length Maximum number of items the queue can hold.
+ * @param[in] item_size    Size of each item in bytes.
+ * @return Generation-checked queue handle, or NULL on failure.
+ */
+void *SPP_OSAL_QueueCreate(uint32_t queue_length, uint32_t item_size)
+{
+    if (queue_length == 0 || item_size == 0)
+        return NULL;
+
+    uint8_t *p_storage = (uint8_t *)malloc((size_t)queue_length * item_size);
+    if (p_storage == NULL)
+        return NULL;
+
+    void *p_handle = spp_posix_queue_register(queue_length, item_size, p_storage, 1u);
+    if (p_handle == NULL)
+    {
+        free(p_storage);
+    }
+
+    return p_handle;
+}
+
+/**
+ * @brief Create a new queue using static memory allocation.
+ *
+ * @param[in] queue_length  Maximum number of items the queue can hold.
+ * @param[in] item_size     Size of each item in bytes.
+ * @param[in] p_queueStorage Pointer to the static storage area for queue items.
+ * @param[in] p_queueBuffer  Caller's queue buffer (checked but unused; the
+ *                           control block comes from an internal pool).
+ * @return Generation-checked queue handle, or NULL on failure.
+ */
+void *SPP_OSAL_QueueCreateStatic(uint32_t queue_length, uint32_t item_size, uint8_t *p_queueStorage,
+                                 void *p_queueBuffer)
+{
+    if (queue_length == 0 || item_size == 0 || p_queueBuffer == 0)
+    {
+        return NULL;
+    }
+
+    if (item_size > 0 && p_queueStorage == NULL)
+    { /* If item_size > 0, valid storage is required */
+        return NULL;
+    }
+
+    return spp_posix_queue_register(queue_length, item_size, p_queueStorage, 0u);
+}
+
+/**
+ * @brief Delete a queue and invalidate its handle.
+ *
+ * The handle is released first, so later calls through any copy of it fail
+ * with SPP_ERROR instead of touching a recycled control block. Storage
+ * passed to SPP_OSAL_QueueCreateStatic() may be reused once this returns.
+ * No task may be blocked on the queue, and the queue must not be in a
+ * queue set.
+ *
+ * @param[in] p_queueHandle Queue handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
+ *         SPP_ERROR if the handle is stale.
+ */
+retval_t SPP_OSAL_QueueDelete(void *p_queueHandle)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_queueHandle == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+
+    if (q == NULL || SPP_OSAL_HandleFree(&s_queueHandles, p_queueHandle) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    if (q->ownsStorage != 0u)
+    {
+        free(q->p_storage);
+    }
+    q->p_storage = NULL;
+    pthread_cond_destroy(&q->notFull);
+    pthread_cond_destroy(&q->notEmpty);
+    pthread_mutex_destroy(&q->lock);
+    return ret;
+}
+
+/* ============================================================================
+ * Public Functions — Queue Status
+ * ========================================================================= */
+
+/**
+ * @brief Get the number of messages currently waiting in a queue.
+ *
+ * @param[in] p_queueHandle Queue handle.
+ * @return Number of queued items, or 0 if the handle is NULL or stale.
+ */
+uint32_t SPP_OSAL_QueueMessagesWaiting(void *p_queueHandle)
+{
+    PosixQueue_t *p_queue = spp_posix_queue_resolve(p_queueHandle);
+    if (p_queue == NULL)
+        return 0;
+
+    pthread_mutex_lock(&p_queue->lock);
+    uint32_t queuedItems = p_queue->count;
+    pthread_mutex_unlock(&p_queue->lock);
+
+    return queuedItems;
+}
+
+/* ============================================================================
+ * Public Functions — Queue Send / Receive / Reset
+ * ========================================================================= */
+
+/**
+ * @brief Send an item to a queue.
+ *
+ * @param[in] p_queueHandle Queue handle.
+ * @param[in] p_item        Pointer to the item to enqueue.
+ * @param[in] timeout_ms    Maximum wait time in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the send timed out or the queue handle is stale.
+ */
+retval_t SPP_OSAL_QueueSend(void *p_queueHandle, const void *p_item, uint32_t timeout_ms)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_queueHandle == NULL || p_item == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_QUEUE_SEND, p_queueHandle, timeout_ms);
+    pthread_mutex_lock(&q->lock);
+    if (spp_posix_queue_wait(q, &q->notFull, &q->count, q->length, timeout_ms) == 0)
+    {
+        pthread_mutex_unlock(&q->lock);
+        ret = SPP_ERROR;
+        SPP_TRACE_END(SPP_TRACE_EV_QUEUE_SEND, p_queueHandle, ret);
+        return ret;
+    }
+
+    uint32_t tail = (q->head + q->count) % q->length;
+    memcpy(&q->p_storage[(size_t)tail * q->itemSize], p_item, q->itemSize);
+    q->count += 1;
+    pthread_cond_signal(&q->notEmpty);
+    pthread_mutex_unlock(&q->lock);
+    spp_posix_queue_notify_set(q);
+    SPP_TRACE_END(SPP_TRACE_EV_QUEUE_SEND, p_queueHandle, ret);
+
+    return ret;
+}
+
+/**
+ * @brief Receive an item from a queue.
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[out] p_outItem     Pointer to the buffer that receives the dequeued item.
+ * @param[in]  timeout_ms    Maximum wait time in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue handle is stale,
+ *         SPP_NOT_ENOUGH_PACKETS if no item was available within the timeout.
+ */
+retval_t SPP_OSAL_QueueReceive(void *p_queueHandle, void *p_outItem, uint32_t timeout_ms)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_queueHandle == NULL || p_outItem == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_QUEUE_RECEIVE, p_queueHandle, timeout_ms);
+    pthread_mutex_lock(&q->lock);
+    if (spp_posix_queue_wait(q, &q->notEmpty, &q->count, 0u, timeout_ms) == 0)
+    {
+        pthread_mutex_unlock(&q->lock);
+        /* For datapool: no pointers were available within the given time */
+        ret = SPP_NOT_ENOUGH_PACKETS;
+        SPP_TRACE_END(SPP_TRACE_EV_QUEUE_RECEIVE, p_queueHandle, ret);
+        return ret;
+    }
+
+    memcpy(p_outItem, &q->p_storage[(size_t)q->head * q->itemSize], q->itemSize);
+    q->head = (q->head + 1u) % q->length;
+    q->count -= 1;
+    pthread_cond_signal(&q->notFull);
+    pthread_mutex_unlock(&q->lock);
+    SPP_TRACE_END(SPP_TRACE_EV_QUEUE_RECEIVE, p_queueHandle, ret);
+
+    return ret;
+}
+
+/**
+ * @brief Reset a queue to its empty state.
+ *
+ * @param[in] p_queueHandle Queue handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if the handle is NULL,
+ *         SPP_ERROR if the handle is stale.
+ */
+retval_t SPP_OSAL_QueueReset(void *p_queueHandle)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_queueHandle == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    q->head = 0;
+    q->count = 0;
+    pthread_cond_broadcast(&q->notFull);
+    pthread_mutex_unlock(&q->lock);
+
+    return ret;
+}
+
+/* ============================================================================
+ * Public Functions — ISR Send / Receive / Peek
+ * ========================================================================= */
+
+/**
+ * @brief Send an item to the back of a queue from a (simulated) ISR.
+ *
+ * Never blocks. The host has no interrupt context; these calls take the
+ * queue lock like any other and exist so interrupt-side code builds and
+ * behaves the same as on target.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to enqueue.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0; there is nothing to
+ *                                       yield to on the host.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue is full or the handle is stale.
+ */
+retval_t SPP_OSAL_QueueSendFromISR(void *p_queueHandle, const void *p_item,
+                                   spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    return spp_posix_queue_send_isr(p_queueHandle, p_item, K_QUEUE_BACK,
+                                    p_higherPriorityTaskWoken);
+}
+
+/**
+ * @brief Send an item to the front of a queue from a (simulated) ISR.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to enqueue.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue is full or the handle is stale.
+ */
+retval_t SPP_OSAL_QueueSendToFrontFromISR(void *p_queueHandle, const void *p_item,
+                                          spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    return spp_posix_queue_send_isr(p_queueHandle, p_item, K_QUEUE_FRONT,
+                                    p_higherPriorityTaskWoken);
+}
+
+/**
+ * @brief Replace the item of a one-item queue from a (simulated) ISR.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[in]  p_item                    Item to store.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the queue length is not 1 (FreeRTOS asserts) or the
+ *         handle is stale.
+ */
+retval_t SPP_OSAL_QueueOverwriteFromISR(void *p_queueHandle, const void *p_item,
+                                        spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    return spp_posix_queue_send_isr(p_queueHandle, p_item, K_QUEUE_OVERWRITE,
+                                    p_higherPriorityTaskWoken);
+}
+
+/**
+ * @brief Receive an item from a queue from a (simulated) ISR.
+ *
+ * @param[in]  p_queueHandle             Queue handle.
+ * @param[out] p_outItem                 Receives the dequeued item.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the handle is stale,
+ *         SPP_NOT_ENOUGH_PACKETS if the queue is empty.
+ */
+retval_t SPP_OSAL_QueueReceiveFromISR(void *p_queueHandle, void *p_outItem,
+                                      spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+
+    return SPP_OSAL_QueueReceive(p_queueHandle, p_outItem, 0u);
+}
+
+/**
+ * @brief Copy the oldest item of a queue without removing it.
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[out] p_outItem     Receives a copy of the item.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if the handle is stale,
+ *         SPP_NOT_ENOUGH_PACKETS if the queue is empty.
+ */
+retval_t SPP_OSAL_QueuePeekFromISR(void *p_queueHandle, void *p_outItem)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_queueHandle == NULL || p_outItem == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    if (q->count == 0u)
+    {
+        ret = SPP_NOT_ENOUGH_PACKETS;
+    }
+    else
+    {
+        memcpy(p_outItem, &q->p_storage[(size_t)q->head * q->itemSize], q->itemSize);
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    return ret;
+}
+
+/* ============================================================================
+ * Public Functions — Batched Send / Receive
+ * ========================================================================= */
+
+/**
+ * @brief Send up to count items to a queue in one call.
+ *
+ * Waits at most timeout_ms for the first free slot, then copies as many
+ * items as fit under the same lock and signals the receiver once.
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[in]  p_items       Array of count items.
+ * @param[in]  item_size     Size of each item in bytes; must equal the queue's.
+ * @param[in]  count         Number of items to send.
+ * @param[in]  timeout_ms    Maximum wait for the first free slot in milliseconds.
+ * @param[out] p_sent        Receives the number of items sent (may be NULL).
+ * @return SPP_OK if at least one item was sent (or count is 0),
+ *         SPP_ERROR_NULL_POINTER if handles are NULL, SPP_ERROR if the queue
+ *         stayed full for the whole timeout, the queue handle is stale or
+ *         item_size does not match the queue.
+ */
+retval_t SPP_OSAL_QueueSendBatch(void *p_queueHandle, const void *p_items, uint32_t item_size,
+                                 uint32_t count, uint32_t timeout_ms, uint32_t *p_sent)
+{
+    retval_t ret = SPP_OK;
+    uint32_t sent = 0;
+
+    if (p_queueHandle == NULL || p_items == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+    const uint8_t *p_bytes = (const uint8_t *)p_items;
+
+    if (item_size != q->itemSize)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    if (count > 0u && spp_posix_queue_wait(q, &q->notFull, &q->count, q->length, timeout_ms) == 0)
+    {
+        ret = SPP_ERROR;
+    }
+    else
+    {
+        while (sent < count && q->count < q->length)
+        {
+            uint32_t tail = (q->head + q->count) % q->length;
+            memcpy(&q->p_storage[(size_t)tail * q->itemSize], &p_bytes[(size_t)sent * item_size],
+                   q->itemSize);
+            q->count += 1;
+            sent += 1;
+        }
+        if (sent > 0u)
+        {
+            pthread_cond_broadcast(&q->notEmpty);
+        }
+    }
+    pthread_mutex_unlock(&q->lock);
+    if (sent > 0u)
+    {
+        spp_posix_queue_notify_set(q);
+    }
+
+    if (p_sent != NULL)
+    {
+        *p_sent = sent;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Receive up to max_items items from a queue in one call.
+ *
+ * Waits at most timeout_ms for the first item, then copies everything else
+ * already queued under the same lock and signals senders once.
+ *
+ * @param[in]  p_queueHandle Queue handle.
+ * @param[out] p_outItems    Buffer for up to max_items items.
+ * @param[in]  item_size     Size of each item in bytes; must equal the queue's.
+ * @param[in]  max_items     Capacity of p_outItems in items.
+ * @param[in]  timeout_ms    Maximum wait for the first item in milliseconds.
+ * @param[out] p_received    Receives the number of items read (may be NULL).
+ * @return SPP_OK if at least one item was received (or max_items is 0),
+ *         SPP_ERROR_NULL_POINTER if handles are NULL, SPP_ERROR if the queue
+ *         handle is stale or item_size does not match the queue,
+ *         SPP_NOT_ENOUGH_PACKETS if no item arrived within the timeout.
+ */
+retval_t SPP_OSAL_QueueReceiveBatch(void *p_queueHandle, void *p_outItems, uint32_t item_size,
+                                    uint32_t max_items, uint32_t timeout_ms,
+                                    uint32_t *p_received)
+{
+    retval_t ret = SPP_OK;
+    uint32_t received = 0;
+
+    if (p_queueHandle == NULL || p_outItems == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+    uint8_t *p_bytes = (uint8_t *)p_outItems;
+
+    if (item_size != q->itemSize)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    pthread_mutex_lock(&q->lock);
+    if (max_items > 0u && spp_posix_queue_wait(q, &q->notEmpty, &q->count, 0u, timeout_ms) == 0)
+    {
+        ret = SPP_NOT_ENOUGH_PACKETS;
+    }
+    else
+    {
+        while (received < max_items && q->count > 0u)
+        {
+            memcpy(&p_bytes[(size_t)received * item_size],
+                   &q->p_storage[(size_t)q->head * q->itemSize], q->itemSize);
+            q->head = (q->head + 1u) % q->length;
+            q->count -= 1;
+            received += 1;
+        }
+        if (received > 0u)
+        {
+            pthread_cond_broadcast(&q->notFull);
+        }
+    }
+    pthread_mutex_unlock(&q->lock);
+
+    if (p_received != NULL)
+    {
+        *p_received = received;
+    }
+
+    return ret;
+}
+
+/* ============================================================================
+ * Public Functions — Loan Queue
+ * ========================================================================= */
+
+/**
+ * @brief Create a zero-copy loan queue over caller-provided slot storage.
+ *
+ * Builds the two index queues with SPP_OSAL_QueueCreateStatic over
+ * storage inside p_loanBuffer.
+ *
+ * @param[in] queue_length  Number of slots (at most LOAN_QUEUE_MAX_SLOTS).
+ * @param[in] item_size     Size of each slot in bytes.
+ * @param[in] p_slotStorage Slot storage of queue_length * item_size bytes.
+ * @param[in] p_loanBuffer  Pointer to an spp_loan_queue_t.
+ * @return Loan queue handle as void pointer, or NULL on failure.
+ */
+void *SPP_OSAL_LoanQueueCreateStatic(uint32_t queue_length, uint32_t item_size,
+                                     uint8_t *p_slotStorage, void *p_loanBuffer)
+{
+    if (queue_length == 0 || queue_length > LOAN_QUEUE_MAX_SLOTS || item_size == 0 ||
+        p_slotStorage == NULL || p_loanBuffer == NULL)
+    {
+        return NULL;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanBuffer;
+
+    p_lq->p_slots = p_slotStorage;
+    p_lq->slotCount = queue_length;
+    p_lq->itemSize = item_size;
+    memset(p_lq->slotState, K_LOAN_SLOT_FREE, sizeof(p_lq->slotState));
+
+    /* Control blocks come from the queue pool; the buffers only need to be non-NULL */
+    p_lq->p_freeQueue = SPP_OSAL_QueueCreateStatic(queue_length, sizeof(uint16_t),
+                                                   (uint8_t *)p_lq->freeStorage, p_lq);
+    if (p_lq->p_freeQueue == NULL)
+        return NULL;
+
+    p_lq->p_readyQueue = SPP_OSAL_QueueCreateStatic(queue_length, sizeof(uint16_t),
+                                                    (uint8_t *)p_lq->readyStorage, p_lq);
+    if (p_lq->p_readyQueue == NULL)
+    {
+        /* Give the first control block back to the pool */
+        (void)SPP_OSAL_QueueDelete(p_lq->p_freeQueue);
+        p_lq->p_freeQueue = NULL;
+        return NULL;
+    }
+
+    for (uint16_t i = 0; i < (uint16_t)queue_length; i++)
+    {
+        (void)SPP_OSAL_QueueSend(p_lq->p_freeQueue, &i, 0);
+    }
+
+    return (void *)p_lq;
+}
+
+/**
+ * @brief Reserve a free slot for the producer to fill in place.
+ *
+ * @param[in]  p_loanQueue Loan queue handle.
+ * @param[out] pp_slot     Receives a pointer to item_size writable bytes.
+ * @param[in]  timeout_ms  Maximum wait for a free slot in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if no slot became free within the timeout.
+ */
+retval_t SPP_OSAL_LoanQueueReserve(void *p_loanQueue, void **pp_slot, uint32_t timeout_ms)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || pp_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    uint16_t index;
+
+    if (SPP_OSAL_QueueReceive(p_lq->p_freeQueue, &index, timeout_ms) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    __atomic_store_n(&p_lq->slotState[index], K_LOAN_SLOT_RESERVED, __ATOMIC_RELEASE);
+    *pp_slot = (void *)&p_lq->p_slots[(size_t)index * p_lq->itemSize];
+    return ret;
+}
+
+/**
+ * @brief Publish a reserved slot to the consumer.
+ *
+ * @param[in] p_loanQueue Loan queue handle.
+ * @param[in] p_slot      Slot obtained from SPP_OSAL_LoanQueueReserve().
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if p_slot does not belong to this queue or is not
+ *         currently reserved (e.g. already committed).
+ */
+retval_t SPP_OSAL_LoanQueueCommit(void *p_loanQueue, void *p_slot)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || p_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    uint16_t index;
+
+    if (spp_osal_loan_slot_index(p_lq, p_slot, &index) == 0 ||
+        spp_osal_loan_slot_move(p_lq, index, K_LOAN_SLOT_RESERVED, K_LOAN_SLOT_READY) == 0)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    /* Every index lives in exactly one queue, so this send never waits */
+    if (SPP_OSAL_QueueSend(p_lq->p_readyQueue, &index, 0) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Borrow the oldest committed slot for the consumer to read in place.
+ *
+ * @param[in]  p_loanQueue Loan queue handle.
+ * @param[out] pp_slot     Receives a pointer to the committed payload.
+ * @param[in]  timeout_ms  Maximum wait for a committed slot in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if nothing was committed within the timeout.
+ */
+retval_t SPP_OSAL_LoanQueueBorrow(void *p_loanQueue, void **pp_slot, uint32_t timeout_ms)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || pp_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    uint16_t index;
+
+    if (SPP_OSAL_QueueReceive(p_lq->p_readyQueue, &index, timeout_ms) != SPP_OK)
+    {
+        ret = SPP_NOT_ENOUGH_PACKETS;
+        return ret;
+    }
+
+    __atomic_store_n(&p_lq->slotState[index], K_LOAN_SLOT_BORROWED, __ATOMIC_RELEASE);
+    *pp_slot = (void *)&p_lq->p_slots[(size_t)index * p_lq->itemSize];
+    return ret;
+}
+
+/**
+ * @brief Return a slot to the free list.
+ *
+ * Used by the consumer when done with a borrowed slot, or by the producer to
+ * abandon a reservation without committing it.
+ *
+ * @param[in] p_loanQueue Loan queue handle.
+ * @param[in] p_slot      Borrowed or reserved slot.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if handles are NULL,
+ *         SPP_ERROR if p_slot does not belong to this queue or is neither
+ *         reserved nor borrowed (e.g. already released, or committed but not
+ *         yet borrowed).
+ */
+retval_t SPP_OSAL_LoanQueueRelease(void *p_loanQueue, void *p_slot)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_loanQueue == NULL || p_slot == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    uint16_t index;
+
+    if (spp_osal_loan_slot_index(p_lq, p_slot, &index) == 0 ||
+        (spp_osal_loan_slot_move(p_lq, index, K_LOAN_SLOT_BORROWED, K_LOAN_SLOT_FREE) == 0 &&
+         spp_osal_loan_slot_move(p_lq, index, K_LOAN_SLOT_RESERVED, K_LOAN_SLOT_FREE) == 0))
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    if (SPP_OSAL_QueueSend(p_lq->p_freeQueue, &index, 0) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get the number of committed slots waiting to be borrowed.
+ *
+ * @param[in] p_loanQueue Loan queue handle.
+ * @return Number of committed slots, or 0 if the handle is NULL.
+ */
+uint32_t SPP_OSAL_LoanQueueMessagesWaiting(void *p_loanQueue)
+{
+    if (p_loanQueue == NULL)
+        return 0;
+
+    spp_loan_queue_t *p_lq = (spp_loan_queue_t *)p_loanQueue;
+    return SPP_OSAL_QueueMessagesWaiting(p_lq->p_readyQueue);
+}
+
+/* ============================================================================
+ * Public Functions — Queue Set
+ * ========================================================================= */
+
+/**
+ * @brief Mark a queue set member ready and wake the set's waiter.
+ *
+ * Called by member queues after they receive items and by event groups
+ * after bits are set (internal_posix.h). Must not be called with a member
+ * lock held.
+ *
+ * @param[in] p_set  Queue set.
+ * @param[in] member Index of the member in the set.
+ */
+void spp_posix_queue_set_signal(void *p_set, uint32_t member)
+{
+    spp_queue_set_t *p_qs = (spp_queue_set_t *)p_set;
+
+    pthread_mutex_lock(&p_qs->lock);
+    p_qs->members[member].pending = 1;
+    pthread_cond_broadcast(&p_qs->ready);
+    pthread_mutex_unlock(&p_qs->lock);
+}
+
+/**
+ * @brief Initialize an empty queue set.
+ *
+ * Mirrors the FreeRTOS port, where capacity sizes the backing queue set;
+ * here members are polled under one lock and capacity is only checked for
+ * being non-zero.
+ *
+ * @param[out] p_set    Set control block.
+ * @param[in]  capacity Events the set can hold on target.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_set is NULL,
+ *         SPP_ERROR if capacity is 0.
+ */
+retval_t SPP_OSAL_QueueSetInit(spp_queue_set_t *p_set, uint32_t capacity)
+{
+    if (p_set == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+    if (capacity == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    pthread_mutex_init(&p_set->lock, NULL);
+    spp_posix_cond_init(&p_set->ready);
+    p_set->memberCount = 0;
+    p_set->next = 0;
+    return SPP_OK;
+}
+
+/**
+ * @brief Add a queue to a queue set.
+ *
+ * The queue must be empty and in no other set. Add every member before
+ * the set is used.
+ *
+ * @param[in,out] p_set         Initialized set.
+ * @param[in]     p_queueHandle Queue handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_ERROR if the queue is not empty or already in a set, or the
+ *         set is full, or the handle is stale.
+ */
+retval_t SPP_OSAL_QueueSetAddQueue(spp_queue_set_t *p_set, void *p_queueHandle)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_set == NULL || p_queueHandle == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    PosixQueue_t *q = spp_posix_queue_resolve(p_queueHandle);
+    if (q == NULL)
+    {
+        ret = SPP_ERROR;
+        return ret;
+    }
+
+    pthread_mutex_lock(&p_set->lock);
+    pthread_mutex_lock(&q->lock);
+    if (p_set->memberCount >= QUEUE_SET_MAX_MEMBERS || q->p_set != NULL || q->count != 0u)
+    {
+        ret = SPP_ERROR;
+    }
+    else
+    {
+        spp_queue_set_member_t *p_member = &p_set->members[p_set->memberCount];
+        p_member->p_handle = p_queueHandle;
+        p_member->isEventGroup = 0;
+        p_member->pending = 0;
+        q->p_set = p_set;
+        q->setMember = p_set->memberCount;
+        p_set->memberCount += 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    pthread_mutex_unlock(&p_set->lock);
+
+    return ret;
+}
+
+/**
+ * @brief Add an event group to a queue set.
+ *
+ * The group is reported once per burst of OSAL_EventGroupSetBitsFromISR()
+ * calls, as on target; read its bits with OSAL_EventGroupWaitBits() and a
+ * zero timeout.
+ *
+ * @param[in,out] p_set        Initialized set.
+ * @param[in]     p_eventGroup Event group handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_ERROR if the group is already in a set or the set is full.
+ */
+retval_t SPP_OSAL_QueueSetAddEventGroup(spp_queue_set_t *p_set, void *p_eventGroup)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_set == NULL || p_eventGroup == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    pthread_mutex_lock(&p_set->lock);
+    if (p_set->memberCount >= QUEUE_SET_MAX_MEMBERS ||
+        spp_posix_eventgroup_join_set(p_eventGroup, p_set, p_set->memberCount) != SPP_OK)
+    {
+        ret = SPP_ERROR;
+    }
+    else
+    {
+        spp_queue_set_member_t *p_member = &p_set->members[p_set->memberCount];
+        p_member->p_handle = p_eventGroup;
+        p_member->isEventGroup = 1;
+        p_member->pending = 0;
+        p_set->memberCount += 1;
+    }
+    pthread_mutex_unlock(&p_set->lock);
+
+    return ret;
+}
+
+/**
+ * @brief Block until a member of a queue set is ready.
+ *
+ * Members are checked round-robin from the one after the last returned,
+ * so a busy queue cannot starve the others. A returned queue holds at
+ * least one item; a returned event group had bits set since it was last
+ * returned. Unlike the FreeRTOS port, a queue with several items is
+ * reported until it is drained rather than once per item.
+ *
+ * @param[in]  p_set      Initialized set.
+ * @param[in]  timeout_ms Maximum wait time in milliseconds (0 = no wait).
+ * @param[out] pp_member  Receives the queue or event group handle.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if an argument is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if no member became ready within the timeout.
+ */
+retval_t SPP_OSAL_QueueSetSelect(spp_queue_set_t *p_set, uint32_t timeout_ms, void **pp_member)
+{
+    struct timespec deadline;
+    int err = 0;
+
+    if (p_set == NULL || pp_member == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    *pp_member = NULL;
+    if (timeout_ms != 0u)
+    {
+        spp_posix_deadline(timeout_ms, &deadline);
+    }
+
+    pthread_mutex_lock(&p_set->lock);
+    pthread_cleanup_push(spp_posix_unlock_cleanup, &p_set->lock);
+    for (;;)
+    {
+        for (uint32_t n = 0; n < p_set->memberCount && *pp_member == NULL; n++)
+        {
+            uint32_t i = (p_set->next + n) % p_set->memberCount;
+            spp_queue_set_member_t *p_member = &p_set->members[i];
+            int ready = p_member->pending;
+
+            if (p_member->isEventGroup == 0u)
+            {
+                PosixQueue_t *q = spp_posix_queue_resolve(p_member->p_handle);
+                ready = 0;
+                if (q != NULL)
+                {
+                    pthread_mutex_lock(&q->lock);
+                    ready = (q->count != 0u);
+                    pthread_mutex_unlock(&q->lock);
+                }
+            }
+            if (ready != 0)
+            {
+                p_member->pending = 0;
+                p_set->next = (i + 1u) % p_set->memberCount;
+                *pp_member = p_member->p_handle;
+            }
+        }
+        if (*pp_member != NULL || timeout_ms == 0u || err == ETIMEDOUT)
+        {
+            break;
+        }
+        err = pthread_cond_timedwait(&p_set->ready, &p_set->lock, &deadline);
+    }
+    pthread_cleanup_pop(0);
+    pthread_mutex_unlock(&p_set->lock);
+
+    return (*pp_member != NULL) ? SPP_OK : SPP_NOT_ENOUGH_PACKETS;
+}
+
+/**
+ * @brief Tear down a queue set.
+ *
+ * Detaches every member and destroys the set's lock and condition
+ * variable. The members themselves are left alive and can join another
+ * set. As on target, member queues must be drained first and no thread
+ * may be in SPP_OSAL_QueueSetSelect() or sending to a member.
+ *
+ * @param[in,out] p_set Initialized set; must be initialized again before reuse.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_set is NULL,
+ *         SPP_ERROR if a member queue still holds items. Nothing is torn
+ *         down on error.
+ */
+retval_t SPP_OSAL_QueueSetDelete(spp_queue_set_t *p_set)
+{
+    retval_t ret = SPP_OK;
+
+    if (p_set == NULL)
+    {
+        ret = SPP_ERROR_NULL_POINTER;
+        return ret;
+    }
+
+    pthread_mutex_lock(&p_set->lock);
+    for (uint32_t i = 0; i < p_set->memberCount && ret == SPP_OK; i++)
+    {
+        if (p_set->members[i].isEventGroup == 0u)
+        {
+            PosixQueue_t *q = spp_posix_queue_resolve(p_set->members[i].p_handle);
+            if (q != NULL)
+            {
+                pthread_mutex_lock(&q->lock);
+                if (q->count != 0u)
+                {
+                    ret = SPP_ERROR;
+                }
+                pthread_mutex_unlock(&q->lock);
+            }
+        }
+    }
+    if (ret != SPP_OK)
+    {
+        pthread_mutex_unlock(&p_set->lock);
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < p_set->memberCount; i++)
+    {
+        spp_queue_set_member_t *p_member = &p_set->members[i];
+        if (p_member->isEventGroup != 0u)
+        {
+            spp_posix_eventgroup_leave_set(p_member->p_handle, p_set);
+        }
+        else
+        {
+            PosixQueue_t *q = spp_posix_queue_resolve(p_member->p_handle);
+            if (q != NULL)
+            {
+                pthread_mutex_lock(&q->lock);
+                if (q->p_set == p_set)
+                {
+                    q->p_set = NULL;
+                    q->setMember = 0;
+                }
+                pthread_mutex_unlock(&q->lock);
+            }
+        }
+        p_member->p_handle = NULL;
+        p_member->pending = 0;
+    }
+    p_set->memberCount = 0;
+    p_set->next = 0;
+    pthread_mutex_unlock(&p_set->lock);
+
+    pthread_cond_destroy(&p_set->ready);
+    pthread_mutex_destroy(&p_set->lock);
+    return ret;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file spsc.c
+ * @brief POSIX OSAL single-producer/single-consumer ring implementation.
+ *
+ * The fast path matches the FreeRTOS port: each side owns one index and
+ * publishes it with release semantics. A side that has to wait registers
+ * itself in a waiter count before sleeping on the ring's condition
+ * variable; the opposite side only takes the mutex when that count is
+ * non-zero.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "internal_posix.h"
+#include "spsc.h"
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Copy one item into the ring if there is space.
+ *
+ * @param[in] p_ring Ring control block.
+ * @param[in] p_item Item to copy in.
+ * @return 1 if the item was stored, 0 if the ring is full.
+ */
+static int spp_spsc_try_push(spp_spsc_t *p_ring, const void *p_item)
+{
+    uint32_t head = p_ring->head;
+    uint32_t tail = __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+
+    if ((head - tail) > p_ring->mask)
+        return 0;
+
+    memcpy(&p_ring->p_storage[(head & p_ring->mask) * p_ring->itemSize], p_item,
+           p_ring->itemSize);
+    __atomic_store_n(&p_ring->head, head + 1u, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * @brief Copy one item out of the ring if it is not empty.
+ *
+ * @param[in]  p_ring    Ring control block.
+ * @param[out] p_outItem Receives the item.
+ * @return 1 if an item was read, 0 if the ring is empty.
+ */
+static int spp_spsc_try_pop(spp_spsc_t *p_ring, void *p_outItem)
+{
+    uint32_t tail = p_ring->tail;
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail)
+        return 0;
+
+    memcpy(p_outItem, &p_ring->p_storage[(tail & p_ring->mask) * p_ring->itemSize],
+           p_ring->itemSize);
+    __atomic_store_n(&p_ring->tail, tail + 1u, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * @brief Wake the opposite side if it is parked.
+ *
+ * @param[in] p_ring Ring control block.
+ */
+static void spp_spsc_wake(spp_spsc_t *p_ring)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&p_ring->waiters, __ATOMIC_RELAXED) != 0u)
+    {
+        pthread_mutex_lock(&p_ring->lock);
+        pthread_cond_broadcast(&p_ring->wake);
+        pthread_mutex_unlock(&p_ring->lock);
+    }
+}
+
+/**
+ * @brief Block until the ring changes or the deadline passes.
+ *
+ * @param[in] p_ring            Ring control block.
+ * @param[in] blocked_when_full 1 when waiting for space, 0 when waiting for data.
+ * @param[in] p_deadline        Absolute CLOCK_MONOTONIC deadline.
+ * @return 1 if the caller should retry, 0 if the deadline passed.
+ */
+static int spp_spsc_block(spp_spsc_t *p_ring, int blocked_when_full,
+                          const struct timespec *p_deadline)
+{
+    int err = 0;
+
+    __atomic_add_fetch(&p_ring->waiters, 1u, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&p_ring->lock);
+    pthread_cleanup_push(spp_posix_unlock_cleanup, &p_ring->lock);
+    for (;;)
+    {
+        uint32_t count = SPP_OSAL_SpscCount(p_ring);
+        int stillBlocked = blocked_when_full ? (count > p_ring->mask) : (count == 0u);
+        if (stillBlocked == 0 || err == ETIMEDOUT)
+            break;
+        err = pthread_cond_timedwait(&p_ring->wake, &p_ring->lock, p_deadline);
+    }
+    pthread_cleanup_pop(1);
+    __atomic_sub_fetch(&p_ring->waiters, 1u, __ATOMIC_SEQ_CST);
+
+    return (err == ETIMEDOUT) ? 0 : 1;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Initialize an SPSC ring over caller-provided storage.
+ *
+ * @param[out] p_ring    Ring control block to initialize.
+ * @param[in]  p_storage Storage of capacity * item_size bytes.
+ * @param[in]  capacity  Number of items; must be a power of two.
+ * @param[in]  item_size Size of each item in bytes.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if capacity is not a power of two or item_size is 0.
+ */
+retval_t SPP_OSAL_SpscInit(spp_spsc_t *p_ring, uint8_t *p_storage, uint32_t capacity,
+                           uint32_t item_size)
+{
+    if (p_ring == NULL || p_storage == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    if (capacity == 0u || (capacity & (capacity - 1u)) != 0u || item_size == 0u)
+    {
+        return SPP_ERROR;
+    }
+
+    p_ring->p_storage = p_storage;
+    p_ring->mask = capacity - 1u;
+    p_ring->itemSize = item_size;
+    p_ring->head = 0;
+    p_ring->tail = 0;
+    p_ring->waiters = 0;
+    pthread_mutex_init(&p_ring->lock, NULL);
+    spp_posix_cond_init(&p_ring->wake);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Push an item from task context.
+ *
+ * @param[in] p_ring     Ring control block.
+ * @param[in] p_item     Item to copy into the ring.
+ * @param[in] timeout_ms Maximum time to wait for space in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the ring stayed full for the whole timeout.
+ */
+retval_t SPP_OSAL_SpscPush(spp_spsc_t *p_ring, const void *p_item, uint32_t timeout_ms)
+{
+    if (p_ring == NULL || p_item == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    struct timespec deadline;
+    spp_posix_deadline(timeout_ms, &deadline);
+
+    /* After a timeout, one last attempt catches space freed at the deadline */
+    int timedOut = (timeout_ms == 0u) ? 1 : 0;
+    for (;;)
+    {
+        if (spp_spsc_try_push(p_ring, p_item) != 0)
+        {
+            spp_spsc_wake(p_ring);
+            return SPP_OK;
+        }
+
+        if (timedOut != 0)
+        {
+            break;
+        }
+        timedOut = spp_spsc_block(p_ring, 1, &deadline) ? 0 : 1;
+    }
+
+    return SPP_ERROR;
+}
+
+/**
+ * @brief Pop an item from task context.
+ *
+ * @param[in]  p_ring     Ring control block.
+ * @param[out] p_outItem  Receives the item.
+ * @param[in]  timeout_ms Maximum time to wait for data in milliseconds.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if the ring stayed empty for the whole
+ *         timeout.
+ */
+retval_t SPP_OSAL_SpscPop(spp_spsc_t *p_ring, void *p_outItem, uint32_t timeout_ms)
+{
+    if (p_ring == NULL || p_outItem == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    struct timespec deadline;
+    spp_posix_deadline(timeout_ms, &deadline);
+
+    /* After a timeout, one last attempt catches data pushed at the deadline */
+    int timedOut = (timeout_ms == 0u) ? 1 : 0;
+    for (;;)
+    {
+        if (spp_spsc_try_pop(p_ring, p_outItem) != 0)
+        {
+            spp_spsc_wake(p_ring);
+            return SPP_OK;
+        }
+
+        if (timedOut != 0)
+        {
+            break;
+        }
+        timedOut = spp_spsc_block(p_ring, 0, &deadline) ? 0 : 1;
+    }
+
+    return SPP_NOT_ENOUGH_PACKETS;
+}
+
+/**
+ * @brief Push an item without blocking (simulated ISR context).
+ *
+ * @param[in]  p_ring                    Ring control block.
+ * @param[in]  p_item                    Item to copy into the ring.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0 (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_ERROR if the ring is full.
+ */
+retval_t SPP_OSAL_SpscPushFromISR(spp_spsc_t *p_ring, const void *p_item,
+                                  spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+
+    return SPP_OSAL_SpscPush(p_ring, p_item, 0u);
+}
+
+/**
+ * @brief Pop an item without blocking (simulated ISR context).
+ *
+ * @param[in]  p_ring                    Ring control block.
+ * @param[out] p_outItem                 Receives the item.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0 (may be NULL).
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if a pointer is NULL,
+ *         SPP_NOT_ENOUGH_PACKETS if the ring is empty.
+ */
+retval_t SPP_OSAL_SpscPopFromISR(spp_spsc_t *p_ring, void *p_outItem,
+                                 spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+
+    return SPP_OSAL_SpscPop(p_ring, p_outItem, 0u);
+}
+
+/**
+ * @brief Get the number of items currently stored in the ring.
+ *
+ * Exact when called by the producer or the consumer; a snapshot otherwise.
+ *
+ * @param[in] p_ring Ring control block.
+ * @return Number of queued items, or 0 if p_ring is NULL.
+ */
+uint32_t SPP_OSAL_SpscCount(const spp_spsc_t *p_ring)
+{
+    if (p_ring == NULL)
+        return 0;
+
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
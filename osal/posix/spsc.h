@@ -0,0 +1,59 @@
+/**
+ * @file spsc.h
+ * @brief POSIX OSAL single-producer/single-consumer ring buffer.
+ *
+ * Same contract as the FreeRTOS port: a wait-free ring for exactly one
+ * producer and one consumer with caller-provided storage. Blocking is
+ * emulated with a per-ring condition variable that is only touched when a
+ * side actually has to wait.
+ */
+
+#ifndef SPSC_H
+#define SPSC_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief SPSC ring control block.
+ *
+ * Allocate statically and initialize with SPP_OSAL_SpscInit(). Fields are
+ * private to spsc.c.
+ */
+typedef struct
+{
+    uint8_t *p_storage;            /**< capacity * item_size bytes. */
+    uint32_t mask;                 /**< capacity - 1. */
+    uint32_t itemSize;             /**< Size of one item in bytes. */
+    volatile uint32_t head;        /**< Next write index (producer owned). */
+    volatile uint32_t tail;        /**< Next read index (consumer owned). */
+    volatile uint32_t waiters;     /**< Number of sides parked on wake. */
+    pthread_mutex_t lock;          /**< Protects the slow path only. */
+    pthread_cond_t wake;           /**< Signalled when a parked side may proceed. */
+} spp_spsc_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+retval_t SPP_OSAL_SpscInit(spp_spsc_t *p_ring, uint8_t *p_storage, uint32_t capacity,
+                           uint32_t item_size);
+retval_t SPP_OSAL_SpscPush(spp_spsc_t *p_ring, const void *p_item, uint32_t timeout_ms);
+retval_t SPP_OSAL_SpscPop(spp_spsc_t *p_ring, void *p_outItem, uint32_t timeout_ms);
+retval_t SPP_OSAL_SpscPushFromISR(spp_spsc_t *p_ring, const void *p_item,
+                                  spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_SpscPopFromISR(spp_spsc_t *p_ring, void *p_outItem,
+                                 spp_uint8_t *p_higherPriorityTaskWoken);
+uint32_t SPP_OSAL_SpscCount(const spp_spsc_t *p_ring);
+
+#endif /* SPSC_H */
@@ -0,0 +1,421 @@
+/**
+ * @file task.c
+ * @brief POSIX OSAL task implementation for the SPP framework.
+ *
+ * Maps SPP tasks onto detached pthreads so the protocol stack can run on a
+ * host machine. Task storage comes from a pre-allocated pool whose slots are
+ * reused once their thread has finished, and handles are generation-checked
+ * (handlepool.h), mirroring the FreeRTOS port. Priorities are recorded but
+ * not applied, because real-time scheduling classes need elevated
+ * privileges on most hosts. Task notifications are a per-task bit mask
+ * guarded by a mutex and condvar.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include "spp/osal/task.h"
+#include "spp/core/types.h"
+#include "spp/core/macros.h"
+#include "macros_posix.h"
+#include "internal_posix.h"
+#include "handlepool.h"
+#include "task_ext.h"
+#include "trace.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Maximum task name length, including the terminator. */
+#define K_MAX_TASK_NAME 16
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/** @brief Task entry function signature expected by SPP. */
+typedef void (*TaskFunction_t)(void *);
+
+/**
+ * @brief Storage for a single POSIX task.
+ */
+typedef struct
+{
+    pthread_t thread;
+    TaskFunction_t p_function;
+    void *p_custom_data;
+    spp_uint32_t priority;
+    char name[K_MAX_TASK_NAME];
+    spp_uint32_t notifyBits;
+    spp_uint8_t notifyPending;
+    pthread_cond_t notified;
+    void *p_handle;
+    spp_uint8_t created; /**< Thread started and not yet finished. */
+} TaskStorage_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+/** @brief Pool of pre-allocated task storage slots, indexed like s_taskHandles. */
+static TaskStorage_t s_taskPool[NUM_TASKS];
+
+/** @brief Handle slots; allocating one reserves the storage slot of the same index. */
+static spp_handle_slot_t s_taskHandleSlots[NUM_TASKS];
+
+/** @brief Task handle pool. */
+static spp_handle_pool_t s_taskHandles =
+    SPP_HANDLE_POOL_INITIALIZER(SPP_HANDLE_TYPE_TASK, s_taskHandleSlots, NUM_TASKS);
+
+/**
+ * @brief Protects the notification state of every task, and the start and
+ *        release of task slots.
+ */
+static pthread_mutex_t s_notifyLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** @brief Storage of the calling task, NULL on threads not created by the OSAL. */
+static __thread TaskStorage_t *s_currentTask = NULL;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Return the slot of a finished task to the pool.
+ *
+ * Runs as a pthread cleanup handler, so it covers a return from the task
+ * function, SPP_OSAL_TaskDelete() on itself and cancellation alike.
+ * Releasing the handle bumps its generation, so copies of it still held by
+ * the application are rejected from now on.
+ *
+ * @param[in] p_arg Pointer to the TaskStorage_t of the task.
+ */
+static void spp_posix_task_release(void *p_arg)
+{
+    TaskStorage_t *p_taskStorage = (TaskStorage_t *)p_arg;
+
+    pthread_mutex_lock(&s_notifyLock);
+    p_taskStorage->created = 0;
+    (void)SPP_OSAL_HandleFree(&s_taskHandles, p_taskStorage->p_handle);
+    pthread_cond_destroy(&p_taskStorage->notified);
+    pthread_mutex_unlock(&s_notifyLock);
+
+    s_currentTask = NULL;
+}
+
+/**
+ * @brief pthread entry point that invokes the SPP task function.
+ *
+ * @param[in] p_arg Pointer to the TaskStorage_t of the task.
+ * @return Always NULL.
+ */
+static void *spp_posix_task_entry(void *p_arg)
+{
+    TaskStorage_t *p_taskStorage = (TaskStorage_t *)p_arg;
+
+    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), p_taskStorage->name);
+#endif
+    s_currentTask = p_taskStorage;
+
+    pthread_cleanup_push(spp_posix_task_release, p_taskStorage);
+    p_taskStorage->p_function(p_taskStorage->p_custom_data);
+    pthread_cleanup_pop(1);
+    return NULL;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Allocate a task storage slot from the static pool.
+ *
+ * Slots of finished or deleted tasks are reused. The slot's handle is
+ * reserved here and returned by SPP_OSAL_TaskCreate().
+ *
+ * @return Pointer to the allocated TaskStorage_t, or NULL if the pool is
+ *         exhausted.
+ */
+void *SPP_OSAL_GetTaskStorage()
+{
+    spp_uint32_t index = 0;
+    void *p_handle = SPP_OSAL_HandleAlloc(&s_taskHandles, NULL, &index);
+
+    if (p_handle == NULL)
+    {
+        return NULL;
+    }
+
+    TaskStorage_t *p_taskStorage = &s_taskPool[index];
+    p_taskStorage->p_handle = p_handle;
+    p_taskStorage->created = 0;
+    (void)SPP_OSAL_HandleSetObject(&s_taskHandles, p_handle, p_taskStorage);
+
+    return p_taskStorage;
+}
+
+/**
+ * @brief Create a new task backed by a detached pthread.
+ *
+ * @param[in] p_function   Task entry function pointer.
+ * @param[in] task_name    Human-readable task name string.
+ * @param[in] stack_depth  Requested stack depth in words; raised to
+ *                         POSIX_MIN_STACK_BYTES when smaller.
+ * @param[in] p_custom_data Opaque pointer passed to the task function.
+ * @param[in] priority     Task priority (recorded only).
+ * @param[in] p_storage    Pointer to a TaskStorage_t obtained from
+ *                         SPP_OSAL_GetTaskStorage().
+ * @return Generation-checked task handle, or NULL on failure.
+ */
+void *SPP_OSAL_TaskCreate(void *p_function, const char *const task_name, const uint32_t stack_depth,
+                          void *const p_custom_data, spp_uint32_t priority, void *p_storage)
+{
+    if (p_function == NULL || task_name == NULL || p_storage == NULL)
+    {
+        return NULL;
+    }
+
+    TaskStorage_t *p_taskStorage = (TaskStorage_t *)p_storage;
+    if (p_taskStorage->created != 0u)
+    {
+        return NULL;
+    }
+
+    p_taskStorage->p_function = (TaskFunction_t)p_function;
+    p_taskStorage->p_custom_data = p_custom_data;
+    p_taskStorage->priority = priority;
+    strncpy(p_taskStorage->name, task_name, K_MAX_TASK_NAME - 1);
+    p_taskStorage->name[K_MAX_TASK_NAME - 1] = '\0';
+    p_taskStorage->notifyBits = 0;
+    p_taskStorage->notifyPending = 0;
+    spp_posix_cond_init(&p_taskStorage->notified);
+
+    size_t stackBytes = (size_t)stack_depth * sizeof(void *);
+    if (stackBytes < POSIX_MIN_STACK_BYTES)
+    {
+        stackBytes = POSIX_MIN_STACK_BYTES;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&attr, stackBytes);
+
+    SPP_TRACE_NAME(p_taskStorage->p_handle, p_taskStorage->name);
+
+    /* Held across the create so the thread cannot release its slot before
+     * the slot is marked created and its thread id is stored */
+    pthread_mutex_lock(&s_notifyLock);
+    int err = pthread_create(&p_taskStorage->thread, &attr, spp_posix_task_entry, p_taskStorage);
+    if (err == 0)
+    {
+        p_taskStorage->created = 1;
+    }
+    pthread_mutex_unlock(&s_notifyLock);
+    pthread_attr_destroy(&attr);
+    if (err != 0)
+    {
+        pthread_cond_destroy(&p_taskStorage->notified);
+        return NULL;
+    }
+
+    SPP_TRACE_INSTANT(SPP_TRACE_EV_TASK_CREATE, p_taskStorage->p_handle, priority);
+
+    void *p_taskHandle = p_taskStorage->p_handle;
+    return p_taskHandle;
+}
+
+/**
+ * @brief Delete a task.
+ *
+ * If p_task is NULL or contains a NULL handle, the calling task exits.
+ * Other tasks are cancelled; cancellation takes effect the next time the
+ * target blocks in an OSAL call or delay. The slot returns to the pool once
+ * the thread has finished.
+ *
+ * @param[in] p_task Pointer to the task handle, or NULL to delete the
+ *                   calling task.
+ * @return SPP_OK on success (if the calling task is deleted, this does not
+ *         return), SPP_ERROR if the handle is stale or was not returned by
+ *         SPP_OSAL_TaskCreate().
+ */
+retval_t SPP_OSAL_TaskDelete(void *p_task)
+{
+    if (p_task == NULL)
+    {
+        pthread_exit(NULL);
+    }
+
+    void *p_handle = *(void **)p_task;
+
+    /* If caller passed a NULL handle inside the pointer, delete current task */
+    if (p_handle == NULL)
+    {
+        pthread_exit(NULL);
+    }
+
+    /* The lock keeps the thread from finishing, and its slot from being
+     * reused, between the lookup and the cancel */
+    pthread_mutex_lock(&s_notifyLock);
+    TaskStorage_t *p_taskStorage = SPP_OSAL_HandleResolve(&s_taskHandles, p_handle);
+    if (p_taskStorage == NULL || p_taskStorage->created == 0u)
+    {
+        pthread_mutex_unlock(&s_notifyLock);
+        return SPP_ERROR;
+    }
+
+    if (pthread_equal(p_taskStorage->thread, pthread_self()))
+    {
+        pthread_mutex_unlock(&s_notifyLock);
+        pthread_exit(NULL);
+    }
+
+    pthread_cancel(p_taskStorage->thread);
+    pthread_mutex_unlock(&s_notifyLock);
+    return SPP_OK;
+}
+
+/**
+ * @brief Delay the calling task for a specified number of milliseconds.
+ *
+ * Sleeps on CLOCK_MONOTONIC and resumes after signal interruptions.
+ *
+ * @param[in] blocktime_ms Delay duration in milliseconds.
+ */
+void SPP_OSAL_TaskDelay(spp_uint32_t blocktime_ms)
+{
+    if (blocktime_ms == 0u)
+    {
+        /* Same as vTaskDelay(0): give up the CPU without sleeping */
+        SPP_TRACE_INSTANT(SPP_TRACE_EV_TASK_DELAY, 0u, 0u);
+        sched_yield();
+        pthread_testcancel();
+        return;
+    }
+
+    struct timespec deadline;
+    spp_posix_deadline(blocktime_ms, &deadline);
+
+    SPP_TRACE_BEGIN(SPP_TRACE_EV_TASK_DELAY, 0u, blocktime_ms);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+    {
+    }
+    SPP_TRACE_END(SPP_TRACE_EV_TASK_DELAY, 0u, blocktime_ms);
+}
+
+/**
+ * @brief Get the handle of the calling task.
+ *
+ * @return Handle as returned by SPP_OSAL_TaskCreate(), or NULL if the
+ *         caller was not created through the OSAL.
+ */
+void *SPP_OSAL_TaskGetCurrent(void)
+{
+    TaskStorage_t *p_taskStorage = s_currentTask;
+
+    return (p_taskStorage != NULL) ? p_taskStorage->p_handle : NULL;
+}
+
+/**
+ * @brief Wake a task, OR-ing bits into its notification value.
+ *
+ * Callable from any thread, including simulated interrupt sources.
+ *
+ * @param[in]  p_task                    Task handle from SPP_OSAL_TaskCreate().
+ * @param[in]  bits                      Bits to set in the notification value.
+ * @param[out] p_higherPriorityTaskWoken Always set to 0; there is nothing to
+ *                                       yield to on the host.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_task is NULL,
+ *         SPP_ERROR if the handle is stale or the task is not running.
+ */
+retval_t SPP_OSAL_TaskNotifyFromISR(void *p_task, spp_uint32_t bits,
+                                    spp_uint8_t *p_higherPriorityTaskWoken)
+{
+    if (p_higherPriorityTaskWoken != NULL)
+    {
+        *p_higherPriorityTaskWoken = 0;
+    }
+    if (p_task == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&s_notifyLock);
+    TaskStorage_t *p_taskStorage = SPP_OSAL_HandleResolve(&s_taskHandles, p_task);
+    if (p_taskStorage == NULL || p_taskStorage->created == 0u)
+    {
+        pthread_mutex_unlock(&s_notifyLock);
+        return SPP_ERROR;
+    }
+    p_taskStorage->notifyBits |= bits;
+    p_taskStorage->notifyPending = 1;
+    pthread_cond_signal(&p_taskStorage->notified);
+    pthread_mutex_unlock(&s_notifyLock);
+
+    return SPP_OK;
+}
+
+/**
+ * @brief Wait for a notification sent to the calling task.
+ *
+ * Collects and clears every bit set since the previous wait.
+ *
+ * @param[in]  timeout_ms Maximum wait time in milliseconds (0 = no wait).
+ * @param[out] p_bits     Receives the collected bits (may be NULL).
+ * @return SPP_OK if a notification arrived, SPP_ERROR on timeout or if the
+ *         caller was not created through the OSAL.
+ */
+retval_t SPP_OSAL_TaskNotifyWait(spp_uint32_t timeout_ms, spp_uint32_t *p_bits)
+{
+    TaskStorage_t *p_taskStorage = s_currentTask;
+    spp_uint32_t bits = 0;
+    retval_t ret = SPP_ERROR;
+
+    if (p_bits != NULL)
+    {
+        *p_bits = 0;
+    }
+    if (p_taskStorage == NULL)
+    {
+        return SPP_ERROR;
+    }
+
+    pthread_mutex_lock(&s_notifyLock);
+    if (p_taskStorage->notifyPending == 0u && timeout_ms != 0u)
+    {
+        struct timespec deadline;
+        spp_posix_deadline(timeout_ms, &deadline);
+
+        int err = 0;
+        pthread_cleanup_push(spp_posix_unlock_cleanup, &s_notifyLock);
+        while (p_taskStorage->notifyPending == 0u && err != ETIMEDOUT)
+        {
+            err = pthread_cond_timedwait(&p_taskStorage->notified, &s_notifyLock, &deadline);
+        }
+        pthread_cleanup_pop(0);
+    }
+
+    if (p_taskStorage->notifyPending != 0u)
+    {
+        bits = p_taskStorage->notifyBits;
+        p_taskStorage->notifyBits = 0;
+        p_taskStorage->notifyPending = 0;
+        ret = SPP_OK;
+    }
+    pthread_mutex_unlock(&s_notifyLock);
+
+    if (p_bits != NULL)
+    {
+        *p_bits = bits;
+    }
+    return ret;
+}
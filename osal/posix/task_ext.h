@@ -0,0 +1,36 @@
+/**
+ * @file task_ext.h
+ * @brief OSAL task extensions beyond the core SPP task interface.
+ *
+ * Direct task notifications, mirroring the FreeRTOS port so code that
+ * wakes a task from a (simulated) interrupt runs unchanged on the host.
+ */
+
+#ifndef TASK_EXT_H
+#define TASK_EXT_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Non-zero if the SPP_OSAL_TaskNotify* calls are available in this build. */
+#define SPP_OSAL_TASK_NOTIFY 1
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void *SPP_OSAL_TaskGetCurrent(void);
+retval_t SPP_OSAL_TaskNotifyFromISR(void *p_task, spp_uint32_t bits,
+                                    spp_uint8_t *p_higherPriorityTaskWoken);
+retval_t SPP_OSAL_TaskNotifyWait(spp_uint32_t timeout_ms, spp_uint32_t *p_bits);
+
+#endif /* TASK_EXT_H */
@@ -0,0 +1,273 @@
+/**
+ * @file trace.c
+ * @brief POSIX OSAL binary trace rings.
+ *
+ * Mirrors the FreeRTOS port: one ring per SPP_TRACE_CORES, picked from the
+ * host CPU the calling thread runs on, with slots claimed by an atomic
+ * increment of the ring head. Timestamps are CLOCK_MONOTONIC microseconds.
+ * The task id is the OSAL task handle, where the FreeRTOS port records the
+ * TCB pointer (see tracefmt.h): dumps share one format, but task ids do
+ * not match across ports. With SPP_TRACE_ENABLED at 0 only stubs remain.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "macros_posix.h"
+#include "task_ext.h"
+#include "trace.h"
+
+#if SPP_TRACE_ENABLED
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Timestamp ticks per second. */
+#define K_TICK_HZ 1000000u
+
+_Static_assert((SPP_TRACE_RING_EVENTS & (SPP_TRACE_RING_EVENTS - 1u)) == 0u,
+               "SPP_TRACE_RING_EVENTS must be a power of two");
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Records of one core.
+ */
+typedef struct
+{
+    uint32_t head; /**< Records ever claimed; slot = head % SPP_TRACE_RING_EVENTS. */
+    spp_trace_event_t events[SPP_TRACE_RING_EVENTS];
+} TraceRing_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static TraceRing_t s_rings[SPP_TRACE_CORES];
+
+static spp_trace_name_t s_names[SPP_TRACE_MAX_NAMES];
+static uint32_t s_nameCount = 0;
+
+/** @brief Next entry to replace once s_names is full. */
+static uint32_t s_nameNext = 0;
+
+/** @brief Copy of s_names taken by SPP_OSAL_TraceWrite() outside the lock. */
+static spp_trace_name_t s_namesOut[SPP_TRACE_MAX_NAMES];
+
+/** @brief Recording on (the default) or paused. */
+static volatile uint8_t s_enabled = 1;
+
+/** @brief Protects the name table. */
+static pthread_mutex_t s_nameLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Record one event into the ring of the calling core.
+ *
+ * Called through the SPP_TRACE_* hooks from any thread. A thread migrated
+ * between CPUs mid-call still writes a whole record into the ring it
+ * claimed.
+ *
+ * @param[in] event  SPP_TRACE_EV_* id.
+ * @param[in] phase  SPP_TRACE_PHASE_*.
+ * @param[in] object Object the call acts on.
+ * @param[in] arg    Event argument; the low 16 bits are kept.
+ */
+void SPP_OSAL_TraceRecord(spp_uint8_t event, spp_uint8_t phase, spp_uint32_t object,
+                          spp_uint32_t arg)
+{
+    struct timespec now;
+
+    if (s_enabled == 0u)
+        return;
+
+    int cpu = sched_getcpu();
+    uint32_t core = (cpu < 0) ? 0u : (uint32_t)cpu % SPP_TRACE_CORES;
+    TraceRing_t *p_ring = &s_rings[core];
+    uint32_t slot =
+        __atomic_fetch_add(&p_ring->head, 1u, __ATOMIC_RELAXED) & (SPP_TRACE_RING_EVENTS - 1u);
+    spp_trace_event_t *p_event = &p_ring->events[slot];
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    p_event->time = (uint32_t)((uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u);
+    p_event->task = (uint32_t)(uintptr_t)SPP_OSAL_TaskGetCurrent();
+    p_event->object = object;
+    p_event->arg = (uint16_t)arg;
+    p_event->event = event;
+    p_event->flags = (uint8_t)((core & SPP_TRACE_CORE_MASK) | phase);
+}
+
+/**
+ * @brief Register the name of a task id for dumps.
+ *
+ * Called by SPP_OSAL_TaskCreate(). Re-registering an id replaces its name;
+ * when the table is full the oldest entry is replaced.
+ *
+ * @param[in] task   Task id as recorded in spp_trace_event_t::task.
+ * @param[in] p_name Task name (truncated).
+ */
+void SPP_OSAL_TraceName(spp_uint32_t task, const char *p_name)
+{
+    if (p_name == NULL)
+        return;
+
+    pthread_mutex_lock(&s_nameLock);
+    spp_trace_name_t *p_entry = NULL;
+    for (uint32_t i = 0; i < s_nameCount && p_entry == NULL; i++)
+    {
+        if (s_names[i].task == task)
+        {
+            p_entry = &s_names[i];
+        }
+    }
+    if (p_entry == NULL && s_nameCount < SPP_TRACE_MAX_NAMES)
+    {
+        p_entry = &s_names[s_nameCount];
+        s_nameCount += 1;
+    }
+    else if (p_entry == NULL)
+    {
+        p_entry = &s_names[s_nameNext];
+        s_nameNext = (s_nameNext + 1u) % SPP_TRACE_MAX_NAMES;
+    }
+    p_entry->task = task;
+    strncpy(p_entry->name, p_name, SPP_TRACE_NAME_LEN - 1u);
+    p_entry->name[SPP_TRACE_NAME_LEN - 1u] = '\0';
+    pthread_mutex_unlock(&s_nameLock);
+}
+
+/**
+ * @brief Pause or resume recording.
+ *
+ * @param[in] enable Non-zero to record.
+ */
+void SPP_OSAL_TraceEnable(spp_uint8_t enable)
+{
+    s_enabled = (enable != 0u) ? 1u : 0u;
+}
+
+/**
+ * @brief Drop every recorded event. Task names are kept.
+ */
+void SPP_OSAL_TraceClear(void)
+{
+    uint8_t was = s_enabled;
+    s_enabled = 0;
+    for (uint32_t c = 0; c < SPP_TRACE_CORES; c++)
+    {
+        __atomic_store_n(&s_rings[c].head, 0u, __ATOMIC_RELAXED);
+    }
+    s_enabled = was;
+}
+
+/**
+ * @brief Write a dump of every ring and the task names (tracefmt.h).
+ *
+ * Recording is paused while the rings are written and restored after; a
+ * record being filled in by another thread at the moment of the pause may
+ * appear half-written.
+ *
+ * @param[in] p_write Sink for the dump bytes.
+ * @param[in] p_ctx   Passed to p_write.
+ * @return SPP_OK on success, SPP_ERROR_NULL_POINTER if p_write is NULL,
+ *         SPP_ERROR if the sink failed.
+ */
+retval_t SPP_OSAL_TraceWrite(spp_trace_write_fn_t p_write, void *p_ctx)
+{
+    spp_trace_file_header_t header;
+    retval_t ret = SPP_OK;
+
+    if (p_write == NULL)
+    {
+        return SPP_ERROR_NULL_POINTER;
+    }
+
+    uint8_t was = s_enabled;
+    s_enabled = 0;
+
+    pthread_mutex_lock(&s_nameLock);
+    uint32_t names = s_nameCount;
+    memcpy(s_namesOut, s_names, sizeof(s_names[0]) * names);
+    pthread_mutex_unlock(&s_nameLock);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SPP_TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = SPP_TRACE_VERSION;
+    header.event_bytes = sizeof(spp_trace_event_t);
+    header.tick_hz = K_TICK_HZ;
+    header.cores = SPP_TRACE_CORES;
+    header.ring_events = SPP_TRACE_RING_EVENTS;
+    header.names = names;
+    ret = p_write(p_ctx, &header, sizeof(header));
+
+    for (uint32_t c = 0; c < SPP_TRACE_CORES && ret == SPP_OK; c++)
+    {
+        spp_trace_ring_header_t ring = {c, __atomic_load_n(&s_rings[c].head, __ATOMIC_RELAXED)};
+        ret = p_write(p_ctx, &ring, sizeof(ring));
+        if (ret == SPP_OK)
+        {
+            ret = p_write(p_ctx, s_rings[c].events, sizeof(s_rings[c].events));
+        }
+    }
+    if (ret == SPP_OK && names != 0u)
+    {
+        ret = p_write(p_ctx, s_namesOut, sizeof(s_namesOut[0]) * names);
+    }
+
+    s_enabled = was;
+    return (ret == SPP_OK) ? SPP_OK : SPP_ERROR;
+}
+
+#else /* SPP_TRACE_ENABLED */
+
+void SPP_OSAL_TraceRecord(spp_uint8_t event, spp_uint8_t phase, spp_uint32_t object,
+                          spp_uint32_t arg)
+{
+    (void)event;
+    (void)phase;
+    (void)object;
+    (void)arg;
+}
+
+void SPP_OSAL_TraceName(spp_uint32_t task, const char *p_name)
+{
+    (void)task;
+    (void)p_name;
+}
+
+void SPP_OSAL_TraceEnable(spp_uint8_t enable)
+{
+    (void)enable;
+}
+
+void SPP_OSAL_TraceClear(void)
+{
+}
+
+/**
+ * @brief Tracing is compiled out: there is nothing to write.
+ *
+ * @return SPP_ERROR.
+ */
+retval_t SPP_OSAL_TraceWrite(spp_trace_write_fn_t p_write, void *p_ctx)
+{
+    (void)p_write;
+    (void)p_ctx;
+    return SPP_ERROR;
+}
+
+#endif /* SPP_TRACE_ENABLED */
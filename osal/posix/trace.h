@@ -0,0 +1,80 @@
+/**
+ * @file trace.h
+ * @brief Compile-time gated binary trace of OSAL and HAL calls.
+ *
+ * Mirrors the FreeRTOS port's trace.h: OSAL and HAL calls of interest
+ * record a 16-byte event (tracefmt.h) into the ring picked by the host CPU
+ * the thread runs on, with CLOCK_MONOTONIC time and the OSAL task handle.
+ * Slots are claimed with an atomic increment; the oldest records are
+ * overwritten. The host has no interrupt context, so events from
+ * simulated ISRs appear on the thread that raised them.
+ *
+ * Hooks compile only with SPP_TRACE_ENABLED (macros_posix.h); otherwise
+ * they expand to nothing and their arguments are not evaluated. Dump the
+ * rings with SPP_OSAL_TraceWrite() (SPP_HAL_Storage_DumpTrace() on the
+ * card) and convert them with tools/spptrace.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "spp/core/types.h"
+#include "spp/core/returntypes.h"
+#include "macros_posix.h"
+#include "tracefmt.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Hooks; object is a pointer or integer, arg is truncated to 16 bits. */
+#if SPP_TRACE_ENABLED
+#define SPP_TRACE_INSTANT(event, object, arg)                                                   \
+    SPP_OSAL_TraceRecord((event), SPP_TRACE_PHASE_INSTANT, (uint32_t)(uintptr_t)(object),       \
+                         (uint32_t)(arg))
+#define SPP_TRACE_BEGIN(event, object, arg)                                                     \
+    SPP_OSAL_TraceRecord((event), SPP_TRACE_PHASE_BEGIN, (uint32_t)(uintptr_t)(object),         \
+                         (uint32_t)(arg))
+#define SPP_TRACE_END(event, object, arg)                                                       \
+    SPP_OSAL_TraceRecord((event), SPP_TRACE_PHASE_END, (uint32_t)(uintptr_t)(object),           \
+                         (uint32_t)(arg))
+#define SPP_TRACE_NAME(task, p_name) SPP_OSAL_TraceName((uint32_t)(uintptr_t)(task), (p_name))
+#else
+#define SPP_TRACE_INSTANT(event, object, arg) ((void)0)
+#define SPP_TRACE_BEGIN(event, object, arg) ((void)0)
+#define SPP_TRACE_END(event, object, arg) ((void)0)
+#define SPP_TRACE_NAME(task, p_name) ((void)0)
+#endif
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief Sink for SPP_OSAL_TraceWrite().
+ *
+ * @param[in] p_ctx  Context given to SPP_OSAL_TraceWrite().
+ * @param[in] p_data Bytes to append.
+ * @param[in] length Number of bytes.
+ * @return SPP_OK if all bytes were written.
+ */
+typedef retval_t (*spp_trace_write_fn_t)(void *p_ctx, const void *p_data, size_t length);
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+void SPP_OSAL_TraceRecord(spp_uint8_t event, spp_uint8_t phase, spp_uint32_t object,
+                          spp_uint32_t arg);
+void SPP_OSAL_TraceName(spp_uint32_t task, const char *p_name);
+void SPP_OSAL_TraceEnable(spp_uint8_t enable);
+void SPP_OSAL_TraceClear(void);
+retval_t SPP_OSAL_TraceWrite(spp_trace_write_fn_t p_write, void *p_ctx);
+
+#endif /* TRACE_H */
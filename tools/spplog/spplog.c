@@ -0,0 +1,461 @@
+/**
+ * @file spplog.c
+ * @brief Host reader for SPP binary telemetry logs.
+ *
+ * Frame validation checks magic, length and CRC straight from the mapping.
+ * Seeking never scans the file: INDEX frames sit just past every multiple
+ * of index_interval and SYNC frames past every multiple of sync_interval,
+ * so "the marker at boundary b" is found by validating frames from b on
+ * for at most a few frames. Binary search over INDEX boundaries picks the
+ * index block, binary search over its entries picks the SYNC frame, and
+ * the log tail that no INDEX covers yet is searched over SYNC boundaries.
+ * Decoding then starts at most sync_interval bytes before the target.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "spplog.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Reflected CRC-32 (IEEE 802.3) polynomial. */
+#define K_CRC32_POLY 0xEDB88320u
+
+/** @brief Frames stepped past the first valid one when looking for a marker. */
+#define K_PROBE_FRAMES 8u
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+/** @brief Slicing-by-8 tables; s_crcTable[0] is the classic byte table. */
+static uint32_t s_crcTable[8][256];
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static void spplog_crc_init(void)
+{
+    for (uint32_t i = 0; i < 256u; i++)
+    {
+        uint32_t entry = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            entry = (entry & 1u) ? (entry >> 1) ^ K_CRC32_POLY : entry >> 1;
+        }
+        s_crcTable[0][i] = entry;
+    }
+    for (uint32_t i = 0; i < 256u; i++)
+    {
+        for (int slice = 1; slice < 8; slice++)
+        {
+            uint32_t prev = s_crcTable[slice - 1][i];
+            s_crcTable[slice][i] = s_crcTable[0][prev & 0xFFu] ^ (prev >> 8);
+        }
+    }
+}
+
+/**
+ * @brief Byte distance a resync may cover before the log is taken to end.
+ *
+ * Valid logs have a SYNC frame in every sync_interval bytes, so a longer
+ * run without any valid frame is unwritten space.
+ */
+static uint64_t spplog_resync_limit(const spplog_t *p_log)
+{
+    return 2u * (uint64_t)p_log->header.sync_interval + p_log->header.max_frame_bytes;
+}
+
+/**
+ * @brief Find the first valid frame at or after offset, within limit bytes.
+ *
+ * @return Offset of the frame, or UINT64_MAX if none.
+ */
+static uint64_t spplog_scan(const spplog_t *p_log, uint64_t offset, uint64_t limit,
+                            spplog_record_t *p_record)
+{
+    const uint8_t magicLo = (uint8_t)(SPP_LOGFMT_FRAME_MAGIC & 0xFFu);
+    uint64_t end = (offset + limit < p_log->size) ? offset + limit : p_log->size;
+
+    while (offset < end)
+    {
+        const uint8_t *p_hit = memchr(p_log->p_base + offset, magicLo, (size_t)(end - offset));
+        if (p_hit == NULL)
+            break;
+
+        offset = (uint64_t)(p_hit - p_log->p_base);
+        if (spplog_frame_at(p_log, offset, p_record) != 0)
+            return offset;
+        offset += 1;
+    }
+
+    return UINT64_MAX;
+}
+
+/**
+ * @brief Find the marker frame of a type written just past a boundary.
+ *
+ * @return 1 if found (p_record filled), 0 if not.
+ */
+static int spplog_probe(const spplog_t *p_log, uint64_t boundary, uint8_t type,
+                        spplog_record_t *p_record)
+{
+    uint64_t offset = (boundary < p_log->header.header_bytes) ? p_log->header.header_bytes : boundary;
+
+    offset = spplog_scan(p_log, offset, 2u * (uint64_t)p_log->header.max_frame_bytes, p_record);
+    for (uint32_t i = 0; offset != UINT64_MAX && i < K_PROBE_FRAMES; i++)
+    {
+        if (p_record->type == type)
+            return 1;
+
+        offset += (uint64_t)p_record->length + SPP_LOGFMT_FRAME_OVERHEAD;
+        if (spplog_frame_at(p_log, offset, p_record) == 0)
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Offset of the last entry of an INDEX frame with a time <= time_us.
+ *
+ * @return The SYNC offset, or UINT64_MAX if every entry is later.
+ */
+static uint64_t spplog_index_lookup(const spplog_record_t *p_index, int64_t time_us)
+{
+    spp_logfmt_index_t index;
+    if (p_index->length < sizeof(index))
+        return UINT64_MAX;
+    memcpy(&index, p_index->p_payload, sizeof(index));
+
+    uint32_t count = (uint32_t)((p_index->length - sizeof(index)) / sizeof(spp_logfmt_index_entry_t));
+    if (index.count < count)
+    {
+        count = index.count;
+    }
+
+    const uint8_t *p_entries = p_index->p_payload + sizeof(index);
+    uint64_t found = UINT64_MAX;
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2u;
+        spp_logfmt_index_entry_t entry;
+        memcpy(&entry, p_entries + (size_t)mid * sizeof(entry), sizeof(entry));
+
+        if (entry.time_us <= time_us)
+        {
+            found = entry.offset;
+            lo = mid + 1u;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return found;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Map a log and validate its header.
+ *
+ * @param[out] p_log  Log to fill.
+ * @param[in]  p_path File to open.
+ * @return SPPLOG_OK, SPPLOG_ERR_IO if the file cannot be mapped, or
+ *         SPPLOG_ERR_FORMAT if it is not a supported log.
+ */
+int spplog_open(spplog_t *p_log, const char *p_path)
+{
+    struct stat st;
+
+    memset(p_log, 0, sizeof(*p_log));
+    p_log->fd = open(p_path, O_RDONLY);
+    if (p_log->fd < 0)
+        return SPPLOG_ERR_IO;
+
+    if (fstat(p_log->fd, &st) != 0)
+    {
+        close(p_log->fd);
+        return SPPLOG_ERR_IO;
+    }
+    if (st.st_size < (off_t)sizeof(spp_logfmt_file_header_t))
+    {
+        close(p_log->fd);
+        return SPPLOG_ERR_FORMAT;
+    }
+
+    void *p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, p_log->fd, 0);
+    if (p_map == MAP_FAILED)
+    {
+        close(p_log->fd);
+        return SPPLOG_ERR_IO;
+    }
+    p_log->p_base = (const uint8_t *)p_map;
+    p_log->size = (uint64_t)st.st_size;
+
+    spp_logfmt_file_header_t *p_header = &p_log->header;
+    memcpy(p_header, p_log->p_base, sizeof(*p_header));
+    uint32_t crc = spplog_crc32(0, p_header, sizeof(*p_header) - sizeof(uint32_t));
+
+    if (memcmp(p_header->magic, SPP_LOGFMT_FILE_MAGIC, sizeof(p_header->magic)) != 0 ||
+        p_header->version != SPP_LOGFMT_VERSION || crc != p_header->crc ||
+        p_header->header_bytes < sizeof(*p_header) || p_header->sync_interval == 0u ||
+        p_header->index_interval < p_header->sync_interval || p_header->max_frame_bytes == 0u ||
+        p_header->max_frame_bytes > SPP_LOGFMT_MAX_FRAME)
+    {
+        spplog_close(p_log);
+        return SPPLOG_ERR_FORMAT;
+    }
+
+    return SPPLOG_OK;
+}
+
+/**
+ * @brief Unmap a log.
+ *
+ * @param[in] p_log Log from spplog_open().
+ */
+void spplog_close(spplog_t *p_log)
+{
+    if (p_log->p_base != NULL)
+    {
+        munmap((void *)p_log->p_base, (size_t)p_log->size);
+        close(p_log->fd);
+    }
+    memset(p_log, 0, sizeof(*p_log));
+}
+
+/**
+ * @brief CRC-32 as the firmware's esp_rom_crc32_le(): pass 0 to start, the
+ *        previous result to continue.
+ */
+uint32_t spplog_crc32(uint32_t crc, const void *p_data, size_t length)
+{
+    const uint8_t *p_bytes = (const uint8_t *)p_data;
+
+    if (s_crcTable[0][1] == 0u)
+    {
+        spplog_crc_init();
+    }
+
+    crc = ~crc;
+    while (length >= 8u)
+    {
+        uint32_t lo;
+        uint32_t hi;
+        memcpy(&lo, p_bytes, sizeof(lo));
+        memcpy(&hi, p_bytes + 4, sizeof(hi));
+        lo ^= crc;
+        crc = s_crcTable[7][lo & 0xFFu] ^ s_crcTable[6][(lo >> 8) & 0xFFu] ^
+              s_crcTable[5][(lo >> 16) & 0xFFu] ^ s_crcTable[4][lo >> 24] ^
+              s_crcTable[3][hi & 0xFFu] ^ s_crcTable[2][(hi >> 8) & 0xFFu] ^
+              s_crcTable[1][(hi >> 16) & 0xFFu] ^ s_crcTable[0][hi >> 24];
+        p_bytes += 8;
+        length -= 8u;
+    }
+    while (length-- > 0u)
+    {
+        crc = s_crcTable[0][(crc ^ *p_bytes++) & 0xFFu] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief Decode the frame at an offset if it is valid for this log.
+ *
+ * @return 1 if a valid frame starts at offset (p_record filled), 0 if not.
+ */
+int spplog_frame_at(const spplog_t *p_log, uint64_t offset, spplog_record_t *p_record)
+{
+    spp_logfmt_frame_t frame;
+
+    if (offset + SPP_LOGFMT_FRAME_OVERHEAD > p_log->size)
+        return 0;
+
+    memcpy(&frame, p_log->p_base + offset, sizeof(frame));
+    uint64_t covered = sizeof(frame) + (uint64_t)frame.length;
+    if (frame.magic != SPP_LOGFMT_FRAME_MAGIC ||
+        covered + sizeof(uint32_t) > p_log->header.max_frame_bytes ||
+        offset + covered + sizeof(uint32_t) > p_log->size)
+        return 0;
+
+    uint32_t crc;
+    memcpy(&crc, p_log->p_base + offset + covered, sizeof(crc));
+    if (spplog_crc32(p_log->header.session, p_log->p_base + offset, (size_t)covered) != crc)
+        return 0;
+
+    p_record->offset = offset;
+    p_record->time_us = frame.time_us;
+    p_record->p_payload = p_log->p_base + offset + sizeof(frame);
+    p_record->length = frame.length;
+    p_record->seq = frame.seq;
+    p_record->type = frame.type;
+    p_record->flags = frame.flags;
+    return 1;
+}
+
+/**
+ * @brief Place a cursor at a frame offset (header_bytes for the first frame).
+ */
+void spplog_cursor_init(spplog_cursor_t *p_cursor, const spplog_t *p_log, uint64_t offset)
+{
+    memset(p_cursor, 0, sizeof(*p_cursor));
+    p_cursor->p_log = p_log;
+    p_cursor->offset = (offset < p_log->header.header_bytes) ? p_log->header.header_bytes : offset;
+}
+
+/**
+ * @brief Decode the next record and advance.
+ *
+ * Damaged data is skipped up to the next valid frame. The log ends at the
+ * end of the file or where no valid frame follows within two sync
+ * intervals (unwritten space of a preallocated file).
+ *
+ * @return SPPLOG_OK with p_record filled, or SPPLOG_END.
+ */
+int spplog_next(spplog_cursor_t *p_cursor, spplog_record_t *p_record)
+{
+    const spplog_t *p_log = p_cursor->p_log;
+
+    while (p_cursor->offset < p_log->size)
+    {
+        if (spplog_frame_at(p_log, p_cursor->offset, p_record) == 0)
+        {
+            uint64_t next = spplog_scan(p_log, p_cursor->offset + 1u, spplog_resync_limit(p_log),
+                                        p_record);
+            if (next == UINT64_MAX)
+            {
+                p_cursor->offset = p_log->size;
+                break;
+            }
+            p_cursor->resyncs += 1;
+            p_cursor->skipped_bytes += next - p_cursor->offset;
+        }
+
+        p_cursor->offset = p_record->offset + p_record->length + SPP_LOGFMT_FRAME_OVERHEAD;
+        if (p_cursor->meta != 0 || p_record->type >= SPP_LOGFMT_TYPE_USER)
+            return SPPLOG_OK;
+    }
+
+    return SPPLOG_END;
+}
+
+/**
+ * @brief Find where to start decoding to reach the first frame at time_us.
+ *
+ * @param[in]  p_log    Open log.
+ * @param[in]  time_us  Target time.
+ * @param[out] p_probes Receives the number of boundary probes (may be NULL).
+ * @return Offset of a frame no later than time_us, or header_bytes.
+ */
+uint64_t spplog_locate(const spplog_t *p_log, int64_t time_us, uint32_t *p_probes)
+{
+    const uint64_t syncInterval = p_log->header.sync_interval;
+    const uint64_t indexInterval = p_log->header.index_interval;
+    uint64_t start = p_log->header.header_bytes;
+    uint32_t probes = 0;
+    spplog_record_t record;
+
+    /* Last INDEX boundary whose following data starts no later than time_us */
+    uint64_t lo = 0;
+    uint64_t hi = p_log->size / indexInterval;
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo + 1u) / 2u;
+        probes += 1;
+        if (spplog_probe(p_log, mid * indexInterval, SPP_LOGFMT_TYPE_INDEX, &record) != 0 &&
+            record.time_us <= time_us)
+        {
+            lo = mid;
+            /* Its last entry is the SYNC before it, so records precede the start */
+            uint64_t last = spplog_index_lookup(&record, time_us);
+            start = (last != UINT64_MAX) ? last : record.offset;
+        }
+        else
+        {
+            hi = mid - 1u;
+        }
+    }
+
+    /* The SYNC entries of that block are in the next INDEX frame */
+    probes += 1;
+    if (spplog_probe(p_log, (lo + 1u) * indexInterval, SPP_LOGFMT_TYPE_INDEX, &record) != 0)
+    {
+        uint64_t found = spplog_index_lookup(&record, time_us);
+        if (found != UINT64_MAX && found > start)
+        {
+            start = found;
+        }
+    }
+    else
+    {
+        /* Log tail not covered by an INDEX frame yet: search its SYNC frames */
+        uint64_t syncLo = lo * indexInterval / syncInterval;
+        uint64_t syncHi = p_log->size / syncInterval;
+        while (syncLo < syncHi)
+        {
+            uint64_t mid = syncLo + (syncHi - syncLo + 1u) / 2u;
+            probes += 1;
+            if (spplog_probe(p_log, mid * syncInterval, SPP_LOGFMT_TYPE_SYNC, &record) != 0 &&
+                record.time_us <= time_us)
+            {
+                syncLo = mid;
+                if (record.offset > start)
+                {
+                    start = record.offset;
+                }
+            }
+            else
+            {
+                syncHi = mid - 1u;
+            }
+        }
+    }
+
+    if (p_probes != NULL)
+    {
+        *p_probes = probes;
+    }
+    return start;
+}
+
+/**
+ * @brief Position a cursor on the first record with a time >= time_us.
+ *
+ * @return SPPLOG_OK if such a record exists, SPPLOG_END (cursor at the end)
+ *         if not.
+ */
+int spplog_seek_time(spplog_cursor_t *p_cursor, int64_t time_us)
+{
+    spplog_record_t record;
+
+    p_cursor->offset = spplog_locate(p_cursor->p_log, time_us, NULL);
+    while (spplog_next(p_cursor, &record) == SPPLOG_OK)
+    {
+        if (record.time_us >= time_us)
+        {
+            p_cursor->offset = record.offset;
+            return SPPLOG_OK;
+        }
+    }
+
+    return SPPLOG_END;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file spplog.h
+ * @brief Host reader for SPP binary telemetry logs (logformat.h).
+ *
+ * Logs are memory-mapped read-only, so multi-GB files open instantly and
+ * only the pages actually decoded are read. A cursor walks frames in file
+ * order, validating each CRC and skipping damaged regions; a time seek
+ * binary-searches the INDEX and SYNC frames and touches O(log n) pages.
+ * Compressed sample blocks (hal/esp32/compress.c) decode with
+ * spplog_block_decode().
+ */
+
+#ifndef SPPLOG_H
+#define SPPLOG_H
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "logformat.h"
+
+/* ============================================================================
+ * Public Constants
+ * ========================================================================= */
+
+/** @brief Result codes. */
+#define SPPLOG_OK 0
+#define SPPLOG_END 1
+#define SPPLOG_ERR_IO (-1)
+#define SPPLOG_ERR_FORMAT (-2)
+
+/** @brief Most samples a compressed block can hold (two bytes per sample minimum). */
+#define SPPLOG_BLOCK_MAX_SAMPLES (SPP_LOGFMT_BLOCK_MAX_PACKED / 2u)
+
+/* ============================================================================
+ * Public Types
+ * ========================================================================= */
+
+/**
+ * @brief An open log.
+ */
+typedef struct
+{
+    int fd;
+    const uint8_t *p_base;           /**< Mapped file. */
+    uint64_t size;                   /**< File size. */
+    spp_logfmt_file_header_t header; /**< Validated file header. */
+} spplog_t;
+
+/**
+ * @brief One decoded frame. p_payload points into the mapping.
+ */
+typedef struct
+{
+    uint64_t offset;          /**< File offset of the frame. */
+    int64_t time_us;          /**< Frame time. */
+    const uint8_t *p_payload; /**< Payload bytes. */
+    uint16_t length;          /**< Payload length. */
+    uint16_t seq;             /**< Frame sequence number. */
+    uint8_t type;             /**< SPP_LOGFMT_TYPE_*. */
+    uint8_t flags;            /**< Frame flags. */
+} spplog_record_t;
+
+/**
+ * @brief Position in a log plus decode counters.
+ */
+typedef struct
+{
+    const spplog_t *p_log;
+    uint64_t offset;        /**< Next frame to decode. */
+    int meta;               /**< Non-zero to return SYNC and INDEX frames too. */
+    uint64_t resyncs;       /**< Damaged regions skipped. */
+    uint64_t skipped_bytes; /**< Bytes skipped in those regions. */
+} spplog_cursor_t;
+
+/**
+ * @brief A decoded compressed sample block (about 150 KiB; not for the stack).
+ */
+typedef struct
+{
+    spp_logfmt_block_t header;
+    int64_t time_us[SPPLOG_BLOCK_MAX_SAMPLES];
+    int32_t values[SPPLOG_BLOCK_MAX_SAMPLES][SPP_LOGFMT_BLOCK_MAX_CHANNELS];
+    uint8_t packed[SPP_LOGFMT_BLOCK_MAX_PACKED]; /**< LZ scratch. */
+} spplog_block_t;
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int spplog_open(spplog_t *p_log, const char *p_path);
+void spplog_close(spplog_t *p_log);
+
+uint32_t spplog_crc32(uint32_t crc, const void *p_data, size_t length);
+int spplog_frame_at(const spplog_t *p_log, uint64_t offset, spplog_record_t *p_record);
+
+void spplog_cursor_init(spplog_cursor_t *p_cursor, const spplog_t *p_log, uint64_t offset);
+int spplog_next(spplog_cursor_t *p_cursor, spplog_record_t *p_record);
+
+uint64_t spplog_locate(const spplog_t *p_log, int64_t time_us, uint32_t *p_probes);
+int spplog_seek_time(spplog_cursor_t *p_cursor, int64_t time_us);
+
+size_t spplog_lz_decode(const uint8_t *p_src, size_t length, uint8_t *p_dst, size_t capacity);
+int spplog_block_decode(const uint8_t *p_payload, size_t length, spplog_block_t *p_block);
+
+#endif /* SPPLOG_H */
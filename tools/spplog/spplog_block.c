@@ -0,0 +1,195 @@
+/**
+ * @file spplog_block.c
+ * @brief Host decoder of compressed sample blocks (spp_logfmt_block_t).
+ *
+ * Inverse of hal/esp32/compress.c: undo the LZ stage if present, then read
+ * back the varints and integrate the differences. Every read is bounds
+ * checked, so a damaged block is rejected instead of decoded into garbage.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <stdint.h>
+#include <string.h>
+#include "spplog.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+#define K_LZ_MIN_MATCH 4u
+#define K_LZ_NIBBLE_MAX 15u
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+/**
+ * @brief Read an LZ length extension.
+ *
+ * @return 1 on success, 0 if the input ends first.
+ */
+static int spplog_lz_length(const uint8_t **pp_src, const uint8_t *p_end, size_t *p_length)
+{
+    for (;;)
+    {
+        if (*pp_src >= p_end)
+            return 0;
+        uint8_t step = *(*pp_src)++;
+        *p_length += step;
+        if (step != 255u)
+            return 1;
+    }
+}
+
+/**
+ * @brief Read one zigzag LEB128 varint.
+ *
+ * @return 1 on success, 0 if it runs past p_end or is too long.
+ */
+static int spplog_varint(const uint8_t **pp_src, const uint8_t *p_end, int64_t *p_value)
+{
+    uint64_t zigzag = 0;
+
+    for (unsigned shift = 0; shift < 64u; shift += 7u)
+    {
+        if (*pp_src >= p_end)
+            return 0;
+        uint8_t byte = *(*pp_src)++;
+        zigzag |= (uint64_t)(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0u)
+        {
+            *p_value = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1u);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+/**
+ * @brief Expand an LZ body.
+ *
+ * @param[in]  p_src    Compressed bytes.
+ * @param[in]  length   Compressed length.
+ * @param[out] p_dst    Output.
+ * @param[in]  capacity Output capacity.
+ * @return Expanded length, or 0 if the input is malformed or too large.
+ */
+size_t spplog_lz_decode(const uint8_t *p_src, size_t length, uint8_t *p_dst, size_t capacity)
+{
+    const uint8_t *p_end = p_src + length;
+    size_t out = 0;
+
+    while (p_src < p_end)
+    {
+        uint8_t token = *p_src++;
+        size_t literals = token >> 4;
+        size_t match = token & 0x0Fu;
+
+        if (literals == K_LZ_NIBBLE_MAX && spplog_lz_length(&p_src, p_end, &literals) == 0)
+            return 0;
+        if ((size_t)(p_end - p_src) < literals || capacity - out < literals)
+            return 0;
+        memcpy(&p_dst[out], p_src, literals);
+        p_src += literals;
+        out += literals;
+
+        /* The last sequence carries literals only */
+        if (p_src == p_end)
+            break;
+
+        if (p_end - p_src < 2)
+            return 0;
+        size_t offset = (size_t)p_src[0] | ((size_t)p_src[1] << 8);
+        p_src += 2;
+        if (match == K_LZ_NIBBLE_MAX && spplog_lz_length(&p_src, p_end, &match) == 0)
+            return 0;
+        match += K_LZ_MIN_MATCH;
+
+        if (offset == 0u || offset > out || capacity - out < match)
+            return 0;
+        /* Byte by byte: matches may overlap their own output */
+        for (size_t i = 0; i < match; i++, out++)
+        {
+            p_dst[out] = p_dst[out - offset];
+        }
+    }
+
+    return out;
+}
+
+/**
+ * @brief Decode a compressed sample block.
+ *
+ * @param[in]  p_payload Frame payload holding the block.
+ * @param[in]  length    Payload length.
+ * @param[out] p_block   Receives the header, times and values.
+ * @return SPPLOG_OK, or SPPLOG_ERR_FORMAT if the block is malformed.
+ */
+int spplog_block_decode(const uint8_t *p_payload, size_t length, spplog_block_t *p_block)
+{
+    spp_logfmt_block_t *p_header = &p_block->header;
+
+    if (length < sizeof(*p_header))
+        return SPPLOG_ERR_FORMAT;
+    memcpy(p_header, p_payload, sizeof(*p_header));
+    if (p_header->channels == 0u || p_header->channels > SPP_LOGFMT_BLOCK_MAX_CHANNELS ||
+        p_header->packed_bytes > SPP_LOGFMT_BLOCK_MAX_PACKED ||
+        p_header->samples > SPPLOG_BLOCK_MAX_SAMPLES)
+        return SPPLOG_ERR_FORMAT;
+
+    const uint8_t *p_body = p_payload + sizeof(*p_header);
+    size_t bodyBytes = length - sizeof(*p_header);
+    const uint8_t *p_src = p_body;
+
+    if ((p_header->flags & SPP_LOGFMT_BLOCK_LZ) != 0u)
+    {
+        if (spplog_lz_decode(p_body, bodyBytes, p_block->packed, sizeof(p_block->packed)) !=
+            p_header->packed_bytes)
+            return SPPLOG_ERR_FORMAT;
+        p_src = p_block->packed;
+    }
+    else if (bodyBytes != p_header->packed_bytes)
+    {
+        return SPPLOG_ERR_FORMAT;
+    }
+
+    const uint8_t *p_end = p_src + p_header->packed_bytes;
+    int64_t time = p_header->base_time_us;
+    int64_t timeDelta = 0;
+    int64_t prev[SPP_LOGFMT_BLOCK_MAX_CHANNELS] = {0};
+    int64_t prevDelta[SPP_LOGFMT_BLOCK_MAX_CHANNELS] = {0};
+
+    for (uint32_t s = 0; s < p_header->samples; s++)
+    {
+        int64_t coded;
+        if (spplog_varint(&p_src, p_end, &coded) == 0)
+            return SPPLOG_ERR_FORMAT;
+        timeDelta += coded;
+        time += timeDelta;
+        p_block->time_us[s] = time;
+
+        for (uint32_t ch = 0; ch < p_header->channels; ch++)
+        {
+            if (spplog_varint(&p_src, p_end, &coded) == 0)
+                return SPPLOG_ERR_FORMAT;
+            int64_t delta = coded;
+            if ((p_header->order2_mask & (1u << ch)) != 0u)
+            {
+                delta = prevDelta[ch] + coded;
+                prevDelta[ch] = delta;
+            }
+            prev[ch] += delta;
+            p_block->values[s][ch] = (int32_t)prev[ch];
+        }
+    }
+
+    return (p_src == p_end) ? SPPLOG_OK : SPPLOG_ERR_FORMAT;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file spplog_cli.c
+ * @brief Command-line front end of the SPP log reader.
+ *
+ *     spplog info  FILE
+ *     spplog dump  FILE [--from US] [--to US] [--type T] [--meta] [--limit N]
+ *     spplog stats FILE
+ *
+ * info prints the header and the time span using only seeks; dump prints
+ * one line per frame starting at --from (found by binary search); stats
+ * decodes the whole log and reports per-type counts, sequence gaps,
+ * damaged regions and decode throughput.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "spplog.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Payload bytes shown per frame by dump. */
+#define K_DUMP_BYTES 16u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+typedef struct
+{
+    int64_t from_us;
+    int64_t to_us;
+    int type; /**< -1 = all. */
+    int meta;
+    uint64_t limit;
+} DumpOptions_t;
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static double cli_now_s(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static int cli_usage(void)
+{
+    fprintf(stderr, "usage: spplog info FILE\n"
+                    "       spplog dump FILE [--from US] [--to US] [--type T] [--meta] [--limit N]\n"
+                    "       spplog stats FILE\n");
+    return 2;
+}
+
+static int cli_info(const spplog_t *p_log)
+{
+    const spp_logfmt_file_header_t *p_header = &p_log->header;
+    spplog_cursor_t cursor;
+    spplog_record_t record;
+    uint32_t probes = 0;
+
+    printf("size            %" PRIu64 " bytes\n", p_log->size);
+    printf("session         0x%08" PRIx32 "\n", p_header->session);
+    printf("sync interval   %" PRIu32 " bytes\n", p_header->sync_interval);
+    printf("index interval  %" PRIu32 " bytes\n", p_header->index_interval);
+    printf("start time      %" PRId64 " us\n", p_header->start_time_us);
+    printf("wall time       %" PRIu64 " us since epoch%s\n", p_header->wall_time_us,
+           (p_header->wall_time_us == 0u) ? " (unknown)" : "");
+
+    spplog_cursor_init(&cursor, p_log, 0);
+    if (spplog_next(&cursor, &record) != SPPLOG_OK)
+    {
+        printf("records         none\n");
+        return 0;
+    }
+    int64_t firstUs = record.time_us;
+
+    /* Last record: jump to the last SYNC frame, then decode to the end */
+    double startS = cli_now_s();
+    spplog_cursor_init(&cursor, p_log, spplog_locate(p_log, INT64_MAX, &probes));
+    cursor.meta = 1;
+    int64_t lastUs = firstUs;
+    uint64_t endOffset = cursor.offset;
+    while (spplog_next(&cursor, &record) == SPPLOG_OK)
+    {
+        if (record.type >= SPP_LOGFMT_TYPE_USER)
+        {
+            lastUs = record.time_us;
+        }
+        endOffset = record.offset + record.length + SPP_LOGFMT_FRAME_OVERHEAD;
+    }
+    double elapsedS = cli_now_s() - startS;
+
+    printf("first record    %" PRId64 " us\n", firstUs);
+    printf("last record     %" PRId64 " us (%.3f s span)\n", lastUs, (double)(lastUs - firstUs) / 1e6);
+    printf("data end        %" PRIu64 " bytes\n", endOffset);
+    printf("end lookup      %u probes, %.3f ms\n", probes, elapsedS * 1e3);
+    return 0;
+}
+
+static int cli_dump(const spplog_t *p_log, const DumpOptions_t *p_opts)
+{
+    spplog_cursor_t cursor;
+    spplog_record_t record;
+    uint64_t printed = 0;
+
+    spplog_cursor_init(&cursor, p_log, 0);
+    cursor.meta = p_opts->meta;
+    if (p_opts->from_us != INT64_MIN && spplog_seek_time(&cursor, p_opts->from_us) != SPPLOG_OK)
+        return 0;
+
+    printf("%12s %16s %4s %5s %5s  payload\n", "offset", "time_us", "type", "seq", "len");
+    while (printed < p_opts->limit && spplog_next(&cursor, &record) == SPPLOG_OK)
+    {
+        if (record.time_us > p_opts->to_us)
+            break;
+        if (p_opts->type >= 0 && record.type != (uint8_t)p_opts->type)
+            continue;
+
+        printf("%12" PRIu64 " %16" PRId64 " %4u %5u %5u ", record.offset, record.time_us,
+               record.type, record.seq, record.length);
+        for (uint32_t i = 0; i < record.length && i < K_DUMP_BYTES; i++)
+        {
+            printf(" %02x", record.p_payload[i]);
+        }
+        printf("%s\n", (record.length > K_DUMP_BYTES) ? " ..." : "");
+        printed += 1;
+    }
+
+    return 0;
+}
+
+static int cli_stats(const spplog_t *p_log)
+{
+    spplog_cursor_t cursor;
+    spplog_record_t record;
+    uint64_t perType[256] = {0};
+    uint64_t frames = 0;
+    uint64_t payloadBytes = 0;
+    uint64_t seqGaps = 0;
+    uint64_t backwards = 0;
+    int64_t prevUs = INT64_MIN;
+    uint16_t expectedSeq = 0;
+
+    spplog_cursor_init(&cursor, p_log, 0);
+    cursor.meta = 1;
+
+    double startS = cli_now_s();
+    while (spplog_next(&cursor, &record) == SPPLOG_OK)
+    {
+        if (frames != 0u && record.seq != expectedSeq)
+        {
+            seqGaps += (uint16_t)(record.seq - expectedSeq);
+        }
+        if (record.time_us < prevUs)
+        {
+            backwards += 1;
+        }
+        expectedSeq = (uint16_t)(record.seq + 1u);
+        prevUs = record.time_us;
+        perType[record.type] += 1;
+        payloadBytes += record.length;
+        frames += 1;
+    }
+    double elapsedS = cli_now_s() - startS;
+    uint64_t decoded = (cursor.offset < p_log->size) ? cursor.offset : p_log->size;
+
+    printf("frames          %" PRIu64 " (%" PRIu64 " payload bytes)\n", frames, payloadBytes);
+    for (int type = 0; type < 256; type++)
+    {
+        if (perType[type] != 0u)
+        {
+            printf("  type %-3d      %" PRIu64 "\n", type, perType[type]);
+        }
+    }
+    printf("seq gaps        %" PRIu64 " frames missing\n", seqGaps);
+    printf("time reversals  %" PRIu64 "\n", backwards);
+    printf("resyncs         %" PRIu64 " (%" PRIu64 " bytes skipped)\n", cursor.resyncs,
+           cursor.skipped_bytes);
+    printf("decode          %.3f s, %.1f MB/s\n", elapsedS,
+           (elapsedS > 0.0) ? (double)decoded / elapsedS / 1e6 : 0.0);
+    return 0;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(int argc, char **argv)
+{
+    DumpOptions_t opts = {INT64_MIN, INT64_MAX, -1, 0, UINT64_MAX};
+    spplog_t log;
+
+    if (argc < 3)
+        return cli_usage();
+
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--meta") == 0)
+            opts.meta = 1;
+        else if (i + 1 < argc && strcmp(argv[i], "--from") == 0)
+            opts.from_us = strtoll(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--to") == 0)
+            opts.to_us = strtoll(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--type") == 0)
+            opts.type = (int)strtol(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--limit") == 0)
+            opts.limit = strtoull(argv[++i], NULL, 0);
+        else
+            return cli_usage();
+    }
+
+    int err = spplog_open(&log, argv[2]);
+    if (err != SPPLOG_OK)
+    {
+        fprintf(stderr, "%s: %s\n", argv[2],
+                (err == SPPLOG_ERR_IO) ? "cannot open" : "not an SPP log");
+        return 1;
+    }
+
+    int ret;
+    if (strcmp(argv[1], "info") == 0)
+        ret = cli_info(&log);
+    else if (strcmp(argv[1], "dump") == 0)
+        ret = cli_dump(&log, &opts);
+    else if (strcmp(argv[1], "stats") == 0)
+        ret = cli_stats(&log);
+    else
+        ret = cli_usage();
+
+    spplog_close(&log);
+    return ret;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file spptrace.c
+ * @brief Convert SPP binary trace dumps to Chrome trace JSON.
+ *
+ *     spptrace DUMP [OUT.json]
+ *
+ * Reads a dump written by SPP_OSAL_TraceWrite() (layout in tracefmt.h)
+ * and writes the Trace Event Format read by Perfetto (ui.perfetto.dev)
+ * and chrome://tracing: one process per core, one thread per task, plus
+ * an "ISR" thread per core for records made in interrupt context. BEGIN
+ * and END records become duration slices, INSTANT records thread-scoped
+ * instants, and object and arg are attached to every event.
+ *
+ * Each ring is read oldest first. Timestamps are unwrapped per ring by
+ * taking the signed 32-bit difference to the previous record, which also
+ * absorbs the small reordering of records claimed just before an
+ * interrupt. Times are shifted so the earliest record is at 0.
+ */
+
+/* ============================================================================
+ * Includes
+ * ========================================================================= */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tracefmt.h"
+
+/* ============================================================================
+ * Private Constants
+ * ========================================================================= */
+
+/** @brief Thread id of the per-core interrupt track. */
+#define K_ISR_TID 0xFFFFFFFFu
+
+/** @brief Largest number of cores a dump may declare (SPP_TRACE_CORE_MASK). */
+#define K_MAX_CORES 16u
+
+/* ============================================================================
+ * Private Types
+ * ========================================================================= */
+
+/**
+ * @brief Record with its unwrapped time.
+ */
+typedef struct
+{
+    uint64_t time;
+    uint32_t core;
+    uint32_t seq; /**< Position in the dump; keeps same-tick records in ring order. */
+    spp_trace_event_t ev;
+} TraceRecord_t;
+
+/**
+ * @brief Thread seen on a core, for thread_name metadata.
+ */
+typedef struct
+{
+    uint32_t core;
+    uint32_t tid;
+} TraceThread_t;
+
+/* ============================================================================
+ * Private Variables
+ * ========================================================================= */
+
+static const char *const s_eventNames[] = {
+    "event_0",   "queue_send", "queue_receive", "eg_set_isr",
+    "eg_wait",   "task_create", "task_delay",   "spi_transmit",
+    "gpio_isr",
+};
+
+/* ============================================================================
+ * Private Functions
+ * ========================================================================= */
+
+static int trace_usage(void)
+{
+    fprintf(stderr, "usage: spptrace DUMP [OUT.json]\n");
+    return 2;
+}
+
+/**
+ * @brief Read a whole file into a malloc'd buffer.
+ *
+ * @return Buffer, or NULL on failure.
+ */
+static uint8_t *trace_read_file(const char *p_path, size_t *p_size)
+{
+    FILE *p_file = fopen(p_path, "rb");
+    if (p_file == NULL)
+        return NULL;
+
+    uint8_t *p_data = NULL;
+    long size = -1;
+    if (fseek(p_file, 0, SEEK_END) == 0)
+        size = ftell(p_file);
+    if (size > 0 && fseek(p_file, 0, SEEK_SET) == 0)
+    {
+        p_data = malloc((size_t)size);
+        if (p_data != NULL && fread(p_data, 1, (size_t)size, p_file) != (size_t)size)
+        {
+            free(p_data);
+            p_data = NULL;
+        }
+    }
+    fclose(p_file);
+    *p_size = (size_t)size;
+    return p_data;
+}
+
+static int trace_compare_time(const void *p_a, const void *p_b)
+{
+    const TraceRecord_t *p_ra = (const TraceRecord_t *)p_a;
+    const TraceRecord_t *p_rb = (const TraceRecord_t *)p_b;
+    if (p_ra->time != p_rb->time)
+        return (p_ra->time > p_rb->time) ? 1 : -1;
+    return (p_ra->seq > p_rb->seq) - (p_ra->seq < p_rb->seq);
+}
+
+static const char *trace_event_name(uint8_t event, char *p_buf, size_t size)
+{
+    if (event < sizeof(s_eventNames) / sizeof(s_eventNames[0]))
+        return s_eventNames[event];
+    snprintf(p_buf, size, (event >= SPP_TRACE_EV_USER) ? "user_%u" : "event_%u",
+             (unsigned)(event >= SPP_TRACE_EV_USER ? event - SPP_TRACE_EV_USER : event));
+    return p_buf;
+}
+
+static const char *trace_task_name(const spp_trace_name_t *p_names, uint32_t count,
+                                   uint32_t task, char *p_buf, size_t size)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (p_names[i].task == task)
+        {
+            snprintf(p_buf, size, "%.*s", (int)SPP_TRACE_NAME_LEN, p_names[i].name);
+            return p_buf;
+        }
+    }
+    snprintf(p_buf, size, (task == 0u) ? "(no task)" : "task 0x%08" PRIx32, task);
+    return p_buf;
+}
+
+/**
+ * @brief Print a name for JSON, escaping what needs it.
+ */
+static void trace_put_string(FILE *p_out, const char *p_str)
+{
+    fputc('"', p_out);
+    for (; *p_str != '\0'; p_str++)
+    {
+        unsigned char c = (unsigned char)*p_str;
+        if (c == '"' || c == '\\')
+            fprintf(p_out, "\\%c", c);
+        else if (c < 0x20u)
+            fprintf(p_out, "\\u%04x", c);
+        else
+            fputc(c, p_out);
+    }
+    fputc('"', p_out);
+}
+
+/**
+ * @brief Collect every used record of the dump, oldest first per ring.
+ *
+ * @return Number of records in p_out, or -1 if the dump is malformed.
+ */
+static long trace_collect(const uint8_t *p_data, size_t size,
+                          const spp_trace_file_header_t *p_header, TraceRecord_t *p_out)
+{
+    size_t offset = sizeof(*p_header);
+    long count = 0;
+
+    for (uint32_t c = 0; c < p_header->cores; c++)
+    {
+        spp_trace_ring_header_t ring;
+        size_t ringBytes = (size_t)p_header->ring_events * sizeof(spp_trace_event_t);
+        if (offset + sizeof(ring) + ringBytes > size)
+            return -1;
+        memcpy(&ring, &p_data[offset], sizeof(ring));
+        offset += sizeof(ring);
+
+        uint32_t used = (ring.head < p_header->ring_events) ? ring.head : p_header->ring_events;
+        uint32_t first = (ring.head < p_header->ring_events) ? 0u : ring.head % p_header->ring_events;
+        uint32_t prev = 0;
+        uint64_t time = 0;
+        int started = 0;
+
+        for (uint32_t i = 0; i < used; i++)
+        {
+            spp_trace_event_t ev;
+            uint32_t slot = (first + i) % p_header->ring_events;
+            memcpy(&ev, &p_data[offset + (size_t)slot * sizeof(ev)], sizeof(ev));
+            if (ev.event == 0u)
+                continue; /* claimed but never filled in */
+
+            if (started == 0)
+            {
+                time = ev.time;
+                started = 1;
+            }
+            else
+            {
+                time += (uint64_t)(int64_t)(int32_t)(ev.time - prev);
+            }
+            prev = ev.time;
+
+            p_out[count].time = time;
+            p_out[count].core = ring.core;
+            p_out[count].seq = (uint32_t)count;
+            p_out[count].ev = ev;
+            count += 1;
+        }
+        offset += ringBytes;
+    }
+
+    if (offset + (size_t)p_header->names * sizeof(spp_trace_name_t) > size)
+        return -1;
+    return count;
+}
+
+/**
+ * @brief Write the Chrome trace JSON.
+ */
+static void trace_write_json(FILE *p_out, const spp_trace_file_header_t *p_header,
+                             TraceRecord_t *p_records, long count,
+                             const spp_trace_name_t *p_names)
+{
+    static TraceThread_t s_threads[4096];
+    uint32_t threads = 0;
+    char eventBuf[16];
+    char nameBuf[SPP_TRACE_NAME_LEN + 16u];
+
+    qsort(p_records, (size_t)count, sizeof(p_records[0]), trace_compare_time);
+    uint64_t base = (count > 0) ? p_records[0].time : 0u;
+    double usPerTick = 1e6 / (double)p_header->tick_hz;
+
+    fprintf(p_out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (uint32_t c = 0; c < p_header->cores; c++)
+    {
+        fprintf(p_out,
+                "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%" PRIu32
+                ",\"args\":{\"name\":\"core %" PRIu32 "\"}},\n",
+                c, c);
+    }
+
+    for (long i = 0; i < count; i++)
+    {
+        const TraceRecord_t *p_rec = &p_records[i];
+        uint8_t phase = p_rec->ev.flags & SPP_TRACE_PHASE_MASK;
+        uint32_t tid = (p_rec->ev.flags & SPP_TRACE_FLAG_ISR) ? K_ISR_TID : p_rec->ev.task;
+
+        uint32_t t = 0;
+        while (t < threads && (s_threads[t].core != p_rec->core || s_threads[t].tid != tid))
+            t++;
+        if (t == threads && threads < sizeof(s_threads) / sizeof(s_threads[0]))
+        {
+            s_threads[threads].core = p_rec->core;
+            s_threads[threads].tid = tid;
+            threads += 1;
+        }
+
+        fprintf(p_out, "{\"ph\":\"%s\",\"name\":\"%s\",\"pid\":%" PRIu32 ",\"tid\":%" PRIu32
+                       ",\"ts\":%.3f,",
+                (phase == SPP_TRACE_PHASE_BEGIN) ? "B"
+                : (phase == SPP_TRACE_PHASE_END) ? "E"
+                                                 : "i",
+                trace_event_name(p_rec->ev.event, eventBuf, sizeof(eventBuf)), p_rec->core, tid,
+                (double)(p_rec->time - base) * usPerTick);
+        if (phase != SPP_TRACE_PHASE_BEGIN && phase != SPP_TRACE_PHASE_END)
+            fprintf(p_out, "\"s\":\"t\",");
+        fprintf(p_out, "\"args\":{\"object\":\"0x%08" PRIx32 "\",\"arg\":%u}},\n",
+                p_rec->ev.object, (unsigned)p_rec->ev.arg);
+    }
+
+    for (uint32_t t = 0; t < threads; t++)
+    {
+        fprintf(p_out, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%" PRIu32
+                       ",\"tid\":%" PRIu32 ",\"args\":{\"name\":",
+                s_threads[t].core, s_threads[t].tid);
+        if (s_threads[t].tid == K_ISR_TID)
+            trace_put_string(p_out, "ISR");
+        else
+            trace_put_string(p_out, trace_task_name(p_names, p_header->names, s_threads[t].tid,
+                                                    nameBuf, sizeof(nameBuf)));
+        fprintf(p_out, "}}%s\n", (t + 1u < threads) ? "," : "");
+    }
+    fprintf(p_out, "]}\n");
+}
+
+/* ============================================================================
+ * Public Functions
+ * ========================================================================= */
+
+int main(int argc, char **argv)
+{
+    spp_trace_file_header_t header;
+    size_t size = 0;
+
+    if (argc < 2 || argc > 3)
+        return trace_usage();
+
+    uint8_t *p_data = trace_read_file(argv[1], &size);
+    if (p_data == NULL)
+    {
+        fprintf(stderr, "%s: cannot read\n", argv[1]);
+        return 1;
+    }
+    if (size < sizeof(header))
+    {
+        fprintf(stderr, "%s: not an SPP trace\n", argv[1]);
+        free(p_data);
+        return 1;
+    }
+    memcpy(&header, p_data, sizeof(header));
+    if (memcmp(header.magic, SPP_TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SPP_TRACE_VERSION || header.event_bytes != sizeof(spp_trace_event_t) ||
+        header.tick_hz == 0u || header.cores == 0u || header.cores > K_MAX_CORES ||
+        header.ring_events == 0u)
+    {
+        fprintf(stderr, "%s: not an SPP trace, or an unsupported version\n", argv[1]);
+        free(p_data);
+        return 1;
+    }
+
+    TraceRecord_t *p_records =
+        malloc((size_t)header.cores * header.ring_events * sizeof(TraceRecord_t));
+    long count = (p_records != NULL) ? trace_collect(p_data, size, &header, p_records) : -1;
+    if (count < 0)
+    {
+        fprintf(stderr, "%s: truncated dump\n", argv[1]);
+        free(p_records);
+        free(p_data);
+        return 1;
+    }
+    size_t namesOffset = sizeof(header) + (size_t)header.cores *
+                                              (sizeof(spp_trace_ring_header_t) +
+                                               (size_t)header.ring_events * sizeof(spp_trace_event_t));
+    const spp_trace_name_t *p_names = (const spp_trace_name_t *)&p_data[namesOffset];
+
+    FILE *p_out = (argc == 3) ? fopen(argv[2], "w") : stdout;
+    if (p_out == NULL)
+    {
+        fprintf(stderr, "%s: cannot create\n", argv[2]);
+        free(p_records);
+        free(p_data);
+        return 1;
+    }
+    trace_write_json(p_out, &header, p_records, count, p_names);
+    int ret = (p_out != stdout && fclose(p_out) != 0) ? 1 : 0;
+
+    fprintf(stderr, "%ld records on %" PRIu32 " cores, %" PRIu32 " task names\n", count,
+            header.cores, header.names);
+    free(p_records);
+    free(p_data);
+    return ret;
+}